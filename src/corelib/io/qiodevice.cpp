@@ -997,7 +997,12 @@ QByteArray QIODevice::readAll()
     if (!(d->openMode & Text) && !d->buffer.isEmpty()) {
         if (quint64(d->buffer.size()) >= QByteArray::MaxSize)
             return QByteArray();
-        result = d->buffer.readAll();
+        if (d->buffer.nextDataBlockSize() == d->buffer.size()) {
+            result = d->buffer.readChunk(d->buffer.size());
+        } else {
+            result.resize(int(d->buffer.size()));
+            d->buffer.read(result.data(), result.size());
+        }
         readBytes = result.size();
         if (!sequential)
             d->pos += readBytes;
@@ -1034,6 +1039,57 @@ QByteArray QIODevice::readAll()
     return result;
 }
 
+/*!
+    \since 5.6
+
+    Reads at most \a maxSize bytes from the device and returns them as a
+    list of byte arrays that, joined together, hold the data read.
+
+    Unlike read(), this function does not need to copy the data into one
+    contiguous block: devices that keep their data in several buffers, like
+    QAbstractSocket or QNetworkReply, hand those buffers out directly through
+    implicit sharing. Devices without such buffers return the data in a
+    single chunk. In Text mode the data is always copied.
+
+    This function has no way of reporting errors; returning an empty
+    list can mean either that no data was currently available
+    for reading, or that an error occurred.
+
+    \sa read(), readAll()
+*/
+QByteArrayList QIODevice::readChunks(qint64 maxSize)
+{
+    Q_D(QIODevice);
+    QByteArrayList chunks;
+
+    CHECK_MAXLEN(readChunks, chunks);
+    CHECK_READABLE(readChunks, chunks);
+
+    if (maxSize)
+        d->readChunks(&chunks, maxSize);
+    return chunks;
+}
+
+/*!
+    \since 5.6
+    \overload
+
+    Reads all available data from the device, and returns it as a list of
+    byte arrays.
+
+    \sa readAll()
+*/
+QByteArrayList QIODevice::readChunks()
+{
+    Q_D(QIODevice);
+    QByteArrayList chunks;
+
+    CHECK_READABLE(readChunks, chunks);
+
+    d->readChunks(&chunks, -1);
+    return chunks;
+}
+
 /*!
     This function reads a line of ASCII characters from the device, up
     to a maximum of \a maxSize - 1 bytes, stores the characters in \a
@@ -1090,7 +1146,8 @@ qint64 QIODevice::readLine(char *data, qint64 maxSize)
 
     qint64 readSoFar = 0;
     if (!d->buffer.isEmpty()) {
-        readSoFar = d->buffer.readLine(data, maxSize);
+        // QRingBuffer::readLine() reserves room for its own '\0'
+        readSoFar = d->buffer.readLine(data, maxSize + 1);
         if (d->buffer.isEmpty())
             readData(data,0);
         if (!sequential)
@@ -1445,6 +1502,56 @@ qint64 QIODevicePrivate::peek(char *data, qint64 maxSize)
     return readBytes;
 }
 
+/*!
+    \internal
+
+    Appends at most \a maxSize bytes (all that is available if \a maxSize is
+    negative) to \a chunks and returns the number of bytes read.
+    Reimplementations hand out the buffers of the device without copying;
+    this implementation gives out what is in the read buffer and reads the
+    rest into a single array.
+*/
+qint64 QIODevicePrivate::readChunks(QByteArrayList *chunks, qint64 maxSize)
+{
+    Q_Q(QIODevice);
+    if (openMode & QIODevice::Text) {
+        const QByteArray data = maxSize < 0 ? q->readAll() : q->read(maxSize);
+        if (!data.isEmpty())
+            chunks->append(data);
+        return data.size();
+    }
+
+    qint64 readSoFar = readBufferedChunks(chunks, maxSize);
+    if (maxSize >= 0 && readSoFar == maxSize)
+        return readSoFar;
+
+    const QByteArray data = maxSize < 0 ? q->readAll() : q->read(maxSize - readSoFar);
+    if (!data.isEmpty()) {
+        chunks->append(data);
+        readSoFar += data.size();
+    }
+    return readSoFar;
+}
+
+/*!
+    \internal
+
+    Moves at most \a maxSize bytes (everything if \a maxSize is negative)
+    from the read buffer to \a chunks, sharing its blocks where possible.
+*/
+qint64 QIODevicePrivate::readBufferedChunks(QByteArrayList *chunks, qint64 maxSize)
+{
+    qint64 readSoFar = 0;
+    while (!buffer.isEmpty() && (maxSize < 0 || readSoFar < maxSize)) {
+        const QByteArray chunk = buffer.readChunk(maxSize < 0 ? buffer.size() : maxSize - readSoFar);
+        chunks->append(chunk);
+        readSoFar += chunk.size();
+    }
+    if (!isSequential())
+        pos += readSoFar;
+    return readSoFar;
+}
+
 /*!
     \internal
 */
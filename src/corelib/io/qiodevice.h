@@ -42,6 +42,7 @@
 #include <QtCore/qscopedpointer.h>
 #endif
 #include <QtCore/qstring.h>
+#include <QtCore/qbytearraylist.h>
 
 #ifdef open
 #error qiodevice.h must be included before any header file that defines open
@@ -107,6 +108,8 @@ public:
     qint64 read(char *data, qint64 maxlen);
     QByteArray read(qint64 maxlen);
     QByteArray readAll();
+    QByteArrayList readChunks(qint64 maxlen);
+    QByteArrayList readChunks();
     qint64 readLine(char *data, qint64 maxlen);
     QByteArray readLine(qint64 maxlen = 0);
     virtual bool canReadLine() const;
@@ -106,6 +106,22 @@ QT_BEGIN_NAMESPACE
 
     \internal
 */
+/*!
+    \fn virtual qintptr QNonContiguousByteDevice::fileHandle(qint64 *offset)
+
+    Returns the native handle of a file that holds the data from the
+    current read position on, and stores the offset of that position
+    in \a offset. Returns -1 if there is no such file, which is what
+    the default implementation does.
+
+    This lets the data be sent straight from the file, without reading
+    it into memory. The caller still has to call advanceReadPointer()
+    for what it consumed that way.
+
+    \sa readPointer()
+
+    \internal
+*/
 /*!
     \fn void QNonContiguousByteDevice::readyRead()
 
@@ -129,6 +145,12 @@ QNonContiguousByteDevice::~QNonContiguousByteDevice()
 {
 }
 
+qintptr QNonContiguousByteDevice::fileHandle(qint64 *offset)
+{
+    Q_UNUSED(offset);
+    return -1;
+}
+
 // FIXME we should scrap this whole implementation and instead change the ByteArrayImpl to be able to cope with sub-arrays?
 QNonContiguousByteDeviceBufferImpl::QNonContiguousByteDeviceBufferImpl(QBuffer *b) : QNonContiguousByteDevice()
 {
@@ -342,6 +364,14 @@ bool QNonContiguousByteDeviceIoDeviceImpl::advanceReadPointer(qint64 amount)
     // advancing over that what has actually been read before
     if (currentReadBufferPosition > currentReadBufferAmount) {
         qint64 i = currentReadBufferPosition - currentReadBufferAmount;
+        if (!device->isSequential()) {
+            // the data was consumed without reading it, e.g. through fileHandle()
+            if (!device->seek(device->pos() + i)) {
+                emit readProgress(totalAdvancements - i, size());
+                return false;
+            }
+            i = 0;
+        }
         while (i > 0) {
             if (device->getChar(0) == false) {
                 emit readProgress(totalAdvancements - i, size());
@@ -399,6 +429,24 @@ qint64 QNonContiguousByteDeviceIoDeviceImpl::pos()
     return device->pos();
 }
 
+qintptr QNonContiguousByteDeviceIoDeviceImpl::fileHandle(qint64 *offset)
+{
+    // whatever was read into our buffer has to be consumed first
+    if (currentReadBufferPosition < currentReadBufferAmount)
+        return -1;
+
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    if (!file || file->isSequential() || (file->openMode() & QIODevice::Text))
+        return -1;
+
+    const int handle = file->handle();
+    if (handle == -1)
+        return -1;
+
+    *offset = file->pos();
+    return handle;
+}
+
 QByteDeviceWrappingIoDevice::QByteDeviceWrappingIoDevice(QNonContiguousByteDevice *bd) : QIODevice((QObject*)0)
 {
     byteDevice = bd;
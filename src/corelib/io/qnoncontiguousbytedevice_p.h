@@ -64,6 +64,7 @@ public:
     virtual qint64 pos() { return -1; }
     virtual bool reset() = 0;
     virtual qint64 size() = 0;
+    virtual qintptr fileHandle(qint64 *offset);
 
     virtual ~QNonContiguousByteDevice();
 
@@ -139,6 +140,7 @@ public:
     bool reset() Q_DECL_OVERRIDE;
     qint64 size() Q_DECL_OVERRIDE;
     qint64 pos() Q_DECL_OVERRIDE;
+    qintptr fileHandle(qint64 *offset) Q_DECL_OVERRIDE;
 protected:
     QIODevice* device;
     QByteArray* currentReadBuffer;
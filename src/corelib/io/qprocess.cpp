@@ -1300,14 +1300,12 @@ void QProcess::setReadChannel(ProcessChannel channel)
 {
     Q_D(QProcess);
     if (d->processChannel != channel) {
-        QByteArray buf = d->buffer.readAll();
-        if (d->processChannel == QProcess::StandardOutput) {
-            for (int i = buf.size() - 1; i >= 0; --i)
-                d->stdoutChannel.buffer.ungetChar(buf.at(i));
-        } else {
-            for (int i = buf.size() - 1; i >= 0; --i)
-                d->stderrChannel.buffer.ungetChar(buf.at(i));
-        }
+        QByteArray buf(int(d->buffer.size()), Qt::Uninitialized);
+        d->buffer.read(buf.data(), buf.size());
+        if (d->processChannel == QProcess::StandardOutput)
+            d->stdoutChannel.buffer.ungetBlock(buf.constData(), buf.size());
+        else
+            d->stderrChannel.buffer.ungetBlock(buf.constData(), buf.size());
     }
     d->processChannel = channel;
 }
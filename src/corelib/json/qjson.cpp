@@ -33,6 +33,7 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -123,6 +124,14 @@ void Data::compact()
     compactionCounter = 0;
 }
 
+void Data::releaseMappedFile()
+{
+    Q_ASSERT(mappedFile);
+    // closing the file removes the mapping
+    delete mappedFile;
+    mappedFile = 0;
+}
+
 bool Data::valid() const
 {
     if (header->tag != QJsonDocument::BinaryFormatTag || header->version != 1u)
@@ -115,6 +115,8 @@ QT_BEGIN_NAMESPACE
     Other measurements have shown a slightly bigger binary size than a compact text
     representation where all possible whitespace was stripped out.
 */
+class QFile;
+
 namespace QJsonPrivate {
 
 class Array;
@@ -743,13 +745,16 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // set for documents created with QJsonDocument::fromMappedFile();
+    // rawData then points into a read-only mapping owned by the file
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true), mappedFile(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true), mappedFile(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -765,7 +770,16 @@ public:
         b->length = 0;
     }
     inline ~Data()
-    { if (ownsData) free(rawData); }
+    {
+        if (ownsData)
+            free(rawData);
+        else if (mappedFile)
+            releaseMappedFile();
+    }
+
+    // data we don't own (fromRawData(), fromMappedFile()) must never be
+    // written to, so it has to be copied before the first modification
+    bool isDetached() const { return ownsData && ref.load() == 1; }
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -782,7 +796,7 @@ public:
     Data *clone(Base *b, int reserve = 0)
     {
         int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
+        if (b == header->root() && isDetached() && alloc >= size + reserve)
             return this;
 
         if (reserve) {
@@ -803,6 +817,7 @@ public:
 
     void compact();
     bool valid() const;
+    void releaseMappedFile();
 
 private:
     Q_DISABLE_COPY(Data)
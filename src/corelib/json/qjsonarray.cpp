@@ -1128,7 +1128,7 @@ void QJsonArray::detach(uint reserve)
         d->ref.ref();
         return;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->isDetached())
         return;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
@@ -38,6 +38,8 @@
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
+#include <qfile.h>
+#include <qscopedpointer.h>
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
@@ -164,6 +166,8 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
  The created document does not take ownership of \a data and the caller
  has to guarantee that \a data will not be deleted or modified as long as
  any QJsonDocument, QJsonObject or QJsonArray still references the data.
+ The document itself never writes to \a data; modifications are applied
+ to a copy.
 
  \a data has to be aligned to a 4 byte boundary.
 
@@ -250,6 +254,68 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     return QJsonDocument(d);
 }
 
+/*!
+ \since 5.6
+
+ Creates a QJsonDocument that uses the binary encoded JSON document stored
+ in the file \a fileName, as written by toBinaryData() or rawData().
+
+ The file is mapped into memory read-only with QFileDevice::map() and the
+ document references the mapping directly instead of copying it. Loading
+ is therefore independent of the size of the file when \a validation is
+ BypassValidation, and processes that load the same file share its pages
+ through the operating system's page cache. The mapping is kept alive as
+ long as any QJsonDocument, QJsonObject, QJsonArray or QJsonValue still
+ references the data.
+
+ The mapped data is never written to. Modifying the document, or any object
+ or array obtained from it, first copies the data into memory owned by the
+ document, leaving the file untouched.
+
+ The file must not be truncated or modified while the document is in use.
+
+ \a validation decides whether the data is checked for validity before being used.
+ By default the data is validated, which has to read the whole file. If the file
+ cannot be opened or mapped, or does not contain a valid document, the method
+ returns a null document.
+
+ \sa fromRawData(), fromBinaryData(), toBinaryData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromMappedFile(const QString &fileName, DataValidation validation)
+{
+    QScopedPointer<QFile> file(new QFile(fileName));
+    if (!file->open(QIODevice::ReadOnly))
+        return QJsonDocument();
+
+    const qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base))
+        || fileSize > std::numeric_limits<int>::max())
+        return QJsonDocument();
+
+    uchar *map = file->map(0, fileSize);
+    if (!map)
+        return QJsonDocument();
+
+    // mappings are page aligned, which satisfies the 4 byte alignment of the format
+    QJsonPrivate::Header *h = reinterpret_cast<QJsonPrivate::Header *>(map);
+    const QJsonPrivate::Base *root = h->root();
+    if (h->tag != QJsonDocument::BinaryFormatTag || h->version != 1u ||
+        sizeof(QJsonPrivate::Header) + root->size > quint64(fileSize))
+        return QJsonDocument();
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(reinterpret_cast<char *>(map),
+                                                   sizeof(QJsonPrivate::Header) + root->size);
+    d->ownsData = false;
+    d->mappedFile = file.take();
+
+    if (validation != BypassValidation && !d->valid()) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
 /*!
  Creates a QJsonDocument from the QVariant \a variant.
 
@@ -98,6 +98,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromMappedFile(const QString &fileName, DataValidation validation = Validate);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
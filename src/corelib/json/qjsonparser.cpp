@@ -39,6 +39,7 @@
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -56,6 +57,9 @@ static const int nestingLimit = 1024;
 
 QT_BEGIN_NAMESPACE
 
+// in qstring.cpp
+void qt_from_latin1(ushort *dst, const char *str, size_t size);
+
 // error strings for the JSON parser
 #define JSONERR_OK          QT_TRANSLATE_NOOP("QJsonParseError", "no error occurred")
 #define JSONERR_UNTERM_OBJ  QT_TRANSLATE_NOOP("QJsonParseError", "unterminated object")
@@ -250,8 +254,88 @@ void Parser::eatBOM()
         json += 3;
 }
 
+/*
+    SIMD helpers. Whitespace between tokens comes in long runs in indented
+    documents, and most strings are plain ASCII without escape sequences;
+    both can be skipped or copied sixteen (or, with AVX2, thirty-two)
+    bytes at a time.
+*/
+#ifdef __SSE2__
+static inline const char *skipSpaceSse2(const char *json, const char *end)
+{
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i carriageReturn = _mm_set1_epi8(Return);
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                          _mm_cmpeq_epi8(data, tab)),
+                                             _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                          _mm_cmpeq_epi8(data, carriageReturn)));
+        const uint n = ~_mm_movemask_epi8(isSpace) & 0xffff;
+        if (n)
+            return json + _bit_scan_forward(n);
+    }
+    return json;
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static const char *scanAsciiRunAvx2(const char *json, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        // the sign bit of data is set for non-ASCII bytes
+        const __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                                 _mm256_cmpeq_epi8(data, backslash)),
+                                                data);
+        const uint n = _mm256_movemask_epi8(special);
+        if (n)
+            return json + _bit_scan_forward(n);
+    }
+    return json;
+}
+#endif
+
+// returns the first quote, backslash or non-ASCII byte in [json, end), or end
+static inline const char *scanAsciiRun(const char *json, const char *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (end - json >= 64 && qCpuHasFeature(AVX2)) {
+        json = scanAsciiRunAvx2(json, end);
+        if (end - json >= 32)
+            return json;
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                          _mm_cmpeq_epi8(data, backslash)),
+                                             data);
+        const uint n = _mm_movemask_epi8(special);
+        if (n)
+            return json + _bit_scan_forward(n);
+    }
+#endif
+    while (json < end && *json != Quote && *json != '\\' && uchar(*json) < 0x80)
+        ++json;
+    return json;
+}
+
 bool Parser::eatSpace()
 {
+    if (json < end && *json > Space)
+        return true;
+#ifdef __SSE2__
+    json = skipSpaceSse2(json, end);
+#endif
     while (json < end) {
         if (*json > Space)
             break;
@@ -766,80 +850,6 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const uchar *&src = reinterpret_cast<const uchar *&>(json);
-    const uchar *uend = reinterpret_cast<const uchar *>(end);
-    uchar b = *src++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, src, uend);
-    if (res < 0) {
-        // decoding error, backtrack the character we read above
-        --json;
-        return false;
-    }
-
-    return true;
-}
-
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -852,6 +862,17 @@ bool Parser::parseString(bool *latin1)
     int stringPos = reserveSpace(2);
     BEGIN << "parse string stringPos=" << stringPos << json;
     while (json < end) {
+        // copy plain ASCII in one go, up to the latin1 length limit below
+        const char *run = scanAsciiRun(json, end - start > 0x7fff ? start + 0x7fff : end);
+        if (run != json) {
+            const int length = int(run - json);
+            int pos = reserveSpace(length);
+            memcpy(data + pos, json, length);
+            json = run;
+            if (json >= end)
+                break;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -900,6 +921,19 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // widen plain ASCII in one go
+        const char *run = scanAsciiRun(json, end);
+        if (run != json) {
+            const int length = int(run - json);
+            int pos = reserveSpace(2 * length);
+            qt_from_latin1(reinterpret_cast<ushort *>(data + pos), json, length);
+            json = run;
+            if (json >= end)
+                break;
+        }
+#endif
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -0,0 +1,937 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamreader.h"
+#include "qjson_p.h"
+#include "qjsonparser_p.h"
+
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+#include <private/qlocale_p.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int nestingLimit = 1024;
+static const int readChunkSize = 64 * 1024;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        BeforeDocument,     // expecting the top-level '{' or '['
+        ObjectStart,        // after '{': a name or '}'
+        ObjectNext,         // after ',' in an object: a name
+        AfterName,          // expecting ':' followed by a value
+        ArrayStart,         // after '[': a value or ']'
+        ArrayNext,          // after ',' in an array: a value
+        AfterValue,         // expecting ',' or the end of the enclosing container
+        AfterDocument,      // the top-level container has been closed
+        Finished            // EndDocument or an error has been reported
+    };
+
+    enum ScanResult {
+        Ok,
+        NeedMoreData,
+        Failed
+    };
+
+    QJsonStreamReaderPrivate();
+    void init();
+
+    bool fill(int keepFrom);
+    void discard(int bytes);
+
+    ScanResult scanToken();
+    ScanResult scanValue(const char *json, const char *end);
+    ScanResult scanString(const char *json, const char *end, QJsonStreamReader::TokenType tokenType);
+    ScanResult scanNumber(const char *json, const char *end);
+    ScanResult startContainer(const char *json, bool object);
+    ScanResult endContainer(const char *json);
+    ScanResult needMoreData(const char *json, QJsonParseError::ParseError errorAtEnd);
+    ScanResult raiseError(const char *json, QJsonParseError::ParseError e);
+    void commit(const char *json, const char *tokenBegin, State st);
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;                    // first byte in buffer not consumed yet
+    qint64 bufferOffset;        // offset of buffer[0] in the input
+    bool atEndOfInput;          // device() has no more data to offer
+    bool incomplete;            // the last read ran out of data
+
+    State state;
+    QVarLengthArray<bool, 32> containers;   // true for objects
+
+    QJsonStreamReader::TokenType type;
+    int tokenStart;             // first byte of the current token in buffer
+    int textStart;              // raw text of Name, String and Number tokens
+    int textLength;
+    bool textIsAscii;           // raw text can be used as is
+    QString decodedText;
+    double number;
+    bool boolean;
+
+    int stringResume;           // scanning progress of an incomplete string
+    bool stringResumeAscii;
+
+    int valueScanned;           // scanning progress of an incomplete readValue()
+    int valueDepth;
+    bool valueInString;
+
+    QJsonParseError::ParseError error;
+    qint64 errorOffset;
+};
+
+QJsonStreamReaderPrivate::QJsonStreamReaderPrivate()
+    : device(0)
+{
+    init();
+}
+
+void QJsonStreamReaderPrivate::init()
+{
+    buffer.clear();
+    pos = 0;
+    bufferOffset = 0;
+    atEndOfInput = false;
+    incomplete = false;
+    state = BeforeDocument;
+    containers.clear();
+    type = QJsonStreamReader::NoToken;
+    tokenStart = 0;
+    textStart = 0;
+    textLength = 0;
+    textIsAscii = true;
+    decodedText.clear();
+    number = 0;
+    boolean = false;
+    stringResume = 0;
+    stringResumeAscii = true;
+    valueScanned = 0;
+    valueDepth = 0;
+    valueInString = false;
+    error = QJsonParseError::NoError;
+    errorOffset = 0;
+}
+
+/*
+    Drops the first \a bytes bytes of the buffer, which must have been
+    consumed already, and adjusts all positions that refer into it.
+*/
+void QJsonStreamReaderPrivate::discard(int bytes)
+{
+    if (bytes <= 0)
+        return;
+    buffer.remove(0, bytes);
+    bufferOffset += bytes;
+    pos -= bytes;
+    tokenStart -= bytes;
+    textStart -= bytes;
+}
+
+/*
+    Reads the next chunk from the device into the buffer. Everything before
+    \a keepFrom is dropped first, so the buffer never holds more than the
+    token currently being scanned plus one chunk.
+
+    Returns \c false if no data could be read; atEndOfInput tells whether
+    more is to be expected.
+*/
+bool QJsonStreamReaderPrivate::fill(int keepFrom)
+{
+    if (!device || atEndOfInput)
+        return false;
+
+    discard(keepFrom);
+
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + readChunkSize);
+    qint64 bytesRead = device->read(buffer.data() + oldSize, readChunkSize);
+    buffer.resize(oldSize + int(qMax<qint64>(bytesRead, 0)));
+    if (bytesRead > 0)
+        return true;
+
+    if (bytesRead < 0 || (!device->isSequential() && device->atEnd()))
+        atEndOfInput = true;
+    return false;
+}
+
+static inline const char *skipSpace(const char *json, const char *end)
+{
+    while (json < end) {
+        const char c = *json;
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+        ++json;
+    }
+    return json;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::needMoreData(const char *json, QJsonParseError::ParseError errorAtEnd)
+{
+    if (atEndOfInput)
+        return raiseError(json, errorAtEnd);
+    return NeedMoreData;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::raiseError(const char *json, QJsonParseError::ParseError e)
+{
+    error = e;
+    errorOffset = bufferOffset + (json - buffer.constData());
+    type = QJsonStreamReader::Invalid;
+    state = Finished;
+    stringResume = 0;
+    return Failed;
+}
+
+void QJsonStreamReaderPrivate::commit(const char *json, const char *tokenBegin, State st)
+{
+    const char *begin = buffer.constData();
+    pos = json - begin;
+    tokenStart = tokenBegin - begin;
+    state = st;
+    stringResume = 0;
+    valueScanned = 0;
+}
+
+/*
+    Scans the next token starting at pos, including the separators in
+    front of it. Nothing is changed unless Ok or Failed is returned, so
+    that the scan can simply be repeated once more data has arrived.
+*/
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanToken()
+{
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+    const char *json = begin + pos;
+    State st = state;
+
+    forever {
+        switch (st) {
+        case BeforeDocument: {
+            if (bufferOffset + pos == 0 && json < end && uchar(*json) == 0xef) {
+                // eat UTF-8 byte order mark
+                static const char utf8bom[3] = { '\xef', '\xbb', '\xbf' };
+                if (end - json < 3 && memcmp(json, utf8bom, end - json) == 0)
+                    return needMoreData(json, QJsonParseError::IllegalValue);
+                if (end - json >= 3 && memcmp(json, utf8bom, 3) == 0)
+                    json += 3;
+            }
+            json = skipSpace(json, end);
+            if (json == end)
+                return needMoreData(json, QJsonParseError::IllegalValue);
+            if (*json == '{' || *json == '[')
+                return startContainer(json, *json == '{');
+            return raiseError(json, QJsonParseError::IllegalValue);
+        }
+        case ObjectStart:
+        case ObjectNext:
+            json = skipSpace(json, end);
+            if (json == end)
+                return needMoreData(json, QJsonParseError::UnterminatedObject);
+            if (*json == '"')
+                return scanString(json, end, QJsonStreamReader::Name);
+            if (*json == '}') {
+                if (st == ObjectNext)
+                    return raiseError(json, QJsonParseError::MissingObject);
+                return endContainer(json);
+            }
+            return raiseError(json, QJsonParseError::UnterminatedObject);
+        case AfterName:
+            json = skipSpace(json, end);
+            if (json == end)
+                return needMoreData(json, QJsonParseError::MissingNameSeparator);
+            if (*json != ':')
+                return raiseError(json, QJsonParseError::MissingNameSeparator);
+            json = skipSpace(json + 1, end);
+            if (json == end)
+                return needMoreData(json, QJsonParseError::UnterminatedObject);
+            return scanValue(json, end);
+        case ArrayStart:
+        case ArrayNext:
+            json = skipSpace(json, end);
+            if (json == end)
+                return needMoreData(json, QJsonParseError::UnterminatedArray);
+            if (*json == ']') {
+                if (st == ArrayNext)
+                    return raiseError(json, QJsonParseError::MissingObject);
+                return endContainer(json);
+            }
+            return scanValue(json, end);
+        case AfterValue: {
+            const bool inObject = containers.last();
+            json = skipSpace(json, end);
+            if (json == end)
+                return needMoreData(json, inObject ? QJsonParseError::UnterminatedObject
+                                                   : QJsonParseError::UnterminatedArray);
+            if (*json == ',') {
+                // not a token of its own, go on with the next one
+                ++json;
+                st = inObject ? ObjectNext : ArrayNext;
+                continue;
+            }
+            if (*json == (inObject ? '}' : ']'))
+                return endContainer(json);
+            return raiseError(json, inObject ? QJsonParseError::UnterminatedObject
+                                             : QJsonParseError::MissingValueSeparator);
+        }
+        case AfterDocument:
+            json = skipSpace(json, end);
+            if (json != end)
+                return raiseError(json, QJsonParseError::GarbageAtEnd);
+            // make sure a file has nothing but whitespace left; for
+            // sequential devices and addData() we can only go by what's there
+            if (device && !atEndOfInput && !device->isSequential())
+                return NeedMoreData;
+            commit(json, json, Finished);
+            type = QJsonStreamReader::EndDocument;
+            return Ok;
+        case Finished:
+            return Ok;
+        }
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::startContainer(const char *json, bool object)
+{
+    if (containers.size() >= nestingLimit)
+        return raiseError(json, QJsonParseError::DeepNesting);
+    containers.append(object);
+    type = object ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+    commit(json + 1, json, object ? ObjectStart : ArrayStart);
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::endContainer(const char *json)
+{
+    type = containers.last() ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+    containers.removeLast();
+    commit(json + 1, json, containers.isEmpty() ? AfterDocument : AfterValue);
+    return Ok;
+}
+
+/*
+    value = false / null / true / object / array / number / string
+*/
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanValue(const char *json, const char *end)
+{
+    switch (*json) {
+    case '"':
+        return scanString(json, end, QJsonStreamReader::String);
+    case '{':
+    case '[':
+        return startContainer(json, *json == '{');
+    case ']':
+        return raiseError(json, QJsonParseError::MissingObject);
+    case 't':
+    case 'f':
+    case 'n': {
+        const char *literal = *json == 't' ? "true" : *json == 'f' ? "false" : "null";
+        const int length = int(strlen(literal));
+        if (end - json < length) {
+            if (memcmp(json, literal, end - json) == 0)
+                return needMoreData(json, QJsonParseError::IllegalValue);
+            return raiseError(json, QJsonParseError::IllegalValue);
+        }
+        if (memcmp(json, literal, length) != 0)
+            return raiseError(json, QJsonParseError::IllegalValue);
+        if (*json == 'n') {
+            type = QJsonStreamReader::Null;
+        } else {
+            type = QJsonStreamReader::Bool;
+            boolean = *json == 't';
+        }
+        commit(json + length, json, AfterValue);
+        return Ok;
+    }
+    default:
+        return scanNumber(json, end);
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanNumber(const char *json, const char *end)
+{
+    const char *start = json;
+
+    // see Parser::parseNumber() for the grammar
+    if (json < end && *json == '-')
+        ++json;
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    // a number can't end a document, so more data has to follow
+    if (json >= end)
+        return needMoreData(json, QJsonParseError::TerminationByNumber);
+
+    QVarLengthArray<char, 64> literal(int(json - start) + 1);
+    memcpy(literal.data(), start, json - start);
+    literal[int(json - start)] = '\0';
+    bool ok;
+    const double d = QLocaleData::bytearrayToDouble(literal.constData(), &ok);
+    if (!ok)
+        return raiseError(json, QJsonParseError::IllegalNumber);
+
+    type = QJsonStreamReader::Number;
+    number = d;
+    textStart = start - buffer.constData();
+    textLength = json - start;
+    textIsAscii = true;
+    commit(json, start, AfterValue);
+    return Ok;
+}
+
+/*
+    Finds the end of the string starting at \a json and validates it. Plain
+    ASCII strings are converted lazily by text(), everything else is decoded
+    right away.
+*/
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanString(const char *json, const char *end,
+                                     QJsonStreamReader::TokenType tokenType)
+{
+    const char *begin = buffer.constData();
+    const char *start = json + 1;
+    const char *p = start;
+    bool ascii = true;
+    if (stringResume) {
+        // continue where the last, incomplete, attempt stopped
+        p = begin + pos + stringResume;
+        ascii = stringResumeAscii;
+    }
+
+    while (p < end) {
+        const char c = *p;
+        if (c == '"')
+            break;
+        if (c == '\\') {
+            // \u needs checking here, "\u12\"" must not end up unterminated
+            const int length = (end - p >= 2 && p[1] == 'u') ? 6 : 2;
+            if (end - p < length)
+                break;
+            uint ch = 0;
+            for (int i = 2; i < length; ++i) {
+                if (!QJsonPrivate::addHexDigit(p[i], &ch))
+                    return raiseError(p, QJsonParseError::IllegalEscapeSequence);
+            }
+            ascii = false;
+            p += length;
+            continue;
+        }
+        if (uchar(c) >= 0x80)
+            ascii = false;
+        ++p;
+    }
+    if (p >= end || *p != '"') {
+        stringResume = p - (begin + pos);
+        stringResumeAscii = ascii;
+        return needMoreData(json, QJsonParseError::UnterminatedString);
+    }
+
+    if (!ascii) {
+        decodedText.resize(int(p - start));
+        QChar *out = decodedText.data();
+        const char *in = start;
+        while (in < p) {
+            uint ch = 0;
+            if (*in == '\\') {
+                if (!QJsonPrivate::scanEscapeSequence(in, p, &ch))
+                    return raiseError(in, QJsonParseError::IllegalEscapeSequence);
+            } else {
+                if (!QJsonPrivate::scanUtf8Char(in, p, &ch))
+                    return raiseError(in, QJsonParseError::IllegalUTF8String);
+            }
+            if (QChar::requiresSurrogates(ch)) {
+                *out++ = QChar(QChar::highSurrogate(ch));
+                *out++ = QChar(QChar::lowSurrogate(ch));
+            } else {
+                *out++ = QChar(ushort(ch));
+            }
+        }
+        decodedText.resize(int(out - decodedText.constData()));
+    }
+
+    type = tokenType;
+    textStart = start - begin;
+    textLength = p - start;
+    textIsAscii = ascii;
+    commit(p + 1, json, tokenType == QJsonStreamReader::Name ? AfterName : AfterValue);
+    return Ok;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.6
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON text token by token.
+
+    QJsonDocument::fromJson() builds the complete document in memory before
+    any of it can be used. QJsonStreamReader instead reports the document as
+    a stream of tokens, like QXmlStreamReader does for XML, so that
+    arbitrarily large documents can be processed with a bounded amount of
+    memory: the reader only holds the token being scanned plus one block of
+    input.
+
+    The input is either read from a QIODevice set with setDevice(), or added
+    incrementally with addData(). readNext() reads the next token and
+    returns its type. Names and strings are available from text(), and all
+    scalars from value():
+
+    \code
+        QJsonStreamReader reader(&file);
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QJsonStreamReader::Name:
+                key = reader.text();
+                break;
+            case QJsonStreamReader::Number:
+                sum += reader.value().toDouble();
+                break;
+            default:
+                break;
+            }
+        }
+        if (reader.hasError())
+            qWarning() << reader.errorString() << "at" << reader.characterOffset();
+    \endcode
+
+    The reader accepts the same documents as QJsonDocument::fromJson(), and
+    reports the same QJsonParseError::ParseError codes for malformed input.
+    Once an error was found, or EndDocument was reported, atEnd() returns
+    \c true and readNext() does not read any further.
+
+    Often a large document is a long array of small records. readValue()
+    reads the object or array starting at the current token into a
+    QJsonValue in one go, which is both faster and more convenient than
+    assembling it from individual tokens.
+
+    \section1 Incremental Parsing
+
+    If the input runs out in the middle of the document, readNext() returns
+    Invalid and atEnd() returns \c true, but hasError() returns \c false.
+    Once more data has been added with addData(), or has become available on
+    a sequential device, parsing continues with the next call to readNext().
+    Tokens are never split: a token that spans two blocks of input is only
+    reported once it is complete.
+
+    For a random-access device, reaching the end of the device in the middle
+    of the document is an error, like it is for QJsonDocument::fromJson().
+
+    \sa QJsonDocument, QXmlStreamReader, {JSON Support in Qt}
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything.
+    \value Invalid An error has occurred, reported in error() and
+        errorString(), or the input ended before the next token was
+        complete.
+    \value EndDocument The reader reached the end of the document.
+    \value StartObject The reader reports the start of an object.
+    \value EndObject The reader reports the end of an object.
+    \value StartArray The reader reports the start of an array.
+    \value EndArray The reader reports the end of an array.
+    \value Name The reader reports the name of an object member, available
+        from text(). The member's value is the next token.
+    \value String The reader reports a string value, available from text().
+    \value Number The reader reports a number, available from value().
+    \value Bool The reader reports \c true or \c false, available from value().
+    \value Null The reader reports \c null.
+*/
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \sa addData(), clear(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    addData(data);
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device. Setting the device resets the
+    reader to its initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the reader, or 0 if no
+    device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing
+    if the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    // keep the current token, its text may still be asked for
+    d->discard(d->tokenStart);
+    d->buffer += data;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = 0;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the JSON
+    document, or if an error() has occurred and reading has been aborted.
+    Otherwise, it returns \c false.
+
+    When atEnd() returns \c true but hasError() returns \c false and
+    tokenType() is not EndDocument, the input has ended in the middle of the
+    document. Adding more data with addData() makes it possible to continue
+    reading.
+
+    \sa hasError(), error(), device(), QIODevice::atEnd()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->state == QJsonStreamReaderPrivate::Finished || d->incomplete;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Once an error() was reported, or EndDocument was reached, this function
+    no longer reads anything and returns the same token type again.
+
+    \sa tokenType(), text(), value()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    if (d->state == QJsonStreamReaderPrivate::Finished)
+        return d->type;
+
+    d->incomplete = false;
+    forever {
+        switch (d->scanToken()) {
+        case QJsonStreamReaderPrivate::Ok:
+        case QJsonStreamReaderPrivate::Failed:
+            return d->type;
+        case QJsonStreamReaderPrivate::NeedMoreData:
+            if (d->fill(d->pos) || d->atEndOfInput)
+                continue;
+            d->incomplete = true;
+            d->type = Invalid;
+            return Invalid;
+        }
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    Returns the text of a Name or a String token, with all escape sequences
+    resolved, or the literal of a Number token. For all other tokens, a null
+    string is returned.
+
+    \sa value()
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case Name:
+    case String:
+    case Number:
+        if (d->textIsAscii)
+            return QString::fromLatin1(d->buffer.constData() + d->textStart, d->textLength);
+        return d->decodedText;
+    default:
+        return QString();
+    }
+}
+
+/*!
+    Returns the value of a String, Number, Bool or Null token. For all other
+    tokens, an undefined QJsonValue is returned.
+
+    \sa text(), readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case String:
+        return QJsonValue(text());
+    case Number:
+        return QJsonValue(d->number);
+    case Bool:
+        return QJsonValue(d->boolean);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    If the current token is a StartObject or StartArray, reads the whole
+    object or array and returns it. The reader is then positioned on the
+    matching EndObject or EndArray token. For all other tokens, this
+    function returns value().
+
+    If the input ends before the object or array is complete, an undefined
+    QJsonValue is returned and atEnd() returns \c true, but the reader stays
+    on the current token, so that readValue() can be called again once more
+    data is available.
+
+    \sa readNext(), value()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type != StartObject && d->type != StartArray)
+        return value();
+
+    d->incomplete = false;
+    if (!d->valueScanned) {
+        d->valueScanned = 1;
+        d->valueDepth = 1;
+        d->valueInString = false;
+    }
+
+    // find the matching end first, so the complete value can be handed to
+    // the regular parser in one piece
+    const char *begin;
+    const char *p;
+    forever {
+        begin = d->buffer.constData();
+        p = begin + d->tokenStart + d->valueScanned;
+        const char *end = begin + d->buffer.size();
+        int depth = d->valueDepth;
+        bool inString = d->valueInString;
+        while (p < end) {
+            const char c = *p;
+            if (inString) {
+                if (c == '\\') {
+                    if (end - p < 2)
+                        break;
+                    ++p;
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                break;
+            }
+            ++p;
+        }
+        d->valueScanned = p - (begin + d->tokenStart);
+        d->valueDepth = depth;
+        d->valueInString = inString;
+        if (p < end && depth == 0)
+            break;
+
+        if (d->fill(d->tokenStart))
+            continue;
+        if (!d->atEndOfInput) {
+            d->incomplete = true;
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        // let the parser tell what exactly is wrong
+        p = d->buffer.constData() + d->buffer.size() - 1;
+        break;
+    }
+
+    begin = d->buffer.constData();
+    const char *start = begin + d->tokenStart;
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonPrivate::Parser(start, int(p + 1 - start)).parse(&parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        d->raiseError(start + parseError.offset, parseError.error);
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    d->type = d->containers.last() ? EndObject : EndArray;
+    d->containers.removeLast();
+    d->commit(p + 1, p, d->containers.isEmpty() ? QJsonStreamReaderPrivate::AfterDocument
+                                                : QJsonStreamReaderPrivate::AfterValue);
+    if (document.isObject())
+        return QJsonValue(document.object());
+    return QJsonValue(document.array());
+}
+
+/*!
+    Returns the current character offset in the input, starting with 0.
+    After an error, this is the offset at which the error was found.
+
+    \sa error()
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->error != QJsonParseError::NoError)
+        return d->errorOffset;
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the type of the current error, or QJsonParseError::NoError if
+    no error occurred.
+
+    \sa errorString(), hasError()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns the error message that was set with error().
+
+    \sa error(), QJsonParseError::errorString()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    QJsonParseError e;
+    e.offset = int(d->errorOffset);
+    e.error = d->error;
+    return e.errorString();
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa errorString(), error()
+*/
+
+QT_END_NAMESPACE
@@ -74,6 +74,9 @@
 #      include "qeventdispatcher_glib_p.h"
 #    endif
 #    include "qeventdispatcher_unix_p.h"
+#    if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_NO_EVENTFD)
+#      include "qeventdispatcher_epoll_p.h"
+#    endif
 #  endif
 #endif
 #ifdef Q_OS_WIN
@@ -306,6 +309,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    QMutexLocker locker(&currentThreadData->postEventList.mutex);
+    currentThreadData->postEventList.takeIncoming();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -488,6 +493,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->postEventList.takeIncoming();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -510,6 +516,11 @@ void QCoreApplicationPrivate::createEventDispatcher()
 #  if defined(Q_OS_BLACKBERRY)
     eventDispatcher = new QEventDispatcherBlackberry(q);
 #  else
+#  if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_NO_EVENTFD)
+    if (!qEnvironmentVariableIsEmpty("QT_EVENT_DISPATCHER_EPOLL") && QEventDispatcherEpoll::isSupported())
+        eventDispatcher = new QEventDispatcherEpoll(q);
+    else
+#  endif
 #  if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
         eventDispatcher = new QEventDispatcherGlib(q);
@@ -1289,6 +1300,20 @@ void QCoreApplication::exit(int returnCode)
     \sa postEvent(), notify()
 */
 
+/*
+    Returns \c true if \a event can be appended to the lock-free incoming
+    queue of the receiver's QPostEventList. That is only the case for events
+    that no compressEvent() reimplementation looks at, since compression
+    needs to see all the events posted before. Events posted from the
+    receiver's own thread take the mutex, which is cheaper when there is no
+    contention on it.
+*/
+static inline bool canPostWithoutLocking(const QEvent *event, const QThreadData *data)
+{
+    return (event->type() == QEvent::MetaCall || event->type() >= QEvent::User)
+            && data != QThreadData::current(false);
+}
+
 /*!
     \since 4.3
 
@@ -1330,6 +1355,44 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    if (canPostWithoutLocking(event, data)) {
+        // delete the event on exceptions to protect against memory leaks
+        QScopedPointer<QEvent> eventDeleter(event);
+        event->posted = true;
+
+        struct IncomingPoster
+        {
+            QAtomicInt &posters;
+            IncomingPoster(QAtomicInt &posters) : posters(posters) { posters.ref(); }
+            ~IncomingPoster() { posters.deref(); }
+        };
+
+        for (;;) {
+            // moveToThread() waits for incomingPosters to drop to zero after
+            // changing the thread data, so once we have checked the thread
+            // data here, the event is either queued to the right list or
+            // forwarded to it by moveToThread()
+            IncomingPoster poster(data->postEventList.incomingPosters);
+            if (data == *pdata) {
+                data->postEventList.postIncoming(receiver, event, priority);
+                eventDeleter.take();
+                break;
+            }
+
+            // if object has moved to another thread, follow it
+            data = *pdata;
+            if (!data) {
+                // posting during destruction? just delete the event to prevent a leak
+                return;
+            }
+        }
+
+        QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+        if (dispatcher)
+            dispatcher->wakeUp();
+        return;
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1349,6 +1412,10 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the order with events posted without locking, and let
+    // compressEvent() see all the events
+    data->postEventList.takeIncoming();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1456,6 +1523,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1487,8 +1555,9 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
         {}
         inline ~CleanUp()
         {
-            if (exceptionCaught) {
-                // since we were interrupted, we need another pass to make sure we clean everything up
+            if (exceptionCaught || data->postEventList.hasIncoming()) {
+                // since we were interrupted, or more events were posted
+                // without locking, we need another pass
                 data->canWait = false;
             }
 
@@ -1612,6 +1681,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1677,6 +1747,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -0,0 +1,525 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+QT_BEGIN_NAMESPACE
+
+// upper bound on the events we collect per epoll_wait(); anything beyond it
+// stays queued in the kernel and is picked up on the next iteration
+enum { MaxEpollEvents = 256 };
+
+static const char *socketNotifierTypeName(int type)
+{
+    static const char *t[] = { "Read", "Write", "Exception" };
+    return t[type];
+}
+
+quint32 QEpollSocketNotifierSet::events() const
+{
+    quint32 events = 0;
+    if (notifiers[QSocketNotifier::Read])
+        events |= EPOLLIN;
+    if (notifiers[QSocketNotifier::Write])
+        events |= EPOLLOUT;
+    if (notifiers[QSocketNotifier::Exception])
+        events |= EPOLLPRI;
+    return events;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        perror("QEventDispatcherEpollPrivate(): Unable to create epoll instance");
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without an epoll instance");
+    }
+
+    wakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeUpFd == -1) {
+        perror("QEventDispatcherEpollPrivate(): Unable to create eventfd");
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a thread wake-up fd");
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeUpFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeUpFd, &ev) == -1) {
+        perror("QEventDispatcherEpollPrivate(): Unable to watch the thread wake-up fd");
+        qFatal("QEventDispatcherEpollPrivate(): Can not continue without a thread wake-up fd");
+    }
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    qt_safe_close(wakeUpFd);
+    qt_safe_close(epollFd);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+/*
+    Adds, modifies or removes \a fd in the epoll set so that it matches the
+    notifiers in \a sn_set. Returns \c false if the fd could not be watched.
+*/
+bool QEventDispatcherEpollPrivate::updateEpoll(int fd, QEpollSocketNotifierSet &sn_set, int op)
+{
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = sn_set.events();
+    ev.data.fd = fd;
+
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == -1 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        // the fd was closed and reused behind our back, so the kernel
+        // dropped it from the epoll set
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    } else if (ret == -1 && op == EPOLL_CTL_ADD && errno == EEXIST) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    }
+
+    if (ret == -1 && errno == EPERM) {
+        // regular files and directories do not support epoll(7); select()
+        // considers them always ready, so do the same
+        sn_set.polled = true;
+        polledFds.append(fd);
+        return true;
+    }
+    return ret != -1;
+}
+
+void QEventDispatcherEpollPrivate::markPending(QEpollSocketNotifierSet &sn_set, int type)
+{
+    QSocketNotifier *notifier = sn_set.notifiers[type];
+    if (!notifier || (sn_set.pending & (1u << type)))
+        return;
+    sn_set.pending |= 1u << type;
+    pendingNotifiers.append(notifier);
+}
+
+int QEventDispatcherEpollPrivate::doWait(QEventLoop::ProcessEventsFlags flags, int timeout)
+{
+    Q_Q(QEventDispatcherEpoll);
+
+    if (flags & QEventLoop::ExcludeSocketNotifiers) {
+        // only wait for the wake-up fd; the socket notifiers are
+        // level-triggered and will be reported again once included
+        pollfd pfd;
+        pfd.fd = wakeUpFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int nsel = ::poll(&pfd, 1, timeout);
+        if (nsel == -1 && errno != EINTR)
+            perror("poll");
+        return nsel > 0 ? processThreadWakeUp() : 0;
+    }
+
+    if (!polledFds.isEmpty())
+        timeout = 0;
+
+    epoll_event events[MaxEpollEvents];
+    int nsel = epoll_wait(epollFd, events, MaxEpollEvents, timeout);
+    if (nsel == -1 && errno != EINTR) {
+        // EBADF/EINVAL on our own epoll fd... shouldn't happen, so let's
+        // complain to stderr and hope someone sends us a bug report
+        perror("epoll_wait");
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < nsel; ++i) {
+        const int fd = events[i].data.fd;
+        const quint32 revents = events[i].events;
+        if (fd == wakeUpFd) {
+            nevents += processThreadWakeUp();
+            continue;
+        }
+
+        QHash<int, QEpollSocketNotifierSet>::iterator it = socketNotifiers.find(fd);
+        if (it == socketNotifiers.end())
+            continue;
+
+        // mirror select(): errors make the fd both readable and writable
+        if (revents & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            markPending(*it, QSocketNotifier::Read);
+        if (revents & (EPOLLOUT | EPOLLERR))
+            markPending(*it, QSocketNotifier::Write);
+        if (revents & EPOLLPRI)
+            markPending(*it, QSocketNotifier::Exception);
+    }
+
+    for (int i = 0; i < polledFds.size(); ++i) {
+        QEpollSocketNotifierSet &sn_set = socketNotifiers[polledFds.at(i)];
+        markPending(sn_set, QSocketNotifier::Read);
+        markPending(sn_set, QSocketNotifier::Write);
+    }
+
+    return nevents + q->activateSocketNotifiers();
+}
+
+int QEventDispatcherEpollPrivate::processThreadWakeUp()
+{
+    // some other thread woke us up... consume the counter so that
+    // epoll_wait doesn't immediately return next time
+    eventfd_t value;
+    eventfd_read(wakeUpFd, &value);
+
+    if (!wakeUps.testAndSetRelease(1, 0)) {
+        // hopefully, this is dead code
+        qWarning("QEventDispatcherEpoll: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+    }
+    return 1;
+}
+
+/*!
+    \internal
+    \class QEventDispatcherEpoll
+
+    An event dispatcher for Linux that waits on a persistent epoll(7) set
+    instead of rebuilding fd_sets for select() on every iteration. Socket
+    notifiers are registered with the kernel once, so each wake-up costs
+    O(ready fds) and there is no FD_SETSIZE limit. Timers use the same
+    QTimerInfoList as QEventDispatcherUNIX, whose deadline becomes the
+    epoll_wait() timeout, and wakeUp() signals an eventfd(7).
+
+    It is used instead of the default dispatcher when the
+    \c QT_EVENT_DISPATCHER_EPOLL environment variable is set.
+*/
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QEventDispatcherEpollPrivate &dd, QObject *parent)
+    : QAbstractEventDispatcher(dd, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{
+}
+
+static bool epollAvailable()
+{
+    // the kernel might lack epoll_create1 (pre-2.6.27) or a seccomp
+    // sandbox might refuse it
+    int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd == -1)
+        return false;
+    qt_safe_close(fd);
+    return true;
+}
+
+/*!
+    \internal
+    Returns \c true if the running kernel provides epoll(7).
+*/
+bool QEventDispatcherEpoll::isSupported()
+{
+    static const bool supported = epollAvailable();
+    return supported;
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QEpollSocketNotifierSet &sn_set = d->socketNotifiers[sockfd];
+    const bool wasEmpty = sn_set.isEmpty();
+    if (sn_set.notifiers[type]) {
+        qWarning("QSocketNotifier: Multiple socket notifiers for "
+                 "same socket %d and type %s", sockfd, socketNotifierTypeName(type));
+        if (sn_set.pending & (1u << type)) {
+            sn_set.pending &= ~(1u << type);
+            d->pendingNotifiers.removeOne(sn_set.notifiers[type]);
+        }
+    }
+    sn_set.notifiers[type] = notifier;
+
+    if (sn_set.polled)
+        return;
+
+    if (!d->updateEpoll(sockfd, sn_set, wasEmpty ? EPOLL_CTL_ADD : EPOLL_CTL_MOD)) {
+        qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                 sockfd, socketNotifierTypeName(type));
+        sn_set.notifiers[type] = 0;
+        if (sn_set.isEmpty())
+            d->socketNotifiers.remove(sockfd);
+    }
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be disabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QHash<int, QEpollSocketNotifierSet>::iterator it = d->socketNotifiers.find(sockfd);
+    if (it == d->socketNotifiers.end() || it->notifiers[type] != notifier) // not found
+        return;
+
+    it->notifiers[type] = 0;
+    if (it->pending & (1u << type)) {
+        it->pending &= ~(1u << type);
+        d->pendingNotifiers.removeOne(notifier);    // remove from activation list
+    }
+
+    if (it->isEmpty()) {
+        if (it->polled) {
+            d->polledFds.removeOne(sockfd);
+        } else {
+            // the fd may already be closed, in which case the kernel
+            // has dropped it from the set and this fails harmlessly
+            epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            epoll_ctl(d->epollFd, EPOLL_CTL_DEL, sockfd, &ev);
+        }
+        d->socketNotifiers.erase(it);
+    } else if (!it->polled) {
+        d->updateEpoll(sockfd, *it, EPOLL_CTL_MOD);
+    }
+}
+
+int QEventDispatcherEpoll::activateSocketNotifiers()
+{
+    Q_D(QEventDispatcherEpoll);
+    if (d->pendingNotifiers.isEmpty())
+        return 0;
+
+    // activate entries; a notifier that gets unregistered while we are
+    // sending events is removed from the list by unregisterSocketNotifier()
+    int n_act = 0;
+    QEvent event(QEvent::SockAct);
+    while (!d->pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = d->pendingNotifiers.takeFirst();
+        QHash<int, QEpollSocketNotifierSet>::iterator it = d->socketNotifiers.find(notifier->socket());
+        if (it != d->socketNotifiers.end())
+            it->pending &= ~(1u << notifier->type());
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_act;
+    }
+    return n_act;
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(0);
+
+    // we are awake, broadcast it
+    emit awake();
+    QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+
+    int nevents = 0;
+    const bool canWait = (d->threadData->canWaitLocked()
+                          && !d->interrupt.load()
+                          && (flags & QEventLoop::WaitForMoreEvents));
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (!d->interrupt.load()) {
+        // return the maximum time we can wait for an event; round up, so
+        // that a timer less than a millisecond away doesn't make us spin
+        int timeout = -1;
+        if (!(flags & QEventLoop::X11ExcludeTimers)) {
+            timespec wait_tm = { 0l, 0l };
+            if (d->timerList.timerWait(wait_tm))
+                timeout = int(qMin<qint64>(qint64(wait_tm.tv_sec) * 1000
+                                           + (wait_tm.tv_nsec + 999999) / (1000 * 1000),
+                                           INT_MAX));
+        }
+
+        if (!canWait)
+            timeout = 0; // no time to wait
+
+        nevents = d->doWait(flags, timeout);
+
+        // activate timers
+        if (! (flags & QEventLoop::X11ExcludeTimers)) {
+            nevents += d->timerList.activateTimers();
+        }
+    }
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    if (d->wakeUps.testAndSetAcquire(0, 1)) {
+        eventfd_t value = 1;
+        int ret;
+        EINTR_LOOP(ret, eventfd_write(d->wakeUpFd, value));
+    }
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
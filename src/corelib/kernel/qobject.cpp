@@ -240,7 +240,8 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    // events posted from other threads may not be counted in postedEvents yet
+    if (postedEvents || threadData->postEventList.hasIncoming())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -1506,8 +1507,28 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->postEventList.takeIncoming();
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // other threads may have posted events to the old thread without
+    // locking while we were moving; forward those to the new thread
+    currentData->postEventList.waitForIncomingPosters();
+    if (currentData->postEventList.takeIncoming()) {
+        int eventsMoved = 0;
+        for (int i = 0; i < currentData->postEventList.size(); ++i) {
+            const QPostEvent &pe = currentData->postEventList.at(i);
+            if (pe.event && pe.receiver->d_func()->threadData == targetData) {
+                targetData->postEventList.addEvent(pe);
+                const_cast<QPostEvent &>(pe).event = 0;
+                ++eventsMoved;
+            }
+        }
+        if (eventsMoved > 0 && targetData->eventDispatcher.load()) {
+            targetData->canWait = false;
+            targetData->eventDispatcher.load()->wakeUp();
+        }
+    }
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -33,6 +33,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -46,6 +47,8 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
@@ -55,6 +58,11 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  * timerBitVec array is used for keeping track of timer identifiers.
  */
 
+static inline qint64 toMsecs(const timespec &t)
+{
+    return qint64(t.tv_sec) * 1000 + t.tv_nsec / (1000 * 1000);
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
@@ -76,7 +84,12 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
-    firstTimerInfo = 0;
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupied, 0, sizeof(occupied));
+    wheelTime = toMsecs(qt_gettime());
+    expiredTimers = 0;
+    nextTimer = 0;
+    nextTimerValid = true;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -143,10 +156,17 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers and file them again relative to the current time
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupied, 0, sizeof(occupied));
+    wheelTime = toMsecs(currentTime);
+    nextTimer = 0;
+    nextTimerValid = true;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        QTimerInfo *t = *it;
         t->timeout = t->timeout + diff;
+        if (t->bucket != &expiredTimers)
+            timerInsert(t);
     }
 }
 
@@ -168,17 +188,203 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  append timer info to the list starting at *bucket
+*/
+void QTimerInfoList::link(QTimerInfo *t, QTimerInfo **bucket)
+{
+    QTimerInfo *first = *bucket;
+    if (!first) {
+        t->next = t->prev = t;
+        *bucket = t;
+    } else {
+        // append, so that timers with equal timeouts keep their order
+        t->prev = first->prev;
+        t->next = first;
+        first->prev->next = t;
+        first->prev = t;
+    }
+    t->bucket = bucket;
+}
+
+/*
+  remove timer info from the list it is in
+*/
+void QTimerInfoList::unlink(QTimerInfo *t)
+{
+    QTimerInfo **bucket = t->bucket;
+    if (t->next == t) {
+        *bucket = 0;
+        if (bucket != &expiredTimers) {
+            const int index = int(bucket - &wheel[0][0]);
+            occupied[index >> WheelBits] &= ~(Q_UINT64_C(1) << (index & WheelMask));
+        }
+    } else {
+        t->prev->next = t->next;
+        t->next->prev = t->prev;
+        if (*bucket == t)
+            *bucket = t->next;
+    }
+    t->bucket = 0;
+}
+
+/*
+  insert timer info into the wheel
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    qint64 tick = toMsecs(ti->timeout);
+    if (tick < wheelTime)
+        tick = wheelTime; // overdue, expires with the current bucket
+
+    const quint64 diff = quint64(tick ^ wheelTime);
+    const int level = diff < WheelSize ? 0 : int(63 - qCountLeadingZeroBits(diff)) / WheelBits;
+    Q_ASSERT(level < WheelLevels);
+    const int slot = int(tick >> (level * WheelBits)) & WheelMask;
+
+    link(ti, &wheel[level][slot]);
+    occupied[level] |= Q_UINT64_C(1) << slot;
+    timerWaiting(ti);
+}
+
+/*
+  keep the cached next timer up to date when \a t may have become the
+  first waiting timer
+*/
+void QTimerInfoList::timerWaiting(QTimerInfo *t)
+{
+    if (nextTimerValid && !t->activateRef && t->bucket != &expiredTimers
+        && (!nextTimer || t->timeout < nextTimer->timeout))
+        nextTimer = t;
+}
+
+/*
+  Advance the wheel to \a msecs. No timer may be due before that time.
+  The buckets of the higher levels that \a msecs enters are cascaded
+  down, starting with the highest level.
+*/
+void QTimerInfoList::setWheelTime(qint64 msecs)
+{
+    const qint64 previous = wheelTime;
+    wheelTime = msecs;
+    for (int level = WheelLevels - 1; level > 0; --level) {
+        const int shift = level * WheelBits;
+        if ((msecs >> shift) == (previous >> shift))
+            continue;
+        const int slot = int(msecs >> shift) & WheelMask;
+        QTimerInfo *list = wheel[level][slot];
+        if (!list)
+            continue;
+        wheel[level][slot] = 0;
+        occupied[level] &= ~(Q_UINT64_C(1) << slot);
+        list->prev->next = 0;
+        while (list) {
+            QTimerInfo *t = list;
+            list = list->next;
+            timerInsert(t);
+        }
+    }
+}
+
+static bool timeoutLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    return t1->timeout < t2->timeout;
+}
+
+/*
+  Move all timers that have expired at \a currentTime off the wheel and
+  into expiredTimers, sorted by their timeout.
+*/
+void QTimerInfoList::collectExpiredTimers(const timespec &currentTime)
+{
+    const qint64 now = toMsecs(currentTime);
+    QVarLengthArray<QTimerInfo *, 64> expired;
+
+    for (;;) {
+        // the rest of the current 64 ms block, one bucket per millisecond
+        const quint64 pending = occupied[0] & (~Q_UINT64_C(0) << (wheelTime & WheelMask));
+        if (pending) {
+            const int slot = qCountTrailingZeroBits(pending);
+            const qint64 tick = (wheelTime & ~qint64(WheelMask)) | slot;
+            if (tick > now)
+                break;
+
+            wheelTime = tick; // same block, nothing to cascade
+            QTimerInfo *list = wheel[0][slot];
+            wheel[0][slot] = 0;
+            occupied[0] &= ~(Q_UINT64_C(1) << slot);
+            list->prev->next = 0;
+            while (list) {
+                QTimerInfo *t = list;
+                list = list->next;
+                if (tick < now || !(currentTime < t->timeout)) {
+                    t->bucket = 0;
+                    if (t == nextTimer)
+                        nextTimerValid = false;
+                    expired.append(t);
+                } else {
+                    timerInsert(t); // due later in this millisecond
+                }
+            }
+            if (tick == now)
+                break;
+            continue;
+        }
+
+        // the block is done, find the next one that has timers
+        int level = 1;
+        quint64 later = 0;
+        for ( ; level < WheelLevels; ++level) {
+            const int digit = int(wheelTime >> (level * WheelBits)) & WheelMask;
+            later = occupied[level] & (~Q_UINT64_C(1) << digit);
+            if (later)
+                break;
+        }
+        if (!later)
+            break; // nothing left on the wheel
+
+        const int shift = level * WheelBits;
+        const qint64 next = ((wheelTime >> (shift + WheelBits)) << (shift + WheelBits))
+                | (qint64(qCountTrailingZeroBits(later)) << shift);
+        if (next > now)
             break;
+        setWheelTime(next);
+    }
+
+    // nothing on the wheel is due before now
+    if (wheelTime < now)
+        setWheelTime(now);
+
+    std::stable_sort(expired.begin(), expired.end(), timeoutLessThan);
+    for (int i = 0; i < expired.size(); ++i)
+        link(expired.at(i), &expiredTimers);
+}
+
+/*
+  Returns the waiting timer on the wheel that expires first, or 0.
+*/
+QTimerInfo *QTimerInfoList::findNextTimer() const
+{
+    for (int level = 0; level < WheelLevels; ++level) {
+        const int digit = int(wheelTime >> (level * WheelBits)) & WheelMask;
+        quint64 buckets = occupied[level] & (~Q_UINT64_C(0) << digit);
+        while (buckets) {
+            const int slot = qCountTrailingZeroBits(buckets);
+            buckets &= buckets - 1;
+
+            // all timers in a bucket expire before those in later buckets
+            QTimerInfo * const first = wheel[level][slot];
+            QTimerInfo *best = 0;
+            QTimerInfo *t = first;
+            do {
+                if (!t->activateRef && (!best || t->timeout < best->timeout))
+                    best = t;
+                t = t->next;
+            } while (t != first);
+            if (best)
+                return best;
+        }
     }
-    insert(index+1, ti);
+    return 0;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -383,11 +589,23 @@ bool QTimerInfoList::timerWait(timespec &tm)
 
     // Find first waiting timer not already active
     QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
+    if (expiredTimers) {
+        // left over from an activateTimers() that is sending events
+        QTimerInfo *it = expiredTimers;
+        do {
+            if (!it->activateRef) {
+                t = it;
+                break;
+            }
+            it = it->next;
+        } while (it != expiredTimers);
+    }
+    if (!t) {
+        if (!nextTimerValid) {
+            nextTimer = findNextTimer();
+            nextTimerValid = true;
         }
+        t = nextTimer;
     }
 
     if (!t)
@@ -416,16 +634,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -444,6 +659,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->bucket = 0;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -487,6 +703,17 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
+    QTimerInfo *&first = objectTimers[object];
+    if (!first) {
+        t->objectNext = t->objectPrev = t;
+        first = t;
+    } else {
+        t->objectPrev = first->objectPrev;
+        t->objectNext = first;
+        first->objectPrev->objectNext = t;
+        first->objectPrev = t;
+    }
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -499,42 +726,48 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 #endif
 }
 
+void QTimerInfoList::deleteTimer(QTimerInfo *t)
+{
+    if (t->bucket)
+        unlink(t);
+    if (t == nextTimer)
+        nextTimerValid = false;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+}
+
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timers.take(timerId);
+    if (!t)
+        return false; // id not found
+
+    if (t->objectNext == t) {
+        objectTimers.remove(t->obj);
+    } else {
+        t->objectPrev->objectNext = t->objectNext;
+        t->objectNext->objectPrev = t->objectPrev;
+        QTimerInfo *&first = objectTimers[t->obj];
+        if (first == t)
+            first = t->objectNext;
     }
-    // id not found
-    return false;
+    deleteTimer(t);
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+    QTimerInfo *t = objectTimers.take(object);
+    if (t) {
+        t->objectPrev->objectNext = 0;
+        while (t) {
+            QTimerInfo *next = t->objectNext;
+            timers.remove(t->id);
+            deleteTimer(t);
+            t = next;
         }
     }
     return true;
@@ -543,16 +776,18 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
-    }
+    const QTimerInfo * const first = objectTimers.value(object);
+    if (!first)
+        return list;
+    const QTimerInfo *t = first;
+    do {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
+        t = t->objectNext;
+    } while (t != first);
     return list;
 }
 
@@ -564,42 +799,21 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = 0;
+    int n_act = 0;
 
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Find out which timers have expired
+    collectExpiredTimers(currentTime);
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = first();
-        if (currentTime < currentTimerInfo->timeout)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+    while (expiredTimers) {
+        QTimerInfo *currentTimerInfo = expiredTimers;
 
         // remove from list
-        removeFirst();
+        unlink(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -632,16 +846,19 @@ int QTimerInfoList::activateTimers()
         if (!currentTimerInfo->activateRef) {
             // send event, but don't allow it to recurse
             currentTimerInfo->activateRef = &currentTimerInfo;
+            if (currentTimerInfo == nextTimer)
+                nextTimerValid = false;
 
             QTimerEvent e(currentTimerInfo->id);
             QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
-            if (currentTimerInfo)
+            if (currentTimerInfo) {
                 currentTimerInfo->activateRef = 0;
+                timerWaiting(currentTimerInfo);
+            }
         }
     }
 
-    firstTimerInfo = 0;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
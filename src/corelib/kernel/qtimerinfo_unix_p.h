@@ -48,6 +48,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -61,6 +62,11 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    QTimerInfo *next; // - links in the wheel bucket or list of expired timers
+    QTimerInfo *prev;
+    QTimerInfo **bucket; // - head of the list the timer is linked into
+    QTimerInfo *objectNext; // - links in the list of timers of obj
+    QTimerInfo *objectPrev;
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -69,7 +75,7 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -81,12 +87,50 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    // Hierarchical timing wheel with millisecond ticks. Level 0 has one
+    // bucket per millisecond of the current 64 ms block, each further level
+    // covers 64 times the range of the previous one. A timer is filed at
+    // the level of the highest 6-bit group in which its deadline differs
+    // from wheelTime, so all timers on a level expire before those on the
+    // next one, and buckets are cascaded down as wheelTime reaches them.
+    enum {
+        WheelBits = 6,
+        WheelSize = 1 << WheelBits,
+        WheelMask = WheelSize - 1,
+        WheelLevels = 8 // 48 bits of milliseconds
+    };
+    QTimerInfo *wheel[WheelLevels][WheelSize];
+    quint64 occupied[WheelLevels];
+    qint64 wheelTime;
+
+    // timers taken off the wheel by activateTimers() that are still to be sent
+    QTimerInfo *expiredTimers;
+
+    // cached result of findNextTimer(), updated on insertion
+    QTimerInfo *nextTimer;
+    bool nextTimerValid;
+
+    QHash<int, QTimerInfo *> timers;
+    QHash<QObject *, QTimerInfo *> objectTimers; // first timer of each object
+
+    void link(QTimerInfo *, QTimerInfo **bucket);
+    void unlink(QTimerInfo *);
+    void setWheelTime(qint64 msecs);
+    void collectExpiredTimers(const timespec &currentTime);
+    QTimerInfo *findNextTimer() const;
+    void timerWaiting(QTimerInfo *);
+    void deleteTimer(QTimerInfo *);
 
 public:
     QTimerInfoList();
 
+    typedef QHash<int, QTimerInfo *>::const_iterator const_iterator;
+    const_iterator begin() const { return timers.constBegin(); }
+    const_iterator end() const { return timers.constEnd(); }
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
+    int count() const { return timers.size(); }
+
     timespec currentTime;
     timespec updateCurrentTime();
 
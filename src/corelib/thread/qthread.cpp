@@ -44,6 +44,135 @@
 
 QT_BEGIN_NAMESPACE
 
+/*
+  QPostEventList
+*/
+
+QPostEventList::~QPostEventList()
+{
+    Q_ASSERT(!incomingPosters.load());
+    while (retiredSegments) {
+        IncomingSegment *next = retiredSegments->nextRetired;
+        delete retiredSegments;
+        retiredSegments = next;
+    }
+    IncomingSegment *segment = incomingHead ? incomingHead : incomingFirst.load();
+    while (segment) {
+        IncomingSegment *next = segment->next.load();
+        delete segment;
+        segment = next;
+    }
+}
+
+/*
+    Appends an event to the incoming queue without locking. The caller must
+    hold a reference on incomingPosters, which keeps the segments it may
+    still look at from being freed by takeIncoming().
+*/
+void QPostEventList::postIncoming(QObject *receiver, QEvent *event, int priority)
+{
+    for (;;) {
+        IncomingSegment *segment = incomingTail.loadAcquire();
+        if (!segment) {
+            // the consumer starts reading from incomingFirst
+            IncomingSegment *first = new IncomingSegment;
+            if (!incomingFirst.testAndSetOrdered(0, first))
+                delete first;
+            incomingTail.testAndSetOrdered(0, incomingFirst.loadAcquire());
+            continue;
+        }
+
+        const int i = segment->claimed.fetchAndAddAcquire(1);
+        if (i < IncomingSegment::Size) {
+            IncomingSlot &slot = segment->entries[i];
+            slot.event = QPostEvent(receiver, event, priority);
+            incomingCount.ref();
+            slot.ready.storeRelease(1);
+            return;
+        }
+
+        // the segment is full; append a new one, or help whoever did it
+        IncomingSegment *next = segment->next.loadAcquire();
+        if (!next) {
+            IncomingSegment *fresh = new IncomingSegment;
+            if (segment->next.testAndSetOrdered(0, fresh, next))
+                next = fresh;
+            else
+                delete fresh;
+        }
+        incomingTail.testAndSetOrdered(segment, next);
+    }
+}
+
+/*
+    Moves the events from the incoming queue into the list, in the order in
+    which they were posted. The mutex must be locked. Returns \c true if
+    there were any.
+*/
+bool QPostEventList::takeIncoming()
+{
+    if (!hasIncoming())
+        return false;
+
+    if (!incomingHead) {
+        incomingHead = incomingFirst.loadAcquire();
+        incomingHeadIndex = 0;
+    }
+
+    int taken = 0;
+    while (incomingHead) {
+        if (incomingHeadIndex == IncomingSegment::Size) {
+            IncomingSegment *next = incomingHead->next.loadAcquire();
+            if (!next)
+                break;
+            // make sure no producer can find the old segment any more,
+            // then free it once none is left that may have found it before
+            incomingTail.testAndSetOrdered(incomingHead, next);
+            incomingHead->nextRetired = retiredSegments;
+            retiredSegments = incomingHead;
+            incomingHead = next;
+            incomingHeadIndex = 0;
+            continue;
+        }
+
+        IncomingSlot &slot = incomingHead->entries[incomingHeadIndex];
+        // stop at a slot that is claimed but not written yet, so that the
+        // posting order is kept; its producer will wake us up again
+        if (!slot.ready.loadAcquire())
+            break;
+        addEvent(slot.event);
+        ++QObjectPrivate::get(slot.event.receiver)->postedEvents;
+        ++incomingHeadIndex;
+        ++taken;
+    }
+    incomingCount.fetchAndSubRelaxed(taken);
+
+    if (retiredSegments && incomingPosters.fetchAndAddOrdered(0) == 0) {
+        while (retiredSegments) {
+            IncomingSegment *next = retiredSegments->nextRetired;
+            delete retiredSegments;
+            retiredSegments = next;
+        }
+    }
+    return taken != 0;
+}
+
+/*
+    Waits until no producer is between reading a receiver's thread data and
+    appending to this list's incoming queue. Called by
+    QObject::moveToThread() after changing the thread data, so that events
+    which were posted to the old thread in the meantime can be forwarded.
+*/
+void QPostEventList::waitForIncomingPosters()
+{
+#ifndef QT_NO_THREAD
+    // the ordered read-modify-write is a full barrier, which orders the
+    // thread data store before the read of the counter
+    while (incomingPosters.fetchAndAddOrdered(0) != 0)
+        QThread::yieldCurrentThread();
+#endif
+}
+
 /*
   QThreadData
 */
@@ -74,6 +203,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    postEventList.takeIncoming();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -107,9 +107,42 @@ public:
 
     QMutex mutex;
 
+    // Events that are never compressed are posted without taking the mutex:
+    // producers append them to the incoming queue, a linked list of
+    // fixed-size segments in which slots are claimed with an atomic counter.
+    // Whoever holds the mutex moves them into the list with takeIncoming().
+    struct IncomingSlot
+    {
+        QAtomicInt ready;
+        QPostEvent event;
+    };
+    struct IncomingSegment
+    {
+        enum { Size = 64 };
+        inline IncomingSegment() : claimed(0), next(0), nextRetired(0) { }
+        QAtomicInt claimed;
+        QAtomicPointer<IncomingSegment> next;
+        IncomingSegment *nextRetired;
+        IncomingSlot entries[Size];
+    };
+
+    // number of producers between checking the receiver's thread and
+    // appending to the incoming queue; see QCoreApplication::postEvent()
+    QAtomicInt incomingPosters;
+
     inline QPostEventList()
-        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
+        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0),
+          incomingPosters(0), incomingFirst(0), incomingTail(0), incomingCount(0),
+          incomingHead(0), incomingHeadIndex(0), retiredSegments(0)
     { }
+    ~QPostEventList();
+
+    inline bool hasIncoming() const
+    { return incomingCount.load() != 0; }
+
+    void postIncoming(QObject *receiver, QEvent *event, int priority);
+    bool takeIncoming();
+    void waitForIncomingPosters();
 
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
@@ -131,6 +164,15 @@ private:
     //hides because they do not keep that list sorted. addEvent must be used
     using QVector<QPostEvent>::append;
     using QVector<QPostEvent>::insert;
+
+    // written by the producers
+    QAtomicPointer<IncomingSegment> incomingFirst;
+    QAtomicPointer<IncomingSegment> incomingTail;
+    QAtomicInt incomingCount;
+    // only accessed with the mutex locked
+    IncomingSegment *incomingHead;
+    int incomingHeadIndex;
+    IncomingSegment *retiredSegments;
 };
 
 #ifndef QT_NO_THREAD
@@ -247,7 +289,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncoming();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -44,6 +44,9 @@
 #    include "../kernel/qeventdispatcher_glib_p.h"
 #  endif
 #  include <private/qeventdispatcher_unix_p.h>
+#  if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_NO_EVENTFD)
+#    include <private/qeventdispatcher_epoll_p.h>
+#  endif
 #endif
 
 #include "qthreadstorage.h"
@@ -252,6 +255,12 @@ void QThreadPrivate::createEventDispatcher(QThreadData *data)
 #if defined(Q_OS_BLACKBERRY)
     data->eventDispatcher.storeRelease(new QEventDispatcherBlackberry);
 #else
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID) && !defined(QT_NO_EVENTFD)
+    if (!qEnvironmentVariableIsEmpty("QT_EVENT_DISPATCHER_EPOLL")
+        && QEventDispatcherEpoll::isSupported())
+        data->eventDispatcher.storeRelease(new QEventDispatcherEpoll);
+    else
+#endif
 #if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
         && qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB")
@@ -36,6 +36,7 @@
 #include "qelapsedtimer.h"
 
 #include <algorithm>
+#include <limits.h>
 
 #ifndef QT_NO_THREAD
 
@@ -52,12 +53,31 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() Q_DECL_OVERRIDE;
     void registerThreadInactive();
+    QRunnable *takeLocalTask();
+
+    bool pushLocal(QRunnable *runnable);
+    QRunnable *popLocal();
+    bool removeLocal(QRunnable *runnable);
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables started from this thread while the pool had no free
+    // thread, in a ring that only this thread adds to. This thread and
+    // the ones stealing from it take from the front with a
+    // compare-and-swap of localHead; a slot is reset to 0 when its
+    // runnable is taken or cancelled, and only reused after that.
+    enum { LocalQueueSize = 256 };
+    QAtomicInteger<quint32> localHead;
+    QAtomicInteger<quint32> localTail;
+    QAtomicPointer<QRunnable> localQueue[LocalQueueSize];
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *currentPoolThread = 0;
+#endif
+
 /*
     QThreadPool private class.
 */
@@ -67,7 +87,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(0)
+    :manager(manager), runnable(0), localHead(0), localTail(0)
 { }
 
 /*
@@ -75,6 +95,9 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    currentPoolThread = this;
+#endif
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -82,37 +105,44 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool autoDelete = r->autoDelete();
-
-
-                // run the task
+                // run the task, followed by the ones it started locally,
+                // without holding the pool's mutex
                 locker.unlock();
+                do {
+                    const bool autoDelete = r->autoDelete();
+
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        locker.relock();
+                        manager->flushLocalQueue(this);
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
-                locker.relock();
 
-                if (autoDelete && !--r->ref)
-                    delete r;
+                    if (autoDelete && !r->ref.deref())
+                        delete r;
+                } while ((r = takeLocalTask()) != 0);
+                locker.relock();
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            r = manager->takeTask(this);
         } while (r != 0);
 
+        // only non-empty if we stopped early because of tooManyThreadsActive()
+        manager->flushLocalQueue(this);
+
         if (manager->isExiting) {
             registerThreadInactive();
             break;
@@ -122,6 +152,15 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            // a worker starting a runnable locally right now either sees
+            // that we are waiting and wakes us, or we find it here
+            manager->updateSpareThreads();
+            if (QRunnable *stolen = manager->stealLocalTask(this)) {
+                manager->waitingThreads.removeOne(this);
+                manager->updateSpareThreads();
+                runnable = stolen;
+                continue;
+            }
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
@@ -131,12 +170,80 @@ void QThreadPoolThread::run()
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
+            manager->updateSpareThreads();
             registerThreadInactive();
             break;
         }
     }
 }
 
+/*
+    Returns the next runnable from this thread's local queue, unless a
+    runnable with a higher priority is waiting in the pool's queue.
+    Called by this thread only, without holding the pool's mutex.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    // local runnables all have the default priority 0
+    if (manager->topQueuedPriority.load() > 0)
+        return 0;
+    return popLocal();
+}
+
+/*
+    Adds \a runnable at the end of the local queue, unless it is full.
+    Called by this thread only.
+*/
+bool QThreadPoolThread::pushLocal(QRunnable *runnable)
+{
+    const quint32 tail = localTail.load();
+    if (tail - localHead.loadAcquire() >= quint32(LocalQueueSize))
+        return false;
+
+    // the thread that took the previous runnable in this slot may not
+    // have reset it yet
+    QAtomicPointer<QRunnable> &slot = localQueue[tail % LocalQueueSize];
+    if (slot.loadAcquire())
+        return false;
+
+    slot.storeRelease(runnable);
+    localTail.storeRelease(tail + 1);
+    return true;
+}
+
+/*
+    Removes and returns the oldest runnable from the local queue, or 0 if
+    it is empty. Called by this thread and by the threads stealing from it.
+*/
+QRunnable *QThreadPoolThread::popLocal()
+{
+    for (;;) {
+        const quint32 head = localHead.loadAcquire();
+        if (head == localTail.loadAcquire())
+            return 0;
+        if (!localHead.testAndSetOrdered(head, head + 1))
+            continue;
+        if (QRunnable *runnable = localQueue[head % LocalQueueSize].fetchAndStoreOrdered(0))
+            return runnable;
+        // cancelled, try the next one
+    }
+}
+
+/*
+    Removes \a runnable from the local queue, leaving its slot to be
+    skipped by popLocal(). Must be called with the pool's mutex locked.
+*/
+bool QThreadPoolThread::removeLocal(QRunnable *runnable)
+{
+    const quint32 head = localHead.loadAcquire();
+    const quint32 tail = localTail.loadAcquire();
+    for (quint32 i = head; i != tail; ++i) {
+        if (localQueue[i % LocalQueueSize].testAndSetOrdered(runnable, 0))
+            return true;
+    }
+    return false;
+}
+
 void QThreadPoolThread::registerThreadInactive()
 {
     if (--manager->activeThreads == 0)
@@ -152,7 +259,10 @@ QThreadPoolPrivate:: QThreadPoolPrivate()
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
-      activeThreads(0)
+      activeThreads(0),
+      topQueuedPriority(INT_MIN),
+      defaultPriorityQueued(0),
+      spareThreads(1)
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -171,6 +281,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         // recycle an available thread
         enqueueTask(task);
         waitingThreads.takeFirst()->runnableReady.wakeOne();
+        updateSpareThreads();
         return true;
     }
 
@@ -180,9 +291,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         Q_ASSERT(thread->runnable == 0);
 
         ++activeThreads;
+        updateSpareThreads();
 
         if (task->autoDelete())
-            ++task->ref;
+            task->ref.ref();
         thread->runnable = task;
         thread->start();
         return true;
@@ -201,7 +313,7 @@ inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     if (runnable->autoDelete())
-        ++runnable->ref;
+        runnable->ref.ref();
 
     // put it on the queue
     QList<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -209,6 +321,151 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     if (it != begin && priority > (*(it - 1)).second)
         it = std::upper_bound(begin, --it, priority);
     queue.insert(it - begin, qMakePair(runnable, priority));
+    updateTopQueuedPriority();
+}
+
+QRunnable *QThreadPoolPrivate::dequeueTask()
+{
+    QRunnable *runnable = queue.takeFirst().first;
+    updateTopQueuedPriority();
+    return runnable;
+}
+
+/*
+    Queues \a runnable on the calling thread's local queue if that is one
+    of our worker threads and the pool has no thread to spare for it.
+    Called without the mutex.
+
+    The worker runs its local runnables after the current one, and the
+    other workers steal from the local queues once the shared queue has
+    nothing older for them, so fine-grained runnables started from within
+    other runnables of a busy pool don't serialize on the mutex. The
+    mutex is only taken when the pool may have a thread for \a runnable
+    after all.
+*/
+bool QThreadPoolPrivate::tryStartLocal(QRunnable *runnable)
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this)
+        return false;
+
+    // local runnables have the default priority and run before the ones
+    // of that priority in the shared queue, so only go local while there
+    // are none there; this keeps runnables of equal priority in the order
+    // they were started
+    if (spareThreads.load() > 0 || defaultPriorityQueued.load())
+        return false;
+
+    if (runnable->autoDelete())
+        runnable->ref.ref();
+    if (!thread->pushLocal(runnable)) {
+        if (runnable->autoDelete())
+            runnable->ref.deref();
+        return false;
+    }
+
+    // pairs with updateSpareThreads(): a thread that went idle or a limit
+    // that was raised meanwhile is either seen here, or their owner
+    // looks at the local queues after making the change
+    if (spareThreads.fetchAndAddOrdered(0) > 0) {
+        QMutexLocker locker(&mutex);
+        tryToStartMoreThreads();
+    }
+    return true;
+#else
+    Q_UNUSED(runnable);
+    return false;
+#endif
+}
+
+/*
+    Removes and returns the oldest runnable from the local queue of a
+    worker other than \a thief, or 0 if they are all empty.
+    Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealLocalTask(QThreadPoolThread *thief)
+{
+    for (QSet<QThreadPoolThread *>::const_iterator it = allThreads.constBegin();
+         it != allThreads.constEnd(); ++it) {
+        QThreadPoolThread *victim = *it;
+        if (victim == thief)
+            continue;
+        if (QRunnable *runnable = victim->popLocal())
+            return runnable;
+    }
+    return 0;
+}
+
+/*
+    Returns the next runnable for \a thread to run: runnables queued with a
+    higher priority first, then the thread's own local queue, then one
+    stolen from another worker, and finally the rest of the pool's queue.
+    Local runnables are always older than the runnables of the same
+    priority in the pool's queue (see tryStartLocal()).
+    Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.first().second > 0)
+        return dequeueTask();
+
+    if (QRunnable *runnable = thread->popLocal())
+        return runnable;
+
+    if (QRunnable *runnable = stealLocalTask(thread))
+        return runnable;
+
+    if (!queue.isEmpty())
+        return dequeueTask();
+    return 0;
+}
+
+/*
+    Moves the runnables from \a thread's local queue to the pool's queue,
+    so that other threads run them. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::flushLocalQueue(QThreadPoolThread *thread)
+{
+    QRunnable *runnable = thread->popLocal();
+    if (!runnable)
+        return;
+
+    // they are older than the runnables of the same priority already in
+    // the queue, so put them in front of those; their references move along
+    int pos = std::lower_bound(queue.constBegin(), queue.constEnd(), 0) - queue.constBegin();
+    do {
+        queue.insert(pos++, qMakePair(runnable, 0));
+    } while ((runnable = thread->popLocal()) != 0);
+    updateTopQueuedPriority();
+
+    for (int i = queue.size(); i > 0 && !waitingThreads.isEmpty(); --i)
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    updateSpareThreads();
+}
+
+/*
+    Refreshes topQueuedPriority and defaultPriorityQueued, which the worker
+    threads read without holding the mutex. Must be called with the mutex
+    locked, after changing the queue.
+*/
+void QThreadPoolPrivate::updateTopQueuedPriority()
+{
+    topQueuedPriority.store(queue.isEmpty() ? INT_MIN : queue.first().second);
+    QList<QPair<QRunnable *, int> >::const_iterator it =
+            std::lower_bound(queue.constBegin(), queue.constEnd(), 0);
+    defaultPriorityQueued.store(it != queue.constEnd() && it->second == 0);
+}
+
+/*
+    Refreshes spareThreads. Must be called with the mutex locked, after
+    changing any of the thread counts or maxThreadCount, and before
+    looking for local runnables to start on the threads that became
+    available (see tryStartLocal()).
+*/
+void QThreadPoolPrivate::updateSpareThreads()
+{
+    spareThreads.fetchAndStoreOrdered(allThreads.isEmpty() ? 1 : maxThreadCount - activeThreadCount());
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -224,6 +481,20 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty() && tryStart(queue.first().first))
         queue.removeFirst();
+
+    // then the ones waiting in the workers' local queues, whose owners may
+    // be blocked waiting for them
+    while (queue.isEmpty() && activeThreadCount() < maxThreadCount) {
+        QRunnable *runnable = stealLocalTask(0);
+        if (!runnable)
+            break;
+        tryStart(runnable);
+        // tryStart() took its own reference
+        if (runnable->autoDelete())
+            runnable->ref.deref();
+    }
+    updateTopQueuedPriority();
+    updateSpareThreads();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -241,9 +512,10 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     allThreads.insert(thread.data());
     ++activeThreads;
+    updateSpareThreads();
 
     if (runnable->autoDelete())
-        ++runnable->ref;
+        runnable->ref.ref();
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -275,6 +547,7 @@ void QThreadPoolPrivate::reset()
 
     waitingThreads.clear();
     expiredThreads.clear();
+    updateSpareThreads();
 
     isExiting = false;
 }
@@ -302,10 +575,22 @@ void QThreadPoolPrivate::clear()
     for (QList<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (r->autoDelete() && !r->ref.deref())
             delete r;
     }
     queue.clear();
+
+    foreach (QThreadPoolThread *thread, allThreads) {
+        // the owner may keep adding while we take
+        for (int i = 0; i < QThreadPoolThread::LocalQueueSize; ++i) {
+            QRunnable *r = thread->popLocal();
+            if (!r)
+                break;
+            if (r->autoDelete() && !r->ref.deref())
+                delete r;
+        }
+    }
+    updateTopQueuedPriority();
 }
 
 /*!
@@ -325,10 +610,16 @@ bool QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
         while (it != end) {
             if (it->first == runnable) {
                 queue.erase(it);
+                updateTopQueuedPriority();
                 return true;
             }
             ++it;
         }
+
+        foreach (QThreadPoolThread *thread, allThreads) {
+            if (thread->removeLocal(runnable))
+                return true;
+        }
     }
 
     return false;
@@ -345,7 +636,7 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     if (!stealRunnable(runnable))
         return;
     const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = autoDelete && !runnable->ref.deref();
 
     runnable->run();
 
@@ -452,12 +743,17 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->tryStartLocal(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
-        if (!d->waitingThreads.isEmpty())
+        if (!d->waitingThreads.isEmpty()) {
             d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->updateSpareThreads();
+        }
     }
 }
 
@@ -484,6 +780,11 @@ bool QThreadPool::tryStart(QRunnable *runnable)
 
     Q_D(QThreadPool);
 
+    // Qt Concurrent keeps trying while the pool is busy, so find out
+    // without the mutex whether there is no thread to spare
+    if (d->spareThreads.load() <= 0)
+        return false;
+
     QMutexLocker locker(&d->mutex);
 
     if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
@@ -546,6 +847,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->maxThreadCount = maxThreadCount;
+    d->updateSpareThreads();
     d->tryToStartMoreThreads();
 }
 
@@ -583,6 +885,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateSpareThreads();
 }
 
 /*!
@@ -602,6 +905,7 @@ void QThreadPool::releaseThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
+    d->updateSpareThreads();
     d->tryToStartMoreThreads();
 }
 
@@ -649,7 +953,7 @@ void QThreadPool::cancel(QRunnable *runnable)
     Q_D(QThreadPool);
     if (!d->stealRunnable(runnable))
         return;
-    if (runnable->autoDelete() && !--runnable->ref) {
+    if (runnable->autoDelete() && !runnable->ref.deref()) {
         delete runnable;
     }
 }
@@ -67,8 +67,16 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    QRunnable *dequeueTask();
     int activeThreadCount() const;
 
+    bool tryStartLocal(QRunnable *task);
+    QRunnable *stealLocalTask(QThreadPoolThread *thief);
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    void flushLocalQueue(QThreadPoolThread *thread);
+    void updateTopQueuedPriority();
+    void updateSpareThreads();
+
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
@@ -91,6 +99,17 @@ public:
     int maxThreadCount;
     int reservedThreads;
     int activeThreads;
+
+    // priority of the first runnable in the queue, and whether it has one
+    // of the default priority, for the worker threads using their local
+    // queues without the mutex
+    QAtomicInt topQueuedPriority;
+    QAtomicInt defaultPriorityQueued;
+
+    // maxThreadCount - activeThreadCount(), or 1 while there are no
+    // threads, for starting runnables from the worker threads and for
+    // tryStart() without the mutex
+    QAtomicInt spareThreads;
 };
 
 QT_END_NAMESPACE
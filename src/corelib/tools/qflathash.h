@@ -0,0 +1,627 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+#include <QtCore/qhashfunctions.h>
+
+#include <iterator>
+#include <new>
+#include <string.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+struct Q_CORE_EXPORT QFlatHashData
+{
+    // Every slot has one control byte. A full slot stores the low 7 bits
+    // of its hash value, so the high bit distinguishes full slots from
+    // empty and deleted ones.
+    enum {
+        GroupWidth = 8,
+        Empty = 0xff,
+        Deleted = 0x80
+    };
+
+    QtPrivate::RefCount ref;
+    int size;
+    int growthLeft;
+    int numSlots;
+    uint seed;
+    uchar *ctrl;
+    void *entries;
+
+    static QFlatHashData *allocate(int numSlots, int slotSize, int slotAlign);
+    static void deallocate(QFlatHashData *d);
+
+    static int capacityForSlots(int numSlots)
+    { return numSlots - numSlots / 8; }
+    static int slotsForCapacity(int capacity);
+
+    // The probe sequence works on whole groups of control bytes, which are
+    // matched eight at a time using plain 64-bit arithmetic.
+    static quint64 loadGroup(const uchar *p)
+    { return qFromLittleEndian<quint64>(p); }
+    static quint64 matchByte(quint64 group, uchar b)
+    {
+        const quint64 lsbs = Q_UINT64_C(0x0101010101010101);
+        const quint64 x = group ^ (lsbs * b);
+        // may report false positives, but only for full slots
+        return (x - lsbs) & ~x & Q_UINT64_C(0x8080808080808080);
+    }
+    static quint64 matchEmpty(quint64 group)
+    { return group & (group << 1) & Q_UINT64_C(0x8080808080808080); }
+    static quint64 matchEmptyOrDeleted(quint64 group)
+    { return group & Q_UINT64_C(0x8080808080808080); }
+    static quint64 matchFull(quint64 group)
+    { return ~group & Q_UINT64_C(0x8080808080808080); }
+    static int firstInMask(quint64 mask)
+    { return int(qCountTrailingZeroBits(mask) >> 3); }
+
+    int nextFull(int i) const
+    {
+        while (i < numSlots) {
+            if ((i & (GroupWidth - 1)) == 0) {
+                const quint64 m = matchFull(loadGroup(ctrl + i));
+                if (m)
+                    return i + firstInMask(m);
+                i += GroupWidth;
+            } else {
+                if (!(ctrl[i] & 0x80))
+                    return i;
+                ++i;
+            }
+        }
+        return numSlots;
+    }
+    int previousFull(int i) const
+    {
+        while (--i >= 0) {
+            if (!(ctrl[i] & 0x80))
+                return i;
+        }
+        return -1;
+    }
+
+    int findEmptyOrDeleted(uint h) const
+    {
+        const int groupMask = numSlots / GroupWidth - 1;
+        int g = int(h >> 7) & groupMask;
+        for (int step = 1; ; ++step) {
+            const quint64 m = matchEmptyOrDeleted(loadGroup(ctrl + g * GroupWidth));
+            if (m)
+                return g * GroupWidth + firstInMask(m);
+            g = (g + step) & groupMask;
+        }
+    }
+
+    void setCtrl(int i, uint h) { ctrl[i] = uchar(h & 0x7f); }
+    void markErased(int i);
+
+    static const QFlatHashData shared_null;
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Slot {
+        Slot(const Key &k, const T &v) : key(k), value(v) {}
+        Key key;
+        T value;
+    };
+
+    QFlatHashData *d;
+
+    static Slot *slotsOf(const QFlatHashData *x) { return static_cast<Slot *>(x->entries); }
+    static uint hashOf(const QFlatHashData *x, const Key &key)
+    {
+        // qHash() is often weak in its low bits; the control bytes and the
+        // group index are taken from different parts of the hash value, so
+        // mix it first (MurmurHash3 finalizer).
+        uint h = qHash(key, x->seed);
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+
+    int findIndex(const Key &key) const;
+    int findIndex(const Key &key, uint h) const;
+    int insertIndex(const Key &key, bool *inserted);
+    void eraseAt(int i);
+    void rehash(int numSlots);
+    void detach_helper();
+    static void freeData(QFlatHashData *x);
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null))
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d)
+    {
+        if (!d->ref.ref())
+            detach_helper();
+    }
+    ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    {
+        QFlatHash copy(other);
+        swap(copy);
+        return *this;
+    }
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW
+        : d(other.d) { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const Q_DECL_NOTHROW { return d->size; }
+    inline int count() const Q_DECL_NOTHROW { return d->size; }
+    inline bool isEmpty() const Q_DECL_NOTHROW { return d->size == 0; }
+    inline bool empty() const Q_DECL_NOTHROW { return d->size == 0; }
+
+    inline int capacity() const Q_DECL_NOTHROW { return QFlatHashData::capacityForSlots(d->numSlots); }
+    void reserve(int size);
+    inline void squeeze() { reserve(1); }
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const Q_DECL_NOTHROW { return !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const Q_DECL_NOTHROW { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    int count(const Key &key) const { return findIndex(key) >= 0 ? 1 : 0; }
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+        iterator(QFlatHashData *data, int index) : d(data), i(index) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(Q_NULLPTR), i(0) { }
+
+        inline const Key &key() const { return slotsOf(d)[i].key; }
+        inline T &value() const { return slotsOf(d)[i].value; }
+        inline T &operator*() const { return slotsOf(d)[i].value; }
+        inline T *operator->() const { return &slotsOf(d)[i].value; }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+
+        inline iterator &operator++() { i = d->nextFull(i + 1); return *this; }
+        inline iterator operator++(int) { iterator r = *this; ++*this; return r; }
+        inline iterator &operator--() { i = d->previousFull(i); return *this; }
+        inline iterator operator--(int) { iterator r = *this; --*this; return r; }
+
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+        const_iterator(const QFlatHashData *data, int index) : d(data), i(index) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(Q_NULLPTR), i(0) { }
+        inline const_iterator(const iterator &o) : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return slotsOf(d)[i].key; }
+        inline const T &value() const { return slotsOf(d)[i].value; }
+        inline const T &operator*() const { return slotsOf(d)[i].value; }
+        inline const T *operator->() const { return &slotsOf(d)[i].value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        inline const_iterator &operator++() { i = d->nextFull(i + 1); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; ++*this; return r; }
+        inline const_iterator &operator--() { i = d->previousFull(i); return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; --*this; return r; }
+    };
+    friend class const_iterator;
+
+    inline iterator begin() { detach(); return iterator(d, d->nextFull(0)); }
+    inline const_iterator begin() const { return const_iterator(d, d->nextFull(0)); }
+    inline const_iterator cbegin() const { return const_iterator(d, d->nextFull(0)); }
+    inline const_iterator constBegin() const { return const_iterator(d, d->nextFull(0)); }
+    inline iterator end() { detach(); return iterator(d, d->numSlots); }
+    inline const_iterator end() const { return const_iterator(d, d->numSlots); }
+    inline const_iterator cend() const { return const_iterator(d, d->numSlots); }
+    inline const_iterator constEnd() const { return const_iterator(d, d->numSlots); }
+
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+    iterator erase(const_iterator it);
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+    QFlatHash &unite(const QFlatHash &other);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        Slot *s = slotsOf(x);
+        for (int i = x->nextFull(0); i < x->numSlots; i = x->nextFull(i + 1))
+            s[i].~Slot();
+    }
+    QFlatHashData::deallocate(x);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    // The copy keeps the seed and the slot positions of the original, so
+    // that indices (and thus iterators) remain valid across a detach.
+    const int numSlots = qMax(d->numSlots, int(QFlatHashData::GroupWidth));
+    QFlatHashData *x = QFlatHashData::allocate(numSlots, sizeof(Slot), Q_ALIGNOF(Slot));
+    if (d->numSlots) {
+        x->seed = d->seed;
+        Slot *src = slotsOf(d);
+        Slot *dst = slotsOf(x);
+        QT_TRY {
+            for (int i = d->nextFull(0); i < d->numSlots; i = d->nextFull(i + 1)) {
+                new (dst + i) Slot(src[i]);
+                x->ctrl[i] = d->ctrl[i];
+            }
+        } QT_CATCH(...) {
+            freeData(x);
+            QT_RETHROW;
+        }
+        // the tombstones must be kept too: turning them into empty slots
+        // would end the probe sequences of keys that were placed past them
+        ::memcpy(x->ctrl, d->ctrl, numSlots);
+        x->size = d->size;
+        x->growthLeft = d->growthLeft;
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int numSlots)
+{
+    Q_ASSERT(!d->ref.isShared());
+    QFlatHashData *x = QFlatHashData::allocate(numSlots, sizeof(Slot), Q_ALIGNOF(Slot));
+    Slot *src = slotsOf(d);
+    Slot *dst = slotsOf(x);
+    for (int i = d->nextFull(0); i < d->numSlots; i = d->nextFull(i + 1)) {
+        const uint h = hashOf(x, src[i].key);
+        const int j = x->findEmptyOrDeleted(h);
+        x->setCtrl(j, h);
+        if (QTypeInfo<Key>::isStatic || QTypeInfo<T>::isStatic) {
+            new (dst + j) Slot(src[i]);
+            src[i].~Slot();
+        } else {
+            ::memcpy(static_cast<void *>(dst + j), static_cast<const void *>(src + i), sizeof(Slot));
+        }
+    }
+    x->size = d->size;
+    x->growthLeft = QFlatHashData::capacityForSlots(numSlots) - d->size;
+    QFlatHashData::deallocate(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int numSlots = QFlatHashData::slotsForCapacity(qMax(asize, d->size));
+    if (numSlots == d->numSlots && d->growthLeft + d->size == capacity())
+        return;
+    detach();
+    rehash(numSlots);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint h) const
+{
+    const int groupMask = d->numSlots / QFlatHashData::GroupWidth - 1;
+    const Slot *s = slotsOf(d);
+    int g = int(h >> 7) & groupMask;
+    for (int step = 1; ; ++step) {
+        const int base = g * QFlatHashData::GroupWidth;
+        const quint64 group = QFlatHashData::loadGroup(d->ctrl + base);
+        for (quint64 m = QFlatHashData::matchByte(group, uchar(h & 0x7f)); m; m &= m - 1) {
+            const int i = base + QFlatHashData::firstInMask(m);
+            if (s[i].key == key)
+                return i;
+        }
+        if (QFlatHashData::matchEmpty(group))
+            return -1;
+        g = (g + step) & groupMask;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key) const
+{
+    if (d->size == 0)
+        return -1;
+    return findIndex(key, hashOf(d, key));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::insertIndex(const Key &key, bool *inserted)
+{
+    detach();
+    uint h = hashOf(d, key);
+    int i = d->size ? findIndex(key, h) : -1;
+    if (i >= 0) {
+        *inserted = false;
+        return i;
+    }
+    if (d->growthLeft == 0) {
+        // Reclaim the tombstones if they make up a good part of the table,
+        // grow otherwise.
+        const int cap = capacity();
+        rehash(d->size > cap / 2 || cap == 0 ? qMax(d->numSlots * 2, int(QFlatHashData::GroupWidth))
+                                             : d->numSlots);
+        h = hashOf(d, key);
+    }
+    i = d->findEmptyOrDeleted(h);
+    if (d->ctrl[i] == QFlatHashData::Empty)
+        --d->growthLeft;
+    d->setCtrl(i, h);
+    ++d->size;
+    *inserted = true;
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i)
+{
+    slotsOf(d)[i].~Slot();
+    d->markErased(i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const int i = other.findIndex(it.key());
+        if (i < 0 || !(slotsOf(other.d)[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    if (isEmpty())
+        return 0;
+    int i = findIndex(key);
+    if (i < 0)
+        return 0;
+    detach();
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    if (isEmpty())
+        return T();
+    int i = findIndex(key);
+    if (i < 0)
+        return T();
+    detach();
+    T t = slotsOf(d)[i].value;
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? T() : slotsOf(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? defaultValue : slotsOf(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    bool inserted;
+    const int i = insertIndex(key, &inserted);
+    if (inserted)
+        new (slotsOf(d) + i) Slot(key, T());
+    return slotsOf(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    bool inserted;
+    const int i = insertIndex(key, &inserted);
+    if (inserted)
+        new (slotsOf(d) + i) Slot(key, value);
+    else
+        slotsOf(d)[i].value = value;
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::unite(const QFlatHash &other)
+{
+    QFlatHash copy(other);
+    reserve(size() + copy.size());
+    for (const_iterator it = copy.constBegin(); it != copy.constEnd(); ++it)
+        insert(it.key(), it.value());
+    return *this;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.i >= 0 && it.i < d->numSlots, "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    const int i = it.i;
+    // the detached copy has the same layout, so the index stays valid
+    detach();
+    eraseAt(i);
+    return iterator(d, d->nextFull(i + 1));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    const int i = findIndex(key);
+    detach();
+    return iterator(d, i < 0 ? d->numSlots : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &key) const
+{
+    const int i = findIndex(key);
+    return const_iterator(d, i < 0 ? d->numSlots : i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultKey) const
+{
+    for (const_iterator it = begin(); it != end(); ++it) {
+        if (it.value() == avalue)
+            return it.key();
+    }
+    return defaultKey;
+}
+
+Q_DECLARE_ASSOCIATIVE_ITERATOR(FlatHash)
+Q_DECLARE_MUTABLE_ASSOCIATIVE_ITERATOR(FlatHash)
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
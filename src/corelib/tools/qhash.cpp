@@ -41,6 +41,7 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
 
 #ifdef truncate
 #undef truncate
@@ -654,6 +655,71 @@ void QHashData::checkSanity()
 }
 #endif
 
+static const uchar qt_flathash_empty_group[QFlatHashData::GroupWidth] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+const QFlatHashData QFlatHashData::shared_null = {
+    Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, const_cast<uchar *>(qt_flathash_empty_group), 0
+};
+
+/*
+    The slots and the control bytes share one allocation: the slots come
+    first, so that they get the alignment of the block, and the control
+    bytes follow them.
+*/
+QFlatHashData *QFlatHashData::allocate(int numSlots, int slotSize, int slotAlign)
+{
+    Q_ASSERT(numSlots >= GroupWidth && (numSlots & (numSlots - 1)) == 0);
+    qt_initialize_qhash_seed(); // may throw
+
+    const size_t slotBytes = size_t(numSlots) * size_t(slotSize);
+    void *block = qMallocAligned(slotBytes + size_t(numSlots), qMax(slotAlign, int(sizeof(void *))));
+    Q_CHECK_PTR(block);
+
+    QFlatHashData *d = new QFlatHashData;
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->growthLeft = capacityForSlots(numSlots);
+    d->numSlots = numSlots;
+    d->seed = uint(qt_qhash_seed.load());
+    d->entries = block;
+    d->ctrl = static_cast<uchar *>(block) + slotBytes;
+    memset(d->ctrl, Empty, numSlots);
+    return d;
+}
+
+void QFlatHashData::deallocate(QFlatHashData *d)
+{
+    Q_ASSERT(d != &shared_null);
+    qFreeAligned(d->entries);
+    delete d;
+}
+
+int QFlatHashData::slotsForCapacity(int capacity)
+{
+    int numSlots = GroupWidth;
+    while (capacityForSlots(numSlots) < capacity && numSlots < (1 << 30))
+        numSlots *= 2;
+    return numSlots;
+}
+
+/*
+    A lookup stops at the first group that has an empty slot. If the group
+    of slot \a i has one, no key has ever probed past it, so the slot can
+    become empty again; otherwise it has to be left as a tombstone.
+*/
+void QFlatHashData::markErased(int i)
+{
+    if (matchEmpty(loadGroup(ctrl + (i & ~(GroupWidth - 1))))) {
+        ctrl[i] = Empty;
+        ++growthLeft;
+    } else {
+        ctrl[i] = Deleted;
+    }
+    --size;
+}
+
 /*!
     \fn uint qHash(const QPair<T1, T2> &key, uint seed = 0)
     \since 5.0
@@ -247,6 +247,29 @@ QByteArray QRingBuffer::read()
     return qba;
 }
 
+/*!
+    \internal
+
+    Read at most \a maxLength bytes of the first buffer. The buffer itself is
+    handed out when it is read completely and mostly filled, so the data is
+    not copied; small pieces of a block are copied out instead, so that they
+    do not keep a whole block allocated.
+*/
+QByteArray QRingBuffer::readChunk(qint64 maxLength)
+{
+    const qint64 blockSize = nextDataBlockSize();
+    if (blockSize <= 0 || maxLength <= 0)
+        return QByteArray();
+
+    if (maxLength >= blockSize && blockSize * 2 >= buffers.first().capacity())
+        return read();
+
+    const int bytesToRead = int(qMin(blockSize, maxLength));
+    QByteArray qba(readPointer(), bytesToRead);
+    free(bytesToRead);
+    return qba;
+}
+
 /*!
     \internal
 
@@ -107,6 +107,11 @@ public:
         }
     }
 
+    inline void ungetBlock(const char *data, qint64 size) {
+        if (size > 0)
+            memcpy(reserveFront(size), data, size);
+    }
+
 
     inline qint64 size() const {
         return bufferSize;
@@ -117,6 +122,7 @@ public:
     Q_CORE_EXPORT qint64 indexOf(char c, qint64 maxLength) const;
     Q_CORE_EXPORT qint64 read(char *data, qint64 maxLength);
     Q_CORE_EXPORT QByteArray read();
+    Q_CORE_EXPORT QByteArray readChunk(qint64 maxLength);
     Q_CORE_EXPORT qint64 peek(char *data, qint64 maxLength, qint64 pos = 0) const;
     Q_CORE_EXPORT void append(const QByteArray &qba);
 
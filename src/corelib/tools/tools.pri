@@ -24,6 +24,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdatetimeparser_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
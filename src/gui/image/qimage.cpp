@@ -1993,7 +1993,7 @@ QImage QImage::convertToFormat_helper(Format format, Qt::ImageConversionFlags fl
         image.d->offset = offset();
         copyMetadata(image.d, d);
 
-        converter(image.d, d, flags);
+        qt_convert_image(converter, image.d, d, flags);
         return image;
     }
 
@@ -2123,7 +2123,7 @@ QImage QImage::convertToFormat(Format format, const QVector<QRgb> &colorTable, Q
     image.d->offset = offset();
     copyMetadata(image.d, d);
 
-    converter(image.d, d, flags);
+    qt_convert_image(converter, image.d, d, flags);
     return image;
 }
 
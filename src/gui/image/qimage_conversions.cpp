@@ -36,6 +36,10 @@
 #include <private/qsimd_p.h>
 #include <private/qimage_p.h>
 #include <qendian.h>
+#include <qrunnable.h>
+#include <qscopedpointer.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -220,6 +224,119 @@ bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::Im
     return true;
 }
 
+#ifndef QT_NO_THREAD
+// Below this many pixels per band the cost of waking up a pool thread
+// outweighs the conversion work it would take over.
+static const int minimumPixelsPerBand = 64 * 1024;
+
+namespace {
+
+class BandedImageConversion : public QRunnable
+{
+public:
+    BandedImageConversion(Image_Converter converter, const QImageData *srcBands, QImageData *destBands,
+                          int bandCount, Qt::ImageConversionFlags flags)
+        : m_converter(converter), m_srcBands(srcBands), m_destBands(destBands),
+          m_bandCount(bandCount), m_flags(flags), m_nextBand(0)
+    {
+        // The same runnable is started on several pool threads at once.
+        setAutoDelete(false);
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        convertBands();
+        m_finished.release();
+    }
+
+    void convertBands()
+    {
+        int band;
+        while ((band = m_nextBand.fetchAndAddRelaxed(1)) < m_bandCount)
+            m_converter(m_destBands + band, m_srcBands + band, m_flags);
+    }
+
+    void waitForHelpers(int helperCount) { m_finished.acquire(helperCount); }
+
+private:
+    Image_Converter m_converter;
+    const QImageData *m_srcBands;
+    QImageData *m_destBands;
+    int m_bandCount;
+    Qt::ImageConversionFlags m_flags;
+    QAtomicInt m_nextBand;
+    QSemaphore m_finished;
+};
+
+} // namespace
+
+static void setupBand(QImageData *band, const QImageData *image, int y, int height)
+{
+    band->width = image->width;
+    band->height = height;
+    band->depth = image->depth;
+    band->format = image->format;
+    band->bytes_per_line = image->bytes_per_line;
+    band->nbytes = image->bytes_per_line * height;
+    band->data = image->data + qptrdiff(y) * image->bytes_per_line;
+    band->own_data = false;
+    band->colortable = image->colortable;
+    band->has_alpha_clut = image->has_alpha_clut;
+}
+#endif // QT_NO_THREAD
+
+/*!
+    \internal
+
+    Converts \a src into \a dest using \a converter. Large images are split
+    into bands of scanlines which are converted in parallel on the global
+    thread pool; the calling thread converts bands too, so the conversion
+    always makes progress even if the pool is busy.
+*/
+void qt_convert_image(Image_Converter converter, QImageData *dest, const QImageData *src, Qt::ImageConversionFlags flags)
+{
+#ifndef QT_NO_THREAD
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    // Dithering and palette building converters carry state from one
+    // scanline to the next, so they have to see the whole image.
+    const bool rowIndependent = dest->format > QImage::Format_Indexed8;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threadCount = pool->maxThreadCount();
+
+    int bandCount = 0;
+    if (rowIndependent && threadCount > 1) {
+        const qint64 pixels = qint64(src->width) * src->height;
+        bandCount = int(qMin(pixels / minimumPixelsPerBand, qint64(threadCount) * 4));
+        bandCount = qMin(bandCount, src->height);
+    }
+
+    if (bandCount > 1) {
+        const int bandHeight = (src->height + bandCount - 1) / bandCount;
+        bandCount = (src->height + bandHeight - 1) / bandHeight;
+
+        QScopedArrayPointer<QImageData> srcBands(new QImageData[bandCount]);
+        QScopedArrayPointer<QImageData> destBands(new QImageData[bandCount]);
+        for (int i = 0; i < bandCount; ++i) {
+            const int y = i * bandHeight;
+            const int height = qMin(bandHeight, src->height - y);
+            setupBand(&srcBands[i], src, y, height);
+            setupBand(&destBands[i], dest, y, height);
+        }
+
+        BandedImageConversion conversion(converter, srcBands.data(), destBands.data(), bandCount, flags);
+        int helperCount = 0;
+        while (helperCount < qMin(threadCount, bandCount) - 1 && pool->tryStart(&conversion))
+            ++helperCount;
+        conversion.convertBands();
+        conversion.waitForHelpers(helperCount);
+        return;
+    }
+#endif
+    converter(dest, src, flags);
+}
+
 static void convert_passthrough(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
 {
     Q_ASSERT(src->width == dest->width);
@@ -2896,12 +3013,48 @@ InPlace_Image_Converter qimage_inplace_converter_map[QImage::NImageFormats][QIma
 
 void qInitImageConversions()
 {
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
+    extern void convert_Grayscale8_to_RGB32_sse2(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+    qimage_converter_map[QImage::Format_Grayscale8][QImage::Format_RGB32] = convert_Grayscale8_to_RGB32_sse2;
+    qimage_converter_map[QImage::Format_Grayscale8][QImage::Format_ARGB32] = convert_Grayscale8_to_RGB32_sse2;
+    qimage_converter_map[QImage::Format_Grayscale8][QImage::Format_ARGB32_Premultiplied] = convert_Grayscale8_to_RGB32_sse2;
+#endif
+
 #if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSSE3)
     if (qCpuHasFeature(SSSE3)) {
         extern void convert_RGB888_to_RGB32_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
         qimage_converter_map[QImage::Format_RGB888][QImage::Format_RGB32] = convert_RGB888_to_RGB32_ssse3;
         qimage_converter_map[QImage::Format_RGB888][QImage::Format_ARGB32] = convert_RGB888_to_RGB32_ssse3;
         qimage_converter_map[QImage::Format_RGB888][QImage::Format_ARGB32_Premultiplied] = convert_RGB888_to_RGB32_ssse3;
+
+        extern void convert_RGB32_to_RGB888_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        qimage_converter_map[QImage::Format_RGB32][QImage::Format_RGB888] = convert_RGB32_to_RGB888_ssse3;
+
+        extern void convert_RGB32_to_Grayscale8_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        qimage_converter_map[QImage::Format_RGB32][QImage::Format_Grayscale8] = convert_RGB32_to_Grayscale8_ssse3;
+
+        extern void convert_ARGB_to_RGBA_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        extern void convert_ARGB_to_RGBx_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        qimage_converter_map[QImage::Format_ARGB32][QImage::Format_RGBX8888] = convert_ARGB_to_RGBx_ssse3;
+        qimage_converter_map[QImage::Format_ARGB32][QImage::Format_RGBA8888] = convert_ARGB_to_RGBA_ssse3;
+        qimage_converter_map[QImage::Format_ARGB32_Premultiplied][QImage::Format_RGBA8888_Premultiplied] = convert_ARGB_to_RGBA_ssse3;
+        qimage_converter_map[QImage::Format_RGBX8888][QImage::Format_RGB32] = convert_ARGB_to_RGBx_ssse3;
+        qimage_converter_map[QImage::Format_RGBX8888][QImage::Format_ARGB32] = convert_ARGB_to_RGBA_ssse3;
+        qimage_converter_map[QImage::Format_RGBX8888][QImage::Format_ARGB32_Premultiplied] = convert_ARGB_to_RGBA_ssse3;
+        qimage_converter_map[QImage::Format_RGBA8888][QImage::Format_RGB32] = convert_ARGB_to_RGBx_ssse3;
+        qimage_converter_map[QImage::Format_RGBA8888][QImage::Format_ARGB32] = convert_ARGB_to_RGBA_ssse3;
+        qimage_converter_map[QImage::Format_RGBA8888_Premultiplied][QImage::Format_ARGB32_Premultiplied] = convert_ARGB_to_RGBA_ssse3;
+    }
+#endif
+
+#if defined(QT_COMPILER_SUPPORTS_SSE4_1)
+    if (qCpuHasFeature(SSE4_1)) {
+        extern void convert_ARGB_PM_to_ARGB_sse4(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        extern void convert_ARGB_PM_to_RGB_sse4(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
+        qimage_converter_map[QImage::Format_ARGB32_Premultiplied][QImage::Format_ARGB32] = convert_ARGB_PM_to_ARGB_sse4;
+        qimage_converter_map[QImage::Format_ARGB32_Premultiplied][QImage::Format_RGB32] = convert_ARGB_PM_to_RGB_sse4;
+        qimage_converter_map[QImage::Format_RGBA8888_Premultiplied][QImage::Format_RGBA8888] = convert_ARGB_PM_to_ARGB_sse4;
+        qimage_converter_map[QImage::Format_RGBA8888_Premultiplied][QImage::Format_RGBX8888] = convert_ARGB_PM_to_RGB_sse4;
     }
 #endif
 
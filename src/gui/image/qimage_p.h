@@ -109,6 +109,8 @@ extern InPlace_Image_Converter qimage_inplace_converter_map[QImage::NImageFormat
 void convert_generic(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags);
 bool convert_generic_inplace(QImageData *data, QImage::Format dst_format, Qt::ImageConversionFlags);
 
+void qt_convert_image(Image_Converter converter, QImageData *dest, const QImageData *src, Qt::ImageConversionFlags flags);
+
 void dither_to_Mono(QImageData *dst, const QImageData *src, Qt::ImageConversionFlags flags, bool fromalpha);
 
 void qInitImageConversions();
@@ -99,6 +99,44 @@ bool convert_ARGB_to_ARGB_PM_inplace_sse2(QImageData *data, Qt::ImageConversionF
     return true;
 }
 
+// Convert a scanline of Grayscale8 (src) to opaque RGB32 (dst)
+static inline void qt_convert_grayscale8_to_rgb32_sse2(quint32 *dst, const uchar *src, int len)
+{
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+
+    int i = 0;
+    for (; i < len - 15; i += 16) {
+        // Doubling each byte twice spreads one gray value over a whole pixel.
+        const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i lo = _mm_unpacklo_epi8(gray, gray);
+        const __m128i hi = _mm_unpackhi_epi8(gray, gray);
+        __m128i *d = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(d, _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alphaMask));
+        _mm_storeu_si128(d + 1, _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alphaMask));
+        _mm_storeu_si128(d + 2, _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alphaMask));
+        _mm_storeu_si128(d + 3, _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alphaMask));
+    }
+    for (; i < len; ++i)
+        dst[i] = qRgb(src[i], src[i], src[i]);
+}
+
+void convert_Grayscale8_to_RGB32_sse2(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_Grayscale8);
+    Q_ASSERT(dest->format == QImage::Format_RGB32 || dest->format == QImage::Format_ARGB32 || dest->format == QImage::Format_ARGB32_Premultiplied);
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    const uchar *src_data = src->data;
+    uchar *dest_data = dest->data;
+
+    for (int i = 0; i < src->height; ++i) {
+        qt_convert_grayscale8_to_rgb32_sse2(reinterpret_cast<quint32 *>(dest_data), src_data, src->width);
+        src_data += src->bytes_per_line;
+        dest_data += dest->bytes_per_line;
+    }
+}
+
 QT_END_NAMESPACE
 
 #endif // QT_COMPILER_SUPPORTS_SSE2
@@ -65,6 +65,82 @@ void convert_ARGB_to_ARGB_PM_sse4(QImageData *dest, const QImageData *src, Qt::I
     }
 }
 
+// Unpremultiplies the four pixels in v, which were loaded from s, with
+// exactly the results of qUnpremultiply(). That includes invalid pixels
+// whose color exceeds their alpha, where qUnpremultiply() truncates the
+// channels to 8 bits instead of saturating them.
+static inline __m128i unpremultiply4_sse4(__m128i v, const uint *s)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i half = _mm_set1_epi32(0x8000);
+    const __m128i alpha = _mm_srli_epi32(v, 24);
+    // the factor for alpha 0 is 0, which zeroes those pixels like qUnpremultiply() does
+    const __m128i invAlpha = _mm_setr_epi32(qt_inv_premul_factor[s[0] >> 24], qt_inv_premul_factor[s[1] >> 24],
+                                            qt_inv_premul_factor[s[2] >> 24], qt_inv_premul_factor[s[3] >> 24]);
+
+    // the products need all 32 bits, so shift them unsigned
+    __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), byteMask);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(v, 8), byteMask);
+    __m128i b = _mm_and_si128(v, byteMask);
+    r = _mm_and_si128(_mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(r, invAlpha), half), 16), byteMask);
+    g = _mm_and_si128(_mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(g, invAlpha), half), 16), byteMask);
+    b = _mm_and_si128(_mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi32(b, invAlpha), half), 16), byteMask);
+    const __m128i result = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(alpha, 24), _mm_slli_epi32(r, 16)),
+                                        _mm_or_si128(_mm_slli_epi32(g, 8), b));
+
+    // opaque pixels are returned unchanged
+    return _mm_blendv_epi8(result, v, _mm_cmpeq_epi32(alpha, byteMask));
+}
+
+template<bool MaskAlpha>
+static void convert_ARGB_PM_to_ARGB_sse4(QImageData *dest, const QImageData *src)
+{
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m128i vmask = _mm_set1_epi32(MaskAlpha ? 0xff000000 : 0);
+    const uint mask = MaskAlpha ? 0xff000000 : 0;
+
+    const uchar *src_data = src->data;
+    uchar *dest_data = dest->data;
+    for (int i = 0; i < src->height; ++i) {
+        const uint *s = reinterpret_cast<const uint *>(src_data);
+        uint *d = reinterpret_cast<uint *>(dest_data);
+        int x = 0;
+        for (; x < src->width - 3; x += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + x));
+            // Runs of fully opaque pixels are left unchanged by unpremultiplying,
+            // and qUnpremultiply() turns fully transparent ones into 0.
+            if (_mm_testc_si128(v, alphaMask))
+                v = _mm_or_si128(v, vmask);
+            else if (_mm_testz_si128(v, alphaMask))
+                v = vmask;
+            else
+                v = _mm_or_si128(unpremultiply4_sse4(v, s + x), vmask);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(d + x), v);
+        }
+        for (; x < src->width; ++x)
+            d[x] = mask | qUnpremultiply(s[x]);
+        src_data += src->bytes_per_line;
+        dest_data += dest->bytes_per_line;
+    }
+}
+
+void convert_ARGB_PM_to_ARGB_sse4(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_ARGB32_Premultiplied || src->format == QImage::Format_RGBA8888_Premultiplied);
+    Q_ASSERT(dest->format == QImage::Format_ARGB32 || dest->format == QImage::Format_RGBA8888);
+    convert_ARGB_PM_to_ARGB_sse4<false>(dest, src);
+}
+
+void convert_ARGB_PM_to_RGB_sse4(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_ARGB32_Premultiplied || src->format == QImage::Format_RGBA8888_Premultiplied);
+    Q_ASSERT(dest->format == QImage::Format_RGB32 || dest->format == QImage::Format_RGBX8888);
+    convert_ARGB_PM_to_ARGB_sse4<true>(dest, src);
+}
+
 QT_END_NAMESPACE
 
 #endif // QT_COMPILER_SUPPORTS_SSE4_1
@@ -136,6 +136,153 @@ void convert_RGB888_to_RGB32_ssse3(QImageData *dest, const QImageData *src, Qt::
     }
 }
 
+// Convert a scanline of RGB32 (src) to RGB888 (dst)
+// src must be at least len * 4 bytes
+// dst must be at least len * 3 bytes
+static inline void qt_convert_rgb32_to_rgb888_ssse3(uchar *dst, const quint32 *src, int len)
+{
+    // Packs 4 pixels into the 12 low bytes of a vector, in R, G, B order.
+    const __m128i shuffleMask = _mm_set_epi8(char(0x80), char(0x80), char(0x80), char(0x80), 12, 13, 14, 8, 9, 10, 4, 5, 6, 0, 1, 2);
+
+    int i = 0;
+    for (; i < len - 15; i += 16) {
+        const __m128i *s = reinterpret_cast<const __m128i *>(src + i);
+        const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(s), shuffleMask);
+        const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(s + 1), shuffleMask);
+        const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(s + 2), shuffleMask);
+        const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(s + 3), shuffleMask);
+
+        // Stitch the four 12 byte groups into three full vectors.
+        __m128i *out = reinterpret_cast<__m128i *>(dst);
+        _mm_storeu_si128(out, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+        _mm_storeu_si128(out + 1, _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+        _mm_storeu_si128(out + 2, _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+        dst += 48;
+    }
+    for (; i < len; ++i) {
+        const quint32 p = src[i];
+        dst[0] = qRed(p);
+        dst[1] = qGreen(p);
+        dst[2] = qBlue(p);
+        dst += 3;
+    }
+}
+
+void convert_RGB32_to_RGB888_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_RGB32);
+    Q_ASSERT(dest->format == QImage::Format_RGB888);
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    const uchar *src_data = src->data;
+    uchar *dest_data = dest->data;
+
+    for (int i = 0; i < src->height; ++i) {
+        qt_convert_rgb32_to_rgb888_ssse3(dest_data, reinterpret_cast<const quint32 *>(src_data), src->width);
+        src_data += src->bytes_per_line;
+        dest_data += dest->bytes_per_line;
+    }
+}
+
+// Swap the red and blue channels of a scanline, optionally forcing alpha to 0xff.
+// This is both ARGB32 -> RGBA8888 and RGBA8888 -> ARGB32 on little endian.
+template<bool SetAlpha>
+static inline void qt_convert_swap_rb_ssse3(quint32 *dst, const quint32 *src, int len)
+{
+    const __m128i shuffleMask = _mm_set_epi8(15, 12, 13, 14, 11, 8, 9, 10, 7, 4, 5, 6, 3, 0, 1, 2);
+    const __m128i alphaMask = _mm_set1_epi32(SetAlpha ? 0xff000000 : 0);
+
+    int i = 0;
+    for (; i < len - 3; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        v = _mm_shuffle_epi8(v, shuffleMask);
+        if (SetAlpha)
+            v = _mm_or_si128(v, alphaMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+    }
+    for (; i < len; ++i) {
+        const quint32 p = src[i];
+        const quint32 ag = p & 0xff00ff00;
+        const quint32 rb = p & 0x00ff00ff;
+        dst[i] = ag | (rb << 16) | (rb >> 16) | (SetAlpha ? 0xff000000 : 0);
+    }
+}
+
+template<bool SetAlpha>
+static void convert_swap_rb_ssse3(QImageData *dest, const QImageData *src)
+{
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    const uchar *src_data = src->data;
+    uchar *dest_data = dest->data;
+
+    for (int i = 0; i < src->height; ++i) {
+        qt_convert_swap_rb_ssse3<SetAlpha>(reinterpret_cast<quint32 *>(dest_data),
+                                           reinterpret_cast<const quint32 *>(src_data), src->width);
+        src_data += src->bytes_per_line;
+        dest_data += dest->bytes_per_line;
+    }
+}
+
+void convert_ARGB_to_RGBA_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_ARGB32 || src->format == QImage::Format_ARGB32_Premultiplied
+             || src->format == QImage::Format_RGBX8888 || src->format == QImage::Format_RGBA8888
+             || src->format == QImage::Format_RGBA8888_Premultiplied);
+    convert_swap_rb_ssse3<false>(dest, src);
+}
+
+void convert_ARGB_to_RGBx_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_ARGB32 || src->format == QImage::Format_RGBX8888
+             || src->format == QImage::Format_RGBA8888);
+    Q_ASSERT(dest->format == QImage::Format_RGBX8888 || dest->format == QImage::Format_RGB32);
+    convert_swap_rb_ssse3<true>(dest, src);
+}
+
+// Convert a scanline of RGB32 (src) to Grayscale8 (dst), using the same weights as qGray()
+static inline void qt_convert_rgb32_to_grayscale8_ssse3(uchar *dst, const quint32 *src, int len)
+{
+    // Per pixel: b * 5 + g * 16 in the first dword, r * 11 in the second.
+    const __m128i weights = _mm_set_epi16(0, 11, 16, 5, 0, 11, 16, 5);
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i < len - 15; i += 16) {
+        __m128i gray[4];
+        for (int j = 0; j < 4; ++j) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i) + j);
+            const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights);
+            const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights);
+            gray[j] = _mm_srli_epi32(_mm_hadd_epi32(lo, hi), 5);
+        }
+        const __m128i words0 = _mm_packs_epi32(gray[0], gray[1]);
+        const __m128i words1 = _mm_packs_epi32(gray[2], gray[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(words0, words1));
+    }
+    for (; i < len; ++i)
+        dst[i] = qGray(src[i]);
+}
+
+void convert_RGB32_to_Grayscale8_ssse3(QImageData *dest, const QImageData *src, Qt::ImageConversionFlags)
+{
+    Q_ASSERT(src->format == QImage::Format_RGB32);
+    Q_ASSERT(dest->format == QImage::Format_Grayscale8);
+    Q_ASSERT(src->width == dest->width);
+    Q_ASSERT(src->height == dest->height);
+
+    const uchar *src_data = src->data;
+    uchar *dest_data = dest->data;
+
+    for (int i = 0; i < src->height; ++i) {
+        qt_convert_rgb32_to_grayscale8_ssse3(dest_data, reinterpret_cast<const quint32 *>(src_data), src->width);
+        src_data += src->bytes_per_line;
+        dest_data += dest->bytes_per_line;
+    }
+}
+
 QT_END_NAMESPACE
 
 #endif // QT_COMPILER_SUPPORTS_SSSE3
@@ -28,6 +28,7 @@ HEADERS += \
         painting/qpaintengineex_p.h \
         painting/qpaintengine_blitter_p.h \
         painting/qpaintengine_raster_p.h \
+        painting/qrastertilerenderer_p.h \
         painting/qpainter.h \
         painting/qpainter_p.h \
         painting/qpainterpath.h \
@@ -79,6 +80,7 @@ SOURCES += \
         painting/qpaintengineex.cpp \
         painting/qpaintengine_blitter.cpp \
         painting/qpaintengine_raster.cpp \
+        painting/qrastertilerenderer.cpp \
         painting/qpainter.cpp \
         painting/qpainterpath.cpp \
         painting/qpathclipper.cpp \
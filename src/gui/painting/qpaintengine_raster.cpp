@@ -59,6 +59,7 @@
 #include "qrgba64_p.h"
 
 #include "qpaintengine_raster_p.h"
+#include "qrastertilerenderer_p.h"
 //   #include "qbezier_p.h"
 #include "qoutlinemapper_p.h"
 
@@ -268,7 +269,15 @@ static void qt_debug_path(const QPainterPath &path)
 
 QRasterPaintEnginePrivate::QRasterPaintEnginePrivate() :
     QPaintEngineExPrivate(),
-    cachedLines(0)
+    cachedLines(0),
+    tiledRendering(false),
+    replayingTile(false),
+    tileHeight(0),
+    tileGlyphCache(0)
+{
+}
+
+QRasterPaintEnginePrivate::~QRasterPaintEnginePrivate()
 {
 }
 
@@ -450,19 +459,19 @@ bool QRasterPaintEngine::begin(QPaintDevice *device)
 
     QRasterPaintEngineState *s = state();
     ensureOutlineMapper();
-    d->outlineMapper->m_clip_rect = d->deviceRect;
+    d->outlineMapper->m_clip_rect = d->geometryClipRect();
 
     if (d->outlineMapper->m_clip_rect.width() > QT_RASTER_COORD_LIMIT)
         d->outlineMapper->m_clip_rect.setWidth(QT_RASTER_COORD_LIMIT);
     if (d->outlineMapper->m_clip_rect.height() > QT_RASTER_COORD_LIMIT)
         d->outlineMapper->m_clip_rect.setHeight(QT_RASTER_COORD_LIMIT);
 
-    d->rasterizer->setClipRect(d->deviceRect);
+    d->rasterizer->setClipRect(d->geometryClipRect());
 
     s->penData.init(d->rasterBuffer.data(), this);
     s->penData.setup(s->pen.brush(), s->intOpacity, s->composition_mode);
     s->stroker = &d->basicStroker;
-    d->basicStroker.setClipRect(d->deviceRect);
+    d->basicStroker.setClipRect(d->geometryClipRect());
 
     s->brushData.init(d->rasterBuffer.data(), this);
     s->brushData.setup(s->brush, s->intOpacity, s->composition_mode);
@@ -496,6 +505,10 @@ bool QRasterPaintEngine::begin(QPaintDevice *device)
     } else
         d->glyphCacheFormat = QFontEngine::Format_A8;
 
+    // Tiles render a whole QImage each, so other targets are painted directly.
+    if (d->tiledRendering && d->device->devType() == QInternal::Image && systemClip().isEmpty())
+        d->tileRenderer.reset(new QRasterTileRenderer(this, static_cast<QImage *>(d->device), d->tileHeight));
+
     setActive(true);
     return true;
 }
@@ -505,17 +518,56 @@ bool QRasterPaintEngine::begin(QPaintDevice *device)
 */
 bool QRasterPaintEngine::end()
 {
-#ifdef QT_DEBUG_DRAW
     Q_D(QRasterPaintEngine);
+
+#ifdef QT_DEBUG_DRAW
     qDebug() << "QRasterPaintEngine::end devRect:" << d->deviceRect;
     if (d->baseClip) {
         dumpClip(d->rasterBuffer->width(), d->rasterBuffer->height(), &*d->baseClip);
     }
 #endif
 
+    if (d->tileRenderer) {
+        d->tileRenderer->flush();
+        d->tileRenderer.reset();
+    }
+
     return true;
 }
 
+/*!
+    \internal
+
+    Enables or disables deferred, tiled rendering for the next begin().
+
+    While enabled, painting commands on a QImage are recorded rather than
+    executed. When painting ends, the image is split into tiles of \a
+    tileHeight full-width scanlines, and the tiles are rasterized and blended
+    in parallel on the global thread pool. A \a tileHeight of 0 picks a tile
+    height from the image size and the number of threads. The result is
+    pixel-identical to painting directly, but the image content is undefined
+    until QPainter::end() returns.
+
+    Painting on other devices, or with a system clip, is never deferred.
+*/
+void QRasterPaintEngine::setTiledRendering(bool enabled, int tileHeight)
+{
+    Q_D(QRasterPaintEngine);
+    d->tiledRendering = enabled;
+    d->tileHeight = qMax(0, tileHeight);
+}
+
+/*!
+    \internal
+
+    Returns \c true if tiled rendering has been enabled with setTiledRendering().
+*/
+bool QRasterPaintEngine::isTiledRenderingEnabled() const
+{
+    Q_D(const QRasterPaintEngine);
+    return d->tiledRendering;
+}
+
 /*!
     \internal
 */
@@ -634,6 +686,7 @@ QRasterPaintEngineState::QRasterPaintEngineState(QRasterPaintEngineState &s)
     , clip(s.clip)
     , dirty(s.dirty)
     , flag_bits(s.flag_bits)
+    , tileClipOps(s.tileClipOps)
 {
     brushData.tempImage = 0;
     penData.tempImage = 0;
@@ -735,10 +788,10 @@ void QRasterPaintEngine::updatePen(const QPen &pen)
         if (!d->dashStroker)
             d->dashStroker.reset(new QDashStroker(&d->basicStroker));
         if (qt_pen_is_cosmetic(pen, s->renderHints)) {
-            d->dashStroker->setClipRect(d->deviceRect);
+            d->dashStroker->setClipRect(d->geometryClipRect());
         } else {
             // ### I've seen this inverted devrect multiple places now...
-            QRectF clipRect = s->matrix.inverted().mapRect(QRectF(d->deviceRect));
+            QRectF clipRect = s->matrix.inverted().mapRect(QRectF(d->geometryClipRect()));
             d->dashStroker->setClipRect(clipRect);
         }
         d->dashStroker->setDashPattern(pen.dashPattern());
@@ -937,6 +990,10 @@ void QRasterPaintEngine::clipEnabledChanged()
     qDebug() << "QRasterPaintEngine::clipEnabledChanged()" << s->clipEnabled;
 #endif
 
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer)
+        d->tileRenderer->clipEnabledChanged();
+
     if (s->clip) {
         s->clip->enabled = s->clipEnabled;
         s->fillFlags |= DirtyClipEnabled;
@@ -1032,7 +1089,7 @@ void QRasterPaintEnginePrivate::systemStateChanged()
     qDebug() << "systemStateChanged" << this << "deviceRect" << deviceRect << deviceRectUnclipped << systemClip;
 #endif
 
-    exDeviceRect = deviceRect;
+    exDeviceRect = geometryClipRect();
 
     Q_Q(QRasterPaintEngine);
     if (q->state()) {
@@ -1150,6 +1207,7 @@ void QRasterPaintEngine::clip(const QVectorPath &path, Qt::ClipOperation op)
 
     Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
+    QRasterTileClipRecorder tileRecorder(d->tileRenderer.data(), path, op);
 
     // There are some cases that are not supported by clip(QRect)
     if (op != Qt::IntersectClip || !s->clip || s->clip->hasRectClip || s->clip->hasRegionClip) {
@@ -1210,7 +1268,9 @@ void QRasterPaintEngine::clip(const QRect &rect, Qt::ClipOperation op)
     qDebug() << "QRasterPaintEngine::clip(): " << rect << op;
 #endif
 
+    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
+    QRasterTileClipRecorder tileRecorder(d->tileRenderer.data(), rect, op);
 
     if (op == Qt::NoClip) {
         qrasterpaintengine_state_setNoClip(s);
@@ -1287,6 +1347,7 @@ void QRasterPaintEngine::clip(const QRegion &region, Qt::ClipOperation op)
 #endif
 
     Q_D(QRasterPaintEngine);
+    QRasterTileClipRecorder tileRecorder(d->tileRenderer.data(), region, op);
 
     if (region.rectCount() == 1) {
         clip(region.boundingRect(), op);
@@ -1447,10 +1508,15 @@ static void fillRect_normalized(const QRect &r, QSpanData *data,
 */
 void QRasterPaintEngine::drawRects(const QRect *rects, int rectCount)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawRects(rects, rectCount);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug(" - QRasterPaintEngine::drawRect(), rectCount=%d", rectCount);
 #endif
-    Q_D(QRasterPaintEngine);
     ensureRasterState();
     QRasterPaintEngineState *s = state();
 
@@ -1502,11 +1568,16 @@ void QRasterPaintEngine::drawRects(const QRect *rects, int rectCount)
 */
 void QRasterPaintEngine::drawRects(const QRectF *rects, int rectCount)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawRects(rects, rectCount);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug(" - QRasterPaintEngine::drawRect(QRectF*), rectCount=%d", rectCount);
 #endif
 #ifdef QT_FAST_SPANS
-    Q_D(QRasterPaintEngine);
     ensureRasterState();
     QRasterPaintEngineState *s = state();
 
@@ -1556,6 +1627,11 @@ void QRasterPaintEngine::drawRects(const QRectF *rects, int rectCount)
 void QRasterPaintEngine::stroke(const QVectorPath &path, const QPen &pen)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->stroke(path, pen);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
     ensurePen(pen);
@@ -1644,6 +1720,12 @@ QRect QRasterPaintEngine::toNormalizedFillRect(const QRectF &rect)
 */
 void QRasterPaintEngine::fill(const QVectorPath &path, const QBrush &brush)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->fill(path, brush);
+        return;
+    }
+
     if (path.isEmpty())
         return;
 #ifdef QT_DEBUG_DRAW
@@ -1654,7 +1736,6 @@ void QRasterPaintEngine::fill(const QVectorPath &path, const QBrush &brush)
              << rf << brush;
 #endif
 
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
 
     ensureBrush(brush);
@@ -1749,6 +1830,12 @@ void QRasterPaintEngine::fillRect(const QRectF &r, QSpanData *data)
 */
 void QRasterPaintEngine::fillRect(const QRectF &r, const QBrush &brush)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->fillRect(r, brush);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << "QRasterPaintEngine::fillRecct(): " << r << brush;
 #endif
@@ -1766,10 +1853,15 @@ void QRasterPaintEngine::fillRect(const QRectF &r, const QBrush &brush)
 */
 void QRasterPaintEngine::fillRect(const QRectF &r, const QColor &color)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->fillRect(r, color);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << "QRasterPaintEngine::fillRect(): " << r << color;
 #endif
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
 
     d->solid_color_filler.solid.color = qPremultiply(combineAlpha256(color.rgba64(), s->intOpacity));
@@ -1880,6 +1972,11 @@ void QRasterPaintEngine::fillPolygon(const QPointF *points, int pointCount, Poly
 void QRasterPaintEngine::drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPolygon(points, pointCount, mode);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
 #ifdef QT_DEBUG_DRAW
@@ -1922,6 +2019,11 @@ void QRasterPaintEngine::drawPolygon(const QPointF *points, int pointCount, Poly
 void QRasterPaintEngine::drawPolygon(const QPoint *points, int pointCount, PolygonDrawMode mode)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPolygon(points, pointCount, mode);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
 #ifdef QT_DEBUG_DRAW
@@ -1991,34 +2093,35 @@ void QRasterPaintEngine::drawPixmap(const QPointF &pos, const QPixmap &pixmap)
 #endif
 
     QPlatformPixmap *pd = pixmap.handle();
-    if (pd->classId() == QPlatformPixmap::RasterClass) {
-        const QImage &image = static_cast<QRasterPlatformPixmap *>(pd)->image;
-        if (image.depth() == 1) {
-            Q_D(QRasterPaintEngine);
-            QRasterPaintEngineState *s = state();
-            if (s->matrix.type() <= QTransform::TxTranslate) {
-                ensurePen();
-                drawBitmap(pos + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
-            } else {
-                drawImage(pos, d->rasterBuffer->colorizeBitmap(image, s->pen.color()));
-            }
+    if (pd->classId() == QPlatformPixmap::RasterClass)
+        drawPixmapImage(pos, static_cast<QRasterPlatformPixmap *>(pd)->image);
+    else
+        drawPixmapImage(pos, pixmap.toImage());
+}
+
+/*!
+    \internal
+
+    Draws the contents of a pixmap, already converted to \a image, at \a pos.
+*/
+void QRasterPaintEngine::drawPixmapImage(const QPointF &pos, const QImage &image)
+{
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPixmapImage(pos, image);
+        return;
+    }
+
+    if (image.depth() == 1) {
+        QRasterPaintEngineState *s = state();
+        if (s->matrix.type() <= QTransform::TxTranslate) {
+            ensurePen();
+            drawBitmap(pos + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
         } else {
-            QRasterPaintEngine::drawImage(pos, image);
+            drawImage(pos, d->rasterBuffer->colorizeBitmap(image, s->pen.color()));
         }
     } else {
-        const QImage image = pixmap.toImage();
-        if (pixmap.depth() == 1) {
-            Q_D(QRasterPaintEngine);
-            QRasterPaintEngineState *s = state();
-            if (s->matrix.type() <= QTransform::TxTranslate) {
-                ensurePen();
-                drawBitmap(pos + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
-            } else {
-                drawImage(pos, d->rasterBuffer->colorizeBitmap(image, s->pen.color()));
-            }
-        } else {
-            QRasterPaintEngine::drawImage(pos, image);
-        }
+        QRasterPaintEngine::drawImage(pos, image);
     }
 }
 
@@ -2033,41 +2136,40 @@ void QRasterPaintEngine::drawPixmap(const QRectF &r, const QPixmap &pixmap, cons
 
     QPlatformPixmap* pd = pixmap.handle();
     if (pd->classId() == QPlatformPixmap::RasterClass) {
-        const QImage &image = static_cast<QRasterPlatformPixmap *>(pd)->image;
-        if (image.depth() == 1) {
-            Q_D(QRasterPaintEngine);
-            QRasterPaintEngineState *s = state();
-            if (s->matrix.type() <= QTransform::TxTranslate
-                && r.size() == sr.size()
-                && r.size() == pixmap.size()) {
-                ensurePen();
-                drawBitmap(r.topLeft() + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
-                return;
-            } else {
-                drawImage(r, d->rasterBuffer->colorizeBitmap(image, s->pen.color()), sr);
-            }
-        } else {
-            drawImage(r, image, sr);
-        }
+        drawPixmapImage(r, static_cast<QRasterPlatformPixmap *>(pd)->image, sr, pixmap.size());
     } else {
         QRect clippedSource = sr.toAlignedRect().intersected(pixmap.rect());
-        const QImage image = pd->toImage(clippedSource);
-        QRectF translatedSource = sr.translated(-clippedSource.topLeft());
-        if (image.depth() == 1) {
-            Q_D(QRasterPaintEngine);
-            QRasterPaintEngineState *s = state();
-            if (s->matrix.type() <= QTransform::TxTranslate
-                && r.size() == sr.size()
-                && r.size() == pixmap.size()) {
-                ensurePen();
-                drawBitmap(r.topLeft() + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
-                return;
-            } else {
-                drawImage(r, d->rasterBuffer->colorizeBitmap(image, s->pen.color()), translatedSource);
-            }
+        drawPixmapImage(r, pd->toImage(clippedSource), sr.translated(-clippedSource.topLeft()), pixmap.size());
+    }
+}
+
+/*!
+    \internal
+
+    Draws the \a sr part of a pixmap of size \a pixmapSize, already converted
+    to \a image, into \a r.
+*/
+void QRasterPaintEngine::drawPixmapImage(const QRectF &r, const QImage &image, const QRectF &sr,
+                                         const QSize &pixmapSize)
+{
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPixmapImage(r, image, sr, pixmapSize);
+        return;
+    }
+
+    if (image.depth() == 1) {
+        QRasterPaintEngineState *s = state();
+        if (s->matrix.type() <= QTransform::TxTranslate
+            && r.size() == sr.size()
+            && r.size() == pixmapSize) {
+            ensurePen();
+            drawBitmap(r.topLeft() + QPointF(s->matrix.dx(), s->matrix.dy()), image, &s->penData);
         } else {
-            drawImage(r, image, translatedSource);
+            drawImage(r, d->rasterBuffer->colorizeBitmap(image, s->pen.color()), sr);
         }
+    } else {
+        drawImage(r, image, sr);
     }
 }
 
@@ -2094,11 +2196,16 @@ static inline const QRect toAlignedRect_positive(const QRectF &rect)
 */
 void QRasterPaintEngine::drawImage(const QPointF &p, const QImage &img)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawImage(p, img);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << " - QRasterPaintEngine::drawImage(), p=" <<  p << " image=" << img.size() << "depth=" << img.depth();
 #endif
 
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
     qreal scale = img.devicePixelRatio();
 
@@ -2185,6 +2292,12 @@ namespace {
 void QRasterPaintEngine::drawImage(const QRectF &r, const QImage &img, const QRectF &sr,
                                    Qt::ImageConversionFlags)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawImage(r, img, sr);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << " - QRasterPaintEngine::drawImage(), r=" << r << " sr=" << sr << " image=" << img.size() << "depth=" << img.depth();
 #endif
@@ -2192,7 +2305,6 @@ void QRasterPaintEngine::drawImage(const QRectF &r, const QImage &img, const QRe
     if (r.isEmpty())
         return;
 
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
     int sr_l = qFloor(sr.left());
     int sr_r = qCeil(sr.right()) - 1;
@@ -2429,18 +2541,30 @@ void QRasterPaintEngine::drawTiledPixmap(const QRectF &r, const QPixmap &pixmap,
 #ifdef QT_DEBUG_DRAW
     qDebug() << " - QRasterPaintEngine::drawTiledPixmap(), r=" << r << "pixmap=" << pixmap.size();
 #endif
-    Q_D(QRasterPaintEngine);
-    QRasterPaintEngineState *s = state();
+    QPlatformPixmap *pd = pixmap.handle();
+    if (pd->classId() == QPlatformPixmap::RasterClass)
+        drawTiledPixmapImage(r, static_cast<QRasterPlatformPixmap *>(pd)->image, sr);
+    else
+        drawTiledPixmapImage(r, pixmap.toImage(), sr);
+}
 
-    QImage image;
+/*!
+    \internal
 
-    QPlatformPixmap *pd = pixmap.handle();
-    if (pd->classId() == QPlatformPixmap::RasterClass) {
-        image = static_cast<QRasterPlatformPixmap *>(pd)->image;
-    } else {
-        image = pixmap.toImage();
+    Tiles the contents of a pixmap, already converted to \a pixmapImage,
+    inside \a r starting at \a sr.
+*/
+void QRasterPaintEngine::drawTiledPixmapImage(const QRectF &r, const QImage &pixmapImage, const QPointF &sr)
+{
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawTiledPixmapImage(r, pixmapImage, sr);
+        return;
     }
 
+    QRasterPaintEngineState *s = state();
+
+    QImage image = pixmapImage;
     if (image.depth() == 1)
         image = d->rasterBuffer->colorizeBitmap(image, s->pen.color());
 
@@ -2766,17 +2890,11 @@ bool QRasterPaintEngine::drawCachedGlyphs(int numGlyphs, const glyph_t *glyphs,
         }
 
     } else {
-        QFontEngine::GlyphFormat glyphFormat = fontEngine->glyphFormat != QFontEngine::Format_None ? fontEngine->glyphFormat : d->glyphCacheFormat;
+        QFontEngine::GlyphFormat glyphFormat = d->glyphFormat(fontEngine);
 
-        QImageTextureGlyphCache *cache =
-            static_cast<QImageTextureGlyphCache *>(fontEngine->glyphCache(0, glyphFormat, s->matrix));
-        if (!cache) {
-            cache = new QImageTextureGlyphCache(glyphFormat, s->matrix);
-            fontEngine->setGlyphCache(0, cache);
-        }
-
-        cache->populate(fontEngine, numGlyphs, glyphs, positions);
-        cache->fillInPendingGlyphs();
+        QImageTextureGlyphCache *cache = d->populatedGlyphCache(fontEngine, numGlyphs, glyphs, positions);
+        if (!cache)
+            return false;
 
         const QImage &image = cache->image();
         int bpl = image.bytesPerLine();
@@ -2795,7 +2913,9 @@ bool QRasterPaintEngine::drawCachedGlyphs(int numGlyphs, const glyph_t *glyphs,
 
             QFixed subPixelPosition = fontEngine->subPixelPositionForX(positions[i].x);
             QTextureGlyphCache::GlyphAndSubPixelPosition glyph(glyphs[i], subPixelPosition);
-            const QTextureGlyphCache::Coord &c = cache->coords[glyph];
+            // tiles share the cache, so they only look glyphs up
+            const QTextureGlyphCache::Coord c = d->replayingTile ? cache->coords.value(glyph)
+                                                                  : cache->coords[glyph];
             if (c.isNull())
                 continue;
 
@@ -2969,6 +3089,12 @@ static QPair<int, int> visibleGlyphRange(const QRectF &clip, QFontEngine *fontEn
 */
 void QRasterPaintEngine::drawStaticTextItem(QStaticTextItem *textItem)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawStaticTextItem(textItem);
+        return;
+    }
+
     if (textItem->numGlyphs == 0)
         return;
 
@@ -3005,10 +3131,15 @@ void QRasterPaintEngine::drawStaticTextItem(QStaticTextItem *textItem)
 */
 void QRasterPaintEngine::drawTextItem(const QPointF &p, const QTextItem &textItem)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawTextItem(p, textItem);
+        return;
+    }
+
     const QTextItemInt &ti = static_cast<const QTextItemInt &>(textItem);
 
 #ifdef QT_DEBUG_DRAW
-    Q_D(QRasterPaintEngine);
     fprintf(stderr," - QRasterPaintEngine::drawTextItem(), (%.2f,%.2f), string=%s ct=%d\n",
            p.x(), p.y(), QString::fromRawData(ti.chars, ti.num_chars).toLatin1().data(),
            d->glyphCacheFormat);
@@ -3068,6 +3199,11 @@ void QRasterPaintEngine::drawTextItem(const QPointF &p, const QTextItem &textIte
 void QRasterPaintEngine::drawPoints(const QPointF *points, int pointCount)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPoints(points, pointCount);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
     ensurePen();
@@ -3088,6 +3224,11 @@ void QRasterPaintEngine::drawPoints(const QPointF *points, int pointCount)
 void QRasterPaintEngine::drawPoints(const QPoint *points, int pointCount)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawPoints(points, pointCount);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
     ensurePen();
@@ -3109,10 +3250,15 @@ void QRasterPaintEngine::drawPoints(const QPoint *points, int pointCount)
 */
 void QRasterPaintEngine::drawLines(const QLine *lines, int lineCount)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawLines(lines, lineCount);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << " - QRasterPaintEngine::drawLines(QLine*)" << lineCount;
 #endif
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
 
     ensurePen();
@@ -3182,10 +3328,15 @@ void QRasterPaintEnginePrivate::rasterizeLine_dashed(QLineF line,
 */
 void QRasterPaintEngine::drawLines(const QLineF *lines, int lineCount)
 {
+    Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawLines(lines, lineCount);
+        return;
+    }
+
 #ifdef QT_DEBUG_DRAW
     qDebug() << " - QRasterPaintEngine::drawLines(QLineF *)" << lineCount;
 #endif
-    Q_D(QRasterPaintEngine);
     QRasterPaintEngineState *s = state();
 
     ensurePen();
@@ -3210,6 +3361,11 @@ void QRasterPaintEngine::drawLines(const QLineF *lines, int lineCount)
 void QRasterPaintEngine::drawEllipse(const QRectF &rect)
 {
     Q_D(QRasterPaintEngine);
+    if (d->tileRenderer) {
+        d->tileRenderer->drawEllipse(rect);
+        return;
+    }
+
     QRasterPaintEngineState *s = state();
 
     ensurePen();
@@ -3264,6 +3420,39 @@ void QRasterPaintEngine::releaseDC(HDC) const
 
 #endif
 
+/*!
+    \internal
+
+    Returns the glyph cache drawCachedGlyphs() draws \a glyphs at \a positions
+    from, with the current matrix, after adding the ones it doesn't have yet.
+
+    Tiles are painted in parallel and share the font engines, so
+    QRasterTileRenderer fills the cache when it records the text, and tiles
+    get that cache from tileGlyphCache without touching the font engine.
+*/
+QImageTextureGlyphCache *QRasterPaintEnginePrivate::populatedGlyphCache(QFontEngine *fontEngine, int numGlyphs,
+                                                                        const glyph_t *glyphs,
+                                                                        const QFixedPoint *positions)
+{
+    if (replayingTile)
+        return tileGlyphCache;
+
+    Q_Q(QRasterPaintEngine);
+    const QFontEngine::GlyphFormat format = glyphFormat(fontEngine);
+    const QTransform &matrix = q->state()->matrix;
+
+    QImageTextureGlyphCache *cache =
+        static_cast<QImageTextureGlyphCache *>(fontEngine->glyphCache(0, format, matrix));
+    if (!cache) {
+        cache = new QImageTextureGlyphCache(format, matrix);
+        fontEngine->setGlyphCache(0, cache);
+    }
+
+    cache->populate(fontEngine, numGlyphs, glyphs, positions);
+    cache->fillInPendingGlyphs();
+    return cache;
+}
+
 /*!
     \internal
 */
@@ -3430,29 +3619,39 @@ QRect QRasterPaintEngine::clipBoundingRect() const
     return QRect(clip->xmin, clip->ymin, clip->xmax - clip->xmin, clip->ymax - clip->ymin);
 }
 
-void QRasterPaintEnginePrivate::initializeRasterizer(QSpanData *data)
-{
-    Q_Q(QRasterPaintEngine);
-    QRasterPaintEngineState *s = q->state();
-
-    rasterizer->setAntialiased(s->flags.antialiased);
-    rasterizer->setLegacyRoundingEnabled(s->flags.legacy_rounding);
+/*!
+    \internal
 
+    Returns the rectangle the scanline rasterizer clips its input against:
+    the device rectangle intersected with the bounds of the current clip.
+*/
+QRect QRasterPaintEnginePrivate::rasterizerClipRect() const
+{
     QRect clipRect(deviceRect);
-    ProcessSpans blend;
     // ### get from optimized rectbased QClipData
-
     const QClipData *c = clip();
     if (c) {
         const QRect r(QPoint(c->xmin, c->ymin),
                       QSize(c->xmax - c->xmin, c->ymax - c->ymin));
         clipRect = clipRect.intersected(r);
-        blend = data->blend;
-    } else {
-        blend = data->unclipped_blend;
     }
+    return clipRect;
+}
+
+void QRasterPaintEnginePrivate::initializeRasterizer(QSpanData *data)
+{
+    Q_Q(QRasterPaintEngine);
+    QRasterPaintEngineState *s = q->state();
+
+    rasterizer->setAntialiased(s->flags.antialiased);
+    rasterizer->setLegacyRoundingEnabled(s->flags.legacy_rounding);
+
+    // When replaying a band of a deferred frame, clip the input exactly as
+    // the recording engine would have, so that lines and edges that cross
+    // the band boundaries are rounded identically.
+    rasterizer->setClipRect(replayingTile ? tileRasterizerClip : rasterizerClipRect());
 
-    rasterizer->setClipRect(clipRect);
+    ProcessSpans blend = clip() ? data->blend : data->unclipped_blend;
     rasterizer->initialize(blend, data);
 }
 
@@ -3502,7 +3701,7 @@ void QRasterPaintEnginePrivate::rasterize(QT_FT_Outline *outline,
     if (!s->flags.antialiased) {
         rasterizer->setAntialiased(s->flags.antialiased);
         rasterizer->setLegacyRoundingEnabled(s->flags.legacy_rounding);
-        rasterizer->setClipRect(deviceRect);
+        rasterizer->setClipRect(geometryClipRect());
         rasterizer->initialize(callback, userData);
 
         const Qt::FillRule fillRule = outline->flags == QT_FT_OUTLINE_NONE
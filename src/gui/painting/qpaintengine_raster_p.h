@@ -64,6 +64,7 @@ class QOutlineMapper;
 class QRasterPaintEnginePrivate;
 class QRasterBuffer;
 class QClipData;
+class QRasterTileRenderer;
 
 class QRasterPaintEngineState : public QPainterState
 {
@@ -113,6 +114,10 @@ public:
         Flags flags;
         uint flag_bits;
     };
+
+    // Clip operations leading to the current clip, as indexes into the
+    // operations recorded by QRasterTileRenderer. Only used while recording.
+    QVector<int> tileClipOps;
 };
 
 
@@ -173,6 +178,10 @@ public:
     void drawImage(const QRectF &r, const QImage &pm, const QRectF &sr,
                    Qt::ImageConversionFlags flags = Qt::AutoColor);
     void drawTiledPixmap(const QRectF &r, const QPixmap &pm, const QPointF &sr);
+    void drawPixmapImage(const QPointF &pos, const QImage &image);
+    void drawPixmapImage(const QRectF &r, const QImage &image, const QRectF &sr, const QSize &pixmapSize);
+    void drawTiledPixmapImage(const QRectF &r, const QImage &pixmapImage, const QPointF &sr);
+
     void drawTextItem(const QPointF &p, const QTextItem &textItem);
 
     void drawLines(const QLine *line, int lineCount);
@@ -226,12 +235,16 @@ public:
     bool requiresPretransformedGlyphPositions(QFontEngine *fontEngine, const QTransform &m) const;
     bool shouldDrawCachedGlyphs(QFontEngine *fontEngine, const QTransform &m) const;
 
+    void setTiledRendering(bool enabled, int tileHeight = 0);
+    bool isTiledRenderingEnabled() const;
+
 protected:
     QRasterPaintEngine(QRasterPaintEnginePrivate &d, QPaintDevice *);
 private:
     friend struct QSpanData;
     friend class QBlitterPaintEngine;
     friend class QBlitterPaintEnginePrivate;
+    friend class QRasterTileRenderer;
     void init();
 
     void fillRect(const QRectF &rect, QSpanData *data);
@@ -272,6 +285,7 @@ class QRasterPaintEnginePrivate : public QPaintEngineExPrivate
     Q_DECLARE_PUBLIC(QRasterPaintEngine)
 public:
     QRasterPaintEnginePrivate();
+    ~QRasterPaintEnginePrivate();
 
     void rasterizeLine_dashed(QLineF line, qreal width,
                               int *dashIndex, qreal *dashOffset, bool *inDash);
@@ -301,11 +315,20 @@ public:
 
     inline const QClipData *clip() const;
 
+    QRect rasterizerClipRect() const;
+    inline QRect geometryClipRect() const;
     void initializeRasterizer(QSpanData *data);
 
     void recalculateFastImages();
     bool canUseFastImageBlending(QPainter::CompositionMode mode, const QImage &image) const;
 
+    QFontEngine::GlyphFormat glyphFormat(QFontEngine *fontEngine) const
+    {
+        return fontEngine->glyphFormat != QFontEngine::Format_None ? fontEngine->glyphFormat : glyphCacheFormat;
+    }
+    QImageTextureGlyphCache *populatedGlyphCache(QFontEngine *fontEngine, int numGlyphs,
+                                                 const glyph_t *glyphs, const QFixedPoint *positions);
+
     QPaintDevice *device;
     QScopedPointer<QOutlineMapper> outlineMapper;
     QScopedPointer<QRasterBuffer>  rasterBuffer;
@@ -336,8 +359,15 @@ public:
 
     uint mono_surface : 1;
     uint outlinemapper_xform_dirty : 1;
+    uint tiledRendering : 1;
+    uint replayingTile : 1;
 
     QScopedPointer<QRasterizer> rasterizer;
+
+    int tileHeight;
+    QScopedPointer<QRasterTileRenderer> tileRenderer;
+    QRect tileRasterizerClip;
+    QImageTextureGlyphCache *tileGlyphCache;
 };
 
 
@@ -481,6 +511,16 @@ inline const QClipData *QRasterPaintEnginePrivate::clip() const {
     return baseClip.data();
 }
 
+/*
+    While a tile replays deferred commands its device rect is the tile, but
+    everything that depends on where geometry gets cut off has to see the
+    whole device so that all tiles produce exactly the same pixels.
+*/
+inline QRect QRasterPaintEnginePrivate::geometryClipRect() const
+{
+    return replayingTile ? deviceRectUnclipped : deviceRect;
+}
+
 inline const QClipData *QRasterPaintEngine::clipData() const {
     Q_D(const QRasterPaintEngine);
     if (state() && state()->clip && state()->clip->enabled)
@@ -0,0 +1,1183 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qrastertilerenderer_p.h"
+
+#include <QtCore/qmath.h>
+#include <QtCore/qnumeric.h>
+#include <QtGui/qpainter.h>
+#include <qpa/qplatformintegration.h>
+
+#ifndef QT_NO_THREAD
+#include <QtCore/qatomic.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#endif
+
+#include <private/qpaintengine_raster_p.h>
+#include <private/qvectorpath_p.h>
+#include <private/qtextengine_p.h>
+#include <private/qfontengine_p.h>
+#include <private/qstatictext_p.h>
+#include <private/qguiapplication_p.h>
+
+QT_BEGIN_NAMESPACE
+
+extern bool qHasPixmapTexture(const QBrush &);
+
+/*
+    The painter state a command is replayed with. A new state is only
+    recorded when something changed since the previous command.
+*/
+struct QRasterTileState
+{
+    QPen pen;
+    QBrush brush;
+    QPointF brushOrigin;
+    qreal opacity;
+    QPainter::CompositionMode compositionMode;
+    QPainter::RenderHints renderHints;
+    QTransform matrix;
+    QFont font;
+    bool clipEnabled;
+    QVector<int> clipOps;
+    QRect rasterizerClip;
+};
+
+/*
+    A deep copy of a QVectorPath, which usually points into memory owned by
+    the caller.
+*/
+struct QRasterTileVectorPath
+{
+    QRasterTileVectorPath(const QVectorPath &path)
+        : count(path.elementCount()),
+          hints(path.hints() & ~(QVectorPath::IsCachedHint | QVectorPath::ShouldUseCacheHint
+                                 | QVectorPath::ControlPointRect)),
+          hasPoints(path.points() != 0)
+    {
+        if (hasPoints) {
+            points.resize(count * 2);
+            memcpy(points.data(), path.points(), count * 2 * sizeof(qreal));
+        }
+        if (path.elements()) {
+            elements.resize(count);
+            memcpy(elements.data(), path.elements(), count * sizeof(QPainterPath::ElementType));
+        }
+    }
+
+    const qreal *pointData() const { return hasPoints ? points.constData() : 0; }
+    const QPainterPath::ElementType *elementData() const
+    { return elements.isEmpty() ? 0 : elements.constData(); }
+
+    QVector<qreal> points;
+    QVector<QPainterPath::ElementType> elements;
+    int count;
+    uint hints;
+    bool hasPoints;
+};
+
+class QRasterTileClipOp
+{
+public:
+    enum Type {
+        Path,
+        Rect,
+        Region,
+        Enabled
+    };
+
+    QRasterTileClipOp(const QVectorPath &p, Qt::ClipOperation o)
+        : type(Path), op(o), path(new QRasterTileVectorPath(p)) {}
+    QRasterTileClipOp(const QRect &r, Qt::ClipOperation o)
+        : type(Rect), op(o), rect(r) {}
+    QRasterTileClipOp(const QRegion &region, Qt::ClipOperation o)
+        : type(Region), op(o), rects(region.rects()) {}
+    QRasterTileClipOp()
+        : type(Enabled), op(Qt::NoClip) {}
+
+    void replay(QRasterPaintEngine *engine) const
+    {
+        switch (type) {
+        case Path:
+        {
+            const QVectorPath vectorPath(path->pointData(), path->count, path->elementData(), path->hints);
+            engine->clip(vectorPath, op);
+            break;
+        }
+        case Rect:
+            engine->clip(rect, op);
+            break;
+        case Region: {
+            // QRegion fills in its rectangles lazily, so every tile gets
+            // a region of its own.
+            QRegion region;
+            region.setRects(rects.constData(), rects.size());
+            engine->clip(region, op);
+            break;
+        }
+        case Enabled:
+            engine->clipEnabledChanged();
+            break;
+        }
+    }
+
+    Type type;
+    Qt::ClipOperation op;
+    QTransform matrix;
+    QPainter::RenderHints renderHints;
+    bool clipEnabled;
+
+    QScopedPointer<QRasterTileVectorPath> path;
+    QRect rect;
+    QVector<QRect> rects;
+};
+
+/*
+    A recorded drawing command. It owns copies of all its arguments and
+    covers the device scanlines top to bottom.
+*/
+class QRasterTileCommand
+{
+public:
+    enum Mode {
+        // Paints the same pixels wherever the tiles cut it
+        AnyTiles,
+        // Paints differently when a tile cuts off its top, so it is painted
+        // on its own when it spans more than one tile
+        OneTile,
+        // Is always painted on its own, through the whole clip and on the
+        // thread that recorded it
+        OnItsOwn
+    };
+
+    QRasterTileCommand() : mode(AnyTiles) {}
+    virtual ~QRasterTileCommand() {}
+    virtual void replay(QRasterPaintEngine *engine) const = 0;
+
+    int state;
+    int top;
+    int bottom;
+    Mode mode;
+    // The glyph cache text is drawn from, filled while recording
+    QExplicitlySharedDataPointer<QImageTextureGlyphCache> glyphCache;
+};
+
+template <typename T>
+static inline QVector<T> qt_tile_copy(const T *data, int count)
+{
+    QVector<T> copy(count);
+    if (count)
+        memcpy(copy.data(), data, count * sizeof(T));
+    return copy;
+}
+
+namespace {
+
+template <typename Point>
+class PolygonCommand : public QRasterTileCommand
+{
+public:
+    PolygonCommand(const Point *points, int pointCount, QPaintEngine::PolygonDrawMode mode)
+        : m_points(qt_tile_copy(points, pointCount)), m_mode(mode) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawPolygon(m_points.constData(), m_points.size(), m_mode); }
+
+private:
+    QVector<Point> m_points;
+    QPaintEngine::PolygonDrawMode m_mode;
+};
+
+template <typename Rect>
+class RectsCommand : public QRasterTileCommand
+{
+public:
+    RectsCommand(const Rect *rects, int rectCount) : m_rects(qt_tile_copy(rects, rectCount)) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawRects(m_rects.constData(), m_rects.size()); }
+
+private:
+    QVector<Rect> m_rects;
+};
+
+template <typename Line>
+class LinesCommand : public QRasterTileCommand
+{
+public:
+    LinesCommand(const Line *lines, int lineCount) : m_lines(qt_tile_copy(lines, lineCount)) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawLines(m_lines.constData(), m_lines.size()); }
+
+private:
+    QVector<Line> m_lines;
+};
+
+template <typename Point>
+class PointsCommand : public QRasterTileCommand
+{
+public:
+    PointsCommand(const Point *points, int pointCount) : m_points(qt_tile_copy(points, pointCount)) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawPoints(m_points.constData(), m_points.size()); }
+
+private:
+    QVector<Point> m_points;
+};
+
+class EllipseCommand : public QRasterTileCommand
+{
+public:
+    EllipseCommand(const QRectF &rect) : m_rect(rect) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawEllipse(m_rect); }
+
+private:
+    QRectF m_rect;
+};
+
+class FillRectBrushCommand : public QRasterTileCommand
+{
+public:
+    FillRectBrushCommand(const QRectF &rect, const QBrush &brush) : m_rect(rect), m_brush(brush) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->fillRect(m_rect, m_brush); }
+
+private:
+    QRectF m_rect;
+    QBrush m_brush;
+};
+
+class FillRectColorCommand : public QRasterTileCommand
+{
+public:
+    FillRectColorCommand(const QRectF &rect, const QColor &color) : m_rect(rect), m_color(color) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->fillRect(m_rect, m_color); }
+
+private:
+    QRectF m_rect;
+    QColor m_color;
+};
+
+class StrokeCommand : public QRasterTileCommand
+{
+public:
+    StrokeCommand(const QVectorPath &path, const QPen &pen) : m_path(path), m_pen(pen) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    {
+        const QVectorPath path(m_path.pointData(), m_path.count, m_path.elementData(), m_path.hints);
+        engine->stroke(path, m_pen);
+    }
+
+private:
+    QRasterTileVectorPath m_path;
+    QPen m_pen;
+};
+
+class FillCommand : public QRasterTileCommand
+{
+public:
+    FillCommand(const QVectorPath &path, const QBrush &brush) : m_path(path), m_brush(brush) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    {
+        const QVectorPath path(m_path.pointData(), m_path.count, m_path.elementData(), m_path.hints);
+        engine->fill(path, m_brush);
+    }
+
+private:
+    QRasterTileVectorPath m_path;
+    QBrush m_brush;
+};
+
+class ImageCommand : public QRasterTileCommand
+{
+public:
+    ImageCommand(const QPointF &pos, const QImage &image)
+        : m_target(pos, QSizeF()), m_image(image), m_scaled(false) {}
+    ImageCommand(const QRectF &r, const QImage &image, const QRectF &sr)
+        : m_target(r), m_image(image), m_source(sr), m_scaled(true) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    {
+        if (m_scaled)
+            engine->drawImage(m_target, m_image, m_source);
+        else
+            engine->drawImage(m_target.topLeft(), m_image);
+    }
+
+private:
+    QRectF m_target;
+    QImage m_image;
+    QRectF m_source;
+    bool m_scaled;
+};
+
+class PixmapImageCommand : public QRasterTileCommand
+{
+public:
+    PixmapImageCommand(const QPointF &pos, const QImage &image)
+        : m_target(pos, QSizeF()), m_image(image), m_scaled(false) {}
+    PixmapImageCommand(const QRectF &r, const QImage &image, const QRectF &sr, const QSize &pixmapSize)
+        : m_target(r), m_image(image), m_source(sr), m_pixmapSize(pixmapSize), m_scaled(true) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    {
+        if (m_scaled)
+            engine->drawPixmapImage(m_target, m_image, m_source, m_pixmapSize);
+        else
+            engine->drawPixmapImage(m_target.topLeft(), m_image);
+    }
+
+private:
+    QRectF m_target;
+    QImage m_image;
+    QRectF m_source;
+    QSize m_pixmapSize;
+    bool m_scaled;
+};
+
+class TiledPixmapImageCommand : public QRasterTileCommand
+{
+public:
+    TiledPixmapImageCommand(const QRectF &r, const QImage &image, const QPointF &sr)
+        : m_target(r), m_image(image), m_source(sr) {}
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawTiledPixmapImage(m_target, m_image, m_source); }
+
+private:
+    QRectF m_target;
+    QImage m_image;
+    QPointF m_source;
+};
+
+static inline QGlyphLayout qt_tile_copy_glyphs(const QGlyphLayout &glyphs, char *buffer)
+{
+    const int n = glyphs.numGlyphs;
+    QGlyphLayout copy(buffer, n);
+    if (n) {
+        memcpy(copy.offsets, glyphs.offsets, n * sizeof(QFixedPoint));
+        memcpy(copy.glyphs, glyphs.glyphs, n * sizeof(glyph_t));
+        memcpy(copy.advances, glyphs.advances, n * sizeof(QFixed));
+        memcpy(copy.justifications, glyphs.justifications, n * sizeof(QGlyphJustification));
+        memcpy(copy.attributes, glyphs.attributes, n * sizeof(QGlyphAttributes));
+    }
+    return copy;
+}
+
+class TextItemCommand : public QRasterTileCommand
+{
+public:
+    TextItemCommand(const QPointF &pos, const QTextItemInt &ti)
+        : m_pos(pos),
+          m_font(ti.f ? *ti.f : QFont()),
+          m_chars(ti.chars, ti.chars ? ti.num_chars : 0),
+          m_logClusters(ti.logClusters ? qt_tile_copy(ti.logClusters, ti.num_chars)
+                                       : QVector<unsigned short>()),
+          m_glyphBuffer(ti.glyphs.numGlyphs * QGlyphLayout::SpaceNeeded, Qt::Uninitialized),
+          m_item(qt_tile_copy_glyphs(ti.glyphs, m_glyphBuffer.data()), ti.f ? &m_font : 0,
+                 ti.chars ? m_chars.constData() : 0, ti.num_chars, ti.fontEngine, ti.charFormat)
+    {
+        m_item.descent = ti.descent;
+        m_item.ascent = ti.ascent;
+        m_item.width = ti.width;
+        m_item.flags = ti.flags;
+        m_item.justified = ti.justified;
+        m_item.underlineStyle = ti.underlineStyle;
+        m_item.logClusters = ti.logClusters ? m_logClusters.constData() : 0;
+        if (m_item.fontEngine)
+            m_item.fontEngine->ref.ref();
+    }
+
+    ~TextItemCommand()
+    {
+        if (m_item.fontEngine && !m_item.fontEngine->ref.deref())
+            delete m_item.fontEngine;
+    }
+
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawTextItem(m_pos, m_item); }
+
+private:
+    QPointF m_pos;
+    QFont m_font;
+    QString m_chars;
+    QVector<unsigned short> m_logClusters;
+    QByteArray m_glyphBuffer;
+    QTextItemInt m_item;
+};
+
+class StaticTextItemCommand : public QRasterTileCommand
+{
+public:
+    StaticTextItemCommand(const QStaticTextItem &item)
+        : m_glyphs(qt_tile_copy(item.glyphs, item.numGlyphs)),
+          m_positions(qt_tile_copy(item.glyphPositions, item.numGlyphs)),
+          m_item(item)
+    {
+        m_item.glyphs = m_glyphs.data();
+        m_item.glyphPositions = m_positions.data();
+    }
+
+    void replay(QRasterPaintEngine *engine) const Q_DECL_OVERRIDE
+    { engine->drawStaticTextItem(&m_item); }
+
+private:
+    QVector<glyph_t> m_glyphs;
+    QVector<QFixedPoint> m_positions;
+    mutable QStaticTextItem m_item;
+};
+
+#ifndef QT_NO_THREAD
+class TileJob : public QRunnable
+{
+public:
+    TileJob(QRasterTileRenderer *renderer)
+        : m_renderer(renderer), m_nextTile(0)
+    {
+        // The same runnable is started on several pool threads at once.
+        setAutoDelete(false);
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        renderTiles();
+        m_finished.release();
+    }
+
+    void renderTiles()
+    {
+        int tile;
+        while ((tile = m_nextTile.fetchAndAddRelaxed(1)) < m_renderer->tileCount())
+            m_renderer->renderTile(tile);
+    }
+
+    void waitForHelpers(int helperCount) { m_finished.acquire(helperCount); }
+
+private:
+    QRasterTileRenderer *m_renderer;
+    QAtomicInt m_nextTile;
+    QSemaphore m_finished;
+};
+#endif // QT_NO_THREAD
+
+struct Bounds
+{
+    Bounds() : x1(qInf()), y1(qInf()), x2(-qInf()), y2(-qInf()) {}
+
+    inline void add(qreal x, qreal y)
+    {
+        x1 = qMin(x1, x);
+        x2 = qMax(x2, x);
+        y1 = qMin(y1, y);
+        y2 = qMax(y2, y);
+    }
+    inline void add(const QPointF &p) { add(p.x(), p.y()); }
+    inline void add(const QPoint &p) { add(p.x(), p.y()); }
+    inline void add(const QLineF &l) { add(l.p1()); add(l.p2()); }
+    inline void add(const QLine &l) { add(l.p1()); add(l.p2()); }
+    inline void add(const QRectF &r) { add(r.topLeft()); add(r.bottomRight()); }
+    inline void add(const QRect &r) { add(QRectF(r)); }
+
+    QRectF rect() const { return x1 <= x2 ? QRectF(x1, y1, x2 - x1, y2 - y1) : QRectF(); }
+
+    qreal x1, y1, x2, y2;
+};
+
+template <typename T>
+static QRectF qt_tile_bounds(const T *items, int count)
+{
+    Bounds bounds;
+    for (int i = 0; i < count; ++i)
+        bounds.add(items[i]);
+    return bounds.rect();
+}
+
+static inline void qt_tile_prime_brush(const QBrush &brush, bool *usesPixmaps)
+{
+    if (brush.style() == Qt::TexturePattern) {
+        // Converts a pixmap texture once, here, rather than on every tile.
+        brush.textureImage();
+        if (qHasPixmapTexture(brush))
+            *usesPixmaps = true;
+    }
+}
+
+/*
+    Fills the glyph cache the engine of \a d draws \a glyphs at the device
+    \a positions from, so that the tiles only read it, and returns it with
+    the device scanlines the glyphs cover in \a top and \a bottom.
+*/
+static QImageTextureGlyphCache *qt_tile_populate_glyphs(QRasterPaintEnginePrivate *d, QFontEngine *fontEngine,
+                                                        int numGlyphs, const glyph_t *glyphs,
+                                                        const QFixedPoint *positions, int *top, int *bottom)
+{
+    QImageTextureGlyphCache *cache = d->populatedGlyphCache(fontEngine, numGlyphs, glyphs, positions);
+    if (!cache)
+        return 0;
+
+    // The same placement as QRasterPaintEngine::drawCachedGlyphs()
+    const int margin = fontEngine->glyphMargin(d->glyphFormat(fontEngine));
+    *top = INT_MAX;
+    *bottom = INT_MIN;
+    for (int i = 0; i < numGlyphs; ++i) {
+        const QFixed subPixelPosition = fontEngine->subPixelPositionForX(positions[i].x);
+        const QTextureGlyphCache::Coord c =
+                cache->coords.value(QTextureGlyphCache::GlyphAndSubPixelPosition(glyphs[i], subPixelPosition));
+        if (c.isNull())
+            continue;
+        const int y = qRound(positions[i].y) - c.baseLineY - margin;
+        *top = qMin(*top, y);
+        *bottom = qMax(*bottom, y + c.h - 1);
+    }
+    return cache;
+}
+
+} // namespace
+
+/*!
+    \class QRasterTileRenderer
+    \internal
+    \since 5.6
+
+    \brief The QRasterTileRenderer class records the painting commands of a
+    QRasterPaintEngine and replays them in horizontal tiles.
+
+    Each tile is a band of full scanlines of the target image, painted by a
+    raster engine of its own that is clipped to the band. A band renders
+    exactly the pixels that painting directly would, since everything that
+    depends on how geometry is cut off, like the spans a gradient or texture
+    is fetched for, sees the whole device. The bands are painted in
+    parallel on the global thread pool.
+
+    The few commands whose output still depends on the clip they are
+    painted through, or that draw through a font engine, are painted on
+    their own instead, in order with the bands painted before and after
+    them.
+*/
+
+QRasterTileRenderer::QRasterTileRenderer(QRasterPaintEngine *engine, QImage *image, int tileHeight)
+    : m_engine(engine),
+      m_image(image),
+      m_tileHeight(tileHeight),
+      m_clipDepth(0),
+      m_usesPixmaps(false)
+{
+    engine->state()->tileClipOps.clear();
+}
+
+QRasterTileRenderer::~QRasterTileRenderer()
+{
+    qDeleteAll(m_commands);
+    qDeleteAll(m_clipOps);
+    qDeleteAll(m_states);
+}
+
+qreal QRasterTileRenderer::penPadding(const QPen &pen) const
+{
+    if (pen.style() == Qt::NoPen)
+        return 0;
+
+    const QRasterPaintEngineState *s = m_engine->state();
+    qreal padding = pen.widthF();
+    if (padding == 0)
+        padding = 1;
+    if (pen.joinStyle() == Qt::MiterJoin || pen.joinStyle() == Qt::SvgMiterJoin)
+        padding *= qMax(pen.miterLimit(), qreal(1));
+    if (!qt_pen_is_cosmetic(pen, s->renderHints)) {
+        const QTransform &m = s->matrix;
+        padding *= qSqrt(m.m11() * m.m11() + m.m12() * m.m12() + m.m21() * m.m21() + m.m22() * m.m22());
+    }
+    return padding + 1;
+}
+
+int QRasterTileRenderer::currentState()
+{
+    const QRasterPaintEngineState *s = m_engine->state();
+    const QRect rasterizerClip = m_engine->d_func()->rasterizerClipRect();
+    // The clip may have been disabled through a state sharing it
+    const bool clipEnabled = s->clip ? bool(s->clip->enabled) : s->clipEnabled;
+
+    if (!m_states.isEmpty()) {
+        const QRasterTileState *last = m_states.last();
+        if (qpen_fast_equals(last->pen, s->pen)
+            && qbrush_fast_equals(last->brush, s->brush)
+            && last->brushOrigin == s->brushOrigin
+            && last->opacity == s->opacity
+            && last->compositionMode == s->composition_mode
+            && last->renderHints == s->renderHints
+            && last->matrix == s->matrix
+            && last->clipEnabled == clipEnabled
+            && last->clipOps == s->tileClipOps
+            && last->rasterizerClip == rasterizerClip
+            && last->font == s->font) {
+            return m_states.size() - 1;
+        }
+    }
+
+    QRasterTileState *state = new QRasterTileState;
+    state->pen = s->pen;
+    state->brush = s->brush;
+    state->brushOrigin = s->brushOrigin;
+    state->opacity = s->opacity;
+    state->compositionMode = s->composition_mode;
+    state->renderHints = s->renderHints;
+    state->matrix = s->matrix;
+    state->font = s->font;
+    state->clipEnabled = clipEnabled;
+    state->clipOps = s->tileClipOps;
+    state->rasterizerClip = rasterizerClip;
+    qt_tile_prime_brush(state->pen.brush(), &m_usesPixmaps);
+    qt_tile_prime_brush(state->brush, &m_usesPixmaps);
+    m_states.append(state);
+    return m_states.size() - 1;
+}
+
+/*
+    Adds \a command for the device scanlines covered by \a rect in logical
+    coordinates, grown by \a padding device pixels.
+*/
+void QRasterTileRenderer::addCommand(QRasterTileCommand *command, const QRectF &rect, qreal padding)
+{
+    const QRect deviceRect = m_engine->d_func()->deviceRect;
+    const QTransform &matrix = m_engine->state()->matrix;
+    if (matrix.type() >= QTransform::TxProject) {
+        addCommand(command, deviceRect.top(), deviceRect.bottom());
+        return;
+    }
+
+    const QRectF mapped = matrix.mapRect(rect);
+    // Leave room for antialiasing and rounding
+    const qreal top = mapped.top() - padding - 2;
+    const qreal bottom = mapped.bottom() + padding + 2;
+    if (!qIsFinite(top) || !qIsFinite(bottom)) {
+        addCommand(command, deviceRect.top(), deviceRect.bottom());
+        return;
+    }
+
+    addCommand(command,
+               qFloor(qBound(qreal(deviceRect.top() - 1), top, qreal(deviceRect.bottom() + 1))),
+               qCeil(qBound(qreal(deviceRect.top() - 1), bottom, qreal(deviceRect.bottom() + 1))));
+}
+
+/*
+    Adds \a command, which strokes with \a pen, for the device scanlines
+    covered by \a rect in logical coordinates.
+*/
+void QRasterTileRenderer::addCommand(QRasterTileCommand *command, const QRectF &rect, const QPen &pen)
+{
+    // The cosmetic stroker blends into rectangular clips directly, which
+    // rounds differently than blending through the spans of other clips.
+    // The part of such a clip that falls into a tile may be a rectangle.
+    const QClipData *clip = m_engine->d_func()->clip();
+    if (pen.style() != Qt::NoPen && clip && !clip->hasRectClip)
+        command->mode = QRasterTileCommand::OnItsOwn;
+    addCommand(command, rect, penPadding(pen));
+}
+
+/*
+    Adds \a command, which draws \a image to \a rect in logical coordinates,
+    \a stretched or not.
+*/
+void QRasterTileRenderer::addImageCommand(QRasterTileCommand *command, const QRectF &rect, const QImage &image,
+                                          bool stretched)
+{
+    // The engine blits scaled and transformed images starting with the
+    // first row inside the clip.
+    const QRasterPaintEngineState *s = m_engine->state();
+    if ((stretched || s->matrix.type() > QTransform::TxTranslate)
+        && m_engine->d_func()->canUseFastImageBlending(s->composition_mode, image)) {
+        command->mode = QRasterTileCommand::OneTile;
+    }
+    addCommand(command, rect, 1);
+}
+
+/*
+    Adds \a command, which draws \a glyphs at the device \a positions with
+    \a fontEngine, for the device scanlines the glyphs cover.
+*/
+void QRasterTileRenderer::addGlyphsCommand(QRasterTileCommand *command, QFontEngine *fontEngine, int numGlyphs,
+                                           const glyph_t *glyphs, const QFixedPoint *positions)
+{
+    int top;
+    int bottom;
+    command->glyphCache = qt_tile_populate_glyphs(m_engine->d_func(), fontEngine, numGlyphs, glyphs, positions,
+                                                  &top, &bottom);
+    if (!command->glyphCache || top > bottom) {
+        // None of the glyphs has any pixels
+        delete command;
+        return;
+    }
+    addCommand(command, top, bottom);
+}
+
+/*
+    Adds \a command to be painted on its own, for the whole device.
+*/
+void QRasterTileRenderer::addCommandOnItsOwn(QRasterTileCommand *command)
+{
+    const QRect deviceRect = m_engine->d_func()->deviceRect;
+    command->mode = QRasterTileCommand::OnItsOwn;
+    addCommand(command, deviceRect.top(), deviceRect.bottom());
+}
+
+void QRasterTileRenderer::addCommand(QRasterTileCommand *command, int top, int bottom)
+{
+    const QRect clip = m_engine->clipBoundingRect();
+    top = qMax(top, clip.top());
+    bottom = qMin(bottom, clip.bottom());
+    if (top > bottom || clip.isEmpty()) {
+        // Nothing of it can show
+        delete command;
+        return;
+    }
+
+    command->state = currentState();
+    command->top = top;
+    command->bottom = bottom;
+    m_commands.append(command);
+}
+
+void QRasterTileRenderer::drawPolygon(const QPointF *points, int pointCount, QPaintEngine::PolygonDrawMode mode)
+{
+    addCommand(new PolygonCommand<QPointF>(points, pointCount, mode),
+               qt_tile_bounds(points, pointCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawPolygon(const QPoint *points, int pointCount, QPaintEngine::PolygonDrawMode mode)
+{
+    addCommand(new PolygonCommand<QPoint>(points, pointCount, mode),
+               qt_tile_bounds(points, pointCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawEllipse(const QRectF &rect)
+{
+    addCommand(new EllipseCommand(rect), rect.normalized(), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::fillRect(const QRectF &rect, const QBrush &brush)
+{
+    qt_tile_prime_brush(brush, &m_usesPixmaps);
+    addCommand(new FillRectBrushCommand(rect, brush), rect.normalized(), 1);
+}
+
+void QRasterTileRenderer::fillRect(const QRectF &rect, const QColor &color)
+{
+    addCommand(new FillRectColorCommand(rect, color), rect.normalized(), 1);
+}
+
+void QRasterTileRenderer::drawRects(const QRect *rects, int rectCount)
+{
+    addCommand(new RectsCommand<QRect>(rects, rectCount),
+               qt_tile_bounds(rects, rectCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawRects(const QRectF *rects, int rectCount)
+{
+    addCommand(new RectsCommand<QRectF>(rects, rectCount),
+               qt_tile_bounds(rects, rectCount), m_engine->state()->pen);
+}
+
+static inline QRectF qt_tile_image_rect(const QPointF &pos, const QImage &image)
+{
+    // Images with a device pixel ratio below 1 are drawn larger than their size
+    return QRectF(pos, QSizeF(image.size()) / qMin(image.devicePixelRatio(), qreal(1)));
+}
+
+void QRasterTileRenderer::drawPixmapImage(const QPointF &pos, const QImage &image)
+{
+    addImageCommand(new PixmapImageCommand(pos, image), qt_tile_image_rect(pos, image), image,
+                    image.devicePixelRatio() != 1);
+}
+
+void QRasterTileRenderer::drawPixmapImage(const QRectF &r, const QImage &image, const QRectF &sr,
+                                          const QSize &pixmapSize)
+{
+    addImageCommand(new PixmapImageCommand(r, image, sr, pixmapSize), r.normalized(), image,
+                    r.size() != sr.size());
+}
+
+void QRasterTileRenderer::drawImage(const QPointF &pos, const QImage &image)
+{
+    addImageCommand(new ImageCommand(pos, image), qt_tile_image_rect(pos, image), image,
+                    image.devicePixelRatio() != 1);
+}
+
+void QRasterTileRenderer::drawImage(const QRectF &r, const QImage &image, const QRectF &sr)
+{
+    addImageCommand(new ImageCommand(r, image, sr), r.normalized(), image, r.size() != sr.size());
+}
+
+void QRasterTileRenderer::drawTiledPixmapImage(const QRectF &r, const QImage &image, const QPointF &sr)
+{
+    addCommand(new TiledPixmapImageCommand(r, image, sr), r.normalized(), 1);
+}
+
+void QRasterTileRenderer::drawTextItem(const QPointF &p, const QTextItem &textItem)
+{
+    const QTextItemInt &ti = static_cast<const QTextItemInt &>(textItem);
+    if (ti.glyphs.numGlyphs == 0)
+        return;
+
+    TextItemCommand *command = new TextItemCommand(p, ti);
+    QFontEngine *fontEngine = ti.fontEngine;
+    QTransform matrix = m_engine->state()->matrix;
+    if (fontEngine && !fontEngine->hasInternalCaching()
+        && m_engine->shouldDrawCachedGlyphs(fontEngine, matrix)) {
+        // The same glyphs and positions QRasterPaintEngine::drawTextItem() draws
+        QVarLengthArray<QFixedPoint> positions;
+        QVarLengthArray<glyph_t> glyphs;
+        matrix.translate(p.x(), p.y());
+        fontEngine->getGlyphPositions(ti.glyphs, matrix, ti.flags, glyphs, positions);
+        addGlyphsCommand(command, fontEngine, glyphs.size(), glyphs.constData(), positions.constData());
+        return;
+    }
+
+    // Anything else draws through the font engine, which is not thread safe
+    addCommandOnItsOwn(command);
+}
+
+void QRasterTileRenderer::drawStaticTextItem(QStaticTextItem *textItem)
+{
+    if (textItem->numGlyphs == 0)
+        return;
+
+    StaticTextItemCommand *command = new StaticTextItemCommand(*textItem);
+    QFontEngine *fontEngine = textItem->fontEngine();
+    if (!fontEngine->hasInternalCaching()
+        && m_engine->shouldDrawCachedGlyphs(fontEngine, m_engine->state()->matrix)) {
+        addGlyphsCommand(command, fontEngine, textItem->numGlyphs, textItem->glyphs, textItem->glyphPositions);
+        return;
+    }
+
+    addCommandOnItsOwn(command);
+}
+
+void QRasterTileRenderer::drawLines(const QLine *lines, int lineCount)
+{
+    addCommand(new LinesCommand<QLine>(lines, lineCount),
+               qt_tile_bounds(lines, lineCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawLines(const QLineF *lines, int lineCount)
+{
+    addCommand(new LinesCommand<QLineF>(lines, lineCount),
+               qt_tile_bounds(lines, lineCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawPoints(const QPointF *points, int pointCount)
+{
+    addCommand(new PointsCommand<QPointF>(points, pointCount),
+               qt_tile_bounds(points, pointCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::drawPoints(const QPoint *points, int pointCount)
+{
+    addCommand(new PointsCommand<QPoint>(points, pointCount),
+               qt_tile_bounds(points, pointCount), m_engine->state()->pen);
+}
+
+void QRasterTileRenderer::stroke(const QVectorPath &path, const QPen &pen)
+{
+    if (path.isEmpty() || path.elementCount() == 0)
+        return;
+    qt_tile_prime_brush(pen.brush(), &m_usesPixmaps);
+    addCommand(new StrokeCommand(path, pen), path.controlPointRect(), pen);
+}
+
+void QRasterTileRenderer::fill(const QVectorPath &path, const QBrush &brush)
+{
+    if (path.isEmpty() || path.elementCount() == 0)
+        return;
+    qt_tile_prime_brush(brush, &m_usesPixmaps);
+    addCommand(new FillCommand(path, brush), path.controlPointRect(), 1);
+}
+
+void QRasterTileRenderer::recordClip(QRasterTileClipOp *op)
+{
+    QRasterPaintEngineState *s = m_engine->state();
+    op->matrix = s->matrix;
+    op->renderHints = s->renderHints;
+    op->clipEnabled = s->clipEnabled;
+
+    if (op->type != QRasterTileClipOp::Enabled
+        && (op->op == Qt::NoClip || op->op == Qt::ReplaceClip)) {
+        // Neither depends on the clip so far
+        s->tileClipOps.clear();
+    }
+    m_clipOps.append(op);
+    s->tileClipOps.append(m_clipOps.size() - 1);
+}
+
+void QRasterTileRenderer::clipEnabledChanged()
+{
+    if (m_clipDepth == 0)
+        recordClip(new QRasterTileClipOp);
+}
+
+/*
+    Makes the state of the tile \a engine match \a t.
+*/
+void QRasterTileRenderer::applyState(QRasterPaintEngine *engine, const QRasterTileState &t)
+{
+    QRasterPaintEngineState *s = engine->state();
+
+    if (!qpen_fast_equals(s->pen, t.pen)) {
+        s->pen = t.pen;
+        engine->penChanged();
+    }
+    if (!qbrush_fast_equals(s->brush, t.brush)) {
+        s->brush = t.brush;
+        engine->brushChanged();
+    }
+    if (s->brushOrigin != t.brushOrigin) {
+        s->brushOrigin = t.brushOrigin;
+        engine->brushOriginChanged();
+    }
+    if (s->opacity != t.opacity) {
+        s->opacity = t.opacity;
+        engine->opacityChanged();
+    }
+    if (s->composition_mode != t.compositionMode) {
+        s->composition_mode = t.compositionMode;
+        engine->compositionModeChanged();
+    }
+
+    bool clipChanged = false;
+    if (s->tileClipOps != t.clipOps) {
+        // Rebuild the clip from scratch with the operations leading to it
+        engine->clip(QRect(), Qt::NoClip);
+        for (int i = 0; i < t.clipOps.size(); ++i) {
+            const QRasterTileClipOp *op = m_clipOps.at(t.clipOps.at(i));
+            if (s->matrix != op->matrix) {
+                s->matrix = op->matrix;
+                engine->transformChanged();
+            }
+            if (s->renderHints != op->renderHints) {
+                s->renderHints = op->renderHints;
+                engine->renderHintsChanged();
+            }
+            s->clipEnabled = op->clipEnabled;
+            op->replay(engine);
+        }
+        s->tileClipOps = t.clipOps;
+        clipChanged = true;
+    }
+    if (clipChanged || s->clipEnabled != t.clipEnabled) {
+        s->clipEnabled = t.clipEnabled;
+        engine->clipEnabledChanged();
+    }
+
+    if (s->renderHints != t.renderHints) {
+        s->renderHints = t.renderHints;
+        engine->renderHintsChanged();
+    }
+    if (s->matrix != t.matrix) {
+        // The engine falls back to the painter for some text, which
+        // derives the matrix from the world matrix.
+        s->matrix = t.matrix;
+        s->worldMatrix = t.matrix;
+        s->WxF = true;
+        s->VxF = false;
+        engine->transformChanged();
+    }
+
+    engine->d_func()->tileRasterizerClip = t.rasterizerClip;
+    s->font = t.font;
+}
+
+/*
+    Paints \a commands into the target image through \a systemClip.
+*/
+void QRasterTileRenderer::paintCommands(const QVector<int> &commands, const QRegion &systemClip)
+{
+    if (commands.isEmpty())
+        return;
+
+    // A view onto the whole target, so that the tile engine sees the same
+    // device as the recording one.
+    QRasterBuffer *buffer = m_engine->d_func()->rasterBuffer.data();
+    QImage target(buffer->buffer(), m_image->width(), m_image->height(), buffer->bytesPerLine(),
+                  m_image->format());
+    if (!m_image->colorTable().isEmpty())
+        target.setColorTable(m_image->colorTable());
+    target.setDotsPerMeterX(m_image->dotsPerMeterX());
+    target.setDotsPerMeterY(m_image->dotsPerMeterY());
+
+    QPaintEngine *paintEngine = target.paintEngine();
+    Q_ASSERT(paintEngine->type() == QPaintEngine::Raster);
+    QRasterPaintEngine *engine = static_cast<QRasterPaintEngine *>(paintEngine);
+    QRasterPaintEnginePrivate *d = engine->d_func();
+    d->replayingTile = true;
+    engine->setSystemClip(systemClip);
+
+    QPainter painter(&target);
+    int state = -1;
+    for (int i = 0; i < commands.size(); ++i) {
+        const QRasterTileCommand *command = m_commands.at(commands.at(i));
+        if (command->state != state) {
+            state = command->state;
+            applyState(engine, *m_states.at(state));
+        }
+        d->tileGlyphCache = command->glyphCache.data();
+        command->replay(engine);
+    }
+    d->tileGlyphCache = 0;
+    painter.end();
+}
+
+/*
+    Paints the commands binned to \a tile into the target image.
+*/
+void QRasterTileRenderer::renderTile(int tile)
+{
+    const int y = tile * m_tileHeight;
+    const int height = qMin(m_tileHeight, m_image->height() - y);
+    paintCommands(m_tileBins.at(tile), QRegion(0, y, m_image->width(), height));
+}
+
+/*
+    Paints the commands from \a first up to \a end in \a tileCount tiles,
+    on up to \a threadCount threads.
+*/
+void QRasterTileRenderer::renderTiles(int first, int end, int tileCount, int threadCount)
+{
+    m_tileBins.fill(QVector<int>(), tileCount);
+    for (int i = first; i < end; ++i) {
+        const QRasterTileCommand *command = m_commands.at(i);
+        const int last = command->bottom / m_tileHeight;
+        for (int tile = command->top / m_tileHeight; tile <= last; ++tile)
+            m_tileBins[tile].append(i);
+    }
+
+#ifndef QT_NO_THREAD
+    if (threadCount > 1 && tileCount > 1) {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        TileJob job(this);
+        int helperCount = 0;
+        while (helperCount < qMin(threadCount, tileCount) - 1 && pool->tryStart(&job))
+            ++helperCount;
+        job.renderTiles();
+        job.waitForHelpers(helperCount);
+        return;
+    }
+#else
+    Q_UNUSED(threadCount);
+#endif
+
+    for (int tile = 0; tile < tileCount; ++tile)
+        renderTile(tile);
+}
+
+bool QRasterTileRenderer::paintsOnItsOwn(const QRasterTileCommand *command) const
+{
+    switch (command->mode) {
+    case QRasterTileCommand::AnyTiles:
+        return false;
+    case QRasterTileCommand::OneTile:
+        return command->top / m_tileHeight != command->bottom / m_tileHeight;
+    case QRasterTileCommand::OnItsOwn:
+        break;
+    }
+    return true;
+}
+
+/*
+    Paints all recorded commands into the target image.
+*/
+void QRasterTileRenderer::flush()
+{
+    if (m_commands.isEmpty())
+        return;
+
+    const int height = m_image->height();
+    int threadCount = 1;
+#ifndef QT_NO_THREAD
+    threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    if (m_usesPixmaps) {
+        // Pixmap brushes hand out copies of their pixmap while painting
+        QPlatformIntegration *integration = QGuiApplicationPrivate::platformIntegration();
+        if (!integration || !integration->hasCapability(QPlatformIntegration::ThreadedPixmaps))
+            threadCount = 1;
+    }
+#endif
+
+    if (m_tileHeight <= 0) {
+        if (threadCount > 1)
+            m_tileHeight = qMax(64, (height + threadCount * 4 - 1) / (threadCount * 4));
+        else
+            m_tileHeight = height;
+    }
+    const int tileCount = (height + m_tileHeight - 1) / m_tileHeight;
+
+    // Runs of commands that can be cut into tiles are painted in parallel,
+    // the commands between them in order on this thread.
+    int first = 0;
+    while (first < m_commands.size()) {
+        int end = first;
+        while (end < m_commands.size() && !paintsOnItsOwn(m_commands.at(end)))
+            ++end;
+        if (end > first)
+            renderTiles(first, end, tileCount, threadCount);
+
+        QVector<int> ownCommands;
+        while (end < m_commands.size() && paintsOnItsOwn(m_commands.at(end)))
+            ownCommands.append(end++);
+        paintCommands(ownCommands, QRegion());
+        first = end;
+    }
+}
+
+QRasterTileClipRecorder::QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QVectorPath &path,
+                                                 Qt::ClipOperation op)
+    : m_renderer(renderer)
+{
+    if (enter())
+        m_renderer->recordClip(new QRasterTileClipOp(path, op));
+}
+
+QRasterTileClipRecorder::QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QRect &rect,
+                                                 Qt::ClipOperation op)
+    : m_renderer(renderer)
+{
+    if (enter())
+        m_renderer->recordClip(new QRasterTileClipOp(rect, op));
+}
+
+QRasterTileClipRecorder::QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QRegion &region,
+                                                 Qt::ClipOperation op)
+    : m_renderer(renderer)
+{
+    if (enter())
+        m_renderer->recordClip(new QRasterTileClipOp(region, op));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QRASTERTILERENDERER_P_H
+#define QRASTERTILERENDERER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/qpaintengine.h>
+#include <QtGui/qimage.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QRasterPaintEngine;
+class QRasterTileCommand;
+class QRasterTileClipOp;
+struct QRasterTileState;
+class QVectorPath;
+class QStaticTextItem;
+class QTextItemInt;
+class QFontEngine;
+struct QFixedPoint;
+typedef unsigned int glyph_t;
+
+class QRasterTileRenderer
+{
+public:
+    QRasterTileRenderer(QRasterPaintEngine *engine, QImage *image, int tileHeight);
+    ~QRasterTileRenderer();
+
+    void drawPolygon(const QPointF *points, int pointCount, QPaintEngine::PolygonDrawMode mode);
+    void drawPolygon(const QPoint *points, int pointCount, QPaintEngine::PolygonDrawMode mode);
+    void drawEllipse(const QRectF &rect);
+    void fillRect(const QRectF &rect, const QBrush &brush);
+    void fillRect(const QRectF &rect, const QColor &color);
+    void drawRects(const QRect *rects, int rectCount);
+    void drawRects(const QRectF *rects, int rectCount);
+    void drawPixmapImage(const QPointF &pos, const QImage &image);
+    void drawPixmapImage(const QRectF &r, const QImage &image, const QRectF &sr, const QSize &pixmapSize);
+    void drawImage(const QPointF &pos, const QImage &image);
+    void drawImage(const QRectF &r, const QImage &image, const QRectF &sr);
+    void drawTiledPixmapImage(const QRectF &r, const QImage &image, const QPointF &sr);
+    void drawTextItem(const QPointF &p, const QTextItem &textItem);
+    void drawStaticTextItem(QStaticTextItem *textItem);
+    void drawLines(const QLine *lines, int lineCount);
+    void drawLines(const QLineF *lines, int lineCount);
+    void drawPoints(const QPointF *points, int pointCount);
+    void drawPoints(const QPoint *points, int pointCount);
+    void stroke(const QVectorPath &path, const QPen &pen);
+    void fill(const QVectorPath &path, const QBrush &brush);
+
+    void clipEnabledChanged();
+
+    void flush();
+
+    // Used by the tile jobs
+    int tileCount() const { return m_tileBins.size(); }
+    void renderTile(int tile);
+
+private:
+    friend class QRasterTileClipRecorder;
+
+    void recordClip(QRasterTileClipOp *op);
+    void addCommand(QRasterTileCommand *command, const QRectF &rect, qreal padding);
+    void addCommand(QRasterTileCommand *command, const QRectF &rect, const QPen &pen);
+    void addCommand(QRasterTileCommand *command, int top, int bottom);
+    void addImageCommand(QRasterTileCommand *command, const QRectF &rect, const QImage &image, bool stretched);
+    void addGlyphsCommand(QRasterTileCommand *command, QFontEngine *fontEngine, int numGlyphs,
+                          const glyph_t *glyphs, const QFixedPoint *positions);
+    void addCommandOnItsOwn(QRasterTileCommand *command);
+    int currentState();
+    qreal penPadding(const QPen &pen) const;
+    void applyState(QRasterPaintEngine *engine, const QRasterTileState &state);
+    bool paintsOnItsOwn(const QRasterTileCommand *command) const;
+    void paintCommands(const QVector<int> &commands, const QRegion &systemClip);
+    void renderTiles(int first, int end, int tileCount, int threadCount);
+
+    QRasterPaintEngine *m_engine;
+    QImage *m_image;
+    int m_tileHeight;
+    int m_clipDepth;
+    bool m_usesPixmaps;
+
+    QVector<QRasterTileState *> m_states;
+    QVector<QRasterTileClipOp *> m_clipOps;
+    QVector<QRasterTileCommand *> m_commands;
+    QVector<QVector<int> > m_tileBins;
+
+    Q_DISABLE_COPY(QRasterTileRenderer)
+};
+
+/*
+    Records the clip operation it is created for, unless it is nested in
+    another one: the raster engine implements some clip operations in terms
+    of others, and only the outermost one is replayed on the tiles.
+*/
+class QRasterTileClipRecorder
+{
+public:
+    QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QVectorPath &path, Qt::ClipOperation op);
+    QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QRect &rect, Qt::ClipOperation op);
+    QRasterTileClipRecorder(QRasterTileRenderer *renderer, const QRegion &region, Qt::ClipOperation op);
+    inline ~QRasterTileClipRecorder()
+    {
+        if (m_renderer)
+            --m_renderer->m_clipDepth;
+    }
+
+private:
+    inline bool enter()
+    {
+        return m_renderer && m_renderer->m_clipDepth++ == 0;
+    }
+
+    QRasterTileRenderer *m_renderer;
+
+    Q_DISABLE_COPY(QRasterTileClipRecorder)
+};
+
+QT_END_NAMESPACE
+
+#endif // QRASTERTILERENDERER_P_H
@@ -5,6 +5,7 @@ HEADERS += \
     access/qhttpnetworkheader_p.h \
     access/qhttpnetworkrequest_p.h \
     access/qhttpnetworkreply_p.h \
+    access/qhttpcontentdecoder_p.h \
     access/qhttpnetworkconnection_p.h \
     access/qhttpnetworkconnectionchannel_p.h \
     access/qabstractprotocolhandler_p.h \
@@ -36,6 +37,8 @@ HEADERS += \
     access/qnetworkdiskcache_p.h \
     access/qnetworkdiskcache.h \
     access/qhttpthreaddelegate_p.h \
+    access/qhttpconnectionpolicy.h \
+    access/qhttpconnectionpool_p.h \
     access/qhttpmultipart.h \
     access/qhttpmultipart_p.h
 
@@ -44,6 +47,7 @@ SOURCES += \
     access/qhttpnetworkheader.cpp \
     access/qhttpnetworkrequest.cpp \
     access/qhttpnetworkreply.cpp \
+    access/qhttpcontentdecoder.cpp \
     access/qhttpnetworkconnection.cpp \
     access/qhttpnetworkconnectionchannel.cpp \
     access/qabstractprotocolhandler.cpp \
@@ -68,6 +72,8 @@ SOURCES += \
     access/qabstractnetworkcache.cpp \
     access/qnetworkdiskcache.cpp \
     access/qhttpthreaddelegate.cpp \
+    access/qhttpconnectionpolicy.cpp \
+    access/qhttpconnectionpool.cpp \
     access/qhttpmultipart.cpp
 
 mac: LIBS_PRIVATE += -framework Security
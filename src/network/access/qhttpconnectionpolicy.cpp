@@ -0,0 +1,408 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpconnectionpolicy.h"
+#include "private/qhttpconnectionpool_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+class QHttpConnectionPolicyPrivate : public QSharedData
+{
+public:
+    QHttpConnectionPolicyPrivate()
+        : QSharedData()
+        , channelCount(6)
+        , pipeliningEnabled(false)
+        , maximumPipelineLength(3)
+        , pipelineStallTimeout(0)
+        , sharedConnectionPool(false)
+    {}
+
+    bool operator==(const QHttpConnectionPolicyPrivate &other) const
+    {
+        return channelCount == other.channelCount
+            && hostChannelCounts == other.hostChannelCounts
+            && pipeliningEnabled == other.pipeliningEnabled
+            && maximumPipelineLength == other.maximumPipelineLength
+            && pipelineStallTimeout == other.pipelineStallTimeout
+            && sharedConnectionPool == other.sharedConnectionPool;
+    }
+
+    int channelCount;
+    QHash<QString, int> hostChannelCounts;
+    bool pipeliningEnabled;
+    int maximumPipelineLength;
+    int pipelineStallTimeout;
+    bool sharedConnectionPool;
+};
+
+/*!
+    \class QHttpConnectionPolicy
+    \since 5.6
+    \ingroup shared
+    \inmodule QtNetwork
+
+    \brief The QHttpConnectionPolicy class controls how QNetworkAccessManager
+    opens and uses HTTP connections.
+
+    QNetworkAccessManager keeps a set of parallel connections (channels) to
+    every HTTP server it talks to. By default it opens up to six of them per
+    host and only pipelines requests that explicitly set
+    QNetworkRequest::HttpPipeliningAllowedAttribute. QHttpConnectionPolicy
+    lets applications tune this per manager:
+
+    \list
+    \li channelCount() is the number of parallel connections per host. It
+        can be overridden for individual hosts with setChannelCount(const
+        QString &, int).
+    \li isPipeliningEnabled() makes HTTP/1.1 pipelining the default for
+        requests that do not set QNetworkRequest::HttpPipeliningAllowedAttribute
+        themselves. Only idempotent GET requests are ever pipelined.
+    \li maximumPipelineLength() is the maximum number of requests queued on a
+        connection behind the one currently being answered.
+    \li pipelineStallTimeout() enables the head-of-line blocking fallback:
+        when a connection has requests pipelined but the server has not
+        started to answer the current one for longer than the timeout, the
+        pipelined requests are sent again on other connections and the
+        pipeline length for that server is halved. It grows back by one
+        for every response that arrives through the pipeline. Once it
+        drops to zero, pipelining is tried again with a length of one after
+        a number of responses have arrived without it.
+    \li isSharedConnectionPoolEnabled() makes the manager take its
+        connections from a pool that is shared by all managers in the
+        process that enable it, whatever thread they live in.
+    \endlist
+
+    The policy is applied when a connection to a server is created. Changing
+    the policy of a QNetworkAccessManager does not affect connections that
+    are already open; call QNetworkAccessManager::clearAccessCache() to close
+    them.
+
+    \sa QNetworkAccessManager::setHttpConnectionPolicy()
+*/
+
+/*!
+    Constructs a QHttpConnectionPolicy with the default settings: six
+    channels per host, pipelining disabled, a maximum pipeline length of
+    three and no stall timeout.
+*/
+QHttpConnectionPolicy::QHttpConnectionPolicy()
+    : d(new QHttpConnectionPolicyPrivate)
+{
+}
+
+/*!
+    Creates a copy of \a other.
+*/
+QHttpConnectionPolicy::QHttpConnectionPolicy(const QHttpConnectionPolicy &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Disposes of the QHttpConnectionPolicy object.
+*/
+QHttpConnectionPolicy::~QHttpConnectionPolicy()
+{
+    // QSharedDataPointer auto deletes d
+}
+
+/*!
+    Makes this policy a copy of \a other and returns a reference to it.
+*/
+QHttpConnectionPolicy &QHttpConnectionPolicy::operator=(const QHttpConnectionPolicy &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn void QHttpConnectionPolicy::swap(QHttpConnectionPolicy &other)
+
+    Swaps this policy with \a other. This function is very fast and never
+    fails.
+*/
+
+/*!
+    Returns \c true if this policy is the same as \a other.
+*/
+bool QHttpConnectionPolicy::operator==(const QHttpConnectionPolicy &other) const
+{
+    return d == other.d || *d == *other.d;
+}
+
+/*!
+    \fn bool QHttpConnectionPolicy::operator!=(const QHttpConnectionPolicy &other) const
+
+    Returns \c true if this policy is different from \a other.
+*/
+
+/*!
+    Returns the number of parallel connections opened to hosts that do not
+    have a count of their own. The default is 6.
+
+    \sa setChannelCount()
+*/
+int QHttpConnectionPolicy::channelCount() const
+{
+    return d->channelCount;
+}
+
+/*!
+    Sets the number of parallel connections opened to hosts that do not have
+    a count of their own to \a count, which must be at least 1.
+
+    SPDY connections always use a single channel.
+
+    \sa channelCount()
+*/
+void QHttpConnectionPolicy::setChannelCount(int count)
+{
+    if (count < 1) {
+        qWarning("QHttpConnectionPolicy::setChannelCount: invalid channel count %d", count);
+        return;
+    }
+    d->channelCount = count;
+}
+
+/*!
+    \overload
+
+    Returns the number of parallel connections opened to \a hostName.
+*/
+int QHttpConnectionPolicy::channelCount(const QString &hostName) const
+{
+    return d->hostChannelCounts.value(hostName.toLower(), d->channelCount);
+}
+
+/*!
+    \overload
+
+    Sets the number of parallel connections opened to \a hostName to
+    \a count. Host names are compared case-insensitively and must match the
+    host of the request URL exactly.
+
+    \sa resetChannelCount()
+*/
+void QHttpConnectionPolicy::setChannelCount(const QString &hostName, int count)
+{
+    if (count < 1) {
+        qWarning("QHttpConnectionPolicy::setChannelCount: invalid channel count %d", count);
+        return;
+    }
+    d->hostChannelCounts.insert(hostName.toLower(), count);
+}
+
+/*!
+    Makes \a hostName use the default channel count again.
+
+    \sa setChannelCount()
+*/
+void QHttpConnectionPolicy::resetChannelCount(const QString &hostName)
+{
+    d->hostChannelCounts.remove(hostName.toLower());
+}
+
+/*!
+    Returns \c true if HTTP pipelining is used for requests that do not set
+    QNetworkRequest::HttpPipeliningAllowedAttribute. The default is \c false.
+
+    \sa setPipeliningEnabled()
+*/
+bool QHttpConnectionPolicy::isPipeliningEnabled() const
+{
+    return d->pipeliningEnabled;
+}
+
+/*!
+    Sets whether HTTP pipelining is used for requests that do not set
+    QNetworkRequest::HttpPipeliningAllowedAttribute to \a enabled.
+
+    \sa isPipeliningEnabled()
+*/
+void QHttpConnectionPolicy::setPipeliningEnabled(bool enabled)
+{
+    d->pipeliningEnabled = enabled;
+}
+
+/*!
+    Returns the maximum number of requests pipelined on a connection behind
+    the one that is currently being answered. The default is 3.
+
+    \sa setMaximumPipelineLength()
+*/
+int QHttpConnectionPolicy::maximumPipelineLength() const
+{
+    return d->maximumPipelineLength;
+}
+
+/*!
+    Sets the maximum number of requests pipelined on a connection behind the
+    one that is currently being answered to \a length, which must be at
+    least 1.
+
+    \sa maximumPipelineLength()
+*/
+void QHttpConnectionPolicy::setMaximumPipelineLength(int length)
+{
+    if (length < 1) {
+        qWarning("QHttpConnectionPolicy::setMaximumPipelineLength: invalid length %d", length);
+        return;
+    }
+    d->maximumPipelineLength = length;
+}
+
+/*!
+    Returns the time in milliseconds after which a stalled pipeline is
+    abandoned. The default is 0, which disables the fallback.
+
+    \sa setPipelineStallTimeout()
+*/
+int QHttpConnectionPolicy::pipelineStallTimeout() const
+{
+    return d->pipelineStallTimeout;
+}
+
+/*!
+    Sets the time after which a stalled pipeline is abandoned to \a msecs
+    milliseconds. A value of 0 disables the fallback.
+
+    A pipeline counts as stalled when requests are queued behind the current
+    one and no byte of the current response has arrived within \a msecs.
+    The queued requests are then sent again on other connections, which is
+    safe because only idempotent requests are pipelined.
+
+    \sa pipelineStallTimeout()
+*/
+void QHttpConnectionPolicy::setPipelineStallTimeout(int msecs)
+{
+    d->pipelineStallTimeout = qMax(0, msecs);
+}
+
+/*!
+    Returns \c true if the manager uses the process-wide connection pool.
+    The default is \c false.
+
+    \sa setSharedConnectionPoolEnabled()
+*/
+bool QHttpConnectionPolicy::isSharedConnectionPoolEnabled() const
+{
+    return d->sharedConnectionPool;
+}
+
+/*!
+    Sets whether the manager uses the process-wide connection pool to
+    \a enabled.
+
+    Normally every QNetworkAccessManager has connections of its own, so
+    applications with a manager per thread open channelCount() connections
+    per host and thread. Managers that enable the pool instead share the
+    pool's connections: a connection opened for one of them is reused for
+    the requests of the others once it is idle. The pool opens at most
+    sharedPoolChannelCount() connections per host, which replaces
+    channelCount() for these managers, and closes connections that have
+    been idle for sharedPoolIdleTimeout() seconds.
+
+    The HTTP traffic of all pooled managers is handled by one common thread.
+    Connections to HTTPS servers set up with a custom SSL configuration are
+    not shared with other managers. Neither are connections for requests
+    that carry credentials, that upload data or that go to a server or
+    proxy that asked for authentication before, since a connection keeps
+    the credentials it authenticated with. Synchronous requests never use
+    the pool.
+
+    \sa isSharedConnectionPoolEnabled(), QNetworkAccessManager::clearAccessCache()
+*/
+void QHttpConnectionPolicy::setSharedConnectionPoolEnabled(bool enabled)
+{
+    d->sharedConnectionPool = enabled;
+}
+
+/*!
+    Returns the number of parallel connections the shared connection pool
+    opens to each host. The default is 6.
+
+    \sa setSharedPoolChannelCount(), setSharedConnectionPoolEnabled()
+*/
+int QHttpConnectionPolicy::sharedPoolChannelCount()
+{
+    return QHttpConnectionPool::channelCount();
+}
+
+/*!
+    Sets the number of parallel connections the shared connection pool opens
+    to each host to \a count, which must be at least 1. This limit applies
+    to all managers that use the pool together.
+
+    Connections that are already open keep their number of channels until
+    they are closed.
+
+    \sa sharedPoolChannelCount()
+*/
+void QHttpConnectionPolicy::setSharedPoolChannelCount(int count)
+{
+    if (count < 1) {
+        qWarning("QHttpConnectionPolicy::setSharedPoolChannelCount: invalid channel count %d", count);
+        return;
+    }
+    QHttpConnectionPool::setChannelCount(count);
+}
+
+/*!
+    Returns the number of seconds after which the shared connection pool
+    closes a connection that no request uses. The default is 120.
+
+    \sa setSharedPoolIdleTimeout()
+*/
+int QHttpConnectionPolicy::sharedPoolIdleTimeout()
+{
+    return QHttpConnectionPool::idleTimeout();
+}
+
+/*!
+    Sets the number of seconds after which the shared connection pool closes
+    a connection that no request uses to \a secs. A value of 0 closes
+    connections as soon as they are idle.
+
+    \sa sharedPoolIdleTimeout()
+*/
+void QHttpConnectionPolicy::setSharedPoolIdleTimeout(int secs)
+{
+    QHttpConnectionPool::setIdleTimeout(qMax(0, secs));
+}
+
+QT_END_NAMESPACE
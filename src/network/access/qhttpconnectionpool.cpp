@@ -0,0 +1,198 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpconnectionpool_p.h"
+
+#ifndef QT_NO_HTTP
+
+#include "qhttpthreaddelegate_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qthread.h>
+
+QT_BEGIN_NAMESPACE
+
+class QHttpConnectionPoolData
+{
+public:
+    QHttpConnectionPoolData() : thread(0), pool(0) {}
+
+    QMutex mutex;
+    QThread *thread;
+    QHttpConnectionPool *pool; // lives in thread
+
+    // taken by the pool thread, so separate from mutex
+    QMutex authenticationMutex;
+    QSet<QByteArray> authenticatingKeys;
+};
+Q_GLOBAL_STATIC(QHttpConnectionPoolData, poolData)
+
+static QBasicAtomicInt poolChannelCount = Q_BASIC_ATOMIC_INITIALIZER(QHttpConnectionPool::DefaultChannelCount);
+static QBasicAtomicInt poolIdleTimeout = Q_BASIC_ATOMIC_INITIALIZER(QHttpConnectionPool::DefaultIdleTimeout);
+
+/*!
+    Returns the thread that runs the HTTP of all managers that use the pool,
+    starting it on first use, or 0 if the pool is gone already.
+*/
+QThread *QHttpConnectionPool::poolThread()
+{
+    QHttpConnectionPoolData *data = poolData();
+    if (!data)
+        return 0;
+
+    QMutexLocker locker(&data->mutex);
+    if (!data->thread) {
+        data->thread = new QThread();
+        data->thread->setObjectName(QStringLiteral("Qt HTTP connection pool thread"));
+        data->pool = new QHttpConnectionPool;
+        data->pool->moveToThread(data->thread);
+        // finished() is emitted in the thread itself, so this is still processed
+        QObject::connect(data->thread, SIGNAL(finished()), data->pool, SLOT(deleteLater()));
+        data->thread->start();
+
+        // the connections have to be closed while the application still exists
+        qAddPostRoutine(&QHttpConnectionPool::stop);
+    }
+    return data->thread;
+}
+
+void QHttpConnectionPool::stop()
+{
+    QHttpConnectionPoolData *data = poolData();
+    if (!data)
+        return;
+
+    QMutexLocker locker(&data->mutex);
+    if (!data->thread)
+        return;
+
+    data->thread->quit();
+    data->thread->wait(5000);
+    if (data->thread->isFinished())
+        delete data->thread;
+    else
+        QObject::connect(data->thread, SIGNAL(finished()), data->thread, SLOT(deleteLater()));
+    data->thread = 0;
+    data->pool = 0;
+}
+
+/*!
+    Returns the number of parallel connections the pool keeps to each host.
+*/
+int QHttpConnectionPool::channelCount()
+{
+    return poolChannelCount.load();
+}
+
+void QHttpConnectionPool::setChannelCount(int count)
+{
+    poolChannelCount.store(count);
+}
+
+/*!
+    Returns the number of seconds after which connections that no request
+    uses are closed.
+*/
+int QHttpConnectionPool::idleTimeout()
+{
+    return poolIdleTimeout.load();
+}
+
+void QHttpConnectionPool::setIdleTimeout(int secs)
+{
+    poolIdleTimeout.store(secs);
+}
+
+/*!
+    Closes the connections in the pool that no request uses. Returns once
+    they are closed, so that requests sent afterwards open new ones.
+*/
+void QHttpConnectionPool::clearIdleConnections()
+{
+    QHttpConnectionPoolData *data = poolData();
+    if (!data)
+        return;
+
+    // the pool thread never takes the mutex, so it is safe to block here
+    QMutexLocker locker(&data->mutex);
+    if (!data->pool)
+        return;
+
+    const Qt::ConnectionType type = (QThread::currentThread() == data->thread)
+            ? Qt::DirectConnection : Qt::BlockingQueuedConnection;
+    QMetaObject::invokeMethod(data->pool, "clearIdleConnectionsInThread", type);
+}
+
+/*!
+    Returns \c true if a server reached through connections with the
+    cache key \a key asked for authentication before.
+*/
+bool QHttpConnectionPool::requiresAuthentication(const QByteArray &key)
+{
+    QHttpConnectionPoolData *data = poolData();
+    if (!data)
+        return false;
+
+    QMutexLocker locker(&data->authenticationMutex);
+    return data->authenticatingKeys.contains(key);
+}
+
+/*!
+    Records that the server (or proxy) reached through connections with the
+    cache key \a key asks for authentication. The connections of the pool
+    must not carry the credentials of one manager to the requests of
+    another, so the requests to it use connections of their own manager
+    from then on.
+*/
+void QHttpConnectionPool::setRequiresAuthentication(const QByteArray &key)
+{
+    QHttpConnectionPoolData *data = poolData();
+    if (!data)
+        return;
+
+    QMutexLocker locker(&data->authenticationMutex);
+    data->authenticatingKeys.insert(key);
+}
+
+void QHttpConnectionPool::clearIdleConnectionsInThread()
+{
+    QHttpThreadDelegate::clearUnusedConnections();
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
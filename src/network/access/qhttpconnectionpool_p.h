@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPCONNECTIONPOOL_P_H
+#define QHTTPCONNECTIONPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qobject.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+class QThread;
+
+// The process-wide pool of HTTP connections that QNetworkAccessManagers
+// share when their QHttpConnectionPolicy enables it. Connections can only
+// be used from the thread that owns them, so the managers run their HTTP
+// in one common thread, and its connection cache is the pool.
+class QHttpConnectionPool : public QObject
+{
+    Q_OBJECT
+public:
+    static QThread *poolThread();
+
+    static int channelCount();
+    static void setChannelCount(int count);
+    static int idleTimeout();
+    static void setIdleTimeout(int secs);
+
+    static void clearIdleConnections();
+
+    static bool requiresAuthentication(const QByteArray &key);
+    static void setRequiresAuthentication(const QByteArray &key);
+
+    enum {
+        DefaultChannelCount = 6,
+        DefaultIdleTimeout = 120
+    };
+
+private slots:
+    void clearIdleConnectionsInThread();
+
+private:
+    QHttpConnectionPool() {}
+    static void stop();
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTPCONNECTIONPOOL_P_H
@@ -0,0 +1,352 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpcontentdecoder_p.h"
+
+#ifndef QT_NO_HTTP
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpair.h>
+#include <private/qbytedata_p.h>
+
+#ifndef QT_NO_COMPRESS
+#include <zlib.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttpContentDecoder
+    \internal
+    \inmodule QtNetwork
+
+    \brief The QHttpContentDecoder class decodes an HTTP body that was sent
+    with a Content-Encoding.
+
+    A decoder is created by create() for the value of the Content-Encoding
+    header of a reply and then fed the body as it arrives from the socket,
+    in the thread that reads the reply. The decoded data is appended to the
+    reply's buffer in chunks of at most ChunkSize bytes, so that a single
+    network read never turns into one large allocation.
+
+    To protect against decompression bombs, a decoder fails once it has
+    produced more than safetyCheckThreshold() bytes and the output is more
+    than maximumRatio() times as large as the input. A threshold of -1
+    turns the check off.
+
+    gzip and deflate are always available when Qt is built with zlib.
+    Support for further encodings, such as br, can be added with
+    registerDecoder(); acceptEncoding() lists all of them for the
+    Accept-Encoding header of outgoing requests.
+*/
+
+typedef QPair<QByteArray, QHttpContentDecoder::Factory> QHttpContentDecoderEntry;
+
+#ifndef QT_NO_COMPRESS
+class QHttpZlibDecoder : public QHttpContentDecoder
+{
+public:
+    QHttpZlibDecoder();
+    ~QHttpZlibDecoder();
+
+    // what deflate reaches on very repetitive, but not crafted, text
+    enum { MaximumRatio = 40 };
+
+    static QHttpContentDecoder *create() { return new QHttpZlibDecoder; }
+
+protected:
+    bool decodeData(const char *data, qint64 size) Q_DECL_OVERRIDE;
+
+private:
+    bool init(int windowBits);
+
+    z_stream stream;
+    bool initialized;
+    bool triedRawDeflate;
+};
+#endif
+
+class QHttpContentDecoderRegistry
+{
+public:
+    QHttpContentDecoderRegistry()
+    {
+#ifndef QT_NO_COMPRESS
+        entries.append(qMakePair(QByteArray("gzip"), &QHttpZlibDecoder::create));
+        entries.append(qMakePair(QByteArray("deflate"), &QHttpZlibDecoder::create));
+#endif
+    }
+
+    QHttpContentDecoder::Factory find(const QByteArray &contentEncoding) const
+    {
+        const QByteArray encoding = contentEncoding.trimmed();
+        for (int i = 0; i < entries.size(); ++i) {
+            if (qstricmp(entries.at(i).first.constData(), encoding.constData()) == 0)
+                return entries.at(i).second;
+        }
+        return 0;
+    }
+
+    QMutex mutex;
+    QList<QHttpContentDecoderEntry> entries; // in the order of Accept-Encoding
+};
+Q_GLOBAL_STATIC(QHttpContentDecoderRegistry, decoderRegistry)
+
+QHttpContentDecoder::QHttpContentDecoder(int maximumRatio)
+    : output(0),
+      totalIn(0),
+      totalOut(0),
+      threshold(DefaultSafetyCheckThreshold),
+      ratio(maximumRatio),
+      finished(false)
+{
+}
+
+QHttpContentDecoder::~QHttpContentDecoder()
+{
+}
+
+/*!
+    Decodes \a data, the next piece of the encoded body, and appends the
+    result to \a out. Returns \c false if the data could not be decoded or
+    the output exceeded the decompression limits; errorMessage() then says
+    why. Data that follows the end of the encoded stream is ignored.
+*/
+bool QHttpContentDecoder::decode(const QByteArray &data, QByteDataBuffer *out)
+{
+    if (hasError())
+        return false;
+    if (finished || data.isEmpty())
+        return true;
+
+    output = out;
+    totalIn += data.size();
+    const bool ok = decodeData(data.constData(), data.size());
+    output = 0;
+    return ok && !hasError();
+}
+
+/*!
+    Sets the number of decoded bytes after which the ratio of output to
+    input is checked to \a bytes, or turns the check off if \a bytes is -1.
+*/
+void QHttpContentDecoder::setSafetyCheckThreshold(qint64 bytes)
+{
+    threshold = bytes;
+}
+
+/*!
+    Appends \a chunk to the output. Returns \c false, and sets an error,
+    if that makes the output larger than the limits allow.
+*/
+bool QHttpContentDecoder::appendDecoded(const QByteArray &chunk)
+{
+    totalOut += chunk.size();
+    if (threshold >= 0 && totalOut > threshold && totalOut > qint64(ratio) * totalIn) {
+        setError(QCoreApplication::translate("QHttp", "Decompressed data exceeds %1 times its compressed size")
+                 .arg(ratio));
+        return false;
+    }
+    output->append(chunk);
+    return true;
+}
+
+/*!
+    Returns a new decoder for \a contentEncoding, or 0 if that encoding is
+    not supported. The caller takes ownership of the decoder.
+*/
+QHttpContentDecoder *QHttpContentDecoder::create(const QByteArray &contentEncoding)
+{
+    QHttpContentDecoderRegistry *registry = decoderRegistry();
+    if (!registry)
+        return 0;
+
+    QMutexLocker locker(&registry->mutex);
+    const Factory factory = registry->find(contentEncoding);
+    return factory ? factory() : 0;
+}
+
+/*!
+    Returns \c true if there is a decoder for \a contentEncoding.
+*/
+bool QHttpContentDecoder::isSupported(const QByteArray &contentEncoding)
+{
+    if (contentEncoding.isEmpty())
+        return false;
+
+    QHttpContentDecoderRegistry *registry = decoderRegistry();
+    if (!registry)
+        return false;
+
+    QMutexLocker locker(&registry->mutex);
+    return registry->find(contentEncoding) != 0;
+}
+
+/*!
+    Returns the value of the Accept-Encoding header that announces all
+    supported encodings, or an empty byte array if there are none.
+*/
+QByteArray QHttpContentDecoder::acceptEncoding()
+{
+    QHttpContentDecoderRegistry *registry = decoderRegistry();
+    if (!registry)
+        return QByteArray();
+
+    QMutexLocker locker(&registry->mutex);
+    QByteArray value;
+    for (int i = 0; i < registry->entries.size(); ++i) {
+        if (i)
+            value += ", ";
+        value += registry->entries.at(i).first;
+    }
+    return value;
+}
+
+/*!
+    Makes \a factory create the decoders for \a contentEncoding, replacing
+    any decoder that was registered for it before. New encodings are
+    announced after the existing ones.
+*/
+void QHttpContentDecoder::registerDecoder(const QByteArray &contentEncoding, Factory factory)
+{
+    QHttpContentDecoderRegistry *registry = decoderRegistry();
+    if (!registry || contentEncoding.isEmpty() || !factory)
+        return;
+
+    QMutexLocker locker(&registry->mutex);
+    const QByteArray encoding = contentEncoding.trimmed().toLower();
+    for (int i = 0; i < registry->entries.size(); ++i) {
+        if (registry->entries.at(i).first == encoding) {
+            registry->entries[i].second = factory;
+            return;
+        }
+    }
+    registry->entries.append(qMakePair(encoding, factory));
+}
+
+#ifndef QT_NO_COMPRESS
+QHttpZlibDecoder::QHttpZlibDecoder()
+    : QHttpContentDecoder(MaximumRatio), initialized(false), triedRawDeflate(false)
+{
+    // "windowBits can also be greater than 15 for optional gzip decoding.
+    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
+    // http://www.zlib.net/manual.html
+    init(MAX_WBITS + 32);
+}
+
+QHttpZlibDecoder::~QHttpZlibDecoder()
+{
+    if (initialized)
+        inflateEnd(&stream);
+}
+
+bool QHttpZlibDecoder::init(int windowBits)
+{
+    if (initialized)
+        inflateEnd(&stream);
+
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.avail_in = 0;
+    stream.next_in = Z_NULL;
+    initialized = (inflateInit2(&stream, windowBits) == Z_OK);
+    return initialized;
+}
+
+bool QHttpZlibDecoder::decodeData(const char *data, qint64 size)
+{
+    if (!initialized) {
+        setError(QCoreApplication::translate("QHttp", "Data corrupted"));
+        return false;
+    }
+
+    // zlib does not modify the input
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = uInt(size);
+
+    forever {
+        // Decode into fixed-size chunks: 32 kB is the deflate window, a
+        // multiple of any vector width, and leaves inflate() in its fast
+        // loop (which needs 258 bytes of room) for nearly all of the chunk.
+        QByteArray chunk(ChunkSize, Qt::Uninitialized);
+        stream.next_out = reinterpret_cast<Bytef *>(chunk.data());
+        stream.avail_out = ChunkSize;
+
+        const int ret = inflate(&stream, Z_NO_FLUSH);
+
+        // Some servers send "deflate" as raw deflate data, without the zlib
+        // header. That fails on the first bytes, so start over on them.
+        if (ret == Z_DATA_ERROR && !triedRawDeflate && bytesOut() == 0 && bytesIn() == size
+            && stream.total_out == 0) {
+            triedRawDeflate = true;
+            if (!init(-MAX_WBITS))
+                break;
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+            stream.avail_in = uInt(size);
+            continue;
+        }
+        // All negative return codes are errors, in the context of HTTP compression
+        // Z_NEED_DICT is also an error. Z_BUF_ERROR only means there was nothing to do.
+        if ((ret < 0 && ret != Z_BUF_ERROR) || ret == Z_NEED_DICT)
+            break;
+
+        const int produced = ChunkSize - stream.avail_out;
+        if (produced > 0) {
+            chunk.resize(produced);
+            if (produced < ChunkSize / 4)
+                chunk.squeeze(); // don't keep mostly empty chunks around in the reply
+            if (!appendDecoded(chunk))
+                return false;
+        }
+
+        if (ret == Z_STREAM_END) {
+            setFinished();
+            return true;
+        }
+        // if the chunk was filled up, there may be more output pending
+        if (stream.avail_out > 0 || ret == Z_BUF_ERROR)
+            return true;
+    }
+
+    setError(QCoreApplication::translate("QHttp", "Data corrupted"));
+    return false;
+}
+#endif // QT_NO_COMPRESS
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
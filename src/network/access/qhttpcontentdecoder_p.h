@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPCONTENTDECODER_P_H
+#define QHTTPCONTENTDECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+class QByteDataBuffer;
+
+class Q_AUTOTEST_EXPORT QHttpContentDecoder
+{
+public:
+    typedef QHttpContentDecoder *(*Factory)();
+
+    virtual ~QHttpContentDecoder();
+
+    bool decode(const QByteArray &data, QByteDataBuffer *out);
+
+    bool atEnd() const { return finished; }
+    bool hasError() const { return !errorString.isEmpty(); }
+    QString errorMessage() const { return errorString; }
+
+    qint64 bytesIn() const { return totalIn; }
+    qint64 bytesOut() const { return totalOut; }
+
+    qint64 safetyCheckThreshold() const { return threshold; }
+    void setSafetyCheckThreshold(qint64 bytes);
+    int maximumRatio() const { return ratio; }
+
+    static QHttpContentDecoder *create(const QByteArray &contentEncoding);
+    static bool isSupported(const QByteArray &contentEncoding);
+    static QByteArray acceptEncoding();
+    static void registerDecoder(const QByteArray &contentEncoding, Factory factory);
+
+    enum {
+        ChunkSize = 32 * 1024,
+        DefaultSafetyCheckThreshold = 10 * 1024 * 1024
+    };
+
+protected:
+    explicit QHttpContentDecoder(int maximumRatio);
+
+    // Called by decode() with the next piece of encoded data. Implementations
+    // pass what they decoded to appendDecoded() and stop when it fails.
+    virtual bool decodeData(const char *data, qint64 size) = 0;
+
+    bool appendDecoded(const QByteArray &chunk);
+    void setFinished() { finished = true; }
+    void setError(const QString &message) { errorString = message; }
+
+private:
+    QByteDataBuffer *output;
+    qint64 totalIn;
+    qint64 totalOut;
+    qint64 threshold;
+    int ratio;
+    bool finished;
+    QString errorString;
+
+    Q_DISABLE_COPY(QHttpContentDecoder)
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTPCONTENTDECODER_P_H
@@ -35,6 +35,7 @@
 #include <private/qabstractsocket_p.h>
 #include "qhttpnetworkconnectionchannel_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
+#include "private/qhttpcontentdecoder_p.h"
 #include <private/qnetworkrequest_p.h>
 #include <private/qobject_p.h>
 #include <private/qauthenticator_p.h>
@@ -67,6 +68,8 @@ const int QHttpNetworkConnectionPrivate::defaultPipelineLength = 3;
 // Only re-fill the pipeline if there's defaultRePipelineLength slots free in the pipeline.
 // This means that there are 2 requests in flight and 2 slots free that will be re-filled.
 const int QHttpNetworkConnectionPrivate::defaultRePipelineLength = 2;
+// Once stalls switched pipelining off, try it again after this many responses.
+const int QHttpNetworkConnectionPrivate::pipelineRetryResponses = 16;
 
 
 QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName,
@@ -80,6 +83,10 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
 #else
 , channelCount(defaultHttpChannelCount)
 #endif // QT_NO_SSL
+  , pipelineLength(defaultPipelineLength)
+  , maximumPipelineLength(defaultPipelineLength)
+  , pipelineStallTimeout(0)
+  , responsesWithoutPipeline(0)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -95,6 +102,10 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 channelCoun
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
   channelCount(channelCount)
+  , pipelineLength(defaultPipelineLength)
+  , maximumPipelineLength(defaultPipelineLength)
+  , pipelineStallTimeout(0)
+  , responsesWithoutPipeline(0)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -131,6 +142,8 @@ void QHttpNetworkConnectionPrivate::init()
 
     delayedConnectionTimer.setSingleShot(true);
     QObject::connect(&delayedConnectionTimer, SIGNAL(timeout()), q, SLOT(_q_connectDelayedChannel()));
+
+    QObject::connect(&pipelineStallTimer, SIGNAL(timeout()), q, SLOT(_q_checkPipelineStalls()));
 }
 
 void QHttpNetworkConnectionPrivate::pauseConnection()
@@ -283,19 +296,20 @@ void QHttpNetworkConnectionPrivate::prepareRequest(HttpMessagePair &messagePair)
 #endif
 
     // If the request had a accept-encoding set, we better not mess
-    // with it. If it was not set, we announce that we understand gzip
-    // and remember this fact in request.d->autoDecompress so that
-    // we can later decompress the HTTP reply if it has such an
+    // with it. If it was not set, we announce the encodings we have
+    // decoders for and remember this fact in request.d->autoDecompress
+    // so that we can later decompress the HTTP reply if it has such an
     // encoding.
     value = request.headerField("accept-encoding");
     if (value.isEmpty()) {
-#ifndef QT_NO_COMPRESS
-        request.setHeaderField("Accept-Encoding", "gzip, deflate");
-        request.d->autoDecompress = true;
-#else
-        // if zlib is not available set this to false always
-        request.d->autoDecompress = false;
-#endif
+        const QByteArray acceptEncoding = QHttpContentDecoder::acceptEncoding();
+        if (!acceptEncoding.isEmpty()) {
+            request.setHeaderField("Accept-Encoding", acceptEncoding);
+            request.d->autoDecompress = true;
+        } else {
+            // if zlib is not available there is nothing to decode with
+            request.d->autoDecompress = false;
+        }
     }
 
     // some websites mandate an accept-language header and fail
@@ -705,7 +719,12 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     if (channels[i].reply == 0)
         return;
 
-    if (! (defaultPipelineLength - channels[i].alreadyPipelinedRequests.length() >= defaultRePipelineLength)) {
+    // pipelining was switched off after stalls
+    if (pipelineLength < 1)
+        return;
+
+    if (! (pipelineLength - channels[i].alreadyPipelinedRequests.length()
+           >= qMin(defaultRePipelineLength, pipelineLength))) {
         return;
     }
 
@@ -749,7 +768,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(highPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -762,7 +781,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(lowPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -775,6 +794,26 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     channels[i].pipelineFlush();
 }
 
+// called when a response has been received completely, \a pipelined tells
+// whether its request went through the pipeline
+void QHttpNetworkConnectionPrivate::responseReceived(bool pipelined)
+{
+    if (pipelineLength == 0) {
+        // switched off after stalls; probe again with a single request
+        if (maximumPipelineLength > 0 && ++responsesWithoutPipeline >= pipelineRetryResponses)
+            pipelineLength = 1;
+        return;
+    }
+    if (pipelined && pipelineLength < maximumPipelineLength)
+        ++pipelineLength;
+}
+
+void QHttpNetworkConnectionPrivate::startPipelineStallTimer()
+{
+    if (pipelineStallTimeout > 0 && !pipelineStallTimer.isActive())
+        pipelineStallTimer.start(qMax(1, pipelineStallTimeout / 4));
+}
+
 // returns true when the processing of a queue has been done
 bool QHttpNetworkConnectionPrivate::fillPipeline(QList<HttpMessagePair> &queue, QHttpNetworkConnectionChannel &channel)
 {
@@ -1242,6 +1281,36 @@ void QHttpNetworkConnectionPrivate::_q_connectDelayedChannel()
         channels[1].ensureConnection();
 }
 
+// A response that does not start arriving blocks everything that was pipelined
+// behind it. Only act while nothing of the head response has been read: the
+// requests are all idempotent GETs and none of their replies emitted anything,
+// so they can be sent again on a fresh connection and on the other channels.
+void QHttpNetworkConnectionPrivate::_q_checkPipelineStalls()
+{
+    bool pipelining = false;
+    for (int i = 0; i < channelCount; ++i) {
+        QHttpNetworkConnectionChannel &channel = channels[i];
+        if (channel.alreadyPipelinedRequests.isEmpty())
+            continue;
+
+        if (channel.reply
+            && channel.reply->d_func()->state == QHttpNetworkReplyPrivate::NothingDoneState
+            && channel.pipelineProgress.hasExpired(pipelineStallTimeout)) {
+            pipelineLength /= 2;
+            responsesWithoutPipeline = 0;
+            channel.reply->d_func()->clear();
+            channel.reply->d_func()->connection = q_func();
+            channel.reply->d_func()->connectionChannel = &channel;
+            channel.closeAndResendCurrentRequest();
+            continue;
+        }
+        pipelining = true;
+    }
+
+    if (!pipelining)
+        pipelineStallTimer.stop();
+}
+
 #ifndef QT_NO_BEARERMANAGEMENT
 QHttpNetworkConnection::QHttpNetworkConnection(const QString &hostName, quint16 port, bool encrypt,
                                                QHttpNetworkConnection::ConnectionType connectionType,
@@ -1306,6 +1375,23 @@ QHttpNetworkReply* QHttpNetworkConnection::sendRequest(const QHttpNetworkRequest
     return d->queueRequest(request);
 }
 
+void QHttpNetworkConnection::setMaximumPipelineLength(int length)
+{
+    Q_D(QHttpNetworkConnection);
+    if (d->maximumPipelineLength == length)
+        return;
+    d->maximumPipelineLength = length;
+    d->pipelineLength = length;
+}
+
+void QHttpNetworkConnection::setPipelineStallTimeout(int msecs)
+{
+    Q_D(QHttpNetworkConnection);
+    d->pipelineStallTimeout = msecs;
+    if (msecs <= 0)
+        d->pipelineStallTimer.stop();
+}
+
 bool QHttpNetworkConnection::isSsl() const
 {
     Q_D(const QHttpNetworkConnection);
@@ -146,6 +146,9 @@ public:
 
     void preConnectFinished();
 
+    void setMaximumPipelineLength(int length);
+    void setPipelineStallTimeout(int msecs);
+
 private:
     Q_DECLARE_PRIVATE(QHttpNetworkConnection)
     Q_DISABLE_COPY(QHttpNetworkConnection)
@@ -159,6 +162,7 @@ private:
     Q_PRIVATE_SLOT(d_func(), void _q_startNextRequest())
     Q_PRIVATE_SLOT(d_func(), void _q_hostLookupFinished(QHostInfo))
     Q_PRIVATE_SLOT(d_func(), void _q_connectDelayedChannel())
+    Q_PRIVATE_SLOT(d_func(), void _q_checkPipelineStalls())
 };
 
 
@@ -173,6 +177,7 @@ public:
     static const int defaultHttpChannelCount;
     static const int defaultPipelineLength;
     static const int defaultRePipelineLength;
+    static const int pipelineRetryResponses;
 
     enum ConnectionState {
         RunningState = 0,
@@ -211,6 +216,8 @@ public:
 
     void fillPipeline(QAbstractSocket *socket);
     bool fillPipeline(QList<HttpMessagePair> &queue, QHttpNetworkConnectionChannel &channel);
+    void responseReceived(bool pipelined);
+    void startPipelineStallTimer();
 
     // read more HTTP body after the next event loop spin
     void readMoreLater(QHttpNetworkReply *reply);
@@ -226,6 +233,7 @@ public:
 
     void _q_hostLookupFinished(QHostInfo info);
     void _q_connectDelayedChannel();
+    void _q_checkPipelineStalls();
 
     void createAuthorization(QAbstractSocket *socket, QHttpNetworkRequest &request);
 
@@ -241,6 +249,15 @@ public:
 
     const int channelCount;
     QTimer delayedConnectionTimer;
+
+    // HTTP pipelining: pipelineLength is halved on head-of-line stalls and
+    // grows back towards maximumPipelineLength with every pipelined response;
+    // at 0 it is set to 1 again after pipelineRetryResponses responses
+    int pipelineLength;
+    int maximumPipelineLength;
+    int pipelineStallTimeout; // 0 = no stall detection
+    int responsesWithoutPipeline;
+    QTimer pipelineStallTimer;
     QHttpNetworkConnectionChannel *channels; // parallel connections to the server
     bool shouldEmitChannelError(QAbstractSocket *socket);
 
@@ -48,6 +48,7 @@
 #    include <QtNetwork/qsslkey.h>
 #    include <QtNetwork/qsslcipher.h>
 #    include <QtNetwork/qsslconfiguration.h>
+#    include <private/qsslsessioncache_p.h>
 #endif
 
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -217,6 +218,7 @@ void QHttpNetworkConnectionChannel::_q_receiveReply()
 void QHttpNetworkConnectionChannel::_q_readyRead()
 {
     Q_ASSERT(!protocolHandler.isNull());
+    pipelineProgress.restart();
     protocolHandler->_q_readyRead();
 }
 
@@ -322,8 +324,12 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
             // check whether we can re-use an existing SSL session
             // (meaning another socket in this connection has already
             // performed a full handshake)
+            sslSessionKey.clear();
+            offeredSslSession.clear();
             if (!connection->sslContext().isNull())
                 QSslSocketPrivate::checkSettingSslContext(sslSocket, connection->sslContext());
+            else
+                resumeCachedSslSession();
 
             sslSocket->connectToHostEncrypted(connectHost, connectPort, QIODevice::ReadWrite, networkLayerPreference);
             if (ignoreAllSslErrors)
@@ -397,6 +403,9 @@ void QHttpNetworkConnectionChannel::allDone()
     if (reply && emitFinished)
         QMetaObject::invokeMethod(reply, "finished", Qt::QueuedConnection);
 
+    // let the pipeline grow back after a stall
+    if (reply)
+        connection->d_func()->responseReceived(reply->d_func()->pipeliningUsed);
 
     // reset the reconnection attempts after we receive a complete reply.
     // in case of failures, each channel will attempt two reconnects before emitting error.
@@ -435,6 +444,7 @@ void QHttpNetworkConnectionChannel::allDone()
 
             written = 0; // message body, excluding the header, irrelevant here
             bytesTotal = 0; // message body total, excluding the header, irrelevant here
+            pipelineProgress.restart();
 
             // pipeline even more
             connection->d_func()->fillPipeline(socket);
@@ -655,6 +665,9 @@ void QHttpNetworkConnectionChannel::pipelineFlush()
     // happens only sometimes.
     socket->write(pipeline);
     pipeline.clear();
+
+    pipelineProgress.restart();
+    connection->d_func()->startPipelineStallTimer();
 }
 
 
@@ -796,6 +809,13 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
 {
     if (!socket)
         return;
+#ifndef QT_NO_SSL
+    // the server may have failed the handshake because of the session we offered
+    if (socketError == QAbstractSocket::SslHandshakeFailedError && !offeredSslSession.isEmpty()) {
+        QSslSessionCache::instance()->remove(sslSessionKey);
+        offeredSslSession.clear();
+    }
+#endif
     QNetworkReply::NetworkError errorCode = QNetworkReply::UnknownNetworkError;
 
     switch (socketError) {
@@ -962,6 +982,29 @@ void QHttpNetworkConnectionChannel::_q_uploadDataReadyRead()
 }
 
 #ifndef QT_NO_SSL
+// Offers the session of an earlier connection to the same server, so that
+// a new connection (for instance after the previous one timed out while
+// idle) does not need a full handshake. Sessions of the other channels of
+// this connection are shared through its QSslContext instead.
+void QHttpNetworkConnectionChannel::resumeCachedSslSession()
+{
+    QSslSocket *sslSocket = static_cast<QSslSocket *>(socket);
+    QSslConfiguration sslConfig = sslSocket->sslConfiguration();
+    // The session of the handshake is only handed out in serialized form
+    // if the application allows it to be persisted
+    if (sslConfig.testSslOption(QSsl::SslOptionDisableSessionSharing)
+        || sslConfig.testSslOption(QSsl::SslOptionDisableSessionPersistence)
+        || !sslConfig.sessionTicket().isEmpty()) {
+        return;
+    }
+
+    sslSessionKey = QSslSessionCache::key(connection->d_func()->hostName, connection->d_func()->port,
+                                          sslSocket->peerVerifyName(), sslConfig);
+    offeredSslSession = QSslSessionCache::instance()->find(sslSessionKey);
+    sslConfig.setSessionTicket(offeredSslSession);
+    sslSocket->setSslConfiguration(sslConfig);
+}
+
 void QHttpNetworkConnectionChannel::_q_encrypted()
 {
     QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
@@ -1003,6 +1046,25 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
     state = QHttpNetworkConnectionChannel::IdleState;
     pendingEncrypt = false;
 
+    const QSslConfiguration sslConfig = sslSocket->sslConfiguration();
+    if (!sslConfig.testSslOption(QSsl::SslOptionDisableSessionSharing)
+        && !sslConfig.testSslOption(QSsl::SslOptionDisableSessionPersistence)) {
+        if (sslSessionKey.isEmpty()) {
+            sslSessionKey = QSslSessionCache::key(connection->d_func()->hostName, connection->d_func()->port,
+                                                  sslSocket->peerVerifyName(), sslConfig);
+        }
+        QSslSessionCache *sessionCache = QSslSessionCache::instance();
+        const QByteArray session = sslConfig.sessionTicket();
+        // a different session means that the server refused to resume ours
+        if (!offeredSslSession.isEmpty() && session != offeredSslSession)
+            sessionCache->remove(sslSessionKey);
+        // a session set up while certificate errors were ignored must not
+        // let other clients skip the verification
+        if (sslSocket->sslErrors().isEmpty())
+            sessionCache->insert(sslSessionKey, session, sslConfig.sessionTicketLifeTimeHint());
+    }
+    offeredSslSession.clear();
+
     if (connection->connectionType() == QHttpNetworkConnection::ConnectionTypeSPDY) {
         // we call setSpdyWasUsed(true) on the replies in the SPDY handler when the request is sent
         if (spdyRequestsToSend.count() > 0)
@@ -52,6 +52,7 @@
 #include <qauthenticator.h>
 #include <qnetworkproxy.h>
 #include <qbuffer.h>
+#include <qelapsedtimer.h>
 
 #include <private/qhttpnetworkheader_p.h>
 #include <private/qhttpnetworkrequest_p.h>
@@ -117,11 +118,14 @@ public:
     bool ignoreAllSslErrors;
     QList<QSslError> ignoreSslErrorsList;
     QSslConfiguration sslConfiguration;
+    QByteArray sslSessionKey; // key of the session in QSslSessionCache
+    QByteArray offeredSslSession; // cached session offered to the server
     QMultiMap<int, HttpMessagePair> spdyRequestsToSend; // sorted by priority
     void ignoreSslErrors();
     void ignoreSslErrors(const QList<QSslError> &errors);
     void setSslConfiguration(const QSslConfiguration &config);
     void requeueSpdyRequests(); // when we wanted SPDY but got HTTP
+    void resumeCachedSslSession(); // when no other channel has handshaken yet
     // to emit the signal for all in-flight replies:
     void emitFinishedWithError(QNetworkReply::NetworkError error, const char *message);
 #endif
@@ -138,6 +142,7 @@ public:
     PipeliningSupport pipeliningSupported;
     QList<HttpMessagePair> alreadyPipelinedRequests;
     QByteArray pipeline; // temporary buffer that gets sent to socket in pipelineFlush
+    QElapsedTimer pipelineProgress; // restarted whenever the pipeline moves, see _q_checkPipelineStalls()
     void pipelineInto(HttpMessagePair &pair);
     void pipelineFlush();
     void requeueCurrentlyPipelinedRequests();
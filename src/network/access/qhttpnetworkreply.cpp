@@ -44,10 +44,6 @@
 #    include <QtNetwork/qsslconfiguration.h>
 #endif
 
-#ifndef QT_NO_COMPRESS
-#include <zlib.h>
-#endif
-
 QT_BEGIN_NAMESPACE
 
 QHttpNetworkReply::QHttpNetworkReply(const QUrl &url, QObject *parent)
@@ -61,11 +57,6 @@ QHttpNetworkReply::~QHttpNetworkReply()
     if (d->connection) {
         d->connection->d_func()->removeReply(this);
     }
-
-#ifndef QT_NO_COMPRESS
-    if (d->autoDecompress && d->isCompressed() && d->inflateStrm)
-        inflateEnd(d->inflateStrm);
-#endif
 }
 
 QUrl QHttpNetworkReply::url() const
@@ -315,9 +306,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       autoDecompress(false), responseData(), requestIsPrepared(false)
       ,pipeliningUsed(false), spdyUsed(false), downstreamLimited(false)
       ,userProvidedDownloadBuffer(0)
-#ifndef QT_NO_COMPRESS
-      ,inflateStrm(0)
-#endif
+      ,decoder(0)
 
 {
     QString scheme = newUrl.scheme();
@@ -329,10 +318,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
 
 QHttpNetworkReplyPrivate::~QHttpNetworkReplyPrivate()
 {
-#ifndef QT_NO_COMPRESS
-      if (inflateStrm)
-          delete inflateStrm;
-#endif
+    delete decoder;
 }
 
 void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
@@ -346,10 +332,8 @@ void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
     currentChunkRead = 0;
     lastChunkRead = false;
     connectionCloseEnabled = true;
-#ifndef QT_NO_COMPRESS
-    if (autoDecompress && inflateStrm)
-        inflateEnd(inflateStrm);
-#endif
+    delete decoder;
+    decoder = 0;
     fields.clear();
 }
 
@@ -370,8 +354,7 @@ qint64 QHttpNetworkReplyPrivate::bytesAvailable() const
 
 bool QHttpNetworkReplyPrivate::isCompressed()
 {
-    QByteArray encoding = headerField("content-encoding");
-    return qstricmp(encoding.constData(), "gzip") == 0 || qstricmp(encoding.constData(), "deflate") == 0;
+    return QHttpContentDecoder::isSupported(headerField("content-encoding"));
 }
 
 void QHttpNetworkReplyPrivate::removeAutoDecompressHeader()
@@ -575,16 +558,8 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
             (majorVersion == 1 && minorVersion == 0 &&
             (connectionHeaderField.isEmpty() && !headerField("proxy-connection").toLower().contains("keep-alive")));
 
-#ifndef QT_NO_COMPRESS
-        if (autoDecompress && isCompressed()) {
-            // allocate inflate state
-            if (!inflateStrm)
-                inflateStrm = new z_stream;
-            int ret = initializeInflateStream();
-            if (ret != Z_OK)
-                return -1;
-        }
-#endif
+        if (autoDecompress && isCompressed() && !createDecoder())
+            return -1;
 
     }
     return bytes;
@@ -665,16 +640,13 @@ qint64 QHttpNetworkReplyPrivate::readBodyFast(QAbstractSocket *socket, QByteData
     if (!toBeRead)
         return 0;
 
-    QByteArray bd;
-    bd.resize(toBeRead);
-    qint64 haveRead = socket->read(bd.data(), toBeRead);
-    if (haveRead == -1) {
-        bd.clear();
-        return 0; // ### error checking here;
+    // take over the socket's buffers instead of copying them
+    const QByteArrayList chunks = socket->readChunks(toBeRead);
+    qint64 haveRead = 0;
+    for (int i = 0; i < chunks.size(); ++i) {
+        rb->append(chunks.at(i));
+        haveRead += chunks.at(i).size();
     }
-    bd.resize(haveRead);
-
-    rb->append(bd);
 
     if (contentRead + haveRead == bodyLength) {
         state = AllDoneState;
@@ -689,12 +661,9 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
 {
     qint64 bytes = 0;
 
-#ifndef QT_NO_COMPRESS
-    // for gzip we'll allocate a temporary one that we then decompress
-    QByteDataBuffer *tempOutDataBuffer = (autoDecompress ? new QByteDataBuffer : out);
-#else
-    QByteDataBuffer *tempOutDataBuffer = out;
-#endif
+    // for gzip we'll read into a temporary one that we then decompress
+    QByteDataBuffer compressedDataBuffer;
+    QByteDataBuffer *tempOutDataBuffer = (autoDecompress ? &compressedDataBuffer : out);
 
 
     if (isChunked()) {
@@ -710,92 +679,41 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
         bytes += readReplyBodyRaw(socket, tempOutDataBuffer, socket->bytesAvailable());
     }
 
-#ifndef QT_NO_COMPRESS
     // This is true if there is compressed encoding and we're supposed to use it.
     if (autoDecompress) {
         qint64 uncompressRet = uncompressBodyData(tempOutDataBuffer, out);
-        delete tempOutDataBuffer;
         if (uncompressRet < 0)
             return -1;
     }
-#endif
 
     contentRead += bytes;
     return bytes;
 }
 
-#ifndef QT_NO_COMPRESS
-int QHttpNetworkReplyPrivate::initializeInflateStream()
+bool QHttpNetworkReplyPrivate::createDecoder()
 {
-    inflateStrm->zalloc = Z_NULL;
-    inflateStrm->zfree = Z_NULL;
-    inflateStrm->opaque = Z_NULL;
-    inflateStrm->avail_in = 0;
-    inflateStrm->next_in = Z_NULL;
-    // "windowBits can also be greater than 15 for optional gzip decoding.
-    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
-    // http://www.zlib.net/manual.html
-    int ret = inflateInit2(inflateStrm, MAX_WBITS+32);
-    Q_ASSERT(ret == Z_OK);
-    return ret;
+    delete decoder;
+    decoder = QHttpContentDecoder::create(headerField("content-encoding"));
+    if (!decoder)
+        return false;
+    decoder->setSafetyCheckThreshold(request.decompressedSafetyCheckThreshold());
+    return true;
 }
 
+// Decodes in into bounded chunks in out. This runs in the thread of the
+// connection, so the user thread only ever sees the decoded data.
 qint64 QHttpNetworkReplyPrivate::uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out)
 {
-    if (!inflateStrm) { // happens when called from the SPDY protocol handler
-        inflateStrm = new z_stream;
-        initializeInflateStream();
-    }
-
-    if (!inflateStrm)
+    if (!decoder && !createDecoder()) // happens when called from the SPDY protocol handler
         return -1;
 
-    bool triedRawDeflate = false;
-    for (int i = 0; i < in->bufferCount(); i++) {
-        QByteArray &bIn = (*in)[i];
-
-        inflateStrm->avail_in = bIn.size();
-        inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-
-        do {
-            QByteArray bOut;
-            // make a wild guess about the uncompressed size.
-            bOut.reserve(inflateStrm->avail_in * 3 + 512);
-            inflateStrm->avail_out = bOut.capacity();
-            inflateStrm->next_out = reinterpret_cast<Bytef*>(bOut.data());
-
-            int ret = inflate(inflateStrm, Z_NO_FLUSH);
-            //All negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
-            // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
-            if (ret == Z_DATA_ERROR && !triedRawDeflate) {
-                inflateEnd(inflateStrm);
-                triedRawDeflate = true;
-                inflateStrm->zalloc = Z_NULL;
-                inflateStrm->zfree = Z_NULL;
-                inflateStrm->opaque = Z_NULL;
-                inflateStrm->avail_in = 0;
-                inflateStrm->next_in = Z_NULL;
-                int ret = inflateInit2(inflateStrm, -MAX_WBITS);
-                if (ret != Z_OK) {
-                    return -1;
-                } else {
-                    inflateStrm->avail_in = bIn.size();
-                    inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-                    continue;
-                }
-            } else if (ret < 0 || ret == Z_NEED_DICT) {
-                return -1;
-            }
-            bOut.resize(bOut.capacity() - inflateStrm->avail_out);
-            out->append(bOut);
-            if (ret == Z_STREAM_END)
-                return out->byteAmount();
-        } while (inflateStrm->avail_in > 0);
+    for (int i = 0; i < in->bufferCount() && !decoder->atEnd(); i++) {
+        if (!decoder->decode((*in)[i], out))
+            return -1;
     }
 
     return out->byteAmount();
 }
-#endif
 
 qint64 QHttpNetworkReplyPrivate::readReplyBodyRaw(QAbstractSocket *socket, QByteDataBuffer *out, qint64 size)
 {
@@ -810,17 +728,17 @@ qint64 QHttpNetworkReplyPrivate::readReplyBodyRaw(QAbstractSocket *socket, QByte
         toBeRead = qMin<qint64>(toBeRead, readBufferMaxSize);
 
     while (toBeRead > 0) {
-        QByteArray byteData;
-        byteData.resize(toBeRead);
-        qint64 haveRead = socket->read(byteData.data(), byteData.size());
+        const QByteArrayList chunks = socket->readChunks(toBeRead);
+        qint64 haveRead = 0;
+        for (int i = 0; i < chunks.size(); ++i) {
+            out->append(chunks.at(i));
+            haveRead += chunks.at(i).size();
+        }
         if (haveRead <= 0) {
             // ### error checking here
-            byteData.clear();
             return bytes;
         }
 
-        byteData.resize(haveRead);
-        out->append(byteData);
         bytes += haveRead;
         size -= haveRead;
 
@@ -33,6 +33,7 @@
 
 #include "qhttpnetworkrequest_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
+#include "private/qhttpcontentdecoder_p.h"
 
 #ifndef QT_NO_HTTP
 
@@ -42,7 +43,8 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Oper
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
       autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false),
-      withCredentials(true), preConnect(false), followRedirect(false), redirectCount(0)
+      withCredentials(true), preConnect(false), followRedirect(false), redirectCount(0),
+      decompressedSafetyCheckThreshold(QHttpContentDecoder::DefaultSafetyCheckThreshold)
 {
 }
 
@@ -61,6 +63,7 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
     preConnect = other.preConnect;
     followRedirect = other.followRedirect;
     redirectCount = other.redirectCount;
+    decompressedSafetyCheckThreshold = other.decompressedSafetyCheckThreshold;
 }
 
 QHttpNetworkRequestPrivate::~QHttpNetworkRequestPrivate()
@@ -239,6 +242,16 @@ void QHttpNetworkRequest::setRedirectCount(int count)
     d->redirectCount = count;
 }
 
+qint64 QHttpNetworkRequest::decompressedSafetyCheckThreshold() const
+{
+    return d->decompressedSafetyCheckThreshold;
+}
+
+void QHttpNetworkRequest::setDecompressedSafetyCheckThreshold(qint64 threshold)
+{
+    d->decompressedSafetyCheckThreshold = threshold;
+}
+
 qint64 QHttpNetworkRequest::contentLength() const
 {
     return d->contentLength();
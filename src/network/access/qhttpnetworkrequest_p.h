@@ -124,6 +124,9 @@ public:
     int redirectCount() const;
     void setRedirectCount(int count);
 
+    qint64 decompressedSafetyCheckThreshold() const;
+    void setDecompressedSafetyCheckThreshold(qint64 threshold);
+
     void setUploadByteDevice(QNonContiguousByteDevice *bd);
     QNonContiguousByteDevice* uploadByteDevice() const;
 
@@ -162,6 +165,7 @@ public:
     bool preConnect;
     bool followRedirect;
     int redirectCount;
+    qint64 decompressedSafetyCheckThreshold;
 };
 
 
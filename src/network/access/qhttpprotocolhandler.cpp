@@ -35,6 +35,7 @@
 #include <private/qhttpprotocolhandler_p.h>
 #include <private/qnoncontiguousbytedevice_p.h>
 #include <private/qhttpnetworkconnectionchannel_p.h>
+#include <private/qabstractsocket_p.h>
 
 #ifndef QT_NO_HTTP
 
@@ -343,6 +344,10 @@ bool QHttpProtocolHandler::sendRequest()
         // only feed the QTcpSocket buffer when there is less than 32 kB in it
         const qint64 socketBufferFill = 32*1024;
         const qint64 socketWriteMaxSize = 16*1024;
+        // sending from a file needs no copy, but still report progress in steps
+        const qint64 socketFileWriteMaxSize = 256*1024;
+        // bytes sent straight from a file in this call; bytesWritten() follows for them
+        qint64 sentFromFile = 0;
 
 
 #ifndef QT_NO_SSL
@@ -355,6 +360,32 @@ bool QHttpProtocolHandler::sendRequest()
                && m_channel->bytesTotal != m_channel->written)
 #endif
         {
+            qint64 fileOffset = 0;
+            const qintptr fileHandle = m_channel->ssl ? -1 : uploadByteDevice->fileHandle(&fileOffset);
+            if (fileHandle != -1) {
+                const qint64 sent = QAbstractSocketPrivate::sendFile(m_socket, fileHandle, fileOffset,
+                                                                   qMin(socketFileWriteMaxSize, m_channel->bytesTotal - m_channel->written));
+                if (sent < 0)
+                    return false; // the socket reported the error
+                if (sent > 0) {
+                    sentFromFile += sent;
+                    m_channel->written += sent;
+                    uploadByteDevice->advanceReadPointer(sent);
+
+                    emit m_reply->dataSendProgress(m_channel->written, m_channel->bytesTotal);
+
+                    if (m_channel->written == m_channel->bytesTotal) {
+                        m_channel->state = QHttpNetworkConnectionChannel::WaitingState;
+                        sendRequest();
+                        break;
+                    }
+                    continue;
+                }
+                if (sentFromFile)
+                    break; // the socket is full
+                // otherwise copy the data through the upload device below
+            }
+
             // get pointer to upload data
             qint64 currentReadSize = 0;
             qint64 desiredReadSize = qMin(socketWriteMaxSize, m_channel->bytesTotal - m_channel->written);
@@ -40,6 +40,7 @@
 #include <QEventLoop>
 
 #include "private/qhttpnetworkreply_p.h"
+#include "private/qhttpconnectionpool_p.h"
 #include "private/qnetworkaccesscache_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 
@@ -187,6 +188,21 @@ public:
         setShareable(true);
     }
 
+#ifdef QT_NO_BEARERMANAGEMENT
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt)
+#else
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt, QSharedPointer<QNetworkSession> networkSession)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/0,
+                                 qMove(networkSession))
+#endif
+    {
+        setExpires(true);
+        setShareable(true);
+    }
+
     virtual void dispose() Q_DECL_OVERRIDE
     {
 #if 0  // sample code; do this right with the API
@@ -223,6 +239,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , bytesEmitted(0)
     , pendingDownloadData(0)
     , pendingDownloadProgress(0)
+    , sharedConnectionPool(false)
     , synchronous(false)
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
@@ -231,11 +248,19 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , incomingErrorCode(QNetworkReply::NoError)
     , downloadBuffer(0)
     , httpConnection(0)
+    , sharedConnection(false)
     , httpReply(0)
     , synchronousRequestLoop(0)
 {
 }
 
+// Closes the connections of the current thread that no request is using
+void QHttpThreadDelegate::clearUnusedConnections()
+{
+    if (connections.hasLocalData())
+        connections.localData()->clearUnusedEntries();
+}
+
 // This is invoked as BlockingQueuedConnection from QNetworkAccessHttpBackend in the user thread
 void QHttpThreadDelegate::startRequestSynchronously()
 {
@@ -273,6 +298,8 @@ void QHttpThreadDelegate::startRequest()
     if (!connections.hasLocalData()) {
         connections.setLocalData(new QNetworkAccessCache());
     }
+    if (sharedConnectionPool)
+        connections.localData()->setExpiryTimeout(QHttpConnectionPool::idleTimeout());
 
     // check if we have an open connection to this host
     QUrl urlCopy = httpRequest.url();
@@ -300,20 +327,72 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, 0);
 
+    // SPDY multiplexes everything over a single channel. In the shared pool,
+    // the pool's limit applies to all managers, so that they share one
+    // connection per host.
+    int channelCount = QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP) {
+        channelCount = sharedConnectionPool ? QHttpConnectionPool::channelCount()
+                                            : connectionPolicy.channelCount(urlCopy.host());
+        channelCount = qMin(channelCount, 0xffff);
+    }
+    if (channelCount != QHttpNetworkConnectionPrivate::defaultHttpChannelCount)
+        cacheKey += "#channels=" + QByteArray::number(channelCount);
+
+    // the pipelining settings are applied when the connection is created,
+    // so managers with different ones must not share it
+    const int maximumPipelineLength = connectionPolicy.maximumPipelineLength();
+    const int pipelineStallTimeout = connectionPolicy.pipelineStallTimeout();
+    if (maximumPipelineLength != QHttpNetworkConnectionPrivate::defaultPipelineLength
+        || pipelineStallTimeout != 0) {
+        cacheKey += "#pipeline=" + QByteArray::number(maximumPipelineLength)
+                + ',' + QByteArray::number(pipelineStallTimeout);
+    }
+
+    // A connection keeps the credentials it authenticated with (NTLM even
+    // authenticates the socket), and it is set up with the SSL configuration
+    // of the request that created it. Only hand it to other managers if
+    // neither can differ between them. Requests with a body cannot be sent
+    // again on another connection if the server asks for credentials.
+    sharedConnection = false;
+    if (sharedConnectionPool) {
+        bool ownConnection = httpRequest.uploadByteDevice()
+                || QHttpConnectionPool::requiresAuthentication(cacheKey)
+                || hasCredentials();
+#ifndef QT_NO_SSL
+        if (ssl && incomingSslConfiguration != QSslConfiguration::defaultConfiguration())
+            ownConnection = true;
+#endif
+        if (ownConnection)
+            cacheKey += "#manager=" + QByteArray::number(quintptr(authenticationManager.data()), 16);
+        else
+            sharedConnection = true;
+    }
 
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
     if (httpConnection == 0) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
+        if (channelCount == QHttpNetworkConnectionPrivate::defaultHttpChannelCount) {
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType);
+            httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+                                                                    connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType,
-                                                                networkSession);
+            httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+                                                                    connectionType,
+                                                                    networkSession);
 #endif
+        } else {
+#ifdef QT_NO_BEARERMANAGEMENT
+            httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                    urlCopy.port(), ssl);
+#else
+            httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                    urlCopy.port(), ssl,
+                                                                    networkSession);
+#endif
+        }
 #ifndef QT_NO_SSL
         // Set the QSslConfiguration from this QNetworkRequest.
         if (ssl && incomingSslConfiguration != QSslConfiguration::defaultConfiguration()) {
@@ -325,6 +404,8 @@ void QHttpThreadDelegate::startRequest()
         httpConnection->setTransparentProxy(transparentProxy);
         httpConnection->setCacheProxy(cacheProxy);
 #endif
+        httpConnection->setMaximumPipelineLength(maximumPipelineLength);
+        httpConnection->setPipelineStallTimeout(pipelineStallTimeout);
 
         // cache the QHttpNetworkConnection corresponding to this cache key
         connections.localData()->addEntry(cacheKey, httpConnection);
@@ -375,6 +456,18 @@ void QHttpThreadDelegate::startRequest()
                 this, SLOT(preSharedKeyAuthenticationRequiredSlot(QSslPreSharedKeyAuthenticator*)));
 #endif
 
+        // A shared connection must not answer the challenge with the
+        // credentials of this manager; this is connected first so that the
+        // signals are not forwarded
+        if (sharedConnection) {
+            connect(httpReply, SIGNAL(authenticationRequired(QHttpNetworkRequest,QAuthenticator*)),
+                    this, SLOT(sharedConnectionAuthenticationRequiredSlot()));
+#ifndef QT_NO_NETWORKPROXY
+            connect(httpReply, SIGNAL(proxyAuthenticationRequired(QNetworkProxy,QAuthenticator*)),
+                    this, SLOT(sharedConnectionAuthenticationRequiredSlot()));
+#endif
+        }
+
         // In the asynchronous HTTP case we can just forward those signals
         // Connect the reply signals that we can directly forward
         connect(httpReply, SIGNAL(authenticationRequired(QHttpNetworkRequest,QAuthenticator*)),
@@ -389,6 +482,57 @@ void QHttpThreadDelegate::startRequest()
             this, SLOT(cacheCredentialsSlot(QHttpNetworkRequest,QAuthenticator*)));
 }
 
+// Returns whether the request may send credentials, to the server or to the proxy
+bool QHttpThreadDelegate::hasCredentials() const
+{
+    const QUrl url = httpRequest.url();
+    if (!url.userName().isEmpty())
+        return true;
+    if (httpRequest.withCredentials() && !authenticationManager->fetchCachedCredentials(url).isNull())
+        return true;
+#ifndef QT_NO_NETWORKPROXY
+    const QNetworkProxy &proxy = transparentProxy.type() != QNetworkProxy::NoProxy
+            ? transparentProxy : cacheProxy;
+    if (proxy.type() != QNetworkProxy::NoProxy) {
+        if (!proxy.user().isEmpty() || !proxy.password().isEmpty())
+            return true;
+        if (!authenticationManager->fetchCachedProxyCredentials(proxy).isNull())
+            return true;
+    }
+#endif
+    return false;
+}
+
+// The server or proxy asked for credentials on a connection that is shared
+// with other managers. Leave the challenge unanswered there and send the
+// request again on a connection of this manager.
+void QHttpThreadDelegate::sharedConnectionAuthenticationRequiredSlot()
+{
+    if (!httpReply)
+        return;
+
+    QHttpConnectionPool::setRequiresAuthentication(cacheKey);
+    // the reply is still emitting; stop listening to it and restart later
+    QObject::disconnect(httpReply, 0, this, 0);
+    QMetaObject::invokeMethod(this, "restartOnOwnConnection", Qt::QueuedConnection);
+}
+
+void QHttpThreadDelegate::restartOnOwnConnection()
+{
+    if (!httpReply)
+        return; // aborted in the meantime
+
+    delete httpReply;
+    httpReply = 0;
+    connections.localData()->releaseEntry(cacheKey);
+    cacheKey.clear();
+    httpConnection = 0;
+
+    // requiresAuthentication() now makes startRequest() pick a connection
+    // of this manager
+    startRequest();
+}
+
 // This gets called from the user thread or by the synchronous HTTP timeout timer
 void QHttpThreadDelegate::abortRequest()
 {
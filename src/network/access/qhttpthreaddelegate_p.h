@@ -59,6 +59,7 @@
 #include "qsslconfiguration.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qhttpconnectionpolicy.h"
 
 #ifndef QT_NO_HTTP
 
@@ -78,6 +79,8 @@ public:
 
     ~QHttpThreadDelegate();
 
+    static void clearUnusedConnections();
+
     // incoming
     bool ssl;
 #ifndef QT_NO_SSL
@@ -95,6 +98,8 @@ public:
     QNetworkProxy transparentProxy;
 #endif
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
+    QHttpConnectionPolicy connectionPolicy;
+    bool sharedConnectionPool;
     bool synchronous;
 
     // outgoing, Retrieved in the synchronous HTTP case
@@ -117,6 +122,7 @@ protected:
     // The QHttpNetworkConnection that is used
     QNetworkAccessCachedHttpConnection *httpConnection;
     QByteArray cacheKey;
+    bool sharedConnection; // taken from the pool under a key all managers use
     QHttpNetworkReply *httpReply;
 
     // Used for implementing the synchronous HTTP, see startRequestSynchronously()
@@ -172,7 +178,12 @@ protected slots:
     void synchronousProxyAuthenticationRequiredSlot(const QNetworkProxy &, QAuthenticator *);
 #endif
 
+    void sharedConnectionAuthenticationRequiredSlot();
+    void restartOnOwnConnection();
+
 protected:
+    bool hasCredentials() const;
+
     // Cache for all the QHttpNetworkConnection objects.
     // This is per thread.
     static QThreadStorage<QNetworkAccessCache *> connections;
@@ -192,6 +203,8 @@ protected:
     bool m_atEnd;
     qint64 m_size;
     qint64 m_pos; // to match calls of haveDataSlot with the expected position
+    qintptr m_fileHandle;
+    qint64 m_fileOffset; // of m_pos 0
 public:
     QNonContiguousByteDeviceThreadForwardImpl(bool aE, qint64 s)
         : QNonContiguousByteDevice(),
@@ -200,10 +213,20 @@ public:
           m_data(0),
           m_atEnd(aE),
           m_size(s),
-          m_pos(0)
+          m_pos(0),
+          m_fileHandle(-1),
+          m_fileOffset(0)
     {
     }
 
+    // Lets the HTTP thread send the data straight from the file the user
+    // thread reads from; the user thread then only follows the position.
+    void setFileHandle(qintptr handle, qint64 offset)
+    {
+        m_fileHandle = handle;
+        m_fileOffset = offset;
+    }
+
     ~QNonContiguousByteDeviceThreadForwardImpl()
     {
     }
@@ -235,11 +258,16 @@ public:
 
     bool advanceReadPointer(qint64 a) Q_DECL_OVERRIDE
     {
-        if (m_data == 0)
+        if (m_fileHandle != -1 && m_amount == 0) {
+            // sent from the file; a chunk that was asked for meanwhile is
+            // for an old position and will be ignored in haveDataSlot()
+            wantDataPending = false;
+        } else if (m_data) {
+            m_amount -= a;
+            m_data += a;
+        } else {
             return false;
-
-        m_amount -= a;
-        m_data += a;
+        }
         m_pos += a;
 
         // To main thread to inform about our state. The m_pos will be sent as a sanity check.
@@ -252,6 +280,8 @@ public:
     {
         if (m_amount > 0)
             return false;
+        else if (m_fileHandle != -1 && m_size != -1 && m_pos >= m_size)
+            return true;
         else
             return m_atEnd;
     }
@@ -283,6 +313,15 @@ public:
         return m_size;
     }
 
+    qintptr fileHandle(qint64 *offset) Q_DECL_OVERRIDE
+    {
+        // data that was already forwarded to us has to be used up first
+        if (m_fileHandle == -1 || m_amount > 0)
+            return -1;
+        *offset = m_fileOffset + m_pos;
+        return m_fileHandle;
+    }
+
 public slots:
     // From user thread:
     void haveDataSlot(qint64 pos, QByteArray dataArray, bool dataAtEnd, qint64 dataSize)
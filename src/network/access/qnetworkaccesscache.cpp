@@ -96,7 +96,7 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
 }
 
 QNetworkAccessCache::QNetworkAccessCache()
-    : oldest(0), newest(0)
+    : oldest(0), newest(0), expiryTime(ExpiryTime)
 {
 }
 
@@ -126,6 +126,24 @@ void QNetworkAccessCache::clear()
     oldest = newest = 0;
 }
 
+/*!
+    Removes the entries that nobody uses and that would expire, without
+    waiting for them to expire.
+ */
+void QNetworkAccessCache::clearUnusedEntries()
+{
+    while (oldest) {
+        Node *next = oldest->newer;
+        oldest->object->dispose();
+
+        hash.remove(oldest->key); // oldest gets deleted
+        oldest = next;
+    }
+    newest = 0;
+
+    timer.stop();
+}
+
 /*!
     Appends the entry given by \a key to the end of the linked list.
     (i.e., makes it the newest entry)
@@ -151,7 +169,7 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
         oldest = node;
     }
 
-    node->timestamp = QDateTime::currentDateTime().addSecs(ExpiryTime);
+    node->timestamp = QDateTime::currentDateTime().addSecs(expiryTime);
     newest = node;
 }
 
@@ -87,6 +87,10 @@ public:
     ~QNetworkAccessCache();
 
     void clear();
+    void clearUnusedEntries();
+
+    int expiryTimeout() const { return expiryTime; }
+    void setExpiryTimeout(int secs) { expiryTime = secs; }
 
     void addEntry(const QByteArray &key, CacheableObject *entry);
     bool hasEntry(const QByteArray &key) const;
@@ -108,6 +112,7 @@ private:
     Node *newest;
 
     QBasicTimer timer;
+    int expiryTime;
 
     void linkEntry(const QByteArray &key);
     bool unlinkEntry(const QByteArray &key);
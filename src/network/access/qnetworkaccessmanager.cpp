@@ -64,6 +64,7 @@
 #include "qhttpmultipart_p.h"
 
 #include "qnetworkreplyhttpimpl_p.h"
+#include "qhttpconnectionpool_p.h"
 
 #include "qthread.h"
 
@@ -690,6 +691,40 @@ void QNetworkAccessManager::setCookieJar(QNetworkCookieJar *cookieJar)
     }
 }
 
+/*!
+    \since 5.6
+
+    Returns the policy that controls how HTTP connections are opened and
+    used by this manager.
+
+    \sa setHttpConnectionPolicy()
+*/
+QHttpConnectionPolicy QNetworkAccessManager::httpConnectionPolicy() const
+{
+    Q_D(const QNetworkAccessManager);
+    return d->httpConnectionPolicy;
+}
+
+/*!
+    \since 5.6
+
+    Sets the policy that controls how HTTP connections are opened and used
+    by this manager to \a policy. This includes the number of parallel
+    connections per host and whether, and how deeply, requests are
+    pipelined.
+
+    The policy applies to requests sent after this call. Connections that
+    are already open keep their number of channels until they expire; call
+    clearAccessCache() to close them.
+
+    \sa httpConnectionPolicy(), QHttpConnectionPolicy
+*/
+void QNetworkAccessManager::setHttpConnectionPolicy(const QHttpConnectionPolicy &policy)
+{
+    Q_D(QNetworkAccessManager);
+    d->httpConnectionPolicy = policy;
+}
+
 /*!
     Posts a request to obtain the network headers for \a request
     and returns a new QNetworkReply object which will contain such headers.
@@ -1521,6 +1556,9 @@ void QNetworkAccessManagerPrivate::clearCache(QNetworkAccessManager *manager)
             QObject::connect(manager->d_func()->httpThread, SIGNAL(finished()), manager->d_func()->httpThread, SLOT(deleteLater()));
         manager->d_func()->httpThread = 0;
     }
+
+    if (manager->d_func()->httpConnectionPolicy.isSharedConnectionPoolEnabled())
+        QHttpConnectionPool::clearIdleConnections();
 }
 
 QNetworkAccessManagerPrivate::~QNetworkAccessManagerPrivate()
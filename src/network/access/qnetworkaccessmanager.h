@@ -50,6 +50,7 @@ class QByteArray;
 template<typename T> class QList;
 class QNetworkCookie;
 class QNetworkCookieJar;
+class QHttpConnectionPolicy;
 class QNetworkRequest;
 class QNetworkReply;
 class QNetworkProxy;
@@ -111,6 +112,9 @@ public:
     QNetworkCookieJar *cookieJar() const;
     void setCookieJar(QNetworkCookieJar *cookieJar);
 
+    QHttpConnectionPolicy httpConnectionPolicy() const;
+    void setHttpConnectionPolicy(const QHttpConnectionPolicy &policy);
+
     QNetworkReply *head(const QNetworkRequest &request);
     QNetworkReply *get(const QNetworkRequest &request);
     QNetworkReply *post(const QNetworkRequest &request, QIODevice *data);
@@ -52,6 +52,7 @@
 #include "QtNetwork/qnetworkproxy.h"
 #include "QtNetwork/qnetworksession.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qhttpconnectionpolicy.h"
 #ifndef QT_NO_BEARERMANAGEMENT
 #include "QtNetwork/qnetworkconfigmanager.h"
 #endif
@@ -165,6 +166,8 @@ public:
 
     bool cookieJarCreated;
 
+    QHttpConnectionPolicy httpConnectionPolicy;
+
     // The cache with authorization data:
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
 
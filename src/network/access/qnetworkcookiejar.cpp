@@ -37,8 +37,11 @@
 #include "QtNetwork/qnetworkcookie.h"
 #include "QtCore/qurl.h"
 #include "QtCore/qdatetime.h"
+#include "QtCore/qstringlist.h"
 #include "private/qtldurl_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -76,10 +79,88 @@ QT_BEGIN_NAMESPACE
     QNetworkAccessManager when they detect new cookies and when they
     require cookies.
 
+    The cookies are indexed by domain, so the time cookiesForUrl() takes
+    depends on the number of cookies that can apply to the host, not on the
+    number of cookies in the jar. Expired cookies are removed from the jar
+    when a lookup comes across them.
+
     \sa QNetworkCookie, QNetworkAccessManager, QNetworkReply,
     QNetworkRequest, QNetworkAccessManager::setCookieJar()
 */
 
+void QNetworkCookieJarPrivate::clear()
+{
+    cookiesByDomain.clear();
+    allCookies.clear();
+    allCookiesValid = true;
+}
+
+void QNetworkCookieJarPrivate::addCookie(const QNetworkCookie &cookie)
+{
+    StoredCookie stored;
+    stored.cookie = cookie;
+    stored.sequence = nextSequence++;
+    cookiesByDomain[cookie.domain()].append(stored);
+    if (allCookiesValid)
+        allCookies.append(cookie);
+}
+
+bool QNetworkCookieJarPrivate::removeCookie(const QNetworkCookie &cookie)
+{
+    QHash<QString, CookieList>::Iterator bucket = cookiesByDomain.find(cookie.domain());
+    if (bucket == cookiesByDomain.end())
+        return false;
+
+    for (CookieList::Iterator it = bucket->begin(); it != bucket->end(); ++it) {
+        if (it->cookie.hasSameIdentifier(cookie)) {
+            bucket->erase(it);
+            if (bucket->isEmpty())
+                cookiesByDomain.erase(bucket);
+            allCookiesValid = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool sequenceLessThan(const QNetworkCookieJarPrivate::StoredCookie &c1,
+                             const QNetworkCookieJarPrivate::StoredCookie &c2)
+{
+    return c1.sequence < c2.sequence;
+}
+
+QList<QNetworkCookie> QNetworkCookieJarPrivate::cookieList() const
+{
+    if (!allCookiesValid) {
+        CookieList stored;
+        QHash<QString, CookieList>::ConstIterator bucket = cookiesByDomain.constBegin();
+        for ( ; bucket != cookiesByDomain.constEnd(); ++bucket)
+            stored += bucket.value();
+        std::sort(stored.begin(), stored.end(), sequenceLessThan);
+
+        allCookies.clear();
+        allCookies.reserve(stored.size());
+        for (int i = 0; i < stored.size(); ++i)
+            allCookies.append(stored.at(i).cookie);
+        allCookiesValid = true;
+    }
+    return allCookies;
+}
+
+/*
+    Returns the cookie domains that match \a host: the host itself, and the
+    host and each of its parent domains with a leading dot. This is the set
+    of domains for which isParentDomain(host, domain) is true.
+*/
+QStringList QNetworkCookieJarPrivate::matchingDomains(const QString &host)
+{
+    QStringList domains;
+    domains << host << QLatin1Char('.') + host;
+    for (int i = host.indexOf(QLatin1Char('.'), 1); i != -1; i = host.indexOf(QLatin1Char('.'), i + 1))
+        domains << host.mid(i);
+    return domains;
+}
+
 /*!
     Creates a QNetworkCookieJar object and sets the parent object to
     be \a parent.
@@ -112,7 +193,7 @@ QNetworkCookieJar::~QNetworkCookieJar()
 */
 QList<QNetworkCookie> QNetworkCookieJar::allCookies() const
 {
-    return d_func()->allCookies;
+    return d_func()->cookieList();
 }
 
 /*!
@@ -127,7 +208,9 @@ QList<QNetworkCookie> QNetworkCookieJar::allCookies() const
 void QNetworkCookieJar::setAllCookies(const QList<QNetworkCookie> &cookieList)
 {
     Q_D(QNetworkCookieJar);
-    d->allCookies = cookieList;
+    d->clear();
+    foreach (const QNetworkCookie &cookie, cookieList)
+        d->addCookie(cookie);
 }
 
 static inline bool isParentPath(const QString &path, const QString &reference)
@@ -157,6 +240,18 @@ static inline bool isParentDomain(const QString &domain, const QString &referenc
     return domain.endsWith(reference) || domain == reference.mid(1);
 }
 
+// longer paths first; cookies with paths of the same length in the order
+// they were added
+static bool cookieOrderLessThan(const QNetworkCookieJarPrivate::StoredCookie &c1,
+                                const QNetworkCookieJarPrivate::StoredCookie &c2)
+{
+    const int length1 = c1.cookie.path().length();
+    const int length2 = c2.cookie.path().length();
+    if (length1 != length2)
+        return length1 > length2;
+    return c1.sequence < c2.sequence;
+}
+
 /*!
     Adds the cookies in the list \a cookieList to this cookie
     jar. Before being inserted cookies are normalized.
@@ -217,39 +312,40 @@ QList<QNetworkCookie> QNetworkCookieJar::cookiesForUrl(const QUrl &url) const
 
     Q_D(const QNetworkCookieJar);
     QDateTime now = QDateTime::currentDateTime();
-    QList<QNetworkCookie> result;
     bool isEncrypted = url.scheme().toLower() == QLatin1String("https");
-
-    // scan our cookies for something that matches
-    QList<QNetworkCookie>::ConstIterator it = d->allCookies.constBegin(),
-                                        end = d->allCookies.constEnd();
-    for ( ; it != end; ++it) {
-        if (!isParentDomain(url.host(), it->domain()))
-            continue;
-        if (!isParentPath(url.path(), it->path()))
-            continue;
-        if (!(*it).isSessionCookie() && (*it).expirationDate() < now)
-            continue;
-        if ((*it).isSecure() && !isEncrypted)
+    const QString path = url.path();
+
+    // only look at the domains that can match the host
+    QNetworkCookieJarPrivate::CookieList matches;
+    foreach (const QString &domain, QNetworkCookieJarPrivate::matchingDomains(url.host())) {
+        QHash<QString, QNetworkCookieJarPrivate::CookieList>::Iterator bucket =
+                d->cookiesByDomain.find(domain);
+        if (bucket == d->cookiesByDomain.end())
             continue;
 
-        // insert this cookie into result, sorted by path
-        QList<QNetworkCookie>::Iterator insertIt = result.begin();
-        while (insertIt != result.end()) {
-            if (insertIt->path().length() < it->path().length()) {
-                // insert here
-                insertIt = result.insert(insertIt, *it);
-                break;
-            } else {
-                ++insertIt;
+        QNetworkCookieJarPrivate::CookieList::Iterator it = bucket->begin();
+        while (it != bucket->end()) {
+            const QNetworkCookie &cookie = it->cookie;
+            if (!cookie.isSessionCookie() && cookie.expirationDate() < now) {
+                // drop expired cookies as we come across them
+                it = bucket->erase(it);
+                d->allCookiesValid = false;
+                continue;
             }
+            if (isParentPath(path, cookie.path()) && (!cookie.isSecure() || isEncrypted))
+                matches += *it;
+            ++it;
         }
-
-        // this is the shortest path yet, just append
-        if (insertIt == result.end())
-            result += *it;
+        if (bucket->isEmpty())
+            d->cookiesByDomain.erase(bucket);
     }
 
+    std::sort(matches.begin(), matches.end(), cookieOrderLessThan);
+
+    QList<QNetworkCookie> result;
+    result.reserve(matches.size());
+    for (int i = 0; i < matches.size(); ++i)
+        result += matches.at(i).cookie;
     return result;
 }
 
@@ -272,7 +368,7 @@ bool QNetworkCookieJar::insertCookie(const QNetworkCookie &cookie)
     deleteCookie(cookie);
 
     if (!isDeletion) {
-        d->allCookies += cookie;
+        d->addCookie(cookie);
         return true;
     }
     return false;
@@ -306,14 +402,7 @@ bool QNetworkCookieJar::updateCookie(const QNetworkCookie &cookie)
 bool QNetworkCookieJar::deleteCookie(const QNetworkCookie &cookie)
 {
     Q_D(QNetworkCookieJar);
-    QList<QNetworkCookie>::Iterator it;
-    for (it = d->allCookies.begin(); it != d->allCookies.end(); ++it) {
-        if (it->hasSameIdentifier(cookie)) {
-            d->allCookies.erase(it);
-            return true;
-        }
-    }
-    return false;
+    return d->removeCookie(cookie);
 }
 
 /*!
@@ -47,16 +47,43 @@
 
 #include "private/qobject_p.h"
 #include "qnetworkcookie.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qvector.h"
 
 QT_BEGIN_NAMESPACE
 
 class QNetworkCookieJarPrivate: public QObjectPrivate
 {
 public:
-    QList<QNetworkCookie> allCookies;
+    QNetworkCookieJarPrivate()
+        : nextSequence(0), allCookiesValid(true)
+    {}
+
+    struct StoredCookie {
+        QNetworkCookie cookie;
+        quint64 sequence; // insertion order, which allCookies() preserves
+    };
+    typedef QVector<StoredCookie> CookieList;
+
+    void clear();
+    void addCookie(const QNetworkCookie &cookie);
+    bool removeCookie(const QNetworkCookie &cookie);
+    QList<QNetworkCookie> cookieList() const;
+    static QStringList matchingDomains(const QString &host);
+
+    // The cookies by their domain attribute, so that looking up the cookies
+    // for a host only needs to visit the few domains that can match it.
+    // Mutable because cookiesForUrl() drops the expired cookies it comes by.
+    mutable QHash<QString, CookieList> cookiesByDomain;
+    quint64 nextSequence;
+
+    // allCookies() in insertion order, built when asked for
+    mutable QList<QNetworkCookie> allCookies;
+    mutable bool allCookiesValid;
 
     Q_DECLARE_PUBLIC(QNetworkCookieJar)
 };
+Q_DECLARE_TYPEINFO(QNetworkCookieJarPrivate::StoredCookie, Q_MOVABLE_TYPE);
 
 QT_END_NAMESPACE
 
@@ -45,12 +45,20 @@
 #include <qdiriterator.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
+#include <qsavefile.h>
+#include <qmutex.h>
+#include <qwaitcondition.h>
+#include <qrunnable.h>
+#include <qthreadpool.h>
 #include <qdebug.h>
 
+#include <algorithm>
+
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -58,6 +66,136 @@
 
 QT_BEGIN_NAMESPACE
 
+enum
+{
+    IndexMagic = 0x69434451,
+    IndexVersion = 2,
+    IndexKeySize = 16
+};
+
+// The index file is a header followed by one fixed size record per cache
+// file, in the order they were last accessed, so it can be read straight
+// from a memory mapping. It uses the host's byte order. The directory stamp
+// tells whether cache files were added or removed after it was written.
+struct QNetworkDiskCacheIndexHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+    quint32 reserved;
+    qint64 directoryStamp;
+};
+
+struct QNetworkDiskCacheIndexRecord
+{
+    char key[IndexKeySize];
+    qint64 size;
+    qint64 lastAccess;
+    qint64 expirationDate;
+};
+
+typedef QHash<QString, QNetworkDiskCacheIndexEntry>::const_iterator QNetworkDiskCacheIndexIterator;
+
+/*
+    Orders index entries by how good a candidate for removal they are:
+    expired ones first, then the least recently used ones.
+*/
+class QNetworkDiskCacheEvictionOrder
+{
+public:
+    explicit QNetworkDiskCacheEvictionOrder(qint64 now) : now(now) {}
+
+    bool operator()(QNetworkDiskCacheIndexIterator a, QNetworkDiskCacheIndexIterator b) const
+    {
+        const bool aExpired = isExpired(a.value());
+        const bool bExpired = isExpired(b.value());
+        if (aExpired != bExpired)
+            return aExpired;
+        if (a.value().lastAccess != b.value().lastAccess)
+            return a.value().lastAccess < b.value().lastAccess;
+        return a.value().accessSerial < b.value().accessSerial;
+    }
+
+private:
+    inline bool isExpired(const QNetworkDiskCacheIndexEntry &entry) const
+    {
+        return entry.expirationDate > 0 && entry.expirationDate < now;
+    }
+
+    qint64 now;
+};
+
+/*
+    Rebuilds the index from the files in the data directory when it wasn't
+    saved, without blocking the thread using the cache.
+*/
+class QNetworkDiskCacheIndexScan
+{
+public:
+    struct Entry
+    {
+        QString key;
+        qint64 size;
+        qint64 lastModified;
+    };
+
+    explicit QNetworkDiskCacheIndexScan(const QString &directory)
+        : directory(directory), finished(false)
+    {
+    }
+
+    void run();
+
+    const QString directory;
+    QAtomicInt canceled;
+
+    QMutex mutex;
+    QWaitCondition condition;
+    bool finished;
+    QVector<Entry> entries;
+};
+
+void QNetworkDiskCacheIndexScan::run()
+{
+    QVector<Entry> found;
+    QDirIterator it(directory, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext() && !canceled.load()) {
+        const QString path = it.next();
+        if (!path.endsWith(CACHE_POSTFIX))
+            continue;
+        const QFileInfo info = it.fileInfo();
+        Entry entry;
+        entry.key = path.mid(directory.length());
+        entry.size = info.size();
+        entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+        found.append(entry);
+    }
+
+    QMutexLocker locker(&mutex);
+    entries.swap(found);
+    finished = true;
+    condition.wakeAll();
+}
+
+#ifndef QT_NO_THREAD
+class QNetworkDiskCacheIndexScanJob : public QRunnable
+{
+public:
+    explicit QNetworkDiskCacheIndexScanJob(const QSharedPointer<QNetworkDiskCacheIndexScan> &scan)
+        : scan(scan)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        scan->run();
+    }
+
+private:
+    QSharedPointer<QNetworkDiskCacheIndexScan> scan;
+};
+#endif
+
 /*!
     \class QNetworkDiskCache
     \since 4.5
@@ -71,8 +209,18 @@ QT_BEGIN_NAMESPACE
     and ends in ".cache".  Data is written to disk only in insert()
     and updateMetaData().
 
-    Currently you cannot share the same cache files with more than
-    one disk cache.
+    The size, last access time and expiration date of every cache file are
+    kept in an in-memory index, so expiring the cache does not need to scan
+    the cache directory. The index is saved in the cache directory when the
+    cache is destroyed or moved to another directory, and read back the
+    next time the directory is used. If it is missing, for instance because
+    the application crashed, or cache files were added or removed after it
+    was saved, it is rebuilt from the cache files in a background thread.
+
+    Several caches, also in different processes, can share a cache
+    directory. A cache file that another cache wrote is added to the index
+    when it is looked up, and the index another cache saved is merged into
+    this one's when it expires files or saves its own index.
 
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
@@ -109,6 +257,7 @@ QNetworkDiskCache::QNetworkDiskCache(QObject *parent)
 QNetworkDiskCache::~QNetworkDiskCache()
 {
     Q_D(QNetworkDiskCache);
+    d->saveIndex();
     QHashIterator<QIODevice*, QCacheItem*> it(d->inserting);
     while (it.hasNext()) {
         it.next();
@@ -143,6 +292,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
     Q_D(QNetworkDiskCache);
     if (cacheDir.isEmpty())
         return;
+    d->saveIndex();
     d->cacheDirectory = cacheDir;
     QDir dir(d->cacheDirectory);
     d->cacheDirectory = dir.absolutePath();
@@ -151,6 +301,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    d->loadIndex();
 }
 
 /*!
@@ -164,10 +315,8 @@ qint64 QNetworkDiskCache::cacheSize() const
     Q_D(const QNetworkDiskCache);
     if (d->cacheDirectory.isEmpty())
         return 0;
-    if (d->currentCacheSize < 0) {
-        QNetworkDiskCache *that = const_cast<QNetworkDiskCache*>(this);
-        that->d_func()->currentCacheSize = that->expire();
-    }
+    // The size is only known once the index is complete
+    const_cast<QNetworkDiskCachePrivate *>(d)->mergeIndexScan(true);
     return d->currentCacheSize;
 }
 
@@ -264,22 +413,20 @@ void QNetworkDiskCachePrivate::prepareLayout()
 
 void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 {
-    Q_Q(QNetworkDiskCache);
     Q_ASSERT(cacheItem->metaData.saveToDisk());
 
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
 
     if (QFile::exists(fileName)) {
-        if (!QFile::remove(fileName)) {
+        if (!removeFile(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
     }
 
-    if (currentCacheSize > 0)
-        currentCacheSize += 1024 + cacheItem->size();
-    currentCacheSize = q->expire();
+    // Make room for the new item
+    expire(1024 + cacheItem->size());
     if (!cacheItem->file) {
         QString templateName = tmpCacheFileName();
         cacheItem->file = new QTemporaryFile(templateName, &cacheItem->data);
@@ -295,7 +442,7 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
         if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
+            addToIndex(indexKey(fileName), cacheItem->file->size(), cacheItem->metaData.expirationDate());
         else
             cacheItem->file->setAutoRemove(true);
     }
@@ -303,6 +450,48 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         lastItem.reset();
 }
 
+/*!
+    Calls QNetworkDiskCache::expire(), counting \a reserved more bytes as
+    used while it runs, and updates the cache's size from its result.
+    A reimplementation of expire() that does not call the base
+    implementation removes files behind the index's back, so the index is
+    checked against the files afterwards.
+ */
+void QNetworkDiskCachePrivate::expire(qint64 reserved)
+{
+    Q_Q(QNetworkDiskCache);
+    currentCacheSize += reserved;
+    expireReachedBase = false;
+    const qint64 size = q->expire();
+    if (expireReachedBase) {
+        // the reservation is gone if expire() had to remove all files
+        currentCacheSize = qMax(size - reserved, qint64(0));
+    } else {
+        syncIndexWithFiles();
+        currentCacheSize = size;
+    }
+}
+
+/*!
+    Removes the entries whose files no longer exist from the index.
+ */
+void QNetworkDiskCachePrivate::syncIndexWithFiles()
+{
+    QStringList missing;
+    for (QNetworkDiskCacheIndexIterator it = index.constBegin(); it != index.constEnd(); ++it) {
+        if (!QFile::exists(dataDirectory + it.key()))
+            missing.append(it.key());
+    }
+    foreach (const QString &key, missing)
+        removeFromIndex(key);
+
+    // a running scan may have listed files that are gone by now
+    if (indexScan) {
+        cancelIndexScan();
+        startIndexScan(false);
+    }
+}
+
 /*!
     \reimp
 */
@@ -344,9 +533,10 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     QString fileName = info.fileName();
     if (!fileName.endsWith(CACHE_POSTFIX))
         return false;
-    qint64 size = info.size();
     if (QFile::remove(file)) {
-        currentCacheSize -= size;
+        const QString key = indexKey(file);
+        if (!key.isEmpty())
+            removeFromIndex(key);
         return true;
     }
     return false;
@@ -363,7 +553,18 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+
+    const QString fileName = d->cacheFileName(url);
+    const QString key = d->indexKey(fileName);
+    if (d->isKnownMiss(key))
+        return QNetworkCacheMetaData();
+
+    QNetworkCacheMetaData metaData = fileMetaData(fileName);
+    if (metaData.isValid())
+        d->touch(key);
+    else if (!QFile::exists(fileName))
+        d->removeFromIndex(key);
+    return metaData;
 }
 
 /*!
@@ -404,9 +605,17 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        const QString fileName = d->cacheFileName(url);
+        const QString key = d->indexKey(fileName);
+        if (d->isKnownMiss(key))
+            return 0;
+
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            d->removeFromIndex(key);
             return 0;
+        }
+        d->touch(key);
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
@@ -494,7 +703,7 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     bool expireCache = (size < d->maximumCacheSize);
     d->maximumCacheSize = size;
     if (expireCache)
-        d->currentCacheSize = expire();
+        d->expire();
 }
 
 /*!
@@ -502,22 +711,27 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     Returns the current size of the cache.
 
     When the current size of the cache is greater than the maximumCacheSize()
-    older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    cache files are removed until the total size is less then 90% of
+    maximumCacheSize(). Files whose expiration date has passed are removed
+    first, followed by the least recently used ones. The candidates are taken
+    from the cache's index, so the cache directory does not have to be
+    scanned.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
     knows about that QNetworkDiskCache does not, for example the number of times
-    a cache is accessed.
-
-    \note cacheSize() calls expire if the current cache size is unknown.
+    a cache is accessed. The cache's size is then set to the value returned
+    by the reimplementation, and unless it calls this implementation, the
+    cache checks which of the files in its index are still there.
 
     \sa maximumCacheSize(), fileMetaData()
  */
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
+    d->expireReachedBase = true;
+    d->mergeIndexScan(false);
+    d->mergeSavedIndex();
     if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
         return d->currentCacheSize;
 
@@ -529,57 +743,41 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            cacheItems.insert(info.created(), path);
-            totalSize += info.size();
-        }
-    }
-
-    int removedFiles = 0;
     qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
-            break;
-        QString name = i.value();
-        QFile file(name);
+    if (goal <= 0) {
+        d->removeAllFiles();
+        return 0;
+    }
 
-        if (name.contains(PREPARED_SLASH)) {
-            QHashIterator<QIODevice*, QCacheItem*> iterator(d->inserting);
-            while (iterator.hasNext()) {
-                iterator.next();
-                QCacheItem *item = iterator.value();
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = 0;
-                    break;
-                }
-            }
-        }
+    // While the index is still being rebuilt only the files known so far
+    // are candidates; the rest is taken into account by the next call.
+    QVector<QNetworkDiskCacheIndexIterator> candidates;
+    candidates.reserve(d->index.size());
+    for (QNetworkDiskCacheIndexIterator it = d->index.constBegin(); it != d->index.constEnd(); ++it)
+        candidates.append(it);
+    std::sort(candidates.begin(), candidates.end(),
+              QNetworkDiskCacheEvictionOrder(QDateTime::currentMSecsSinceEpoch()));
+
+    QStringList victims;
+    qint64 remainingSize = d->currentCacheSize;
+    for (int i = 0; i < candidates.size() && remainingSize >= goal; ++i) {
+        victims.append(candidates.at(i).key());
+        remainingSize -= candidates.at(i).value().size;
+    }
+    candidates.clear();
 
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
-        ++removedFiles;
-        ++i;
+    foreach (const QString &key, victims) {
+        QFile::remove(d->dataDirectory + key);
+        d->removeFromIndex(key);
     }
 #if defined(QNETWORKDISKCACHE_DEBUG)
-    if (removedFiles > 0) {
+    if (!victims.isEmpty()) {
         qDebug() << "QNetworkDiskCache::expire()"
-                << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Removed:" << victims.count()
+                << "Kept:" << d->index.count();
     }
 #endif
-    return totalSize;
+    return d->currentCacheSize;
 }
 
 /*!
@@ -593,7 +791,7 @@ void QNetworkDiskCache::clear()
     Q_D(QNetworkDiskCache);
     qint64 size = d->maximumCacheSize;
     d->maximumCacheSize = 0;
-    d->currentCacheSize = expire();
+    d->expire();
     d->maximumCacheSize = size;
 }
 
@@ -636,6 +834,383 @@ QString QNetworkDiskCachePrivate::cacheFileName(const QUrl &url) const
     return  fullpath;
 }
 
+QString QNetworkDiskCachePrivate::indexFileName() const
+{
+    return dataDirectory + INDEX_FILE;
+}
+
+/*!
+    Returns the index key of \a fileName, or an empty string if it is not
+    a file in the data directory.
+ */
+QString QNetworkDiskCachePrivate::indexKey(const QString &fileName) const
+{
+    if (dataDirectory.isEmpty() || !fileName.startsWith(dataDirectory))
+        return QString();
+    return fileName.mid(dataDirectory.length());
+}
+
+/*!
+    Returns a value that changes whenever a cache file is added to or
+    removed from the data directory, as that changes the modification time
+    of its subdirectory.
+ */
+qint64 QNetworkDiskCachePrivate::directoryStamp() const
+{
+    qint64 stamp = 0;
+    for (uint i = 0; i < 16; ++i) {
+        const QFileInfo info(dataDirectory + QString::number(i, 16));
+        stamp = stamp * 31 + info.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+/*!
+    Reads the index file of the data directory into \a entries, numbering
+    their accesses from 1 in the order of the file, and its directory stamp
+    into \a stamp. Returns \c false if there is no valid index file.
+ */
+bool QNetworkDiskCachePrivate::readIndexFile(QHash<QString, QNetworkDiskCacheIndexEntry> *entries,
+                                             qint64 *stamp) const
+{
+    QFile file(indexFileName());
+    if (!file.open(QFile::ReadOnly))
+        return false;
+    const qint64 size = file.size();
+    const uchar *data = 0;
+    if (size >= qint64(sizeof(QNetworkDiskCacheIndexHeader)))
+        data = file.map(0, size);
+    if (!data)
+        return false;
+
+    QNetworkDiskCacheIndexHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != IndexMagic || header.version != IndexVersion
+        || size != qint64(sizeof(header) + header.count * sizeof(QNetworkDiskCacheIndexRecord))) {
+        return false;
+    }
+
+    const QNetworkDiskCacheIndexRecord *records =
+            reinterpret_cast<const QNetworkDiskCacheIndexRecord *>(data + sizeof(header));
+    entries->reserve(header.count);
+    for (quint32 i = 0; i < header.count; ++i) {
+        const QNetworkDiskCacheIndexRecord &record = records[i];
+        const QString key = QString::fromLatin1(record.key, qstrnlen(record.key, IndexKeySize));
+        if (!key.endsWith(CACHE_POSTFIX) || key.contains(QLatin1String("..")))
+            continue;
+        QNetworkDiskCacheIndexEntry entry;
+        entry.size = record.size;
+        entry.lastAccess = record.lastAccess;
+        entry.expirationDate = record.expirationDate;
+        entry.accessSerial = entries->size() + 1;
+        entries->insert(key, entry);
+    }
+    *stamp = header.directoryStamp;
+    return true;
+}
+
+/*!
+    Reads the index saved for the data directory and removes its file, as
+    it goes stale as soon as the cache is used. Starts rebuilding the index
+    if there is none, or if cache files were added or removed after it was
+    saved.
+ */
+void QNetworkDiskCachePrivate::loadIndex()
+{
+    cancelIndexScan();
+    index.clear();
+    scanHints.clear();
+    accessSerial = 0;
+    currentCacheSize = 0;
+    savedIndexModified = 0;
+
+    QHash<QString, QNetworkDiskCacheIndexEntry> saved;
+    qint64 stamp = 0;
+    const bool loaded = readIndexFile(&saved, &stamp);
+    QFile::remove(indexFileName());
+
+    if (loaded && stamp == directoryStamp()) {
+        index.swap(saved);
+        accessSerial = index.size();
+        for (QNetworkDiskCacheIndexIterator it = index.constBegin(); it != index.constEnd(); ++it)
+            currentCacheSize += it.value().size;
+    } else if (loaded) {
+        // Another cache sharing the directory, or one that crashed, changed
+        // it since: the index only knows when its files were last used
+        scanHints.swap(saved);
+        startIndexScan(false);
+    } else {
+        startIndexScan(true);
+    }
+}
+
+/*!
+    Adds the files in the index that another cache sharing the data
+    directory saved to this cache's index, unless they are gone by now.
+ */
+void QNetworkDiskCachePrivate::mergeSavedIndex()
+{
+    const QFileInfo info(indexFileName());
+    if (!info.exists())
+        return;
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    if (modified == savedIndexModified)
+        return;
+    savedIndexModified = modified;
+
+    QHash<QString, QNetworkDiskCacheIndexEntry> saved;
+    qint64 stamp = 0;
+    if (!readIndexFile(&saved, &stamp))
+        return;
+    for (QNetworkDiskCacheIndexIterator it = saved.constBegin(); it != saved.constEnd(); ++it) {
+        if (index.contains(it.key()) || removedDuringScan.contains(it.key()))
+            continue;
+        if (!QFile::exists(dataDirectory + it.key()))
+            continue;
+        QNetworkDiskCacheIndexEntry entry = it.value();
+        entry.accessSerial = 0;
+        index.insert(it.key(), entry);
+        currentCacheSize += entry.size;
+    }
+}
+
+/*!
+    Writes the index of the data directory, unless it is still being
+    rebuilt: the files an incomplete index misses would never be found again.
+    The index another cache sharing the directory saved is merged first, so
+    that its files are not lost. Nothing is written for an empty cache,
+    rebuilding its index is cheap.
+ */
+void QNetworkDiskCachePrivate::saveIndex()
+{
+    if (dataDirectory.isEmpty())
+        return;
+    if (indexScan) {
+        cancelIndexScan();
+        return;
+    }
+    mergeSavedIndex();
+    if (index.isEmpty())
+        return;
+
+    QVector<QNetworkDiskCacheIndexIterator> entries;
+    entries.reserve(index.size());
+    for (QNetworkDiskCacheIndexIterator it = index.constBegin(); it != index.constEnd(); ++it)
+        entries.append(it);
+    std::sort(entries.begin(), entries.end(), QNetworkDiskCacheEvictionOrder(0));
+
+    QSaveFile file(indexFileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "QNetworkDiskCache: couldn't write the cache index" << file.fileName();
+        return;
+    }
+
+    QNetworkDiskCacheIndexHeader header;
+    header.magic = IndexMagic;
+    header.version = IndexVersion;
+    header.count = 0;
+    header.reserved = 0;
+    header.directoryStamp = directoryStamp();
+
+    QByteArray records;
+    records.reserve(entries.size() * int(sizeof(QNetworkDiskCacheIndexRecord)));
+    for (int i = 0; i < entries.size(); ++i) {
+        const QByteArray key = entries.at(i).key().toLatin1();
+        if (key.size() >= IndexKeySize)
+            continue;
+        QNetworkDiskCacheIndexRecord record;
+        memset(&record, 0, sizeof(record));
+        memcpy(record.key, key.constData(), key.size());
+        record.size = entries.at(i).value().size;
+        record.lastAccess = entries.at(i).value().lastAccess;
+        record.expirationDate = entries.at(i).value().expirationDate;
+        records.append(reinterpret_cast<const char *>(&record), sizeof(record));
+        ++header.count;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(records);
+    file.commit();
+}
+
+/*!
+    Starts rebuilding the index in the background. If \a removeLeftovers is
+    true, the cache wasn't closed properly, so the files left in prepared/
+    belong to items that were never inserted and are removed.
+ */
+void QNetworkDiskCachePrivate::startIndexScan(bool removeLeftovers)
+{
+    if (removeLeftovers) {
+        QDirIterator it(cacheDirectory + PREPARED_SLASH, QDir::Files | QDir::NoDotAndDotDot);
+        while (it.hasNext()) {
+            const QString path = it.next();
+            bool inUse = false;
+            QHashIterator<QIODevice*, QCacheItem*> iterator(inserting);
+            while (iterator.hasNext() && !inUse) {
+                iterator.next();
+                QCacheItem *item = iterator.value();
+                inUse = item && item->file && item->file->fileName() == path;
+            }
+            if (!inUse)
+                QFile::remove(path);
+        }
+    }
+
+    indexScan = QSharedPointer<QNetworkDiskCacheIndexScan>::create(dataDirectory);
+#ifndef QT_NO_THREAD
+    QThreadPool::globalInstance()->start(new QNetworkDiskCacheIndexScanJob(indexScan));
+#else
+    indexScan->run();
+#endif
+}
+
+void QNetworkDiskCachePrivate::cancelIndexScan()
+{
+    if (!indexScan)
+        return;
+    indexScan->canceled.store(1);
+    indexScan.clear();
+    removedDuringScan.clear();
+}
+
+/*!
+    Adds the files found by the index scan to the index once it has
+    finished, waiting for it if \a wait is true. Files that were inserted
+    or removed in the meantime keep their current state.
+ */
+void QNetworkDiskCachePrivate::mergeIndexScan(bool wait)
+{
+    if (!indexScan)
+        return;
+
+    QVector<QNetworkDiskCacheIndexScan::Entry> entries;
+    {
+        QMutexLocker locker(&indexScan->mutex);
+        if (!indexScan->finished && !wait)
+            return;
+        while (!indexScan->finished)
+            indexScan->condition.wait(&indexScan->mutex);
+        entries.swap(indexScan->entries);
+    }
+    indexScan.clear();
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const QNetworkDiskCacheIndexScan::Entry &scanned = entries.at(i);
+        if (index.contains(scanned.key) || removedDuringScan.contains(scanned.key))
+            continue;
+        QNetworkDiskCacheIndexEntry entry;
+        const QHash<QString, QNetworkDiskCacheIndexEntry>::const_iterator hint = scanHints.constFind(scanned.key);
+        if (hint != scanHints.constEnd()) {
+            entry = hint.value();
+        } else {
+            entry.lastAccess = scanned.lastModified;
+            entry.expirationDate = 0;
+            entry.accessSerial = 0;
+        }
+        entry.size = scanned.size;
+        index.insert(scanned.key, entry);
+        currentCacheSize += entry.size;
+    }
+    removedDuringScan.clear();
+    scanHints.clear();
+}
+
+/*!
+    Returns \c true if there is no cache file for \a key. Another cache
+    sharing the data directory may have written one that the index doesn't
+    know about, so a key missing from the index is looked up on disk, and
+    the file found that way is added to the index.
+ */
+bool QNetworkDiskCachePrivate::isKnownMiss(const QString &key)
+{
+    mergeIndexScan(false);
+    if (index.contains(key))
+        return false;
+    if (key.isEmpty())
+        return true;
+    const QFileInfo info(dataDirectory + key);
+    if (!info.isFile())
+        return true;
+
+    QNetworkDiskCacheIndexEntry entry;
+    entry.size = info.size();
+    entry.lastAccess = info.lastModified().toMSecsSinceEpoch();
+    entry.expirationDate = 0;
+    entry.accessSerial = 0;
+    index.insert(key, entry);
+    currentCacheSize += entry.size;
+    return false;
+}
+
+void QNetworkDiskCachePrivate::touch(const QString &key)
+{
+    QHash<QString, QNetworkDiskCacheIndexEntry>::iterator it = index.find(key);
+    if (it == index.end())
+        return;
+    it->lastAccess = QDateTime::currentMSecsSinceEpoch();
+    it->accessSerial = ++accessSerial;
+}
+
+void QNetworkDiskCachePrivate::addToIndex(const QString &key, qint64 size, const QDateTime &expirationDate)
+{
+    if (key.isEmpty())
+        return;
+    removeFromIndex(key);
+
+    QNetworkDiskCacheIndexEntry entry;
+    entry.size = size;
+    entry.lastAccess = QDateTime::currentMSecsSinceEpoch();
+    entry.expirationDate = expirationDate.isValid() ? expirationDate.toMSecsSinceEpoch() : 0;
+    entry.accessSerial = ++accessSerial;
+    index.insert(key, entry);
+    currentCacheSize += size;
+}
+
+void QNetworkDiskCachePrivate::removeFromIndex(const QString &key)
+{
+    QHash<QString, QNetworkDiskCacheIndexEntry>::iterator it = index.find(key);
+    if (it != index.end()) {
+        currentCacheSize -= it->size;
+        index.erase(it);
+    }
+    if (indexScan)
+        removedDuringScan.insert(key);
+}
+
+/*!
+    Removes every cache file in the cache directory, including the ones the
+    index doesn't know about and the ones still being prepared.
+ */
+void QNetworkDiskCachePrivate::removeAllFiles()
+{
+    cancelIndexScan();
+
+    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
+    QDirIterator it(cacheDirectory, filters, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (!it.fileInfo().fileName().endsWith(CACHE_POSTFIX))
+            continue;
+
+        if (path.contains(PREPARED_SLASH)) {
+            QHashIterator<QIODevice*, QCacheItem*> iterator(inserting);
+            while (iterator.hasNext()) {
+                iterator.next();
+                QCacheItem *item = iterator.value();
+                if (item && item->file && item->file->fileName() == path) {
+                    delete item->file;
+                    item->file = 0;
+                    break;
+                }
+            }
+        }
+        QFile::remove(path);
+    }
+
+    index.clear();
+    currentCacheSize = 0;
+}
+
 /*!
     We compress small text and JavaScript files.
  */
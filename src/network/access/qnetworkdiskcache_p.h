@@ -49,6 +49,8 @@
 
 #include <qbuffer.h>
 #include <qhash.h>
+#include <qset.h>
+#include <qsharedpointer.h>
 #include <qtemporaryfile.h>
 
 #ifndef QT_NO_NETWORKDISKCACHE
@@ -56,6 +58,7 @@
 QT_BEGIN_NAMESPACE
 
 class QFile;
+class QNetworkDiskCacheIndexScan;
 
 class QCacheItem
 {
@@ -87,6 +90,15 @@ public:
     bool canCompress() const;
 };
 
+struct QNetworkDiskCacheIndexEntry
+{
+    qint64 size;
+    qint64 lastAccess;      // msecs since epoch
+    qint64 expirationDate;  // msecs since epoch, 0 if unknown
+    quint64 accessSerial;   // orders accesses within the same msec
+};
+Q_DECLARE_TYPEINFO(QNetworkDiskCacheIndexEntry, Q_PRIMITIVE_TYPE);
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -94,6 +106,9 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , accessSerial(0)
+        , savedIndexModified(0)
+        , expireReachedBase(false)
         {}
 
     static QString uniqueFileName(const QUrl &url);
@@ -101,15 +116,45 @@ public:
     QString tmpCacheFileName() const;
     bool removeFile(const QString &file);
     void storeItem(QCacheItem *item);
+    void expire(qint64 reserved = 0);
+    void syncIndexWithFiles();
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    QString indexFileName() const;
+    QString indexKey(const QString &fileName) const;
+    qint64 directoryStamp() const;
+    bool readIndexFile(QHash<QString, QNetworkDiskCacheIndexEntry> *entries, qint64 *stamp) const;
+    void loadIndex();
+    void mergeSavedIndex();
+    void saveIndex();
+    void startIndexScan(bool removeLeftovers);
+    void cancelIndexScan();
+    void mergeIndexScan(bool wait);
+    bool isKnownMiss(const QString &key);
+    void touch(const QString &key);
+    void addToIndex(const QString &key, qint64 size, const QDateTime &expirationDate);
+    void removeFromIndex(const QString &key);
+    void removeAllFiles();
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
 
+    // In-memory index of the files in dataDirectory, keyed by their path
+    // relative to it. It is written to disk when the cache is closed and
+    // read back (and removed) when it is opened again; a missing or stale
+    // index means it has to be rebuilt from the directory in the background.
+    QHash<QString, QNetworkDiskCacheIndexEntry> index;
+    quint64 accessSerial;
+    QSharedPointer<QNetworkDiskCacheIndexScan> indexScan;
+    QSet<QString> removedDuringScan;
+    QHash<QString, QNetworkDiskCacheIndexEntry> scanHints; // stale index entries
+    qint64 savedIndexModified;  // of the index file merged last
+    bool expireReachedBase;     // set by QNetworkDiskCache::expire()
+
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
@@ -46,6 +46,7 @@
 #include "QtCore/qelapsedtimer.h"
 #include "QtNetwork/qsslconfiguration.h"
 #include "qhttpthreaddelegate_p.h"
+#include "qhttpconnectionpool_p.h"
 #include "qthread.h"
 #include "QtCore/qcoreapplication.h"
 
@@ -364,6 +365,31 @@ qint64 QNetworkReplyHttpImpl::readData(char* data, qint64 maxlen)
     return bytesRead;
 }
 
+// Hands out the arrays received from the HTTP thread instead of copying them
+qint64 QNetworkReplyHttpImplPrivate::readChunks(QByteArrayList *chunks, qint64 maxSize)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+    if (cacheLoadDevice || downloadZerocopyBuffer || (openMode & QIODevice::Text))
+        return QNetworkReplyPrivate::readChunks(chunks, maxSize);
+
+    qint64 readSoFar = readBufferedChunks(chunks, maxSize);
+    qint64 bytesRead = 0;
+    while (!downloadMultiBuffer.isEmpty() && (maxSize < 0 || readSoFar < maxSize)) {
+        QByteArray chunk;
+        if (maxSize < 0 || downloadMultiBuffer.sizeNextBlock() <= maxSize - readSoFar)
+            chunk = downloadMultiBuffer.read();
+        else
+            chunk = downloadMultiBuffer.read(maxSize - readSoFar);
+        chunks->append(chunk);
+        readSoFar += chunk.size();
+        bytesRead += chunk.size();
+    }
+
+    if (bytesRead && q->readBufferSize())
+        emit q->readBufferFreed(bytesRead);
+    return readSoFar;
+}
+
 void QNetworkReplyHttpImpl::setReadBufferSize(qint64 size)
 {
     QNetworkReply::setReadBufferSize(size);
@@ -603,22 +629,28 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     Q_Q(QNetworkReplyHttpImpl);
 
     QThread *thread = 0;
+    bool sharedConnectionPool = false;
     if (synchronous) {
         // A synchronous HTTP request uses its own thread
         thread = new QThread();
         thread->setObjectName(QStringLiteral("Qt HTTP synchronous thread"));
         QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
         thread->start();
-    } else if (!managerPrivate->httpThread) {
-        // We use the manager-global thread.
-        // At some point we could switch to having multiple threads if it makes sense.
-        managerPrivate->httpThread = new QThread();
-        managerPrivate->httpThread->setObjectName(QStringLiteral("Qt HTTP thread"));
-        managerPrivate->httpThread->start();
-
-        thread = managerPrivate->httpThread;
-    } else {
-        // Asynchronous request, thread already exists
+    } else if (managerPrivate->httpConnectionPolicy.isSharedConnectionPoolEnabled()) {
+        // All managers that share the connection pool use its thread,
+        // because a connection can only be used from the thread that owns it.
+        thread = QHttpConnectionPool::poolThread();
+        sharedConnectionPool = (thread != 0);
+    }
+
+    if (!thread) {
+        if (!managerPrivate->httpThread) {
+            // We use the manager-global thread.
+            // At some point we could switch to having multiple threads if it makes sense.
+            managerPrivate->httpThread = new QThread();
+            managerPrivate->httpThread->setObjectName(QStringLiteral("Qt HTTP thread"));
+            managerPrivate->httpThread->start();
+        }
         thread = managerPrivate->httpThread;
     }
 
@@ -748,7 +780,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     foreach (const QByteArray &header, headers)
         httpRequest.setHeaderField(header, newHttpRequest.rawHeader(header));
 
-    if (newHttpRequest.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute).toBool() == true)
+    if (newHttpRequest.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute,
+                                 managerPrivate->httpConnectionPolicy.isPipeliningEnabled()).toBool() == true)
         httpRequest.setPipeliningAllowed(true);
 
     if (request.attribute(QNetworkRequest::SpdyAllowedAttribute).toBool() == true)
@@ -762,6 +795,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     if (request.attribute(QNetworkRequest::EmitAllUploadProgressSignalsAttribute).toBool() == true)
         emitAllUploadProgressSignals = true;
 
+    QVariant decompressedSafetyCheckThreshold = newHttpRequest.attribute(QNetworkRequest::DecompressedSafetyCheckThresholdAttribute);
+    if (decompressedSafetyCheckThreshold.isValid())
+        httpRequest.setDecompressedSafetyCheckThreshold(decompressedSafetyCheckThreshold.toLongLong());
+
 
     // Create the HTTP thread delegate
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
@@ -791,6 +828,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     // The authentication manager is used to avoid the BlockingQueuedConnection communication
     // from HTTP thread to user thread in some cases.
     delegate->authenticationManager = managerPrivate->authenticationManager;
+    delegate->connectionPolicy = managerPrivate->httpConnectionPolicy;
+    delegate->sharedConnectionPool = sharedConnectionPool;
 
     if (!synchronous) {
         // Tell our zerocopy policy to the delegate
@@ -870,6 +909,12 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
             forwardUploadDevice->setParent(delegate); // needed to make sure it is moved on moveToThread()
             delegate->httpRequest.setUploadByteDevice(forwardUploadDevice);
 
+            // If the data comes from a file, the HTTP thread may send it from there directly
+            qint64 fileOffset = 0;
+            const qintptr fileHandle = uploadByteDevice->fileHandle(&fileOffset);
+            if (fileHandle != -1)
+                forwardUploadDevice->setFileHandle(fileHandle, fileOffset);
+
             // If the device in the user thread claims it has more data, keep the flow to HTTP thread going
             QObject::connect(uploadByteDevice.data(), SIGNAL(readyRead()),
                              q, SLOT(uploadByteDeviceReadyReadSlot()),
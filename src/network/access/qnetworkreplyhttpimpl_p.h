@@ -161,6 +161,8 @@ public:
     bool start(const QNetworkRequest &newHttpRequest);
     void _q_startOperation();
 
+    qint64 readChunks(QByteArrayList *chunks, qint64 maxSize) Q_DECL_OVERRIDE;
+
     void _q_cacheLoadReadyRead();
 
     void _q_bufferOutgoingData();
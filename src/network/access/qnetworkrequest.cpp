@@ -264,6 +264,15 @@ QT_BEGIN_NAMESPACE
         HTTP redirect response or not. Currently redirects that are insecure,
         that is redirecting from "https" to "http" protocol, are not allowed.
 
+    \value DecompressedSafetyCheckThresholdAttribute
+        Requests only, type: QMetaType::LongLong (default: 10 MiB)
+        Indicates after how many bytes of decompressed data the Network Access
+        API checks that a compressed HTTP reply does not decompress to more than
+        40 times its size. Larger ratios are typical of decompression bombs,
+        and the reply is then aborted with QNetworkReply::ProtocolFailure.
+        A value of -1 disables the check.
+        (This value was introduced in 5.7.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -82,6 +82,7 @@ public:
         SpdyWasUsedAttribute,
         EmitAllUploadProgressSignalsAttribute,
         FollowRedirectsAttribute,
+        DecompressedSafetyCheckThresholdAttribute,
 
         User = 1000,
         UserMax = 32767
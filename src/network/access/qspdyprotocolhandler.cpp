@@ -1245,8 +1245,13 @@ void QSpdyProtocolHandler::handleDataFrame(const QByteArray &frameHeaders)
         inDataBuffer.append(data);
         qint64 compressedCount = httpReply->d_func()->uncompressBodyData(&inDataBuffer,
                                                                          &replyPrivate->responseData);
-        Q_ASSERT(compressedCount >= 0);
-        Q_UNUSED(compressedCount); // silence -Wunused-variable
+        if (compressedCount < 0) {
+            // corrupt data, or more than the decompression limits allow
+            sendRST_STREAM(streamID, RST_STREAM_CANCEL);
+            replyFinishedWithError(httpReply, streamID, QNetworkReply::ProtocolFailure,
+                                   "could not decompress the reply");
+            return;
+        }
     } else {
         replyPrivate->responseData.append(data);
     }
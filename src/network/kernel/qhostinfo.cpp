@@ -102,44 +102,21 @@ Q_GLOBAL_STATIC(QHostInfoLookupManager, theHostInfoLookupManager)
     but also changes the order of signal emissions when using lookupHost()
     compared to previous versions of Qt.
     \note Since Qt 4.6.3 QHostInfo is using a small internal 60 second DNS cache
-    for performance improvements.
+    for performance improvements. Since Qt 5.6, its size and the time results
+    are kept can be changed with setMaximumCacheSize() and
+    setCacheTimeToLive(), failed lookups can be cached as well (see
+    setNegativeCacheTimeToLive()), and prefetchHost() fills the cache ahead
+    of time. Names that keep being looked up are refreshed in the background
+    shortly before their entry expires, and concurrent lookups of the same
+    name share one query to the resolver.
 
     \sa QAbstractSocket, {http://www.rfc-editor.org/rfc/rfc3492.txt}{RFC 3492}
 */
 
 static QBasicAtomicInt theIdCounter = Q_BASIC_ATOMIC_INITIALIZER(1);
 
-/*!
-    Looks up the IP address(es) associated with host name \a name, and
-    returns an ID for the lookup. When the result of the lookup is
-    ready, the slot or signal \a member in \a receiver is called with
-    a QHostInfo argument. The QHostInfo object can then be inspected
-    to get the results of the lookup.
-
-    The lookup is performed by a single function call, for example:
-
-    \snippet code/src_network_kernel_qhostinfo.cpp 2
-
-    The implementation of the slot prints basic information about the
-    addresses returned by the lookup, or reports an error if it failed:
-
-    \snippet code/src_network_kernel_qhostinfo.cpp 3
-
-    If you pass a literal IP address to \a name instead of a host name,
-    QHostInfo will search for the domain name for the IP (i.e., QHostInfo will
-    perform a \e reverse lookup). On success, the resulting QHostInfo will
-    contain both the resolved domain name and IP addresses for the host
-    name. Example:
-
-    \snippet code/src_network_kernel_qhostinfo.cpp 4
-
-    \note There is no guarantee on the order the signals will be emitted
-    if you start multiple requests with lookupHost().
-
-    \sa abortHostLookup(), addresses(), error(), fromName()
-*/
-int QHostInfo::lookupHost(const QString &name, QObject *receiver,
-                          const char *member)
+static int lookupHostHelper(const QString &name, QObject *receiver, const char *member,
+                            bool checkCache)
 {
 #if defined QHOSTINFO_DEBUG
     qDebug("QHostInfo::lookupHost(\"%s\", %p, %s)",
@@ -173,10 +150,13 @@ int QHostInfo::lookupHost(const QString &name, QObject *receiver,
 
     if (manager) {
         // the application is still alive
-        if (manager->cache.isEnabled()) {
+        if (checkCache && manager->cache.isEnabled()) {
             // check cache first
             bool valid = false;
-            QHostInfo info = manager->cache.get(name, &valid);
+            bool needsRefresh = false;
+            QHostInfo info = manager->cache.get(name, &valid, &needsRefresh);
+            if (needsRefresh)
+                manager->prefetch(name, true);
             if (valid) {
                 if (!receiver)
                     return -1;
@@ -198,6 +178,41 @@ int QHostInfo::lookupHost(const QString &name, QObject *receiver,
     return id;
 }
 
+/*!
+    Looks up the IP address(es) associated with host name \a name, and
+    returns an ID for the lookup. When the result of the lookup is
+    ready, the slot or signal \a member in \a receiver is called with
+    a QHostInfo argument. The QHostInfo object can then be inspected
+    to get the results of the lookup.
+
+    The lookup is performed by a single function call, for example:
+
+    \snippet code/src_network_kernel_qhostinfo.cpp 2
+
+    The implementation of the slot prints basic information about the
+    addresses returned by the lookup, or reports an error if it failed:
+
+    \snippet code/src_network_kernel_qhostinfo.cpp 3
+
+    If you pass a literal IP address to \a name instead of a host name,
+    QHostInfo will search for the domain name for the IP (i.e., QHostInfo will
+    perform a \e reverse lookup). On success, the resulting QHostInfo will
+    contain both the resolved domain name and IP addresses for the host
+    name. Example:
+
+    \snippet code/src_network_kernel_qhostinfo.cpp 4
+
+    \note There is no guarantee on the order the signals will be emitted
+    if you start multiple requests with lookupHost().
+
+    \sa abortHostLookup(), addresses(), error(), fromName()
+*/
+int QHostInfo::lookupHost(const QString &name, QObject *receiver,
+                          const char *member)
+{
+    return lookupHostHelper(name, receiver, member, true);
+}
+
 /*!
     Aborts the host lookup with the ID \a id, as returned by lookupHost().
 
@@ -431,7 +446,8 @@ void QHostInfo::setErrorString(const QString &str)
     \sa hostName()
 */
 
-QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i) : toBeLookedUp(hn), id(i)
+QHostInfoRunnable::QHostInfoRunnable(const QString &hn, int i, bool r)
+    : toBeLookedUp(hn), id(i), refresh(r)
 {
     setAutoDelete(true);
 }
@@ -452,9 +468,10 @@ void QHostInfoRunnable::run()
     // it here too because it might have been cache saved by another QHostInfoRunnable
     // in the meanwhile while this QHostInfoRunnable was scheduled but not running
     if (manager->cache.isEnabled()) {
-        // check the cache first
+        // check the cache first, unless this lookup is meant to refresh it
         bool valid = false;
-        hostInfo = manager->cache.get(toBeLookedUp, &valid);
+        if (!refresh)
+            hostInfo = manager->cache.peek(toBeLookedUp, &valid);
         if (!valid) {
             // not in cache, we need to do the lookup and store the result in the cache
             hostInfo = QHostInfoAgent::fromName(toBeLookedUp);
@@ -580,6 +597,7 @@ void QHostInfoLookupManager::work()
                 if (currentLookups.at(i)->toBeLookedUp == scheduled->toBeLookedUp) {
                     iterator.remove();
                     postponedLookups.append(scheduled);
+                    cache.countCoalescedLookup();
                     scheduled = 0;
                     break;
                 }
@@ -637,6 +655,29 @@ void QHostInfoLookupManager::abortLookup(int id)
         abortedLookups.append(id);
 }
 
+// called by QHostInfo
+void QHostInfoLookupManager::prefetch(const QString &name, bool refresh)
+{
+    if (wasDeleted)
+        return;
+
+    // a lookup already on its way will fill the cache just as well
+    {
+        QMutexLocker locker(&this->mutex);
+        for (int i = 0; i < currentLookups.size(); ++i) {
+            if (currentLookups.at(i)->toBeLookedUp == name)
+                return;
+        }
+        for (int i = 0; i < scheduledLookups.size(); ++i) {
+            if (scheduledLookups.at(i)->toBeLookedUp == name)
+                return;
+        }
+    }
+
+    cache.countPrefetch();
+    scheduleLookup(new QHostInfoRunnable(name, theIdCounter.fetchAndAddRelaxed(1), refresh));
+}
+
 // called from QHostInfoRunnable
 bool QHostInfoLookupManager::wasAborted(int id)
 {
@@ -666,16 +707,19 @@ QHostInfo qt_qhostinfo_lookup(const QString &name, QObject *receiver, const char
     *id = -1;
 
     // check cache
-    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    QHostInfoLookupManager* manager = theHostInfoLookupManager();
     if (manager && manager->cache.isEnabled()) {
-        QHostInfo info = manager->cache.get(name, valid);
+        bool needsRefresh = false;
+        QHostInfo info = manager->cache.get(name, valid, &needsRefresh);
+        if (needsRefresh)
+            manager->prefetch(name, true);
         if (*valid) {
             return info;
         }
     }
 
     // was not in cache, trigger lookup
-    *id = QHostInfo::lookupHost(name, receiver, member);
+    *id = lookupHostHelper(name, receiver, member, false);
 
     // return empty response, valid==false
     return QHostInfo();
@@ -708,9 +752,137 @@ void qt_qhostinfo_cache_inject(const QString &hostname, const QHostInfo &resolut
 }
 #endif
 
+QHostInfoCache::Statistics qt_qhostinfo_cache_statistics()
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    return manager ? manager->cache.statistics() : QHostInfoCache::Statistics();
+}
+
+void qt_qhostinfo_reset_cache_statistics()
+{
+    QAbstractHostInfoLookupManager* manager = theHostInfoLookupManager();
+    if (manager)
+        manager->cache.resetStatistics();
+}
+
+/*!
+    \since 5.6
+
+    Starts looking up \a name in the background, so that a later
+    lookupHost() or connection to \a name can be answered from the cache.
+    Nothing is done if the cache already holds a result for \a name, or if
+    a lookup of \a name is already in progress.
+
+    \sa lookupHost(), setCacheTimeToLive()
+*/
+void QHostInfo::prefetchHost(const QString &name)
+{
+    if (name.isEmpty())
+        return;
+
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    if (!manager || !manager->cache.isEnabled())
+        return;
+
+    bool valid = false;
+    manager->cache.peek(name, &valid);
+    if (!valid)
+        manager->prefetch(name, false);
+}
+
+/*!
+    \since 5.6
+
+    Returns the maximum number of host names whose lookup results are
+    cached. The default is 128.
+
+    \sa setMaximumCacheSize()
+*/
+int QHostInfo::maximumCacheSize()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->cache.maximumSize() : 0;
+}
+
+/*!
+    \since 5.6
+
+    Sets the maximum number of host names whose lookup results are cached
+    to \a size. When the cache is full, the results used least recently
+    are dropped first.
+
+    \sa maximumCacheSize(), setCacheTimeToLive()
+*/
+void QHostInfo::setMaximumCacheSize(int size)
+{
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->cache.setMaximumSize(qMax(size, 0));
+}
+
+/*!
+    \since 5.6
+
+    Returns the number of seconds a successful lookup result is cached.
+    The default is 60 seconds.
+
+    \sa setCacheTimeToLive(), negativeCacheTimeToLive()
+*/
+int QHostInfo::cacheTimeToLive()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->cache.timeToLive() : 0;
+}
+
+/*!
+    \since 5.6
+
+    Sets the number of seconds a successful lookup result is cached to
+    \a seconds. The resolver interface used by QHostInfo does not report
+    the time to live of the DNS records, so this should be set to what the
+    records typically used by the application allow. A value of 0 disables
+    caching of successful lookups.
+
+    \sa cacheTimeToLive(), setNegativeCacheTimeToLive()
+*/
+void QHostInfo::setCacheTimeToLive(int seconds)
+{
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->cache.setTimeToLive(qMax(seconds, 0));
+}
+
+/*!
+    \since 5.6
+
+    Returns the number of seconds the failure to find a host is cached.
+    The default is 0, meaning failed lookups are not cached.
+
+    \sa setNegativeCacheTimeToLive(), cacheTimeToLive()
+*/
+int QHostInfo::negativeCacheTimeToLive()
+{
+    QHostInfoLookupManager *manager = theHostInfoLookupManager();
+    return manager ? manager->cache.negativeTimeToLive() : 0;
+}
+
+/*!
+    \since 5.6
+
+    Sets the number of seconds the failure to find a host is cached to
+    \a seconds, so that repeated lookups of a name that does not exist do
+    not all wait for the resolver. Only lookups that failed with
+    HostNotFound are cached; other errors may be temporary.
+
+    \sa negativeCacheTimeToLive(), setCacheTimeToLive()
+*/
+void QHostInfo::setNegativeCacheTimeToLive(int seconds)
+{
+    if (QHostInfoLookupManager *manager = theHostInfoLookupManager())
+        manager->cache.setNegativeTimeToLive(qMax(seconds, 0));
+}
+
 // cache for 60 seconds
 // cache 128 items
-QHostInfoCache::QHostInfoCache() : max_age(60), enabled(true), cache(128)
+QHostInfoCache::QHostInfoCache() : enabled(true), max_age(60), negative_max_age(0), cache(128)
 {
 #ifdef QT_QHOSTINFO_CACHE_DISABLED_BY_DEFAULT
     enabled = false;
@@ -729,35 +901,107 @@ void QHostInfoCache::setEnabled(bool e)
     enabled = e;
 }
 
+int QHostInfoCache::maximumSize()
+{
+    QMutexLocker locker(&this->mutex);
+    return cache.maxCost();
+}
+
+void QHostInfoCache::setMaximumSize(int size)
+{
+    QMutexLocker locker(&this->mutex);
+    cache.setMaxCost(size);
+}
+
+int QHostInfoCache::timeToLive()
+{
+    QMutexLocker locker(&this->mutex);
+    return max_age;
+}
 
-QHostInfo QHostInfoCache::get(const QString &name, bool *valid)
+void QHostInfoCache::setTimeToLive(int seconds)
 {
     QMutexLocker locker(&this->mutex);
+    max_age = seconds;
+}
 
+int QHostInfoCache::negativeTimeToLive()
+{
+    QMutexLocker locker(&this->mutex);
+    return negative_max_age;
+}
+
+void QHostInfoCache::setNegativeTimeToLive(int seconds)
+{
+    QMutexLocker locker(&this->mutex);
+    negative_max_age = seconds;
+}
+
+// must be called with the mutex locked
+QHostInfoCache::QHostInfoCacheElement *QHostInfoCache::find(const QString &name, bool *valid)
+{
     *valid = false;
-    if (QHostInfoCacheElement *element = cache.object(name)) {
-        if (element->age.elapsed() < max_age*1000)
+    QHostInfoCacheElement *element = cache.object(name);
+    if (element) {
+        const int maxAge = element->info.error() == QHostInfo::NoError ? max_age : negative_max_age;
+        if (element->age.elapsed() < maxAge * qint64(1000))
             *valid = true;
-        return element->info;
+    }
+    return element;
+}
+
+// Looks up name for a caller that would otherwise ask the resolver;
+// needsRefresh is set for one caller when a busy entry is about to expire.
+QHostInfo QHostInfoCache::get(const QString &name, bool *valid, bool *needsRefresh)
+{
+    QMutexLocker locker(&this->mutex);
+
+    ++stats.lookups;
+    if (needsRefresh)
+        *needsRefresh = false;
 
-        // FIXME idea:
-        // if too old but not expired, trigger a new lookup
-        // to freshen our cache
+    if (QHostInfoCacheElement *element = find(name, valid)) {
+        if (*valid) {
+            ++stats.hits;
+            if (element->info.error() != QHostInfo::NoError) {
+                ++stats.negativeHits;
+            } else if (needsRefresh && !element->refreshing
+                       && element->age.elapsed() > max_age * qint64(800)) {
+                // in the last fifth of its life: look it up again in the
+                // background, so that names in use never drop out
+                element->refreshing = true;
+                *needsRefresh = true;
+            }
+        }
+        return element->info;
     }
 
     return QHostInfo();
 }
 
+// Like get(), but without counting as a lookup
+QHostInfo QHostInfoCache::peek(const QString &name, bool *valid)
+{
+    QMutexLocker locker(&this->mutex);
+
+    if (QHostInfoCacheElement *element = find(name, valid))
+        return element->info;
+    return QHostInfo();
+}
+
 void QHostInfoCache::put(const QString &name, const QHostInfo &info)
 {
-    // if the lookup failed, don't cache
-    if (info.error() != QHostInfo::NoError)
+    // if the lookup failed, only cache it if it is certain to fail again
+    if (info.error() != QHostInfo::NoError
+        && (info.error() != QHostInfo::HostNotFound || negativeTimeToLive() <= 0)) {
         return;
+    }
 
     QHostInfoCacheElement* element = new QHostInfoCacheElement();
     element->info = info;
     element->age = QElapsedTimer();
     element->age.start();
+    element->refreshing = false;
 
     QMutexLocker locker(&this->mutex);
     cache.insert(name, element); // cache will take ownership
@@ -769,6 +1013,30 @@ void QHostInfoCache::clear()
     cache.clear();
 }
 
+void QHostInfoCache::countCoalescedLookup()
+{
+    QMutexLocker locker(&this->mutex);
+    ++stats.coalescedLookups;
+}
+
+void QHostInfoCache::countPrefetch()
+{
+    QMutexLocker locker(&this->mutex);
+    ++stats.prefetches;
+}
+
+QHostInfoCache::Statistics QHostInfoCache::statistics()
+{
+    QMutexLocker locker(&this->mutex);
+    return stats;
+}
+
+void QHostInfoCache::resetStatistics()
+{
+    QMutexLocker locker(&this->mutex);
+    stats = Statistics();
+}
+
 QAbstractHostInfoLookupManager* QAbstractHostInfoLookupManager::globalInstance()
 {
     return theHostInfoLookupManager();
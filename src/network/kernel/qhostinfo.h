@@ -80,6 +80,15 @@ public:
     static QString localHostName();
     static QString localDomainName();
 
+    static void prefetchHost(const QString &name);
+
+    static int maximumCacheSize();
+    static void setMaximumCacheSize(int size);
+    static int cacheTimeToLive();
+    static void setCacheTimeToLive(int seconds);
+    static int negativeCacheTimeToLive();
+    static void setNegativeCacheTimeToLive(int seconds);
+
 private:
     QScopedPointer<QHostInfoPrivate> d;
 };
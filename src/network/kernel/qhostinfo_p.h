@@ -122,35 +122,69 @@ void Q_AUTOTEST_EXPORT qt_qhostinfo_cache_inject(const QString &hostname, const
 class QHostInfoCache
 {
 public:
+    struct Statistics
+    {
+        Statistics() : lookups(0), hits(0), negativeHits(0), coalescedLookups(0), prefetches(0) {}
+
+        qint64 lookups;             // lookups that consulted the cache
+        qint64 hits;                // ... and were answered from it
+        qint64 negativeHits;        // ... with a cached "host not found"
+        qint64 coalescedLookups;    // lookups that waited for one already running
+        qint64 prefetches;          // lookups started by prefetchHost() or to refresh an entry
+    };
+
     QHostInfoCache();
-    const int max_age; // seconds
 
-    QHostInfo get(const QString &name, bool *valid);
+    QHostInfo get(const QString &name, bool *valid, bool *needsRefresh = 0);
+    QHostInfo peek(const QString &name, bool *valid);
     void put(const QString &name, const QHostInfo &info);
     void clear();
 
     bool isEnabled();
     void setEnabled(bool e);
+
+    int maximumSize();
+    void setMaximumSize(int size);
+    int timeToLive();
+    void setTimeToLive(int seconds);
+    int negativeTimeToLive();
+    void setNegativeTimeToLive(int seconds);
+
+    void countCoalescedLookup();
+    void countPrefetch();
+    Statistics statistics();
+    void resetStatistics();
+
 private:
-    bool enabled;
     struct QHostInfoCacheElement {
         QHostInfo info;
         QElapsedTimer age;
+        bool refreshing;
     };
+    QHostInfoCacheElement *find(const QString &name, bool *valid);
+
+    bool enabled;
+    int max_age; // seconds
+    int negative_max_age; // seconds, 0 disables negative caching
     QCache<QString,QHostInfoCacheElement> cache;
+    Statistics stats;
     QMutex mutex;
 };
 
+QHostInfoCache::Statistics Q_NETWORK_EXPORT qt_qhostinfo_cache_statistics();
+void Q_NETWORK_EXPORT qt_qhostinfo_reset_cache_statistics();
+
 // the following classes are used for the (normal) case: We use multiple threads to lookup DNS
 
 class QHostInfoRunnable : public QRunnable
 {
 public:
-    QHostInfoRunnable(const QString &hn, int i);
+    QHostInfoRunnable(const QString &hn, int i, bool refresh = false);
     void run() Q_DECL_OVERRIDE;
 
     QString toBeLookedUp;
     int id;
+    bool refresh; // look up even if the cache has a valid entry
     QHostInfoResult resultEmitter;
 };
 
@@ -184,6 +218,7 @@ public:
     // called from QHostInfo
     void scheduleLookup(QHostInfoRunnable *r);
     void abortLookup(int id);
+    void prefetch(const QString &name, bool refresh);
 
     // called from QHostInfoRunnable
     void lookupFinished(QHostInfoRunnable *r);
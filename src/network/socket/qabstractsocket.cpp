@@ -460,6 +460,7 @@
 #include <qpointer.h>
 #include <qtimer.h>
 #include <qelapsedtimer.h>
+#include <qfiledevice.h>
 #include <qscopedvaluerollback.h>
 
 #ifndef QT_NO_SSL
@@ -558,6 +559,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       cachedSocketDescriptor(-1),
       readBufferMaxSize(0),
       writeBuffer(QABSTRACTSOCKET_BUFFERSIZE),
+      pendingFileBytesWritten(0),
       isBuffered(false),
       connectTimer(0),
       disconnectTimer(0),
@@ -596,6 +598,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
         socketEngine = 0;
         cachedSocketDescriptor = -1;
     }
+    pendingFileBytesWritten = 0;
     if (connectTimer)
         connectTimer->stop();
     if (disconnectTimer)
@@ -811,6 +814,7 @@ void QAbstractSocketPrivate::canCloseNotification()
 */
 bool QAbstractSocketPrivate::canWriteNotification()
 {
+    Q_Q(QAbstractSocket);
 #if defined (Q_OS_WIN)
     if (socketEngine && socketEngine->isWriteNotificationEnabled())
         socketEngine->setWriteNotificationEnabled(false);
@@ -822,17 +826,29 @@ bool QAbstractSocketPrivate::canWriteNotification()
     qint64 tmp = writeBuffer.size();
     flush();
 
+    // Data sent by sendFile() bypassed the write buffer; report it now
+    // that the socket can take more.
+    bool reportedFileBytes = false;
+    if (pendingFileBytesWritten && writeBuffer.isEmpty() && !emittedBytesWritten) {
+        const qint64 written = pendingFileBytesWritten;
+        pendingFileBytesWritten = 0;
+        reportedFileBytes = true;
+        QScopedValueRollback<bool> r(emittedBytesWritten);
+        emittedBytesWritten = true;
+        emit q->bytesWritten(written);
+    }
+
     if (socketEngine) {
 #if defined (Q_OS_WIN)
-        if (!writeBuffer.isEmpty())
+        if (!writeBuffer.isEmpty() || pendingFileBytesWritten)
             socketEngine->setWriteNotificationEnabled(true);
 #else
-        if (writeBuffer.isEmpty() && socketEngine->bytesToWrite() == 0)
+        if (writeBuffer.isEmpty() && socketEngine->bytesToWrite() == 0 && !pendingFileBytesWritten)
             socketEngine->setWriteNotificationEnabled(false);
 #endif
     }
 
-    return (writeBuffer.size() < tmp);
+    return (writeBuffer.size() < tmp) || reportedFileBytes;
 }
 
 /*! \internal
@@ -913,7 +929,7 @@ bool QAbstractSocketPrivate::flush()
     }
 
     if (writeBuffer.isEmpty() && socketEngine && socketEngine->isWriteNotificationEnabled()
-        && !socketEngine->bytesToWrite())
+        && !socketEngine->bytesToWrite() && !pendingFileBytesWritten)
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -1248,6 +1264,31 @@ void QAbstractSocketPrivate::_q_forceDisconnect()
     }
 }
 
+/*! \internal
+
+    A buffered socket keeps what it has received in the read buffer, so its
+    blocks can be handed out as they are. Subclasses may keep data elsewhere
+    (QSslSocket in UnencryptedMode reads from its plain socket), so the rest
+    is taken through readData() once the buffer is drained.
+*/
+qint64 QAbstractSocketPrivate::readChunks(QByteArrayList *chunks, qint64 maxSize)
+{
+    Q_Q(QAbstractSocket);
+    if (!isBuffered || (openMode & QIODevice::Text))
+        return QIODevicePrivate::readChunks(chunks, maxSize);
+
+    const qint64 readSoFar = readBufferedChunks(chunks, maxSize);
+    if (!buffer.isEmpty())
+        return readSoFar;
+    if (maxSize < 0 || readSoFar < maxSize)
+        return readSoFar + QIODevicePrivate::readChunks(chunks, maxSize < 0 ? maxSize : maxSize - readSoFar);
+
+    // let the socket (or QSslSocket) enable the read notifier again
+    char c;
+    q->readData(&c, 0);
+    return readSoFar;
+}
+
 /*! \internal
 
     Reads data from the socket layer into the read buffer. Returns
@@ -1363,6 +1404,56 @@ QAbstractSocketEngine* QAbstractSocketPrivate::getSocketEngine(QAbstractSocket *
     return socket->d_func()->socketEngine;
 }
 
+/*! \internal
+
+    Sends up to \a maxSize bytes of the file \a fileDescriptor, starting at
+    \a offset, from the file straight to the network, without going through
+    the write buffer. This needs a connected TCP socket whose write buffer is
+    empty, and a socket engine that supports it. Returns the number of bytes
+    sent, 0 if nothing was sent and the caller should write() the data
+    instead, or -1 if an error occurred; in that case the socket is aborted.
+
+    bytesWritten() is emitted for the sent bytes once the socket is ready for
+    writing again, so that callers don't recurse into this function.
+*/
+qint64 QAbstractSocketPrivate::sendFile(QAbstractSocket *socket, qintptr fileDescriptor,
+                                        qint64 offset, qint64 maxSize)
+{
+#ifndef QT_NO_SSL
+    // The data would bypass the encryption.
+    if (qobject_cast<QSslSocket *>(socket))
+        return 0;
+#endif
+    QAbstractSocketPrivate *d = socket->d_func();
+    if (maxSize <= 0 || d->socketType != QAbstractSocket::TcpSocket
+        || d->state != QAbstractSocket::ConnectedState || !d->socketEngine
+        || !d->socketEngine->isValid() || !d->writeBuffer.isEmpty()
+        || d->socketEngine->bytesToWrite()) {
+        return 0;
+    }
+
+    const qint64 sent = d->socketEngine->sendFile(fileDescriptor, offset, maxSize);
+    if (sent < 0) {
+        if (d->socketEngine->error() == QAbstractSocket::UnsupportedSocketOperationError)
+            return 0;
+        d->socketError = d->socketEngine->error();
+        socket->setErrorString(d->socketEngine->errorString());
+        emit socket->error(d->socketError);
+        socket->abort();
+        return -1;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::sendFile() %lld bytes sent from file", sent);
+#endif
+
+    if (sent > 0) {
+        d->pendingFileBytesWritten += sent;
+        d->socketEngine->setWriteNotificationEnabled(true);
+    }
+    return sent;
+}
+
 
 /*! \internal
 
@@ -2198,7 +2289,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (d->writeBuffer.isEmpty() && !d->pendingFileBytesWritten)
         return false;
 
     QElapsedTimer stopWatch;
@@ -2213,8 +2304,9 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
     forever {
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
-                                               qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true,
+                                                 !d->writeBuffer.isEmpty() || d->pendingFileBytesWritten,
+                                                 qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
             d->socketError = d->socketEngine->error();
             setErrorString(d->socketEngine->errorString());
 #if defined (QABSTRACTSOCKET_DEBUG)
@@ -2404,6 +2496,72 @@ bool QAbstractSocket::flush()
     return d->flush();
 }
 
+/*!
+    \since 5.6
+
+    Writes at most \a maxSize bytes from \a file, starting at its current
+    position, and returns the number of bytes taken from the file, or -1 if
+    an error occurred. The file position is advanced by that amount.
+
+    If this is a connected TCP socket and \a file is backed by a file
+    descriptor, the operating system passes the data from the file to the
+    network without copying it through the application, where the platform
+    supports it. This can return fewer than \a maxSize bytes if the socket
+    cannot take more data at the moment; bytesWritten() is emitted once it
+    can, and sendFile() can then be called again. Otherwise sendFile()
+    behaves like write(file->read(maxSize)), except that data the socket
+    does not take is left in the file.
+
+    Currently the direct transfer is only available on Linux.
+
+    \sa write(), bytesWritten()
+*/
+qint64 QAbstractSocket::sendFile(QFileDevice *file, qint64 maxSize)
+{
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::sendFile: File is not open for reading");
+        return -1;
+    }
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::sendFile: Socket is not open for writing");
+        return -1;
+    }
+    if (maxSize <= 0)
+        return 0;
+
+    const qintptr fileDescriptor = file->handle();
+    if (fileDescriptor != -1 && !file->isSequential() && !(file->openMode() & QIODevice::Text)) {
+        const qint64 pos = file->pos();
+        const qint64 sent = QAbstractSocketPrivate::sendFile(this, fileDescriptor, pos, maxSize);
+        if (sent < 0)
+            return -1;
+        if (sent > 0)
+            return file->seek(pos + sent) ? sent : -1;
+    }
+
+    // Copy the data through the write buffer.
+    char buffer[16384];
+    qint64 total = 0;
+    while (total < maxSize) {
+        const qint64 readBytes = file->read(buffer, qMin<qint64>(sizeof buffer, maxSize - total));
+        if (readBytes < 0)
+            return total ? total : -1;
+        if (readBytes == 0)
+            break;
+        const qint64 written = write(buffer, readBytes);
+        if (written != readBytes) {
+            // put back what the socket did not take, so that it is sent next time
+            const qint64 taken = qMax<qint64>(written, 0);
+            if (!file->seek(file->pos() - (readBytes - taken)))
+                return -1;
+            total += taken;
+            return total ? total : written;
+        }
+        total += readBytes;
+    }
+    return total;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -49,6 +49,7 @@ class QNetworkProxy;
 #endif
 class QAbstractSocketPrivate;
 class QAuthenticator;
+class QFileDevice;
 
 class Q_NETWORK_EXPORT QAbstractSocket : public QIODevice
 {
@@ -179,6 +180,8 @@ public:
     bool atEnd() const Q_DECL_OVERRIDE;
     bool flush();
 
+    qint64 sendFile(QFileDevice *file, qint64 maxSize);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) Q_DECL_OVERRIDE;
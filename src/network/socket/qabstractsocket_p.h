@@ -80,6 +80,8 @@ public:
 
     virtual bool bind(const QHostAddress &address, quint16 port, QAbstractSocket::BindMode mode);
 
+    qint64 readChunks(QByteArrayList *chunks, qint64 maxSize) Q_DECL_OVERRIDE;
+
     bool canReadNotification();
     bool canWriteNotification();
     void canCloseNotification();
@@ -138,6 +140,7 @@ public:
 
     qint64 readBufferMaxSize;
     QRingBuffer writeBuffer;
+    qint64 pendingFileBytesWritten;
 
     bool isBuffered;
 
@@ -160,6 +163,7 @@ public:
     static void pauseSocketNotifiers(QAbstractSocket*);
     static void resumeSocketNotifiers(QAbstractSocket*);
     static QAbstractSocketEngine* getSocketEngine(QAbstractSocket*);
+    static qint64 sendFile(QAbstractSocket *socket, qintptr fileDescriptor, qint64 offset, qint64 maxSize);
 };
 
 QT_END_NAMESPACE
@@ -141,6 +141,82 @@ void QAbstractSocketEngine::setError(QAbstractSocket::SocketError error, const Q
     d->socketErrorString = errorString;
 }
 
+/*
+    Sends up to \a maxSize bytes of the file \a fileDescriptor, starting
+    at \a offset, without copying them into user space. The file position
+    of \a fileDescriptor is not changed. Returns the number of bytes sent,
+    0 if the socket cannot take more data or \a offset is at the end of the
+    file, or -1 if an error occurred.
+
+    This implementation always fails with
+    QAbstractSocket::UnsupportedSocketOperationError, and the caller has to
+    read the file and write() its contents instead.
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(maxSize);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QAbstractSocket::tr("Operation on socket is not supported"));
+    return -1;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*
+    Reads up to \a maxCount pending datagrams, each truncated to \a maxSize
+    bytes, and appends them to \a datagrams. The senders are appended to
+    \a addrs and \a ports unless these are 0. Returns the number of
+    datagrams read, 0 if none were pending, or -1 if an error occurred
+    before anything was read.
+
+    This implementation reads one datagram at a time; engines that can
+    receive several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                                         QList<QHostAddress> *addrs, QList<quint16> *ports)
+{
+    QHostAddress addr;
+    quint16 port = 0;
+    QByteArray buffer;
+    int count = 0;
+    while (count < maxCount && hasPendingDatagrams()) {
+        buffer.resize(int(maxSize));
+        const qint64 readBytes = readDatagram(buffer.data(), maxSize, &addr, &port);
+        if (readBytes < 0)
+            return count ? count : -1;
+        buffer.resize(int(readBytes));
+        datagrams->append(buffer);
+        if (addrs)
+            addrs->append(addr);
+        if (ports)
+            ports->append(port);
+        ++count;
+    }
+    return count;
+}
+
+/*
+    Writes each of \a datagrams to \a addr on port \a port. Returns the
+    number of datagrams sent, or -1 if the first one could not be sent. If
+    only some were sent, error() describes why the next one failed.
+
+    This implementation sends one datagram at a time; engines that can
+    send several datagrams with one system call reimplement it.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QByteArrayList &datagrams, const QHostAddress &addr,
+                                          quint16 port)
+{
+    int count = 0;
+    for (; count < datagrams.size(); ++count) {
+        const QByteArray &datagram = datagrams.at(count);
+        if (writeDatagram(datagram.constData(), datagram.size(), addr, port) < 0)
+            return count ? count : -1;
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 void QAbstractSocketEngine::setReceiver(QAbstractSocketEngineReceiver *receiver)
 {
     d_func()->receiver = receiver;
@@ -47,6 +47,7 @@
 
 #include "QtNetwork/qhostaddress.h"
 #include "QtNetwork/qabstractsocket.h"
+#include "QtCore/qbytearraylist.h"
 #include "private/qobject_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -115,6 +116,7 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -132,6 +134,11 @@ public:
                                  quint16 port) = 0;
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual int readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                              QList<QHostAddress> *addrs = 0, QList<quint16> *ports = 0);
+    virtual int writeDatagrams(const QByteArrayList &datagrams, const QHostAddress &addr,
+                               quint16 port);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 bytesToWrite() const = 0;
@@ -188,6 +188,22 @@ QT_BEGIN_NAMESPACE
     \sa write(), waitForBytesWritten()
 */
 
+/*!
+    \fn qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 maxSize)
+    \since 5.6
+
+    Writes at most \a maxSize bytes from \a file, starting at its current
+    position, and returns the number of bytes taken from the file, or -1 if
+    an error occurred. The file position is advanced by that amount.
+
+    Where the platform supports it, the data is passed from the file to the
+    socket without being copied through the application; see
+    QAbstractSocket::sendFile() for details. Otherwise this behaves like
+    write(file->read(maxSize)).
+
+    \sa write(), bytesWritten()
+*/
+
 /*!
     \fn void QLocalSocket::disconnectFromServer()
 
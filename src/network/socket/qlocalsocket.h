@@ -43,6 +43,7 @@ QT_BEGIN_NAMESPACE
 #ifndef QT_NO_LOCALSOCKET
 
 class QLocalSocketPrivate;
+class QFileDevice;
 
 class Q_NETWORK_EXPORT QLocalSocket : public QIODevice
 {
@@ -93,6 +94,7 @@ public:
     virtual void close() Q_DECL_OVERRIDE;
     LocalSocketError error() const;
     bool flush();
+    qint64 sendFile(QFileDevice *file, qint64 maxSize);
     bool isValid() const;
     qint64 readBufferSize() const;
     void setReadBufferSize(qint64 size);
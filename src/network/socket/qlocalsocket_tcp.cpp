@@ -346,6 +346,12 @@ bool QLocalSocket::flush()
     return d->tcpSocket->flush();
 }
 
+qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 maxSize)
+{
+    Q_D(QLocalSocket);
+    return d->tcpSocket->sendFile(file, maxSize);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
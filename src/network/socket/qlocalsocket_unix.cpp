@@ -446,6 +446,12 @@ bool QLocalSocket::flush()
     return d->unixSocket.flush();
 }
 
+qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 maxSize)
+{
+    Q_D(QLocalSocket);
+    return d->unixSocket.sendFile(file, maxSize);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
@@ -35,6 +35,7 @@
 
 #include <private/qthread_p.h>
 #include <qcoreapplication.h>
+#include <qfiledevice.h>
 #include <qdebug.h>
 
 QT_BEGIN_NAMESPACE
@@ -304,6 +305,19 @@ bool QLocalSocket::flush()
     return false;
 }
 
+qint64 QLocalSocket::sendFile(QFileDevice *file, qint64 maxSize)
+{
+    if (!file || !file->isReadable()) {
+        qWarning("QLocalSocket::sendFile: File is not open for reading");
+        return -1;
+    }
+    if (maxSize <= 0)
+        return 0;
+
+    const QByteArray data = file->read(maxSize);
+    return data.isEmpty() ? 0 : write(data);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
@@ -811,6 +811,46 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size,
     return d->nativeSendDatagram(data, size, d->adjustAddressProtocol(host), port);
 }
 
+/*!
+    Reads up to \a maxCount pending datagrams, each of them truncated to
+    \a maxSize bytes, and appends them to \a datagrams. The address and
+    port of each sender are appended to \a addresses and \a ports, unless
+    these pointers are 0.
+
+    Returns the number of datagrams read, which is 0 if none were pending,
+    or -1 if an error occurred before any datagram could be read. Where
+    the platform supports it, all datagrams are received with a single
+    system call.
+
+    \sa readDatagram(), writeDatagrams()
+*/
+int QNativeSocketEngine::readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                                       QList<QHostAddress> *addresses, QList<quint16> *ports)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::readDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+    return d->nativeReceiveDatagrams(datagrams, maxCount, maxSize, addresses, ports);
+}
+
+/*!
+    Writes each of \a datagrams to the address \a host on port \a port,
+    and returns the number of datagrams written, or -1 if not even the
+    first one could be written. Where the platform supports it, the
+    datagrams are sent with as few system calls as possible.
+
+    \sa writeDatagram(), readDatagrams()
+*/
+int QNativeSocketEngine::writeDatagrams(const QByteArrayList &datagrams,
+                                        const QHostAddress &host, quint16 port)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::UdpSocket, -1);
+    return d->nativeSendDatagrams(datagrams, d->adjustAddressProtocol(host), port);
+}
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -823,6 +863,23 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Sends up to \a maxSize bytes of the file \a fileDescriptor, starting at
+    \a offset, directly from the file to the socket. The file position is
+    not changed. Returns the number of bytes sent, 0 if the socket would
+    block or \a offset is at the end of the file, or -1 if an error
+    occurred. If the platform or the file does not support this, the error
+    is QAbstractSocket::UnsupportedSocketOperationError.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+    return d->nativeSendFile(fileDescriptor, offset, maxSize);
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
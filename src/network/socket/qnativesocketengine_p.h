@@ -132,6 +132,7 @@ public:
 
     qint64 read(char *data, qint64 maxlen) Q_DECL_OVERRIDE;
     qint64 write(const char *data, qint64 len) Q_DECL_OVERRIDE;
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize) Q_DECL_OVERRIDE;
 
     qint64 readDatagram(char *data, qint64 maxlen, QHostAddress *addr = 0,
                             quint16 *port = 0) Q_DECL_OVERRIDE;
@@ -139,6 +140,10 @@ public:
                              quint16 port) Q_DECL_OVERRIDE;
     bool hasPendingDatagrams() const Q_DECL_OVERRIDE;
     qint64 pendingDatagramSize() const Q_DECL_OVERRIDE;
+    int readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                      QList<QHostAddress> *addrs = 0, QList<quint16> *ports = 0) Q_DECL_OVERRIDE;
+    int writeDatagrams(const QByteArrayList &datagrams, const QHostAddress &addr,
+                       quint16 port) Q_DECL_OVERRIDE;
 
     qint64 bytesToWrite() const Q_DECL_OVERRIDE;
 
@@ -196,6 +201,9 @@ public:
 
     QSocketNotifier *readNotifier, *writeNotifier, *exceptNotifier;
 
+    // reused by nativeReceiveDatagrams()
+    QByteArray datagramBuffer;
+
 #ifdef Q_OS_WIN
     QWindowsSockInit winSock;
 #endif
@@ -260,8 +268,16 @@ public:
                                      QHostAddress *address, quint16 *port);
     qint64 nativeSendDatagram(const char *data, qint64 length,
                                   const QHostAddress &host, quint16 port);
+    int nativeReceiveDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                               QList<QHostAddress> *addresses, QList<quint16> *ports);
+    int nativeSendDatagrams(const QByteArrayList &datagrams,
+                            const QHostAddress &host, quint16 port);
+#ifdef Q_OS_UNIX
+    void setSendDatagramError();
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize);
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
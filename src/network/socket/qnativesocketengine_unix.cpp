@@ -871,47 +871,61 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64(maxSize ? recvFromResult : recvFromResult == -1 ? -1 : 0);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len,
-                                                   const QHostAddress &host, quint16 port)
+static QT_SOCKLEN_T setDatagramAddress(QAbstractSocket::NetworkLayerProtocol socketProtocol,
+                                       const QHostAddress &host, quint16 port,
+                                       struct sockaddr_in *sockAddrIPv4,
+                                       struct sockaddr_in6 *sockAddrIPv6,
+                                       struct sockaddr **sockAddrPtr)
 {
-    struct sockaddr_in sockAddrIPv4;
-    struct sockaddr *sockAddrPtr = 0;
-    QT_SOCKLEN_T sockAddrSize = 0;
-
-    struct sockaddr_in6 sockAddrIPv6;
     if (host.protocol() == QAbstractSocket::IPv6Protocol
         || socketProtocol == QAbstractSocket::IPv6Protocol
         || socketProtocol == QAbstractSocket::AnyIPProtocol) {
-        memset(&sockAddrIPv6, 0, sizeof(sockAddrIPv6));
-        sockAddrIPv6.sin6_family = AF_INET6;
-        sockAddrIPv6.sin6_port = htons(port);
-        sockAddrIPv6.sin6_scope_id = makeScopeId(host);
+        memset(sockAddrIPv6, 0, sizeof(*sockAddrIPv6));
+        sockAddrIPv6->sin6_family = AF_INET6;
+        sockAddrIPv6->sin6_port = htons(port);
+        sockAddrIPv6->sin6_scope_id = makeScopeId(host);
 
         Q_IPV6ADDR tmp = host.toIPv6Address();
-        memcpy(&sockAddrIPv6.sin6_addr.s6_addr, &tmp, sizeof(tmp));
-        sockAddrSize = sizeof(sockAddrIPv6);
-        sockAddrPtr = (struct sockaddr *)&sockAddrIPv6;
+        memcpy(&sockAddrIPv6->sin6_addr.s6_addr, &tmp, sizeof(tmp));
+        *sockAddrPtr = (struct sockaddr *)sockAddrIPv6;
+        return sizeof(*sockAddrIPv6);
     } else if (host.protocol() == QAbstractSocket::IPv4Protocol) {
-        memset(&sockAddrIPv4, 0, sizeof(sockAddrIPv4));
-        sockAddrIPv4.sin_family = AF_INET;
-        sockAddrIPv4.sin_port = htons(port);
-        sockAddrIPv4.sin_addr.s_addr = htonl(host.toIPv4Address());
-        sockAddrSize = sizeof(sockAddrIPv4);
-        sockAddrPtr = (struct sockaddr *)&sockAddrIPv4;
+        memset(sockAddrIPv4, 0, sizeof(*sockAddrIPv4));
+        sockAddrIPv4->sin_family = AF_INET;
+        sockAddrIPv4->sin_port = htons(port);
+        sockAddrIPv4->sin_addr.s_addr = htonl(host.toIPv4Address());
+        *sockAddrPtr = (struct sockaddr *)sockAddrIPv4;
+        return sizeof(*sockAddrIPv4);
+    }
+    *sockAddrPtr = 0;
+    return 0;
+}
+
+void QNativeSocketEnginePrivate::setSendDatagramError()
+{
+    switch (errno) {
+    case EMSGSIZE:
+        setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+        break;
+    default:
+        setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
     }
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len,
+                                                   const QHostAddress &host, quint16 port)
+{
+    struct sockaddr_in sockAddrIPv4;
+    struct sockaddr_in6 sockAddrIPv6;
+    struct sockaddr *sockAddrPtr;
+    const QT_SOCKLEN_T sockAddrSize = setDatagramAddress(socketProtocol, host, port, &sockAddrIPv4,
+                                                         &sockAddrIPv6, &sockAddrPtr);
 
     ssize_t sentBytes = qt_safe_sendto(socketDescriptor, data, len,
                                        0, sockAddrPtr, sockAddrSize);
 
-    if (sentBytes < 0) {
-        switch (errno) {
-        case EMSGSIZE:
-            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
-            break;
-        default:
-            setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
-        }
-    }
+    if (sentBytes < 0)
+        setSendDatagramError();
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
     qDebug("QNativeSocketEngine::sendDatagram(%p \"%s\", %lli, \"%s\", %i) == %lli", data,
@@ -922,6 +936,133 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+// Number of datagrams moved per recvmmsg() or sendmmsg() call
+static const int DatagramBatchSize = 64;
+
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                                                       QList<QHostAddress> *addresses, QList<quint16> *ports)
+{
+    Q_Q(QNativeSocketEngine);
+#if QT_UNIX_SUPPORTS_MMSG
+    const int batchSize = qMin(maxCount, DatagramBatchSize);
+    QVarLengthArray<struct mmsghdr, DatagramBatchSize> headers(batchSize);
+    QVarLengthArray<struct iovec, DatagramBatchSize> vectors(batchSize);
+    QVarLengthArray<qt_sockaddr, DatagramBatchSize> senders(batchSize);
+    // Received datagrams are copied out of one shared buffer, rather than
+    // received into maxSize'd QByteArrays that would mostly hold slack. The
+    // buffer is kept for the next call, and only grows, a batch at a time,
+    // while the datagrams arrive faster than they are read.
+    int slots = qBound(1, int(datagramBuffer.size() / maxSize), batchSize);
+
+    int count = 0;
+    while (count < maxCount) {
+        const int batch = qMin(maxCount - count, slots);
+        if (datagramBuffer.size() < batch * maxSize)
+            datagramBuffer.resize(int(batch * maxSize));
+        char *buffer = datagramBuffer.data();
+        memset(headers.data(), 0, batch * sizeof(struct mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            vectors[i].iov_base = buffer + i * maxSize;
+            vectors[i].iov_len = maxSize;
+            headers[i].msg_hdr.msg_name = &senders[i].a;
+            headers[i].msg_hdr.msg_namelen = sizeof(qt_sockaddr);
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int received = qt_safe_recvmmsg(socketDescriptor, headers.data(), batch, MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == ENOSYS && count == 0)
+                return q->QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize, addresses, ports);
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+            return count ? count : -1;
+        }
+
+        for (int i = 0; i < received; ++i) {
+            datagrams->append(QByteArray(buffer + i * maxSize, int(headers[i].msg_len)));
+            if (addresses || ports) {
+                QHostAddress address;
+                quint16 port = 0;
+                qt_socket_getPortAndAddress(&senders[i], &port, &address);
+                if (addresses)
+                    addresses->append(address);
+                if (ports)
+                    ports->append(port);
+            }
+        }
+        count += received;
+        if (received < batch)
+            break;
+        slots = qMin(slots * 2, batchSize);
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %i, %lli) == %i",
+           datagrams, maxCount, maxSize, count);
+#endif
+
+    return count;
+#else
+    return q->QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize, addresses, ports);
+#endif
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QByteArrayList &datagrams,
+                                                    const QHostAddress &host, quint16 port)
+{
+    Q_Q(QNativeSocketEngine);
+#if QT_UNIX_SUPPORTS_MMSG
+    struct sockaddr_in sockAddrIPv4;
+    struct sockaddr_in6 sockAddrIPv6;
+    struct sockaddr *sockAddrPtr;
+    const QT_SOCKLEN_T sockAddrSize = setDatagramAddress(socketProtocol, host, port, &sockAddrIPv4,
+                                                         &sockAddrIPv6, &sockAddrPtr);
+
+    const int total = datagrams.size();
+    const int batchSize = qMin(total, DatagramBatchSize);
+    QVarLengthArray<struct mmsghdr, DatagramBatchSize> headers(batchSize);
+    QVarLengthArray<struct iovec, DatagramBatchSize> vectors(batchSize);
+
+    int count = 0;
+    while (count < total) {
+        const int batch = qMin(total - count, batchSize);
+        memset(headers.data(), 0, batch * sizeof(struct mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            const QByteArray &datagram = datagrams.at(count + i);
+            vectors[i].iov_base = const_cast<char *>(datagram.constData());
+            vectors[i].iov_len = datagram.size();
+            headers[i].msg_hdr.msg_name = sockAddrPtr;
+            headers[i].msg_hdr.msg_namelen = sockAddrSize;
+            headers[i].msg_hdr.msg_iov = &vectors[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // If a datagram other than the first of the batch fails, the
+        // datagrams before it are reported as sent and the next call
+        // reports the error.
+        const int sent = qt_safe_sendmmsg(socketDescriptor, headers.data(), batch, 0);
+        if (sent < 0) {
+            if (errno == ENOSYS && count == 0)
+                return q->QAbstractSocketEngine::writeDatagrams(datagrams, host, port);
+            setSendDatagramError();
+            return count ? count : -1;
+        }
+        count += sent;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%i, \"%s\", %i) == %i", total,
+           host.toString().toLatin1().constData(), port, count);
+#endif
+
+    return count;
+#else
+    return q->QAbstractSocketEngine::writeDatagrams(datagrams, host, port);
+#endif
+}
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1017,6 +1158,7 @@ void QNativeSocketEnginePrivate::nativeClose()
 #endif
 
     qt_safe_close(socketDescriptor);
+    datagramBuffer.clear();
 }
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
@@ -1053,6 +1195,45 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize)
+{
+#if QT_UNIX_SUPPORTS_SENDFILE
+    Q_Q(QNativeSocketEngine);
+
+    // Linux transfers at most 0x7ffff000 bytes per call
+    qint64 sentBytes = qt_safe_sendfile(socketDescriptor, int(fileDescriptor), offset,
+                                        qMin<qint64>(maxSize, 0x7ffff000));
+
+    if (sentBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            sentBytes = 0;
+            break;
+        default:
+            // EINVAL, ENOSYS: the file or the kernel can't do it, let the caller copy the data
+            setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%lld, %lld, %lld) == %lld",
+           qint64(fileDescriptor), offset, maxSize, sentBytes);
+#endif
+
+    return sentBytes;
+#else
+    Q_Q(QNativeSocketEngine);
+    return q->QAbstractSocketEngine::sendFile(fileDescriptor, offset, maxSize);
+#endif
+}
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -1311,6 +1311,27 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return ret;
 }
 
+// Winsock has no way of moving several datagrams in one call
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                                                       QList<QHostAddress> *addresses, QList<quint16> *ports)
+{
+    Q_Q(QNativeSocketEngine);
+    return q->QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize, addresses, ports);
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const QByteArrayList &datagrams,
+                                                    const QHostAddress &host, quint16 port)
+{
+    Q_Q(QNativeSocketEngine);
+    return q->QAbstractSocketEngine::writeDatagrams(datagrams, host, port);
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 maxSize)
+{
+    Q_Q(QNativeSocketEngine);
+    return q->QAbstractSocketEngine::sendFile(fileDescriptor, offset, maxSize);
+}
+
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 {
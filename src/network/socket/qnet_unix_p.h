@@ -64,6 +64,10 @@
 #  include <resolv.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#  include <sys/sendfile.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 // Almost always the same. If not, specify in qplatformdefs.h.
@@ -71,6 +75,20 @@ QT_BEGIN_NAMESPACE
 # define QT_SOCKOPTLEN_T QT_SOCKLEN_T
 #endif
 
+// recvmmsg() and sendmmsg() appeared in glibc 2.12 and 2.14 respectively
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14))
+# define QT_UNIX_SUPPORTS_MMSG 1
+#else
+# define QT_UNIX_SUPPORTS_MMSG 0
+#endif
+
+// sendfile() can write to any socket since Linux 2.6.33, older kernels fail with EINVAL
+#if defined(Q_OS_LINUX)
+# define QT_UNIX_SUPPORTS_SENDFILE 1
+#else
+# define QT_UNIX_SUPPORTS_SENDFILE 0
+#endif
+
 // UnixWare 7 redefines socket -> _socket
 static inline int qt_safe_socket(int domain, int type, int protocol, int flags = 0)
 {
@@ -219,6 +237,41 @@ static inline int qt_safe_sendmsg(int sockfd, const struct msghdr *msg, int flag
     return ret;
 }
 
+#if QT_UNIX_SUPPORTS_MMSG
+static inline int qt_safe_recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    int ret;
+    EINTR_LOOP(ret, ::recvmmsg(sockfd, msgvec, vlen, flags, 0));
+    return ret;
+}
+
+static inline int qt_safe_sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#else
+    qt_ignore_sigpipe();
+#endif
+
+    int ret;
+    EINTR_LOOP(ret, ::sendmmsg(sockfd, msgvec, vlen, flags));
+    return ret;
+}
+#endif
+
+#if QT_UNIX_SUPPORTS_SENDFILE
+static inline qint64 qt_safe_sendfile(int sockfd, int fd, qint64 offset, qint64 count)
+{
+    // there is no MSG_NOSIGNAL for sendfile()
+    qt_ignore_sigpipe();
+
+    off_t off = off_t(offset);
+    ssize_t ret;
+    EINTR_LOOP(ret, ::sendfile(sockfd, fd, &off, size_t(count)));
+    return ret;
+}
+#endif
+
 QT_END_NAMESPACE
 
 #endif // QNET_UNIX_P_H
@@ -65,6 +65,10 @@
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
 
+    Applications handling many datagrams per second should use
+    readDatagrams() and writeDatagrams(), which move a whole batch of
+    datagrams with as few system calls as the platform allows.
+
     Example:
 
     \snippet code/src_network_socket_qudpsocket.cpp 0
@@ -388,6 +392,100 @@ qint64 QUdpSocket::readDatagram(char *data, qint64 maxSize, QHostAddress *addres
     }
     return readBytes;
 }
+
+/*!
+    \since 5.6
+
+    Sends each datagram in \a datagrams to the host address \a host at
+    port \a port. Returns the number of datagrams sent, or -1 if not even
+    the first one could be sent. If fewer datagrams than given were sent,
+    error() describes why the next one could not be sent.
+
+    Where the platform supports it (on Linux, through \c sendmmsg()), many
+    datagrams are passed to the operating system in a single call, which
+    is considerably cheaper than calling writeDatagram() for each of them.
+    The bytesWritten() signal is emitted once, with the combined size of
+    all datagrams sent.
+
+    The same restrictions as for writeDatagram() apply to each datagram.
+
+    \sa readDatagrams(), writeDatagram()
+*/
+int QUdpSocket::writeDatagrams(const QByteArrayList &datagrams, const QHostAddress &host,
+                               quint16 port)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%i, \"%s\", %i)", datagrams.size(),
+           host.toString().toLatin1().constData(), port);
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, host))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    const int sent = d->socketEngine->writeDatagrams(datagrams, host, port);
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent > 0) {
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += datagrams.at(i).size();
+        emit bytesWritten(bytes);
+    }
+    if (sent < datagrams.size()) {
+        d->socketError = d->socketEngine->error();
+        setErrorString(d->socketEngine->errorString());
+        emit error(d->socketError);
+    }
+    return sent;
+}
+
+/*!
+    \since 5.6
+
+    Receives up to \a maxCount pending datagrams and appends them to
+    \a datagrams. Each datagram is truncated to \a maxSize bytes, and
+    whatever does not fit is lost, as with readDatagram(). The sender of
+    each datagram is appended to \a hosts and \a ports, unless these
+    pointers are 0.
+
+    Returns the number of datagrams read, which is 0 if none were pending,
+    or -1 if an error occurred.
+
+    Where the platform supports it (on Linux, through \c recvmmsg()), all
+    datagrams are received with a single call to the operating system.
+    Draining the socket with readDatagrams() whenever readyRead() is
+    emitted therefore costs far fewer system calls and signal emissions
+    than reading one datagram at a time.
+
+    \sa writeDatagrams(), readDatagram(), hasPendingDatagrams()
+*/
+int QUdpSocket::readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                              QList<QHostAddress> *hosts, QList<quint16> *ports)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::readDatagrams(%p, %i, %lli, %p, %p)", datagrams, maxCount, maxSize, hosts, ports);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::readDatagrams()", -1);
+    if (!datagrams || maxCount <= 0 || maxSize <= 0)
+        return 0;
+    // No UDP datagram is larger than this
+    maxSize = qMin<qint64>(maxSize, 65535);
+
+    const int count = d->socketEngine->readDatagrams(datagrams, maxCount, maxSize, hosts, ports);
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (count < 0) {
+        d->socketError = d->socketEngine->error();
+        setErrorString(d->socketEngine->errorString());
+        emit error(d->socketError);
+    }
+    return count;
+}
 #endif // QT_NO_UDPSOCKET
 
 QT_END_NAMESPACE
@@ -36,6 +36,7 @@
 
 #include <QtNetwork/qabstractsocket.h>
 #include <QtNetwork/qhostaddress.h>
+#include <QtCore/qbytearraylist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -71,6 +72,10 @@ public:
     inline qint64 writeDatagram(const QByteArray &datagram, const QHostAddress &host, quint16 port)
         { return writeDatagram(datagram.constData(), datagram.size(), host, port); }
 
+    int readDatagrams(QByteArrayList *datagrams, int maxCount, qint64 maxSize,
+                      QList<QHostAddress> *hosts = 0, QList<quint16> *ports = 0);
+    int writeDatagrams(const QByteArrayList &datagrams, const QHostAddress &host, quint16 port);
+
 private:
     Q_DISABLE_COPY(QUdpSocket)
     Q_DECLARE_PRIVATE(QUdpSocket)
@@ -161,11 +161,13 @@ Q_LOGGING_CATEGORY(lcSsl, "qt.network.ssl");
     option can allow connections for legacy servers, but it introduces the
     possibility that an attacker could inject plaintext into the SSL session.
     \value SslOptionDisableSessionSharing Disables SSL session sharing via
-    the session ID handshake attribute.
+    the session ID handshake attribute. This also keeps QNetworkAccessManager
+    from resuming sessions of earlier connections to the same server.
     \value SslOptionDisableSessionPersistence Disables storing the SSL session
     in ASN.1 format as returned by QSslConfiguration::sessionTicket(). Enabling
     this feature adds memory overhead of approximately 1K per used session
-    ticket.
+    ticket. QNetworkAccessManager only resumes sessions of earlier
+    connections to the same server when this option is turned off.
     \value SslOptionDisableServerCipherPreference Disables selecting the cipher
     chosen based on the servers preferences rather than the order ciphers were
     sent by the client. This option is only relevant to server sockets, and is
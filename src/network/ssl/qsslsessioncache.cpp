@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsslsessioncache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslcipher.h>
+#include <QtNetwork/qsslellipticcurve.h>
+#include <QtNetwork/qsslkey.h>
+
+#ifndef QT_NO_SSL
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QSslSessionCache
+    \internal
+    \inmodule QtNetwork
+
+    \brief The QSslSessionCache class keeps TLS sessions for resumption.
+
+    The cache maps a key() made of a host, port, peer verification name and
+    the SSL configuration of the client to the serialized session (see
+    QSslConfiguration::sessionTicket()) of the last successful handshake
+    with that peer. A client that finds a session here can offer it to the
+    server and skip the full handshake, which is what makes reconnecting to
+    a server cheap. Since the key covers the CA certificates, the local
+    certificate and key, the verification settings and the protocol, a
+    session is only resumed by clients that would have set up the same one.
+
+    instance() is shared by the whole process, so that sessions survive the
+    QNetworkAccessManager and the connection that negotiated them. Once the
+    cache holds maximumSize() sessions, the least recently used ones are
+    dropped. Sessions whose ticket lifetime hint has passed are dropped
+    when they are looked up.
+
+    All functions are thread-safe.
+*/
+
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+/*!
+    Constructs an empty cache holding at most \a maximumSize sessions.
+*/
+QSslSessionCache::QSslSessionCache(int maximumSize)
+    : entries(maximumSize)
+{
+}
+
+/*!
+    Returns the process-wide session cache.
+*/
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+int QSslSessionCache::maximumSize() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.maxCost();
+}
+
+/*!
+    Sets the maximum number of sessions kept to \a size, dropping the
+    least recently used sessions if there are more. A \a size of 0
+    disables the cache.
+*/
+void QSslSessionCache::setMaximumSize(int size)
+{
+    QMutexLocker locker(&mutex);
+    const int sizeBefore = entries.size();
+    entries.setMaxCost(qMax(size, 0));
+    stats.evictions += sizeBefore - entries.size();
+}
+
+int QSslSessionCache::size() const
+{
+    QMutexLocker locker(&mutex);
+    return entries.size();
+}
+
+/*!
+    Returns the key for sessions with \a peerName at \a host and \a port
+    set up by a client using \a configuration.
+
+    The key contains a digest of everything in \a configuration that
+    affects the handshake or the identity of the client. The session itself
+    and the results of an earlier handshake (the peer certificates, the
+    negotiated cipher) do not count.
+*/
+QByteArray QSslSessionCache::key(const QString &host, quint16 port, const QString &peerName,
+                                 const QSslConfiguration &configuration)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << int(configuration.protocol())
+           << int(configuration.peerVerifyMode())
+           << configuration.peerVerifyDepth();
+    // whether the session may be persisted does not change the session
+    for (int option = QSsl::SslOptionDisableEmptyFragments;
+         option <= QSsl::SslOptionDisableServerCipherPreference; option <<= 1) {
+        if (option != QSsl::SslOptionDisableSessionPersistence)
+            stream << configuration.testSslOption(QSsl::SslOption(option));
+    }
+    foreach (const QSslCertificate &certificate, configuration.caCertificates())
+        stream << certificate.digest(QCryptographicHash::Sha1);
+    foreach (const QSslCertificate &certificate, configuration.localCertificateChain())
+        stream << certificate.digest(QCryptographicHash::Sha1);
+    stream << configuration.privateKey().toDer();
+    foreach (const QSslCipher &cipher, configuration.ciphers())
+        stream << cipher.name() << int(cipher.protocol());
+    foreach (const QSslEllipticCurve &curve, configuration.ellipticCurves())
+        stream << curve.shortName();
+    stream << configuration.allowedNextProtocols();
+
+    return host.toLower().toUtf8() + ':' + QByteArray::number(port)
+            + '/' + peerName.toLower().toUtf8()
+            + '#' + QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+/*!
+    Returns the session stored for \a key, or an empty byte array if there
+    is none or it has expired.
+*/
+QByteArray QSslSessionCache::find(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    ++stats.lookups;
+    Entry *entry = entries.object(key);
+    if (!entry)
+        return QByteArray();
+    if (entry->lifetime >= 0 && entry->age.hasExpired(entry->lifetime)) {
+        entries.remove(key);
+        ++stats.evictions;
+        return QByteArray();
+    }
+    ++stats.hits;
+    return entry->session;
+}
+
+/*!
+    Stores \a session as the session for \a key, replacing any previous
+    one. \a lifetimeHint is the number of seconds the server promised to
+    accept the session for; if it is not positive, the session is kept
+    until it is pushed out by newer ones.
+*/
+void QSslSessionCache::insert(const QByteArray &key, const QByteArray &session, int lifetimeHint)
+{
+    if (session.isEmpty())
+        return;
+
+    Entry *entry = new Entry;
+    entry->session = session;
+    entry->age.start();
+    entry->lifetime = lifetimeHint > 0 ? qint64(lifetimeHint) * 1000 : -1;
+
+    QMutexLocker locker(&mutex);
+    const bool replacing = entries.contains(key);
+    const int sizeBefore = entries.size();
+    if (!entries.insert(key, entry))
+        return; // the cache is disabled; QCache deleted the entry
+    ++stats.insertions;
+    stats.evictions += sizeBefore + (replacing ? 0 : 1) - entries.size();
+}
+
+/*!
+    Removes the session for \a key, for instance because the server
+    refused to resume it.
+*/
+void QSslSessionCache::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    entries.remove(key);
+}
+
+/*!
+    Removes all sessions. The statistics are kept.
+*/
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+}
+
+/*!
+    Returns how many lookups were made and how many of them found a
+    session, as well as how many sessions were stored and dropped, since
+    the cache was created or resetStatistics() was last called.
+*/
+QSslSessionCache::Statistics QSslSessionCache::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void QSslSessionCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    stats = Statistics();
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_SSL
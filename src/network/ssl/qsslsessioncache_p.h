@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSSLSESSIONCACHE_P_H
+#define QSSLSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtNetwork/qsslconfiguration.h>
+
+#ifndef QT_NO_SSL
+
+QT_BEGIN_NAMESPACE
+
+class Q_NETWORK_EXPORT QSslSessionCache
+{
+public:
+    struct Statistics
+    {
+        Statistics() : lookups(0), hits(0), insertions(0), evictions(0) {}
+
+        qint64 lookups;
+        qint64 hits;
+        qint64 insertions;
+        qint64 evictions;
+
+        qint64 misses() const { return lookups - hits; }
+        double hitRate() const { return lookups ? double(hits) / lookups : 0.0; }
+    };
+
+    explicit QSslSessionCache(int maximumSize = DefaultMaximumSize);
+
+    static QSslSessionCache *instance();
+
+    int maximumSize() const;
+    void setMaximumSize(int size);
+    int size() const;
+
+    static QByteArray key(const QString &host, quint16 port, const QString &peerName,
+                          const QSslConfiguration &configuration);
+
+    QByteArray find(const QByteArray &key);
+    void insert(const QByteArray &key, const QByteArray &session, int lifetimeHint = -1);
+    void remove(const QByteArray &key);
+    void clear();
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+    enum { DefaultMaximumSize = 256 };
+
+private:
+    struct Entry
+    {
+        QByteArray session;
+        QElapsedTimer age;
+        qint64 lifetime; // msecs, or -1 if the server did not say
+    };
+
+    mutable QMutex mutex;
+    QCache<QByteArray, Entry> entries;
+    Statistics stats;
+
+    Q_DISABLE_COPY(QSslSessionCache)
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_SSL
+
+#endif // QSSLSESSIONCACHE_P_H
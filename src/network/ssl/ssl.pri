@@ -18,7 +18,8 @@ contains(QT_CONFIG, ssl) | contains(QT_CONFIG, openssl) | contains(QT_CONFIG, op
                ssl/qsslpresharedkeyauthenticator.h \
                ssl/qsslpresharedkeyauthenticator_p.h \
                ssl/qsslcertificateextension.h \
-               ssl/qsslcertificateextension_p.h
+               ssl/qsslcertificateextension_p.h \
+               ssl/qsslsessioncache_p.h
     SOURCES += ssl/qasn1element.cpp \
                ssl/qssl.cpp \
                ssl/qsslcertificate.cpp \
@@ -29,7 +30,8 @@ contains(QT_CONFIG, ssl) | contains(QT_CONFIG, openssl) | contains(QT_CONFIG, op
                ssl/qsslerror.cpp \
                ssl/qsslsocket.cpp \
                ssl/qsslpresharedkeyauthenticator.cpp \
-               ssl/qsslcertificateextension.cpp
+               ssl/qsslcertificateextension.cpp \
+               ssl/qsslsessioncache.cpp
 
     winrt {
         HEADERS += ssl/qsslsocket_winrt_p.h
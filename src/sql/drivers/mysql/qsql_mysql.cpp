@@ -34,9 +34,11 @@
 #include "qsql_mysql_p.h"
 
 #include <QtSql/private/qsqldriver_p.h>
+#include <QtSql/private/qsqlresult_p.h>
 #include <qcoreapplication.h>
 #include <qvariant.h>
 #include <qdatetime.h>
+#include <qsqlcolumnbatch.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
 #include <qsqlindex.h>
@@ -668,6 +670,69 @@ QVariant QMYSQLResult::data(int field)
     return QVariant();
 }
 
+int QMYSQLResult::fetchBatch(QSqlColumnBatch *batch, int maximumRows)
+{
+    batch->reset(record());
+    if (!d->driver)
+        return 0;
+
+    QTextCodec *tc = d->driver->d_func()->tc;
+#ifdef QT_NO_TEXTCODEC
+    Q_UNUSED(tc);
+#else
+    const bool isUtf8 = tc->mibEnum() == 106;
+#endif
+    int rows = 0;
+    while (rows < maximumRows) {
+        if (!fetchNext()) {
+            setAt(QSql::AfterLastRow);
+            break;
+        }
+        const unsigned long *lengths = d->preparedQuery ? 0 : mysql_fetch_lengths(d->result);
+        for (int i = 0; i < batch->columnCount(); ++i) {
+            const QMYSQLResultPrivate::QMyField &f = d->fields.at(i);
+            const char *val;
+            int len;
+            if (d->preparedQuery) {
+                val = f.nullIndicator ? 0 : f.outField;
+                len = f.bufLength;
+            } else {
+                val = d->row[i];
+                len = lengths[i];
+            }
+            if (!val) {
+                batch->appendNull(i);
+                continue;
+            }
+            switch (batch->columnType(i)) {
+            case QSqlColumnBatch::Int64:
+                batch->appendInt64(i, QByteArray::fromRawData(val, len).toLongLong());
+                break;
+            case QSqlColumnBatch::Double:
+                batch->appendDouble(i, QByteArray::fromRawData(val, len).toDouble());
+                break;
+            case QSqlColumnBatch::Binary:
+                batch->appendBinary(i, val, len);
+                break;
+            case QSqlColumnBatch::String:
+#ifdef QT_NO_TEXTCODEC
+                batch->appendLatin1(i, val, len);
+#else
+                if (isUtf8) {
+                    batch->appendUtf8(i, val, len);
+                } else {
+                    const QString str = toUnicode(tc, val, len);
+                    batch->appendString(i, str.constData(), str.size());
+                }
+#endif
+                break;
+            }
+        }
+        ++rows;
+    }
+    return rows;
+}
+
 bool QMYSQLResult::isNull(int field)
 {
    if (field < 0 || field >= d->fields.count())
@@ -833,6 +898,11 @@ bool QMYSQLResult::nextResult()
 
 void QMYSQLResult::virtual_hook(int id, void *data)
 {
+    if (id == FetchColumnBatch) {
+        QSqlColumnBatchFetch *fetch = static_cast<QSqlColumnBatchFetch *>(data);
+        fetch->rows = fetchBatch(fetch->batch, fetch->maximumRows);
+        return;
+    }
     QSqlResult::virtual_hook(id, data);
 }
 
@@ -91,6 +91,7 @@ protected:
     QSqlRecord record() const Q_DECL_OVERRIDE;
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
     bool nextResult() Q_DECL_OVERRIDE;
+    int fetchBatch(QSqlColumnBatch *batch, int maximumRows);
 
 #if MYSQL_VERSION_ID >= 40108
     bool prepare(const QString& stmt) Q_DECL_OVERRIDE;
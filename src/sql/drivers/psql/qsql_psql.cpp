@@ -37,6 +37,7 @@
 #include <qvariant.h>
 #include <qdatetime.h>
 #include <qregexp.h>
+#include <qsqlcolumnbatch.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
 #include <qsqlindex.h>
@@ -47,6 +48,7 @@
 #include <qmutex.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
+#include <QtSql/private/qsqlstatementcache_p.h>
 
 #include <libpq-fe.h>
 #include <pg_config.h>
@@ -119,6 +121,20 @@ inline void qPQfreemem(void *buffer)
     PQfreemem(buffer);
 }
 
+class QPSQLDriverPrivate;
+
+// a prepared statement kept for reuse by the driver's statement cache
+class QPSQLCachedStatement
+{
+public:
+    QPSQLCachedStatement(const QString &stmtId, const QPSQLDriverPrivate *driver)
+        : stmtId(stmtId), driver(driver) {}
+    ~QPSQLCachedStatement();
+
+    QString stmtId;
+    const QPSQLDriverPrivate *driver;
+};
+
 class QPSQLDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLDriver)
@@ -129,8 +145,12 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
-    { dbmsType = QSqlDriver::PostgreSQL; }
+        hasBackslashEscape(false),
+        sessionId(0)
+    {
+        dbmsType = QSqlDriver::PostgreSQL;
+        statementCache = &cachedStatements;
+    }
 
     PGconn *connection;
     bool isUtf8;
@@ -139,6 +159,9 @@ public:
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    // changes with every open(), as prepared statements belong to a session
+    uint sessionId;
+    QSqlStatementCache<QPSQLCachedStatement> cachedStatements;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
@@ -147,8 +170,16 @@ public:
     bool setEncodingUtf8();
     void setDatestyle();
     void detectBackslashEscape();
+    void deallocatePreparedStmt(const QString &stmtId) const;
 };
 
+QPSQLCachedStatement::~QPSQLCachedStatement()
+{
+    // the statements of a closed connection are gone already
+    if (driver->connection && !stmtId.isEmpty())
+        driver->deallocatePreparedStmt(stmtId);
+}
+
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
 {
     QString query;
@@ -197,7 +228,8 @@ public:
       : QSqlResultPrivate(),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        preparedQueriesEnabled(false),
+        preparedSessionId(0)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
@@ -212,6 +244,8 @@ public:
     int currentSize;
     bool preparedQueriesEnabled;
     QString preparedStmtId;
+    QString preparedQuery;
+    uint preparedSessionId;
 
     bool processResults();
 };
@@ -298,15 +332,28 @@ static QVariant::Type qDecodePSQLType(int t)
     return type;
 }
 
-void QPSQLResultPrivate::deallocatePreparedStmt()
+void QPSQLDriverPrivate::deallocatePreparedStmt(const QString &stmtId) const
 {
-    const QString stmt = QLatin1String("DEALLOCATE ") + preparedStmtId;
-    PGresult *result = privDriver()->exec(stmt);
+    const QString stmt = QLatin1String("DEALLOCATE ") + stmtId;
+    PGresult *result = exec(stmt);
 
     if (PQresultStatus(result) != PGRES_COMMAND_OK)
-        qWarning("Unable to free statement: %s", PQerrorMessage(privDriver()->connection));
+        qWarning("Unable to free statement: %s", PQerrorMessage(connection));
     PQclear(result);
+}
+
+// Hands the prepared statement to the driver's statement cache, which
+// deallocates it unless it keeps it.
+void QPSQLResultPrivate::deallocatePreparedStmt()
+{
+    Q_Q(QPSQLResult);
+    if (q->driver()) {
+        QPSQLDriverPrivate *driver = const_cast<QPSQLDriverPrivate *>(privDriver());
+        if (driver->connection && driver->sessionId == preparedSessionId)
+            driver->cachedStatements.release(preparedQuery, new QPSQLCachedStatement(preparedStmtId, driver));
+    }
     preparedStmtId.clear();
+    preparedQuery.clear();
 }
 
 QPSQLResult::QPSQLResult(const QPSQLDriver* db)
@@ -460,6 +507,59 @@ QVariant QPSQLResult::data(int i)
     return QVariant();
 }
 
+int QPSQLResult::fetchBatch(QSqlColumnBatch *batch, int maximumRows)
+{
+    Q_D(const QPSQLResult);
+    batch->reset(record());
+    if (!isActive() || !d->result || at() == QSql::AfterLastRow)
+        return 0;
+
+    const int first = at() + 1;
+    const int last = first + qMin(d->currentSize - first, maximumRows);
+    const bool isUtf8 = d->privDriver()->isUtf8;
+    for (int row = first; row < last; ++row) {
+        for (int i = 0; i < batch->columnCount(); ++i) {
+            if (PQgetisnull(d->result, row, i)) {
+                batch->appendNull(i);
+                continue;
+            }
+            const char *val = PQgetvalue(d->result, row, i);
+            const int len = PQgetlength(d->result, row, i);
+            switch (batch->columnType(i)) {
+            case QSqlColumnBatch::Int64:
+                if (qDecodePSQLType(PQftype(d->result, i)) == QVariant::Bool)
+                    batch->appendInt64(i, val[0] == 't');
+                else
+                    batch->appendInt64(i, QByteArray::fromRawData(val, len).toLongLong());
+                break;
+            case QSqlColumnBatch::Double:
+                batch->appendDouble(i, QByteArray::fromRawData(val, len).toDouble());
+                break;
+            case QSqlColumnBatch::Binary: {
+                size_t size;
+                unsigned char *data = PQunescapeBytea((const unsigned char*)val, &size);
+                batch->appendBinary(i, (const char*)data, int(size));
+                qPQfreemem(data);
+                break;
+            }
+            case QSqlColumnBatch::String:
+                if (isUtf8)
+                    batch->appendUtf8(i, val, len);
+                else
+                    batch->appendLatin1(i, val, len);
+                break;
+            }
+        }
+    }
+
+    const int rows = last - first;
+    if (rows < maximumRows)
+        setAt(QSql::AfterLastRow);
+    else
+        setAt(last - 1);
+    return rows;
+}
+
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
@@ -562,6 +662,12 @@ void QPSQLResult::virtual_hook(int id, void *data)
 {
     Q_ASSERT(data);
 
+    if (id == FetchColumnBatch) {
+        QSqlColumnBatchFetch *fetch = static_cast<QSqlColumnBatchFetch *>(data);
+        fetch->rows = fetchBatch(fetch->batch, fetch->maximumRows);
+        return;
+    }
+
     QSqlResult::virtual_hook(id, data);
 }
 
@@ -608,6 +714,16 @@ bool QPSQLResult::prepare(const QString &query)
     if (!d->preparedStmtId.isEmpty())
         d->deallocatePreparedStmt();
 
+    QPSQLDriverPrivate *driver = const_cast<QPSQLDriverPrivate *>(d->privDriver());
+    if (QPSQLCachedStatement *cached = driver->cachedStatements.take(query)) {
+        d->preparedStmtId = cached->stmtId;
+        d->preparedQuery = query;
+        d->preparedSessionId = driver->sessionId;
+        cached->stmtId.clear();
+        delete cached;
+        return true;
+    }
+
     const QString stmtId = qMakePreparedStmtId();
     const QString stmt = QString::fromLatin1("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
 
@@ -623,6 +739,8 @@ bool QPSQLResult::prepare(const QString &query)
 
     PQclear(result);
     d->preparedStmtId = stmtId;
+    d->preparedQuery = query;
+    d->preparedSessionId = driver->sessionId;
     return true;
 }
 
@@ -646,6 +764,74 @@ bool QPSQLResult::exec()
     return d->processResults();
 }
 
+// the number of characters of EXECUTE commands sent in one go by execBatch()
+enum { QPSQLBatchChunkSize = 1024 * 1024 };
+
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    if (!d->preparedQueriesEnabled)
+        return QSqlResult::execBatch(arrayBind);
+
+    cleanup();
+
+    const QVector<QVariant> values = boundValues();
+    if (values.isEmpty())
+        return false;
+    QVector<QVariantList> columns(values.count());
+    for (int i = 0; i < values.count(); ++i) {
+        columns[i] = values.at(i).toList();
+        if (columns.at(i).count() != columns.at(0).count()) {
+            setLastError(QSqlError(QCoreApplication::translate("QPSQLResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    // Send many rows per round trip as one query string of EXECUTE commands.
+    // It runs in a transaction, so that a failing row rolls back all of them.
+    const bool ownTransaction = PQtransactionStatus(d->privDriver()->connection) == PQTRANS_IDLE;
+    if (ownTransaction) {
+        PGresult *res = d->privDriver()->exec("BEGIN");
+        if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+            setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Could not begin transaction"), QSqlError::TransactionError, d->privDriver(), res));
+            PQclear(res);
+            return false;
+        }
+        PQclear(res);
+    }
+
+    const int rows = columns.at(0).count();
+    const QString execute = QLatin1String("EXECUTE ") + d->preparedStmtId + QLatin1String(" (");
+    QVector<QVariant> rowValues(columns.count());
+    QString stmt;
+    bool ok = true;
+    for (int row = 0; row < rows && ok; ++row) {
+        for (int i = 0; i < columns.count(); ++i)
+            rowValues[i] = columns.at(i).at(row);
+        stmt += execute + qCreateParamString(rowValues, driver()) + QLatin1String(");");
+        if (stmt.size() >= QPSQLBatchChunkSize || row == rows - 1) {
+            cleanup();
+            d->result = d->privDriver()->exec(stmt);
+            ok = d->processResults();
+            stmt.clear();
+        }
+    }
+
+    if (ownTransaction) {
+        PGresult *res = d->privDriver()->exec(ok ? "COMMIT" : "ROLLBACK");
+        if (ok && (!res || PQresultStatus(res) != PGRES_COMMAND_OK)) {
+            setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                            "Could not commit transaction"), QSqlError::TransactionError, d->privDriver(), res));
+            setActive(false);
+            ok = false;
+        }
+        PQclear(res);
+    }
+    return ok;
+}
+
 ///////////////////////////////////////////////////////////////////
 
 bool QPSQLDriverPrivate::setEncodingUtf8()
@@ -801,8 +987,13 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
-    if (d->connection)
-        PQfinish(d->connection);
+    // the cached statements go with the session, so don't deallocate them
+    // one by one; they must not outlive the connection either
+    PGconn *connection = d->connection;
+    d->connection = 0;
+    d->cachedStatements.clear();
+    if (connection)
+        PQfinish(connection);
 }
 
 QVariant QPSQLDriver::handle() const
@@ -823,8 +1014,8 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
         return true;
     case PreparedQueries:
     case PositionalPlaceholders:
-        return d->pro >= QPSQLDriver::Version82;
     case BatchOperations:
+        return d->pro >= QPSQLDriver::Version82;
     case NamedPlaceholders:
     case SimpleLocking:
     case FinishQuery:
@@ -896,6 +1087,7 @@ bool QPSQLDriver::open(const QString & db,
     d->isUtf8 = d->setEncodingUtf8();
     d->setDatestyle();
 
+    ++d->sessionId;
     setOpen(true);
     setOpenError(false);
     return true;
@@ -916,6 +1108,7 @@ void QPSQLDriver::close()
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
+        d->cachedStatements.clear();
         setOpen(false);
         setOpenError(false);
     }
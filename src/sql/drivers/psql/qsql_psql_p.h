@@ -88,6 +88,8 @@ protected:
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     bool prepare(const QString& query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
+    int fetchBatch(QSqlColumnBatch *batch, int maximumRows);
 };
 
 class QPSQLDriverPrivate;
@@ -36,12 +36,15 @@
 #include <qcoreapplication.h>
 #include <qdatetime.h>
 #include <qvariant.h>
+#include <qsqlcolumnbatch.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
 #include <qsqlindex.h>
 #include <qsqlquery.h>
 #include <QtSql/private/qsqlcachedresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
+#include <QtSql/private/qsqlresult_p.h>
+#include <QtSql/private/qsqlstatementcache_p.h>
 #include <qstringlist.h>
 #include <qvector.h>
 #include <qdebug.h>
@@ -117,23 +120,40 @@ protected:
     bool reset(const QString &query) Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
     int size() Q_DECL_OVERRIDE;
     int numRowsAffected() Q_DECL_OVERRIDE;
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     QSqlRecord record() const Q_DECL_OVERRIDE;
     void detachFromResultSet() Q_DECL_OVERRIDE;
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
+    int fetchBatch(QSqlColumnBatch *batch, int maximumRows);
 
 private:
     QSQLiteResultPrivate* d;
 };
 
+// a prepared statement kept for reuse by the driver's statement cache
+class QSQLiteCachedStatement
+{
+public:
+    explicit QSQLiteCachedStatement(sqlite3_stmt *stmt) : stmt(stmt) {}
+    ~QSQLiteCachedStatement() { if (stmt) sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *stmt;
+};
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
 public:
-    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0) { dbmsType = QSqlDriver::SQLite; }
+    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0)
+    {
+        dbmsType = QSqlDriver::SQLite;
+        statementCache = &cachedStatements;
+    }
     sqlite3 *access;
     QList <QSQLiteResult *> results;
+    QSqlStatementCache<QSQLiteCachedStatement> cachedStatements;
 };
 
 
@@ -143,6 +163,10 @@ public:
     QSQLiteResultPrivate(QSQLiteResult *res);
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    void readRow(QSqlCachedResult::ValueCache &values, int idx);
+    void appendRow(QSqlColumnBatch *batch);
+    void stepFailed(int res);
+    int bindValue(int index, const QVariant &value);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
@@ -151,6 +175,7 @@ public:
     sqlite3 *access;
 
     sqlite3_stmt *stmt;
+    QString query; // the SQL of stmt, if it may go to the statement cache
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
@@ -179,8 +204,18 @@ void QSQLiteResultPrivate::finalize()
     if (!stmt)
         return;
 
-    sqlite3_finalize(stmt);
+    const QSQLiteDriver *driver = qobject_cast<const QSQLiteDriver *>(q->driver());
+    if (driver && !query.isNull()) {
+        // keep the statement for the next prepare() of the same query
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        QSQLiteDriverPrivate *driverPrivate = const_cast<QSQLiteDriverPrivate *>(driver->d_func());
+        driverPrivate->cachedStatements.release(query, new QSQLiteCachedStatement(stmt));
+    } else {
+        sqlite3_finalize(stmt);
+    }
     stmt = 0;
+    query.clear();
 }
 
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
@@ -237,7 +272,6 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
 bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch)
 {
     int res;
-    int i;
 
     if (skipRow) {
         // already fetched
@@ -261,58 +295,102 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
         return false;
     }
     res = sqlite3_step(stmt);
+    if (res != SQLITE_ROW) {
+        stepFailed(res);
+        return false;
+    }
 
-    switch(res) {
-    case SQLITE_ROW:
-        // check to see if should fill out columns
-        if (rInf.isEmpty())
-            // must be first call.
-            initColumns(false);
-        if (idx < 0 && !initialFetch)
-            return true;
-        for (i = 0; i < rInf.count(); ++i) {
-            switch (sqlite3_column_type(stmt, i)) {
-            case SQLITE_BLOB:
-                values[i + idx] = QByteArray(static_cast<const char *>(
-                            sqlite3_column_blob(stmt, i)),
-                            sqlite3_column_bytes(stmt, i));
-                break;
-            case SQLITE_INTEGER:
-                values[i + idx] = sqlite3_column_int64(stmt, i);
-                break;
-            case SQLITE_FLOAT:
-                switch(q->numericalPrecisionPolicy()) {
-                    case QSql::LowPrecisionInt32:
-                        values[i + idx] = sqlite3_column_int(stmt, i);
-                        break;
-                    case QSql::LowPrecisionInt64:
-                        values[i + idx] = sqlite3_column_int64(stmt, i);
-                        break;
-                    case QSql::LowPrecisionDouble:
-                    case QSql::HighPrecision:
-                    default:
-                        values[i + idx] = sqlite3_column_double(stmt, i);
-                        break;
-                };
-                break;
-            case SQLITE_NULL:
-                values[i + idx] = QVariant(QVariant::String);
-                break;
-            default:
-                values[i + idx] = QString(reinterpret_cast<const QChar *>(
-                            sqlite3_column_text16(stmt, i)),
-                            sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
-                break;
-            }
-        }
+    // check to see if should fill out columns
+    if (rInf.isEmpty())
+        // must be first call.
+        initColumns(false);
+    if (idx < 0 && !initialFetch)
         return true;
+    readRow(values, idx);
+    return true;
+}
+
+// Reads the current row into values, starting at idx
+void QSQLiteResultPrivate::readRow(QSqlCachedResult::ValueCache &values, int idx)
+{
+    for (int i = 0; i < rInf.count(); ++i) {
+        switch (sqlite3_column_type(stmt, i)) {
+        case SQLITE_BLOB:
+            values[i + idx] = QByteArray(static_cast<const char *>(
+                        sqlite3_column_blob(stmt, i)),
+                        sqlite3_column_bytes(stmt, i));
+            break;
+        case SQLITE_INTEGER:
+            values[i + idx] = sqlite3_column_int64(stmt, i);
+            break;
+        case SQLITE_FLOAT:
+            switch(q->numericalPrecisionPolicy()) {
+                case QSql::LowPrecisionInt32:
+                    values[i + idx] = sqlite3_column_int(stmt, i);
+                    break;
+                case QSql::LowPrecisionInt64:
+                    values[i + idx] = sqlite3_column_int64(stmt, i);
+                    break;
+                case QSql::LowPrecisionDouble:
+                case QSql::HighPrecision:
+                default:
+                    values[i + idx] = sqlite3_column_double(stmt, i);
+                    break;
+            };
+            break;
+        case SQLITE_NULL:
+            values[i + idx] = QVariant(QVariant::String);
+            break;
+        default:
+            values[i + idx] = QString(reinterpret_cast<const QChar *>(
+                        sqlite3_column_text16(stmt, i)),
+                        sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+            break;
+        }
+    }
+}
+
+// Appends the current row to batch, letting SQLite convert the values to
+// the column types
+void QSQLiteResultPrivate::appendRow(QSqlColumnBatch *batch)
+{
+    for (int i = 0; i < batch->columnCount(); ++i) {
+        if (sqlite3_column_type(stmt, i) == SQLITE_NULL) {
+            batch->appendNull(i);
+            continue;
+        }
+        switch (batch->columnType(i)) {
+        case QSqlColumnBatch::Int64:
+            batch->appendInt64(i, sqlite3_column_int64(stmt, i));
+            break;
+        case QSqlColumnBatch::Double:
+            batch->appendDouble(i, sqlite3_column_double(stmt, i));
+            break;
+        case QSqlColumnBatch::Binary: {
+            const char *data = static_cast<const char *>(sqlite3_column_blob(stmt, i));
+            batch->appendBinary(i, data, sqlite3_column_bytes(stmt, i));
+            break;
+        }
+        case QSqlColumnBatch::String: {
+            const QChar *data = reinterpret_cast<const QChar *>(sqlite3_column_text16(stmt, i));
+            batch->appendString(i, data, sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+            break;
+        }
+        }
+    }
+}
+
+// Handles a result of sqlite3_step() other than SQLITE_ROW
+void QSQLiteResultPrivate::stepFailed(int res)
+{
+    switch(res) {
     case SQLITE_DONE:
         if (rInf.isEmpty())
             // must be first call.
             initColumns(true);
         q->setAt(QSql::AfterLastRow);
         sqlite3_reset(stmt);
-        return false;
+        break;
     case SQLITE_CONSTRAINT:
     case SQLITE_ERROR:
         // SQLITE_ERROR is a generic error code and we must call sqlite3_reset()
@@ -321,7 +399,7 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
         q->setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
                         "Unable to fetch row"), QSqlError::ConnectionError, res));
         q->setAt(QSql::AfterLastRow);
-        return false;
+        break;
     case SQLITE_MISUSE:
     case SQLITE_BUSY:
     default:
@@ -330,9 +408,8 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
                         "Unable to fetch row"), QSqlError::ConnectionError, res));
         sqlite3_reset(stmt);
         q->setAt(QSql::AfterLastRow);
-        return false;
+        break;
     }
-    return false;
 }
 
 QSQLiteResult::QSQLiteResult(const QSQLiteDriver* db)
@@ -354,9 +431,50 @@ QSQLiteResult::~QSQLiteResult()
 
 void QSQLiteResult::virtual_hook(int id, void *data)
 {
+    if (id == FetchColumnBatch) {
+        QSqlColumnBatchFetch *fetch = static_cast<QSqlColumnBatchFetch *>(data);
+        fetch->rows = fetchBatch(fetch->batch, fetch->maximumRows);
+        return;
+    }
     QSqlCachedResult::virtual_hook(id, data);
 }
 
+int QSQLiteResult::fetchBatch(QSqlColumnBatch *batch, int maximumRows)
+{
+    // with a cache, the rows have to go into it as well
+    if (!isForwardOnly() || !d->stmt)
+        return fetchBatchRowByRow(batch, maximumRows);
+
+    batch->reset(d->rInf);
+    int rows = 0;
+    if (d->skipRow) {
+        // exec() has stepped to the first row already
+        d->skipRow = false;
+        if (!d->skippedStatus) {
+            setAtEnd();
+            return 0;
+        }
+        d->appendRow(batch);
+        ++rows;
+    }
+
+    while (rows < maximumRows) {
+        const int res = sqlite3_step(d->stmt);
+        if (res != SQLITE_ROW) {
+            d->stepFailed(res);
+            setAtEnd();
+            return rows;
+        }
+        d->appendRow(batch);
+        ++rows;
+    }
+
+    // the query is now on the last row read
+    d->readRow(cache(), 0);
+    setAt(at() + rows);
+    return rows;
+}
+
 bool QSQLiteResult::reset(const QString &query)
 {
     if (!prepare(query))
@@ -373,6 +491,16 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    QSQLiteDriverPrivate *driverPrivate =
+            const_cast<QSQLiteDriverPrivate *>(static_cast<const QSQLiteDriver *>(driver())->d_func());
+    if (QSQLiteCachedStatement *cached = driverPrivate->cachedStatements.take(query)) {
+        d->stmt = cached->stmt;
+        d->query = query;
+        cached->stmt = 0;
+        delete cached;
+        return true;
+    }
+
     const void *pzTail = NULL;
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -394,9 +522,66 @@ bool QSQLiteResult::prepare(const QString &query)
         d->finalize();
         return false;
     }
+    d->query = query;
     return true;
 }
 
+// Binds value to the parameter at index, starting from 0. Strings and byte
+// arrays are not copied, value must stay alive while the statement runs.
+int QSQLiteResultPrivate::bindValue(int index, const QVariant &value)
+{
+    int res = SQLITE_OK;
+    if (value.isNull()) {
+        res = sqlite3_bind_null(stmt, index + 1);
+    } else {
+        switch (value.type()) {
+        case QVariant::ByteArray: {
+            const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
+            res = sqlite3_bind_blob(stmt, index + 1, ba->constData(),
+                                    ba->size(), SQLITE_STATIC);
+            break; }
+        case QVariant::Int:
+        case QVariant::Bool:
+            res = sqlite3_bind_int(stmt, index + 1, value.toInt());
+            break;
+        case QVariant::Double:
+            res = sqlite3_bind_double(stmt, index + 1, value.toDouble());
+            break;
+        case QVariant::UInt:
+        case QVariant::LongLong:
+            res = sqlite3_bind_int64(stmt, index + 1, value.toLongLong());
+            break;
+        case QVariant::DateTime: {
+            const QDateTime dateTime = value.toDateTime();
+            const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, index + 1, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::Time: {
+            const QTime time = value.toTime();
+            const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, index + 1, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::String: {
+            // lifetime of string == lifetime of its qvariant
+            const QString *str = static_cast<const QString*>(value.constData());
+            res = sqlite3_bind_text16(stmt, index + 1, str->utf16(),
+                                      (str->size()) * sizeof(QChar), SQLITE_STATIC);
+            break; }
+        default: {
+            QString str = value.toString();
+            // SQLITE_TRANSIENT makes sure that sqlite buffers the data
+            res = sqlite3_bind_text16(stmt, index + 1, str.utf16(),
+                                      (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
+            break; }
+        }
+    }
+    return res;
+}
+
 bool QSQLiteResult::exec()
 {
     const QVector<QVariant> values = boundValues();
@@ -417,57 +602,7 @@ bool QSQLiteResult::exec()
     int paramCount = sqlite3_bind_parameter_count(d->stmt);
     if (paramCount == values.count()) {
         for (int i = 0; i < paramCount; ++i) {
-            res = SQLITE_OK;
-            const QVariant value = values.at(i);
-
-            if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
-            } else {
-                switch (value.type()) {
-                case QVariant::ByteArray: {
-                    const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
-                                            ba->size(), SQLITE_STATIC);
-                    break; }
-                case QVariant::Int:
-                case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
-                    break;
-                case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
-                    break;
-                case QVariant::UInt:
-                case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
-                    break;
-                case QVariant::DateTime: {
-                    const QDateTime dateTime = value.toDateTime();
-                    const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::Time: {
-                    const QTime time = value.toTime();
-                    const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::String: {
-                    // lifetime of string == lifetime of its qvariant
-                    const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
-                                              (str->size()) * sizeof(QChar), SQLITE_STATIC);
-                    break; }
-                default: {
-                    QString str = value.toString();
-                    // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
-                    break; }
-                }
-            }
+            res = d->bindValue(i, values.at(i));
             if (res != SQLITE_OK) {
                 setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
@@ -491,6 +626,95 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_UNUSED(arrayBind);
+
+    const QVector<QVariant> values = boundValues();
+    if (values.isEmpty())
+        return false;
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+    setSelect(false);
+    setActive(false);
+
+    // keep the lists alive, the strings and byte arrays are bound without copying
+    QVector<QVariantList> columns(values.count());
+    for (int i = 0; i < values.count(); ++i) {
+        columns[i] = values.at(i).toList();
+        if (columns.at(i).count() != columns.at(0).count()) {
+            setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
+    if (sqlite3_bind_parameter_count(d->stmt) != columns.count()) {
+        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                        "Parameter count mismatch"), QString(), QSqlError::StatementError));
+        return false;
+    }
+
+    // without a transaction, SQLite commits and syncs every row on its own
+    const bool ownTransaction = sqlite3_get_autocommit(d->access);
+    int res = SQLITE_OK;
+    if (ownTransaction) {
+        res = sqlite3_exec(d->access, "BEGIN", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to begin transaction"), QSqlError::TransactionError, res));
+            return false;
+        }
+    }
+
+    const int rows = columns.at(0).count();
+    for (int row = 0; row < rows; ++row) {
+        res = sqlite3_reset(d->stmt);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to reset statement"), QSqlError::StatementError, res));
+            break;
+        }
+        for (int i = 0; i < columns.count() && res == SQLITE_OK; ++i)
+            res = d->bindValue(i, columns.at(i).at(row));
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to bind parameters"), QSqlError::StatementError, res));
+            break;
+        }
+        res = sqlite3_step(d->stmt);
+        if (res != SQLITE_DONE && res != SQLITE_ROW) {
+            // sqlite3_reset() returns the specific error
+            res = sqlite3_reset(d->stmt);
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to execute statement"), QSqlError::StatementError, res));
+            break;
+        }
+    }
+    sqlite3_reset(d->stmt);
+    sqlite3_clear_bindings(d->stmt);
+
+    if (lastError().isValid()) {
+        if (ownTransaction)
+            sqlite3_exec(d->access, "ROLLBACK", 0, 0, 0);
+        return false;
+    }
+    if (ownTransaction) {
+        res = sqlite3_exec(d->access, "COMMIT", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(d->access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to commit transaction"), QSqlError::TransactionError, res));
+            sqlite3_exec(d->access, "ROLLBACK", 0, 0, 0);
+            return false;
+        }
+    }
+    setActive(true);
+    return true;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     return d->fetchNext(row, idx, false);
@@ -568,9 +792,10 @@ bool QSQLiteDriver::hasFeature(DriverFeature f) const
     case FinishQuery:
     case LowPrecisionNumbers:
         return true;
+    case BatchOperations:
+        return true;
     case QuerySize:
     case NamedPlaceholders:
-    case BatchOperations:
     case EventNotifications:
     case MultipleResultSets:
     case CancelQuery:
@@ -642,6 +867,7 @@ void QSQLiteDriver::close()
         foreach (QSQLiteResult *result, d->results) {
             result->d->finalize();
         }
+        d->cachedStatements.clear();
 
         if (sqlite3_close(d->access) != SQLITE_OK)
             setLastError(qMakeError(d->access, tr("Error closing database"),
@@ -11,7 +11,10 @@ HEADERS +=      kernel/qsql.h \
                 kernel/qsqlresult.h \
                 kernel/qsqlresult_p.h \
                 kernel/qsqlcachedresult_p.h \
-                kernel/qsqlindex.h
+                kernel/qsqlstatementcache_p.h \
+                kernel/qsqlindex.h \
+                kernel/qsqlcolumnbatch.h \
+                kernel/qsqlquerypool.h
 
 SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqldatabase.cpp \
@@ -22,5 +25,7 @@ SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqlerror.cpp \
                 kernel/qsqlresult.cpp \
                 kernel/qsqlindex.cpp \
-                kernel/qsqlcachedresult.cpp
+                kernel/qsqlcachedresult.cpp \
+                kernel/qsqlcolumnbatch.cpp \
+                kernel/qsqlquerypool.cpp
 
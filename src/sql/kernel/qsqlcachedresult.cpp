@@ -294,6 +294,14 @@ QSqlCachedResult::ValueCache &QSqlCachedResult::cache()
     return d->cache;
 }
 
+// For results that read rows without going through the cache, such as in
+// fetchBatch(): there are no more rows, don't call gotoNext() again.
+void QSqlCachedResult::setAtEnd()
+{
+    d->atEnd = true;
+    setAt(QSql::AfterLastRow);
+}
+
 void QSqlCachedResult::virtual_hook(int id, void *data)
 {
     QSqlResult::virtual_hook(id, data);
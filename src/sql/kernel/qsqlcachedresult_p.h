@@ -80,6 +80,7 @@ protected:
 
     int colCount() const;
     ValueCache &cache();
+    void setAtEnd();
 
     void virtual_hook(int id, void *data);
     void detachFromResultSet();
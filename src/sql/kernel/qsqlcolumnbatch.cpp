@@ -0,0 +1,530 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlcolumnbatch.h"
+
+#include "qsqlfield.h"
+#include "qsqlrecord.h"
+#include "qbitarray.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSqlColumnBatchPrivate : public QSharedData
+{
+public:
+    struct Column
+    {
+        Column() : type(QSqlColumnBatch::String), count(0) { offsets.append(0); }
+
+        void clear();
+        void appendNullFlag(bool isNull);
+
+        QSqlColumnBatch::ColumnType type;
+        int count;
+        QVector<qint64> ints;
+        QVector<double> doubles;
+        QString text;           // the values of a String column, one after another
+        QByteArray bytes;       // the values of a Binary column
+        QVector<int> offsets;   // where the values of a String or Binary column start, and the end
+        QBitArray nulls;        // may be larger than count
+    };
+
+    inline const Column &column(int i) const
+    {
+        Q_ASSERT_X(i >= 0 && i < columns.size(), "QSqlColumnBatch", "column index out of range");
+        return columns.at(i);
+    }
+    inline Column &column(int i)
+    {
+        Q_ASSERT_X(i >= 0 && i < columns.size(), "QSqlColumnBatch", "column index out of range");
+        return columns[i];
+    }
+
+    QVector<Column> columns;
+};
+
+void QSqlColumnBatchPrivate::Column::clear()
+{
+    count = 0;
+    ints.resize(0);
+    doubles.resize(0);
+    text.resize(0);
+    bytes.resize(0);
+    offsets.resize(1);
+    nulls.fill(false);
+}
+
+void QSqlColumnBatchPrivate::Column::appendNullFlag(bool isNull)
+{
+    if (count >= nulls.size())
+        nulls.resize(qMax(64, nulls.size() * 2));
+    if (isNull)
+        nulls.setBit(count);
+    ++count;
+}
+
+/*!
+    \class QSqlColumnBatch
+    \brief The QSqlColumnBatch class holds a block of rows of a result set,
+    stored column by column.
+    \since 5.6
+
+    \ingroup database
+    \inmodule QtSql
+
+    QSqlQuery::fetchBatch() reads many rows of a result set at once into a
+    QSqlColumnBatch. Unlike QSqlQuery::value(), which returns every value
+    as a QVariant, the batch keeps the values of each column in a buffer of
+    the column's type:
+
+    \table
+    \header \li Column type \li Used for \li Values
+    \row \li \l Int64 \li integer and boolean columns
+         \li an array of qint64, see int64Data()
+    \row \li \l Double \li floating point and numeric columns
+         \li an array of double, see doubleData()
+    \row \li \l String \li text and all other columns
+         \li the UTF-16 text of all values in one string, see stringValue()
+    \row \li \l Binary \li BLOB columns
+         \li the bytes of all values in one byte array, see binaryValue()
+    \endtable
+
+    For each column, nullFlags() tells which values are NULL. The value
+    buffers hold 0 or an empty value for them.
+
+    Reusing a QSqlColumnBatch for the next call of fetchBatch() reuses its
+    buffers, so that reading a large result set does not allocate memory
+    for every row:
+
+    \snippet code/src_sql_kernel_qsqlcolumnbatch.cpp 0
+
+    Which column type a column gets is decided by the type of its field in
+    QSqlQuery::record(); see columnTypeFor(). Dates and times are stored as
+    text in the format the driver receives them in. Double columns hold
+    doubles regardless of the query's numerical precision policy.
+
+    QSqlColumnBatch is implicitly shared. The QStringRef objects returned
+    by stringValue() point into the batch and are valid until the batch is
+    modified.
+
+    \sa QSqlQuery::fetchBatch()
+*/
+
+/*!
+    \enum QSqlColumnBatch::ColumnType
+
+    This enum describes how the values of a column are stored.
+
+    \value Int64 The values are stored as qint64.
+    \value Double The values are stored as double.
+    \value String The values are stored as UTF-16 text.
+    \value Binary The values are stored as bytes.
+*/
+
+/*!
+    Constructs an empty batch without columns.
+*/
+QSqlColumnBatch::QSqlColumnBatch()
+    : d(new QSqlColumnBatchPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSqlColumnBatch::QSqlColumnBatch(const QSqlColumnBatch &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this batch and returns a reference to it.
+*/
+QSqlColumnBatch &QSqlColumnBatch::operator=(const QSqlColumnBatch &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the batch.
+*/
+QSqlColumnBatch::~QSqlColumnBatch()
+{
+}
+
+/*!
+    Sets up the batch with one column for each field of \a record, with the
+    column type given by columnTypeFor() for the field's type, and removes
+    all rows.
+*/
+void QSqlColumnBatch::reset(const QSqlRecord &record)
+{
+    QVector<ColumnType> columnTypes(record.count());
+    for (int i = 0; i < record.count(); ++i)
+        columnTypes[i] = columnTypeFor(record.field(i).type());
+    reset(columnTypes);
+}
+
+/*!
+    \overload
+
+    Sets up the batch with columns of the types \a columnTypes and removes
+    all rows. The buffers of columns that keep their type are reused.
+*/
+void QSqlColumnBatch::reset(const QVector<ColumnType> &columnTypes)
+{
+    d->columns.resize(columnTypes.size());
+    for (int i = 0; i < columnTypes.size(); ++i) {
+        QSqlColumnBatchPrivate::Column &column = d->columns[i];
+        column.clear();
+        column.type = columnTypes.at(i);
+    }
+}
+
+/*!
+    Removes all rows, keeping the columns.
+*/
+void QSqlColumnBatch::clear()
+{
+    for (int i = 0; i < d->columns.size(); ++i)
+        d->columns[i].clear();
+}
+
+/*!
+    Returns the number of columns.
+*/
+int QSqlColumnBatch::columnCount() const
+{
+    return d->columns.size();
+}
+
+/*!
+    Returns the number of rows.
+*/
+int QSqlColumnBatch::rowCount() const
+{
+    return d->columns.isEmpty() ? 0 : d->columns.first().count;
+}
+
+/*!
+    Returns how the values of \a column are stored.
+*/
+QSqlColumnBatch::ColumnType QSqlColumnBatch::columnType(int column) const
+{
+    return d->column(column).type;
+}
+
+/*!
+    Returns \c true if the value in \a row and \a column is NULL.
+*/
+bool QSqlColumnBatch::isNull(int row, int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(row >= 0 && row < c.count, "QSqlColumnBatch::isNull", "row index out of range");
+    return c.nulls.testBit(row);
+}
+
+/*!
+    Returns the value in \a row and \a column, which must be an \l Int64
+    column.
+*/
+qint64 QSqlColumnBatch::int64Value(int row, int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == Int64, "QSqlColumnBatch::int64Value", "column is not an Int64 column");
+    return c.ints.at(row);
+}
+
+/*!
+    Returns the value in \a row and \a column, which must be a \l Double
+    column.
+*/
+double QSqlColumnBatch::doubleValue(int row, int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == Double, "QSqlColumnBatch::doubleValue", "column is not a Double column");
+    return c.doubles.at(row);
+}
+
+/*!
+    Returns the value in \a row and \a column, which must be a \l String
+    column. The reference is valid until the batch is modified.
+*/
+QStringRef QSqlColumnBatch::stringValue(int row, int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == String, "QSqlColumnBatch::stringValue", "column is not a String column");
+    const int start = c.offsets.at(row);
+    return QStringRef(&c.text, start, c.offsets.at(row + 1) - start);
+}
+
+/*!
+    Returns the value in \a row and \a column, which must be a \l Binary
+    column.
+*/
+QByteArray QSqlColumnBatch::binaryValue(int row, int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == Binary, "QSqlColumnBatch::binaryValue", "column is not a Binary column");
+    const int start = c.offsets.at(row);
+    return c.bytes.mid(start, c.offsets.at(row + 1) - start);
+}
+
+/*!
+    Returns the value in \a row and \a column as a QVariant. NULL values
+    are returned as null QVariant objects of the column's type.
+
+    This is a convenience function; it allocates a QVariant for every value.
+*/
+QVariant QSqlColumnBatch::value(int row, int column) const
+{
+    switch (columnType(column)) {
+    case Int64:
+        return isNull(row, column) ? QVariant(QVariant::LongLong) : QVariant(int64Value(row, column));
+    case Double:
+        return isNull(row, column) ? QVariant(QVariant::Double) : QVariant(doubleValue(row, column));
+    case Binary:
+        return isNull(row, column) ? QVariant(QVariant::ByteArray) : QVariant(binaryValue(row, column));
+    case String:
+        break;
+    }
+    return isNull(row, column) ? QVariant(QVariant::String) : QVariant(stringValue(row, column).toString());
+}
+
+/*!
+    Returns the values of \a column, which must be an \l Int64 column, as
+    an array of rowCount() values. The array is valid until the batch is
+    modified.
+*/
+const qint64 *QSqlColumnBatch::int64Data(int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == Int64, "QSqlColumnBatch::int64Data", "column is not an Int64 column");
+    return c.ints.constData();
+}
+
+/*!
+    Returns the values of \a column, which must be a \l Double column, as
+    an array of rowCount() values. The array is valid until the batch is
+    modified.
+*/
+const double *QSqlColumnBatch::doubleData(int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT_X(c.type == Double, "QSqlColumnBatch::doubleData", "column is not a Double column");
+    return c.doubles.constData();
+}
+
+/*!
+    Returns a bit array with rowCount() bits, in which the bits of the rows
+    that have a NULL value in \a column are set.
+*/
+QBitArray QSqlColumnBatch::nullFlags(int column) const
+{
+    const QSqlColumnBatchPrivate::Column &c = d->column(column);
+    QBitArray flags = c.nulls;
+    flags.truncate(c.count);
+    return flags;
+}
+
+/*!
+    Appends a NULL value to \a column.
+
+    The append functions are meant for SQL drivers that fill the batch
+    for QSqlQuery::fetchBatch(). They must append one value to every
+    column for each row, with the function that matches the column type.
+*/
+void QSqlColumnBatch::appendNull(int column)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    switch (c.type) {
+    case Int64:
+        c.ints.append(0);
+        break;
+    case Double:
+        c.doubles.append(0);
+        break;
+    case String:
+        c.offsets.append(c.text.size());
+        break;
+    case Binary:
+        c.offsets.append(c.bytes.size());
+        break;
+    }
+    c.appendNullFlag(true);
+}
+
+/*!
+    Appends \a value to \a column, which must be an \l Int64 column.
+*/
+void QSqlColumnBatch::appendInt64(int column, qint64 value)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == Int64);
+    c.ints.append(value);
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends \a value to \a column, which must be a \l Double column.
+*/
+void QSqlColumnBatch::appendDouble(int column, double value)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == Double);
+    c.doubles.append(value);
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends the \a length characters at \a data to \a column, which must be
+    a \l String column.
+*/
+void QSqlColumnBatch::appendString(int column, const QChar *data, int length)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == String);
+    c.text.append(data, length);
+    c.offsets.append(c.text.size());
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends the \a length Latin-1 characters at \a data to \a column, which
+    must be a \l String column.
+*/
+void QSqlColumnBatch::appendLatin1(int column, const char *data, int length)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == String);
+    c.text.append(QLatin1String(data, length));
+    c.offsets.append(c.text.size());
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends the \a length bytes of UTF-8 text at \a data to \a column,
+    which must be a \l String column.
+*/
+void QSqlColumnBatch::appendUtf8(int column, const char *data, int length)
+{
+    // plain ASCII, which most values are, needs no decoding
+    int i = 0;
+    while (i < length && uchar(data[i]) < 0x80)
+        ++i;
+    if (i == length) {
+        appendLatin1(column, data, length);
+        return;
+    }
+
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == String);
+    c.text.append(QString::fromUtf8(data, length));
+    c.offsets.append(c.text.size());
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends the \a length bytes at \a data to \a column, which must be a
+    \l Binary column.
+*/
+void QSqlColumnBatch::appendBinary(int column, const char *data, int length)
+{
+    QSqlColumnBatchPrivate::Column &c = d->column(column);
+    Q_ASSERT(c.type == Binary);
+    c.bytes.append(data, length);
+    c.offsets.append(c.bytes.size());
+    c.appendNullFlag(false);
+}
+
+/*!
+    Appends \a value to \a column, converting it to the column type. A null
+    \a value is appended as NULL.
+*/
+void QSqlColumnBatch::appendValue(int column, const QVariant &value)
+{
+    if (value.isNull()) {
+        appendNull(column);
+        return;
+    }
+
+    switch (columnType(column)) {
+    case Int64:
+        appendInt64(column, value.toLongLong());
+        break;
+    case Double:
+        appendDouble(column, value.toDouble());
+        break;
+    case Binary: {
+        const QByteArray bytes = value.toByteArray();
+        appendBinary(column, bytes.constData(), bytes.size());
+        break;
+    }
+    case String: {
+        const QString text = value.toString();
+        appendString(column, text.constData(), text.size());
+        break;
+    }
+    }
+}
+
+/*!
+    Returns the column type used for fields of the type \a type: \l Int64
+    for integer and boolean types, \l Double for floating point types,
+    \l Binary for QByteArray and \l String for everything else.
+*/
+QSqlColumnBatch::ColumnType QSqlColumnBatch::columnTypeFor(QVariant::Type type)
+{
+    switch (int(type)) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+        return Int64;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return Double;
+    case QMetaType::QByteArray:
+        return Binary;
+    default:
+        return String;
+    }
+}
+
+QT_END_NAMESPACE
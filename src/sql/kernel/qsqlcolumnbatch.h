@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLCOLUMNBATCH_H
+#define QSQLCOLUMNBATCH_H
+
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+#include <QtSql/qsql.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QBitArray;
+class QSqlRecord;
+class QSqlColumnBatchPrivate;
+
+class Q_SQL_EXPORT QSqlColumnBatch
+{
+public:
+    enum ColumnType {
+        Int64,
+        Double,
+        String,
+        Binary
+    };
+
+    QSqlColumnBatch();
+    QSqlColumnBatch(const QSqlColumnBatch &other);
+    QSqlColumnBatch &operator=(const QSqlColumnBatch &other);
+    ~QSqlColumnBatch();
+
+    void reset(const QSqlRecord &record);
+    void reset(const QVector<ColumnType> &columnTypes);
+    void clear();
+
+    int columnCount() const;
+    int rowCount() const;
+    ColumnType columnType(int column) const;
+
+    bool isNull(int row, int column) const;
+    qint64 int64Value(int row, int column) const;
+    double doubleValue(int row, int column) const;
+    QStringRef stringValue(int row, int column) const;
+    QByteArray binaryValue(int row, int column) const;
+    QVariant value(int row, int column) const;
+
+    const qint64 *int64Data(int column) const;
+    const double *doubleData(int column) const;
+    QBitArray nullFlags(int column) const;
+
+    void appendNull(int column);
+    void appendInt64(int column, qint64 value);
+    void appendDouble(int column, double value);
+    void appendString(int column, const QChar *data, int length);
+    void appendLatin1(int column, const char *data, int length);
+    void appendUtf8(int column, const char *data, int length);
+    void appendBinary(int column, const char *data, int length);
+    void appendValue(int column, const QVariant &value);
+
+    static ColumnType columnTypeFor(QVariant::Type type);
+
+private:
+    QSharedDataPointer<QSqlColumnBatchPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNBATCH_H
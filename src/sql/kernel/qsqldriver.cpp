@@ -792,6 +792,78 @@ QSqlDriver::DbmsType QSqlDriver::dbmsType() const
     return d_func()->dbmsType;
 }
 
+/*!
+    \since 5.6
+
+    Returns the maximum number of prepared statements that the driver keeps
+    for reuse. The default is 0, which means that statements are not reused.
+
+    \sa setStatementCacheSize(), statementCacheHits()
+*/
+int QSqlDriver::statementCacheSize() const
+{
+    Q_D(const QSqlDriver);
+    return d->statementCache ? d->statementCache->maximumSize() : 0;
+}
+
+/*!
+    \since 5.6
+
+    Sets the maximum number of prepared statements that the driver keeps for
+    reuse to \a size.
+
+    Preparing a statement makes the database parse and plan the SQL. With
+    a cache size greater than 0, the driver does not free the statement when
+    the QSqlQuery that prepared it is done with it, but keeps it, and a
+    later QSqlQuery::prepare() of the same SQL text reuses it; the
+    statement is only reset and new values are bound to it. When the cache
+    is full, the least recently used statement is freed.
+
+    Only the SQLite and PostgreSQL drivers cache statements; for other
+    drivers this function does nothing and statementCacheSize() stays 0.
+    The SQLite driver prepares every query, so QSqlQuery::exec() with SQL
+    text reuses cached statements as well. The PostgreSQL driver runs such
+    queries unprepared, so only QSqlQuery::prepare() uses the cache there.
+    Setting a size of 0 frees all cached statements.
+
+    \sa statementCacheSize(), statementCacheHits(), statementCacheMisses()
+*/
+void QSqlDriver::setStatementCacheSize(int size)
+{
+    Q_D(QSqlDriver);
+    if (d->statementCache)
+        d->statementCache->setMaximumSize(size);
+}
+
+/*!
+    \since 5.6
+
+    Returns how many times a statement has been prepared by reusing a cached
+    one since the driver was created.
+
+    \sa statementCacheMisses(), setStatementCacheSize()
+*/
+qint64 QSqlDriver::statementCacheHits() const
+{
+    Q_D(const QSqlDriver);
+    return d->statementCache ? d->statementCache->hits : 0;
+}
+
+/*!
+    \since 5.6
+
+    Returns how many times a statement had to be prepared by the database
+    while the statement cache was enabled, because the cache did not hold
+    one for its SQL.
+
+    \sa statementCacheHits(), setStatementCacheSize()
+*/
+qint64 QSqlDriver::statementCacheMisses() const
+{
+    Q_D(const QSqlDriver);
+    return d->statementCache ? d->statementCache->misses : 0;
+}
+
 /*!
     \since 5.0
     \internal
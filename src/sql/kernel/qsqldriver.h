@@ -125,6 +125,11 @@ public:
 
     DbmsType dbmsType() const;
 
+    int statementCacheSize() const;
+    void setStatementCacheSize(int size);
+    qint64 statementCacheHits() const;
+    qint64 statementCacheMisses() const;
+
 public Q_SLOTS:
     virtual bool cancelQuery();
 
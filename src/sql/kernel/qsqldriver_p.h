@@ -48,6 +48,7 @@
 #include "private/qobject_p.h"
 #include "qsqldriver.h"
 #include "qsqlerror.h"
+#include "qsqlstatementcache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -61,7 +62,8 @@ public:
         isOpen(false),
         isOpenError(false),
         precisionPolicy(QSql::LowPrecisionDouble),
-        dbmsType(QSqlDriver::UnknownDbms)
+        dbmsType(QSqlDriver::UnknownDbms),
+        statementCache(0)
     { }
 
     uint isOpen;
@@ -69,6 +71,8 @@ public:
     QSqlError error;
     QSql::NumericalPrecisionPolicy precisionPolicy;
     QSqlDriver::DbmsType dbmsType;
+    // set by drivers that can reuse prepared statements
+    QSqlAbstractStatementCache *statementCache;
 };
 
 QT_END_NAMESPACE
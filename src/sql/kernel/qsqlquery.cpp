@@ -40,9 +40,11 @@
 #include "qatomic.h"
 #include "qsqlrecord.h"
 #include "qsqlresult.h"
+#include "qsqlcolumnbatch.h"
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
 #include "qvector.h"
 #include "qmap.h"
 
@@ -1039,6 +1041,10 @@ bool QSqlQuery::exec()
   {QVariant(QVariant::String)} should be used if you are using
   strings.
 
+  The SQLite and PostgreSQL drivers execute the rows of a batch in a
+  single transaction if no transaction is open, so that either all rows
+  or none are inserted. PostgreSQL receives many rows per round trip.
+
   \note Every bound QVariantList must contain the same amount of
   variants.
 
@@ -1289,4 +1295,44 @@ bool QSqlQuery::nextResult()
     return false;
 }
 
+/*!
+  \since 5.6
+
+  Reads up to \a maximumRows rows that follow the current row into
+  \a batch, and returns the number of rows read. The previous contents of
+  \a batch are replaced; it gets one column for each field of record().
+
+  This is much faster than reading the values with next() and value() when
+  a result set has many rows, because the values are stored in typed
+  column buffers instead of a QVariant each. The SQLite, PostgreSQL and
+  MySQL drivers fill the batch straight from the database client's
+  buffers; for SQLite this needs a \l{setForwardOnly()}{forward only}
+  query.
+
+  If fewer than \a maximumRows rows are read, the end of the result set
+  has been reached and the query is positioned after the last record.
+  Otherwise the query is positioned on the last row read, so that next()
+  and the next call of fetchBatch() continue after it.
+
+  The query must be \l{isActive()}{active} and isSelect() must return
+  true, otherwise 0 is returned.
+
+  \sa QSqlColumnBatch, next(), setForwardOnly()
+*/
+int QSqlQuery::fetchBatch(QSqlColumnBatch *batch, int maximumRows)
+{
+    Q_ASSERT(batch);
+    if (!isSelect() || !isActive() || at() == QSql::AfterLastRow || maximumRows <= 0) {
+        batch->reset(record());
+        return 0;
+    }
+
+    QSqlColumnBatchFetch fetch = { batch, maximumRows, -1 };
+    d->sqlResult->virtual_hook(QSqlResult::FetchColumnBatch, &fetch);
+    // a result whose virtual_hook() doesn't pass on unknown operations
+    if (fetch.rows < 0)
+        fetch.rows = d->sqlResult->fetchBatchRowByRow(batch, maximumRows);
+    return fetch.rows;
+}
+
 QT_END_NAMESPACE
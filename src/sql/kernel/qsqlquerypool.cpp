@@ -0,0 +1,635 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlquerypool.h"
+
+#ifndef QT_NO_QFUTURE
+
+#include "qsqlcolumnbatch.h"
+#include "qsqldatabase.h"
+#include "qsqlerror.h"
+#include "qsqlquery.h"
+#include "qsqlrecord.h"
+
+#include <qelapsedtimer.h>
+#include <qfutureinterface.h>
+#include <qmutex.h>
+#include <qqueue.h>
+#include <qthread.h>
+#include <qwaitcondition.h>
+#include "private/qobject_p.h"
+
+#include <limits.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSqlAsyncResultPrivate : public QSharedData
+{
+public:
+    QSqlAsyncResultPrivate() : active(false), select(false), numRowsAffected(-1) {}
+
+    bool active;
+    bool select;
+    int numRowsAffected;
+    QString lastQuery;
+    QSqlError error;
+    QSqlRecord record;
+    QSqlColumnBatch rows;
+    QVariant lastInsertId;
+};
+
+struct QSqlQueryPoolTask
+{
+    QSqlQueryPoolTask() : batchSize(0) {}
+
+    QString query;
+    QVariantList values;
+    int batchSize; // rows per result, or 0 for a single result
+    QFutureInterface<QSqlAsyncResult> future;
+    QElapsedTimer queued;
+};
+
+class QSqlQueryPoolThread : public QThread
+{
+public:
+    QSqlQueryPoolThread(QSqlQueryPoolPrivate *pool, const QString &connectionName)
+        : pool(pool), connectionName(connectionName) {}
+
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    static void execTask(QSqlDatabase &db, QSqlQueryPoolTask &task);
+
+    QSqlQueryPoolPrivate *pool;
+    QString connectionName;
+};
+
+class QSqlQueryPoolPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSqlQueryPool)
+public:
+    QSqlQueryPoolPrivate()
+        : maxThreadCount(qMax(QThread::idealThreadCount(), 1)), idleThreadCount(0),
+          activeQueryCount(0), peakPendingQueryCount(0), finishedQueryCount(0),
+          totalWaitTime(0), nextThreadId(0), quit(false) {}
+
+    QFuture<QSqlAsyncResult> enqueue(QSqlQueryPoolTask &task);
+    bool takeTask(QSqlQueryPoolThread *thread, QSqlQueryPoolTask *task);
+    void finishTask();
+    void startThreads();
+
+    QString templateName; // the connection the worker connections are cloned from
+
+    mutable QMutex mutex;
+    QWaitCondition taskQueued;
+    QWaitCondition allDone;
+    QQueue<QSqlQueryPoolTask> tasks;
+    QList<QSqlQueryPoolThread *> threads;
+    QList<QSqlQueryPoolThread *> exitedThreads;
+    int maxThreadCount;
+    int idleThreadCount;
+    int activeQueryCount;
+    int peakPendingQueryCount;
+    qint64 finishedQueryCount;
+    qint64 totalWaitTime;
+    int nextThreadId;
+    bool quit;
+};
+
+QFuture<QSqlAsyncResult> QSqlQueryPoolPrivate::enqueue(QSqlQueryPoolTask &task)
+{
+    task.future.reportStarted();
+    task.queued.start();
+    QFuture<QSqlAsyncResult> future = task.future.future();
+
+    QMutexLocker locker(&mutex);
+    tasks.enqueue(task);
+    peakPendingQueryCount = qMax(peakPendingQueryCount, tasks.count());
+    startThreads();
+    taskQueued.wakeOne();
+    return future;
+}
+
+// Waits for a query to run. Returns false if the thread should exit instead.
+bool QSqlQueryPoolPrivate::takeTask(QSqlQueryPoolThread *thread, QSqlQueryPoolTask *task)
+{
+    QMutexLocker locker(&mutex);
+    while (tasks.isEmpty() && !quit && threads.count() <= maxThreadCount) {
+        ++idleThreadCount;
+        taskQueued.wait(&mutex);
+        --idleThreadCount;
+    }
+    if (quit || threads.count() > maxThreadCount) {
+        threads.removeOne(thread);
+        exitedThreads.append(thread);
+        return false;
+    }
+
+    *task = tasks.dequeue();
+    ++activeQueryCount;
+    totalWaitTime += task->queued.elapsed();
+    return true;
+}
+
+void QSqlQueryPoolPrivate::finishTask()
+{
+    QMutexLocker locker(&mutex);
+    --activeQueryCount;
+    ++finishedQueryCount;
+    if (tasks.isEmpty() && activeQueryCount == 0)
+        allDone.wakeAll();
+}
+
+// Starts threads for the queries no idle thread will take. Called with the
+// mutex locked.
+void QSqlQueryPoolPrivate::startThreads()
+{
+    // threads that exited after a smaller maxThreadCount was set
+    while (!exitedThreads.isEmpty()) {
+        QSqlQueryPoolThread *thread = exitedThreads.takeFirst();
+        thread->wait();
+        delete thread;
+    }
+
+    while (tasks.count() > idleThreadCount && threads.count() < maxThreadCount) {
+        const QString name = templateName + QLatin1Char('_') + QString::number(nextThreadId++);
+        QSqlQueryPoolThread *thread = new QSqlQueryPoolThread(this, name);
+        threads.append(thread);
+        // counts as idle until it takes its first query
+        ++idleThreadCount;
+        thread->start();
+    }
+}
+
+void QSqlQueryPoolThread::run()
+{
+    {
+        pool->mutex.lock();
+        --pool->idleThreadCount;
+        const QString templateName = pool->templateName;
+        pool->mutex.unlock();
+
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::database(templateName, false),
+                                                      connectionName);
+        QSqlQueryPoolTask task;
+        while (pool->takeTask(this, &task)) {
+            if (!task.future.isCanceled())
+                execTask(db, task);
+            task.future.reportFinished();
+            task = QSqlQueryPoolTask();
+            pool->finishTask();
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void QSqlQueryPoolThread::execTask(QSqlDatabase &db, QSqlQueryPoolTask &task)
+{
+    QSqlAsyncResult result;
+    QSqlAsyncResultPrivate *d = result.d.data();
+    d->lastQuery = task.query;
+
+    // opened on first use, and again after the connection failed
+    if (!db.isOpen() && !db.open()) {
+        d->error = db.lastError();
+        task.future.reportResult(result);
+        return;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    bool ok;
+    if (task.values.isEmpty()) {
+        ok = query.exec(task.query);
+    } else {
+        ok = query.prepare(task.query);
+        if (ok) {
+            for (int i = 0; i < task.values.count(); ++i)
+                query.addBindValue(task.values.at(i));
+            ok = query.exec();
+        }
+    }
+
+    if (ok) {
+        d->active = true;
+        d->select = query.isSelect();
+        d->numRowsAffected = query.numRowsAffected();
+        d->lastInsertId = query.lastInsertId();
+        if (d->select)
+            d->record = query.record();
+    }
+    if (!d->select) {
+        d->error = query.lastError();
+        task.future.reportResult(result);
+        return;
+    }
+
+    const int batchSize = task.batchSize > 0 ? task.batchSize : INT_MAX;
+    int index = 0;
+    do {
+        // a new batch each time, the previous one is shared with the future
+        QSqlColumnBatch rows;
+        const int count = query.fetchBatch(&rows, batchSize);
+        if (index > 0 && count == 0 && !query.lastError().isValid())
+            break;
+        QSqlAsyncResult batchResult(result);
+        batchResult.d->rows = rows;
+        batchResult.d->error = query.lastError();
+        task.future.reportResult(batchResult, index++);
+        if (count < batchSize)
+            break;
+    } while (!task.future.isCanceled());
+}
+
+/*!
+    \class QSqlAsyncResult
+    \brief The QSqlAsyncResult class holds the result of a query run by a
+    QSqlQueryPool.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.6
+
+    A QSqlAsyncResult is a snapshot of the query after it has been
+    executed: isActive() and lastError() tell whether it succeeded, and
+    for a SELECT statement, rows() holds all rows of the result set.
+    Unlike a QSqlQuery, it is not tied to a connection or a thread.
+
+    QSqlAsyncResult is implicitly shared.
+
+    \sa QSqlQueryPool
+*/
+
+/*!
+    Constructs an empty result, which is not active.
+*/
+QSqlAsyncResult::QSqlAsyncResult()
+    : d(new QSqlAsyncResultPrivate)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSqlAsyncResult::QSqlAsyncResult(const QSqlAsyncResult &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this result and returns a reference to it.
+*/
+QSqlAsyncResult &QSqlAsyncResult::operator=(const QSqlAsyncResult &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the result.
+*/
+QSqlAsyncResult::~QSqlAsyncResult()
+{
+}
+
+/*!
+    Returns \c true if the query was executed successfully; otherwise
+    returns \c false.
+
+    \sa QSqlQuery::isActive(), lastError()
+*/
+bool QSqlAsyncResult::isActive() const
+{
+    return d->active;
+}
+
+/*!
+    Returns \c true if the query was a SELECT statement; otherwise returns
+    \c false.
+
+    \sa QSqlQuery::isSelect()
+*/
+bool QSqlAsyncResult::isSelect() const
+{
+    return d->select;
+}
+
+/*!
+    Returns the text of the query.
+*/
+QString QSqlAsyncResult::lastQuery() const
+{
+    return d->lastQuery;
+}
+
+/*!
+    Returns the error of the query, or of the connection if the worker
+    thread could not open it.
+
+    \sa QSqlQuery::lastError()
+*/
+QSqlError QSqlAsyncResult::lastError() const
+{
+    return d->error;
+}
+
+/*!
+    Returns the fields of the result set of a SELECT statement.
+
+    \sa QSqlQuery::record()
+*/
+QSqlRecord QSqlAsyncResult::record() const
+{
+    return d->record;
+}
+
+/*!
+    Returns all rows of the result set of a SELECT statement.
+
+    \sa QSqlQuery::fetchBatch()
+*/
+QSqlColumnBatch QSqlAsyncResult::rows() const
+{
+    return d->rows;
+}
+
+/*!
+    Returns the number of rows the query affected, or -1 if that cannot
+    be determined.
+
+    \sa QSqlQuery::numRowsAffected()
+*/
+int QSqlAsyncResult::numRowsAffected() const
+{
+    return d->numRowsAffected;
+}
+
+/*!
+    Returns the object ID of the most recent inserted row if the database
+    supports it.
+
+    \sa QSqlQuery::lastInsertId()
+*/
+QVariant QSqlAsyncResult::lastInsertId() const
+{
+    return d->lastInsertId;
+}
+
+/*!
+    \class QSqlQueryPool
+    \brief The QSqlQueryPool class runs queries in worker threads without
+    blocking the calling thread.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.6
+
+    A QSqlDatabase connection can only be used by the thread that created
+    it, and all its operations block. QSqlQueryPool keeps up to
+    maxThreadCount() worker threads, each with its own connection cloned
+    from the database passed to the constructor with
+    QSqlDatabase::cloneDatabase(). Queries passed to exec() wait in a queue
+    until a worker thread is free.
+
+    exec() returns a QFuture that gets a QSqlAsyncResult when the query has
+    run. Use a QFutureWatcher to be notified:
+
+    \snippet code/src_sql_kernel_qsqlquerypool.cpp 0
+
+    Worker threads are started when queries are waiting and no thread is
+    idle, and open their connection when they run their first query. Each
+    query runs as a single statement on whichever connection is free, so
+    statements that depend on each other, such as the ones of a
+    transaction, must be sent in one query or run on a QSqlDatabase of
+    their own.
+
+    pendingQueryCount(), activeQueryCount(), finishedQueryCount() and
+    averageWaitTime() tell how busy the pool is.
+
+    \sa QSqlAsyncResult, QSqlDatabase::cloneDatabase()
+*/
+
+/*!
+    Constructs a pool running queries on clones of the connection \a db,
+    with the given \a parent. The pool keeps a closed copy of the
+    connection parameters, so later changes to \a db do not affect it.
+*/
+QSqlQueryPool::QSqlQueryPool(const QSqlDatabase &db, QObject *parent)
+    : QObject(*new QSqlQueryPoolPrivate, parent)
+{
+    Q_D(QSqlQueryPool);
+    d->templateName = QLatin1String("qt_sql_querypool_")
+            + QString::number(quintptr(this), 16);
+    QSqlDatabase::cloneDatabase(db, d->templateName);
+}
+
+/*!
+    Destroys the pool. Queries that are still waiting are canceled, and
+    the destructor waits for the running queries to finish.
+*/
+QSqlQueryPool::~QSqlQueryPool()
+{
+    Q_D(QSqlQueryPool);
+    QList<QSqlQueryPoolThread *> allThreads;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->quit = true;
+        while (!d->tasks.isEmpty()) {
+            QSqlQueryPoolTask task = d->tasks.dequeue();
+            task.future.reportCanceled();
+            task.future.reportFinished();
+        }
+        d->taskQueued.wakeAll();
+        allThreads = d->threads + d->exitedThreads;
+    }
+    for (int i = 0; i < allThreads.count(); ++i) {
+        allThreads.at(i)->wait();
+        delete allThreads.at(i);
+    }
+    QSqlDatabase::removeDatabase(d->templateName);
+}
+
+/*!
+    Queues \a query to be executed by a worker thread and returns a future
+    for its result. If \a values is not empty, the query is prepared and
+    the values are bound to its placeholders in order, as with
+    QSqlQuery::addBindValue().
+
+    Canceling the future before a worker thread takes the query keeps it
+    from running.
+*/
+QFuture<QSqlAsyncResult> QSqlQueryPool::exec(const QString &query, const QVariantList &values)
+{
+    Q_D(QSqlQueryPool);
+    QSqlQueryPoolTask task;
+    task.query = query;
+    task.values = values;
+    return d->enqueue(task);
+}
+
+/*!
+    Queues \a query to be executed by a worker thread like exec(), but
+    returns the rows of a SELECT statement in results of up to \a batchSize
+    rows each, as they are read. The first result is reported even if
+    there are no rows.
+
+    The results become available one by one while the query is still
+    running; QFutureWatcher::resultsReadyAt() notifies about them.
+    Canceling the future stops reading rows.
+*/
+QFuture<QSqlAsyncResult> QSqlQueryPool::fetchInBatches(const QString &query, const QVariantList &values,
+                                                       int batchSize)
+{
+    Q_D(QSqlQueryPool);
+    QSqlQueryPoolTask task;
+    task.query = query;
+    task.values = values;
+    task.batchSize = qMax(batchSize, 1);
+    return d->enqueue(task);
+}
+
+/*!
+    \property QSqlQueryPool::maxThreadCount
+    \brief the maximum number of worker threads, and so of connections,
+    of the pool
+
+    The default is QThread::idealThreadCount(). The pool always uses at
+    least one thread. When the maximum is lowered, threads above it exit
+    after their current query.
+*/
+int QSqlQueryPool::maxThreadCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->maxThreadCount;
+}
+
+void QSqlQueryPool::setMaxThreadCount(int maxThreadCount)
+{
+    Q_D(QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    d->maxThreadCount = qMax(maxThreadCount, 1);
+    d->startThreads();
+    d->taskQueued.wakeAll();
+}
+
+/*!
+    Returns the number of worker threads that are running.
+*/
+int QSqlQueryPool::threadCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->threads.count();
+}
+
+/*!
+    Returns the number of queries waiting for a worker thread.
+*/
+int QSqlQueryPool::pendingQueryCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->tasks.count();
+}
+
+/*!
+    Returns the largest number of queries that have been waiting for a
+    worker thread at the same time.
+*/
+int QSqlQueryPool::peakPendingQueryCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->peakPendingQueryCount;
+}
+
+/*!
+    Returns the number of queries being executed.
+*/
+int QSqlQueryPool::activeQueryCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->activeQueryCount;
+}
+
+/*!
+    Returns the number of queries the pool has executed.
+*/
+qint64 QSqlQueryPool::finishedQueryCount() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    return d->finishedQueryCount;
+}
+
+/*!
+    Returns how long queries have waited for a worker thread on average,
+    in milliseconds.
+*/
+qint64 QSqlQueryPool::averageWaitTime() const
+{
+    Q_D(const QSqlQueryPool);
+    QMutexLocker locker(&d->mutex);
+    const qint64 started = d->finishedQueryCount + d->activeQueryCount;
+    return started ? d->totalWaitTime / started : 0;
+}
+
+/*!
+    Waits up to \a msecs milliseconds for all queued queries to finish.
+    Returns \c true if they did; otherwise returns \c false. If \a msecs is
+    -1 (the default), the timeout is ignored.
+*/
+bool QSqlQueryPool::waitForDone(int msecs)
+{
+    Q_D(QSqlQueryPool);
+    QElapsedTimer timer;
+    timer.start();
+    QMutexLocker locker(&d->mutex);
+    while (!d->tasks.isEmpty() || d->activeQueryCount > 0) {
+        if (msecs < 0) {
+            d->allDone.wait(&d->mutex);
+        } else {
+            const qint64 remaining = msecs - timer.elapsed();
+            if (remaining <= 0 || !d->allDone.wait(&d->mutex, remaining))
+                return d->tasks.isEmpty() && d->activeQueryCount == 0;
+        }
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_QFUTURE
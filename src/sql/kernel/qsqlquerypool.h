@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLQUERYPOOL_H
+#define QSQLQUERYPOOL_H
+
+#include <QtCore/qfuture.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qvariant.h>
+#include <QtSql/qsql.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef QT_NO_QFUTURE
+
+class QSqlColumnBatch;
+class QSqlDatabase;
+class QSqlError;
+class QSqlRecord;
+class QSqlAsyncResultPrivate;
+class QSqlQueryPoolPrivate;
+
+class Q_SQL_EXPORT QSqlAsyncResult
+{
+public:
+    QSqlAsyncResult();
+    QSqlAsyncResult(const QSqlAsyncResult &other);
+    QSqlAsyncResult &operator=(const QSqlAsyncResult &other);
+    ~QSqlAsyncResult();
+
+    bool isActive() const;
+    bool isSelect() const;
+    QString lastQuery() const;
+    QSqlError lastError() const;
+
+    QSqlRecord record() const;
+    QSqlColumnBatch rows() const;
+    int numRowsAffected() const;
+    QVariant lastInsertId() const;
+
+private:
+    friend class QSqlQueryPoolThread;
+    QSharedDataPointer<QSqlAsyncResultPrivate> d;
+};
+
+class Q_SQL_EXPORT QSqlQueryPool : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QSqlQueryPool)
+    Q_PROPERTY(int maxThreadCount READ maxThreadCount WRITE setMaxThreadCount)
+
+public:
+    explicit QSqlQueryPool(const QSqlDatabase &db, QObject *parent = Q_NULLPTR);
+    ~QSqlQueryPool();
+
+    QFuture<QSqlAsyncResult> exec(const QString &query, const QVariantList &values = QVariantList());
+    QFuture<QSqlAsyncResult> fetchInBatches(const QString &query, const QVariantList &values,
+                                            int batchSize);
+
+    int maxThreadCount() const;
+    void setMaxThreadCount(int maxThreadCount);
+    int threadCount() const;
+
+    int pendingQueryCount() const;
+    int peakPendingQueryCount() const;
+    int activeQueryCount() const;
+    qint64 finishedQueryCount() const;
+    qint64 averageWaitTime() const;
+
+    bool waitForDone(int msecs = -1);
+
+private:
+    Q_DISABLE_COPY(QSqlQueryPool)
+};
+
+#endif // QT_NO_QFUTURE
+
+QT_END_NAMESPACE
+
+#endif // QSQLQUERYPOOL_H
@@ -32,6 +32,7 @@
 ****************************************************************************/
 
 #include "qsqlresult.h"
+#include "qsqlcolumnbatch.h"
 
 #include "qvariant.h"
 #include "qhash.h"
@@ -207,6 +208,9 @@ QString QSqlResultPrivate::namedToPositionalBinding(const QString &query)
 /*!
     \enum QSqlResult::VirtualHookOperation
     \internal
+
+    \value FetchColumnBatch Fill a QSqlColumnBatch for QSqlQuery::fetchBatch();
+           the data is a QSqlColumnBatchFetch.
 */
 
 /*!
@@ -911,8 +915,12 @@ QVariant QSqlResult::lastInsertId() const
 
 /*! \internal
 */
-void QSqlResult::virtual_hook(int, void *)
+void QSqlResult::virtual_hook(int id, void *data)
 {
+    if (id == FetchColumnBatch) {
+        QSqlColumnBatchFetch *fetch = static_cast<QSqlColumnBatchFetch *>(data);
+        fetch->rows = fetchBatchRowByRow(fetch->batch, fetch->maximumRows);
+    }
 }
 
 /*! \internal
@@ -989,6 +997,40 @@ bool QSqlResult::nextResult()
     return false;
 }
 
+/*! \internal
+    \since 5.6
+
+    Reads up to \a maximumRows rows after the current row into \a batch,
+    after resetting \a batch to the columns of record(), and returns the
+    number of rows read. The rows are read one by one with fetchNext(),
+    data() and isNull(). If fewer than \a maximumRows rows are read, the
+    result is positioned after the last row; otherwise it is positioned
+    on the last row read.
+
+    This is what the FetchColumnBatch operation of virtual_hook() does
+    unless a driver fills the batch straight from the database's buffers.
+
+    \sa QSqlQuery::fetchBatch()
+*/
+int QSqlResult::fetchBatchRowByRow(QSqlColumnBatch *batch, int maximumRows)
+{
+    batch->reset(record());
+    const int columns = batch->columnCount();
+
+    int rows = 0;
+    while (rows < maximumRows) {
+        const bool fetched = (at() == QSql::BeforeFirstRow) ? fetchFirst() : fetchNext();
+        if (!fetched) {
+            setAt(QSql::AfterLastRow);
+            break;
+        }
+        for (int i = 0; i < columns; ++i)
+            batch->appendValue(i, isNull(i) ? QVariant() : data(i));
+        ++rows;
+    }
+    return rows;
+}
+
 /*!
     Returns the low-level database handle for this result set
     wrapped in a QVariant or an invalid QVariant if there is no handle.
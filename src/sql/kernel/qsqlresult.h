@@ -45,6 +45,7 @@ class QString;
 class QSqlRecord;
 template <typename T> class QVector;
 class QVariant;
+class QSqlColumnBatch;
 class QSqlDriver;
 class QSqlError;
 class QSqlResultPrivate;
@@ -116,7 +117,7 @@ protected:
     virtual QSqlRecord record() const;
     virtual QVariant lastInsertId() const;
 
-    enum VirtualHookOperation { };
+    enum VirtualHookOperation { FetchColumnBatch = 1 };
     virtual void virtual_hook(int id, void *data);
     virtual bool execBatch(bool arrayBind = false);
     virtual void detachFromResultSet();
@@ -124,6 +125,7 @@ protected:
     QSql::NumericalPrecisionPolicy numericalPrecisionPolicy() const;
     virtual bool nextResult();
     void resetBindCount(); // HACK
+    int fetchBatchRowByRow(QSqlColumnBatch *batch, int maximumRows);
 
     QSqlResultPrivate *d_ptr;
 
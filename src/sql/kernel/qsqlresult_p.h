@@ -60,6 +60,15 @@ struct QHolder {
     int holderPos;
 };
 
+// the data of the QSqlResult::FetchColumnBatch virtual_hook() operation;
+// rows stays -1 if no result handled it
+struct QSqlColumnBatchFetch
+{
+    QSqlColumnBatch *batch;
+    int maximumRows;
+    int rows;
+};
+
 class Q_SQL_EXPORT QSqlResultPrivate
 {
 
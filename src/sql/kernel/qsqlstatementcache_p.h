@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSQLSTATEMENTCACHE_P_H
+#define QSQLSTATEMENTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QtSQL module and its drivers.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qcache.h"
+#include "QtCore/qstring.h"
+
+QT_BEGIN_NAMESPACE
+
+// The driver independent part of a statement cache, which QSqlDriver
+// uses to configure it and to report its statistics.
+class QSqlAbstractStatementCache
+{
+public:
+    QSqlAbstractStatementCache() : hits(0), misses(0) {}
+    virtual ~QSqlAbstractStatementCache() {}
+
+    virtual int maximumSize() const = 0;
+    virtual void setMaximumSize(int size) = 0;
+    virtual void clear() = 0;
+
+    qint64 hits;
+    qint64 misses;
+};
+
+// Keeps up to maximumSize() prepared statements of a connection, keyed by
+// their SQL, and drops the least recently used ones when it is full.
+// Statement is a driver class that owns the driver's statement handle and
+// frees it in its destructor. A statement is not in the cache while a
+// result uses it: results take() it when preparing a query and release()
+// it again when they are done with it.
+template <typename Statement>
+class QSqlStatementCache : public QSqlAbstractStatementCache
+{
+public:
+    QSqlStatementCache() { cache.setMaxCost(0); }
+
+    int maximumSize() const Q_DECL_OVERRIDE { return cache.maxCost(); }
+    void setMaximumSize(int size) Q_DECL_OVERRIDE { cache.setMaxCost(qMax(0, size)); }
+    void clear() Q_DECL_OVERRIDE { cache.clear(); }
+
+    // Returns the statement prepared for query, which the caller then
+    // owns, or 0 if there is none.
+    Statement *take(const QString &query)
+    {
+        if (cache.maxCost() == 0)
+            return 0;
+        Statement *statement = cache.take(query);
+        if (statement)
+            ++hits;
+        else
+            ++misses;
+        return statement;
+    }
+
+    // Keeps statement, which has been reset by the caller, for the next
+    // take() of query. Deletes it if caching is off or the cache has a
+    // statement for query already.
+    void release(const QString &query, Statement *statement)
+    {
+        if (cache.maxCost() == 0 || cache.contains(query)) {
+            delete statement;
+            return;
+        }
+        cache.insert(query, statement);
+    }
+
+private:
+    QCache<QString, Statement> cache;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLSTATEMENTCACHE_P_H
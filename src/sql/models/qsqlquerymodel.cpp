@@ -38,9 +38,12 @@
 #include <qsqldriver.h>
 #include <qsqlfield.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 #define QSQL_PREFETCH 255
+#define QSQL_BACKGROUND_BATCH 1024
 
 void QSqlQueryModelPrivate::prefetch(int limit)
 {
@@ -81,6 +84,113 @@ QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
 
+#ifndef QT_NO_QFUTURE
+void QSqlQueryModelPrivate::cancelBackgroundFetch()
+{
+    if (batchWatcher) {
+        batchWatcher->cancel();
+        batchWatcher->setFuture(QFuture<QSqlAsyncResult>());
+    }
+    if (rowCountWatcher) {
+        rowCountWatcher->cancel();
+        rowCountWatcher->setFuture(QFuture<QSqlAsyncResult>());
+    }
+    batches.clear();
+    batchStarts.clear();
+    fetchedRows = 0;
+    background = false;
+}
+
+// Inserts or removes rows at the end so that there are count rows
+void QSqlQueryModelPrivate::setBackgroundRowCount(int count)
+{
+    Q_Q(QSqlQueryModel);
+    const int lastRow = count - 1;
+    if (lastRow > bottom.row()) {
+        q->beginInsertRows(QModelIndex(), bottom.row() + 1, lastRow);
+        bottom = q->createIndex(lastRow, rec.count() - 1);
+        q->endInsertRows();
+    } else if (lastRow < bottom.row()) {
+        q->beginRemoveRows(QModelIndex(), count, bottom.row());
+        bottom = q->createIndex(lastRow, rec.count() - 1);
+        q->endRemoveRows();
+    }
+}
+
+QVariant QSqlQueryModelPrivate::backgroundValue(int row, int column) const
+{
+    if (row < 0 || row >= fetchedRows)
+        return QVariant(); // not read yet
+    const int batch = int(std::upper_bound(batchStarts.constBegin(), batchStarts.constEnd(), row)
+                          - batchStarts.constBegin()) - 1;
+    const QSqlColumnBatch &rows = batches.at(batch);
+    if (column < 0 || column >= rows.columnCount())
+        return QVariant();
+    return rows.value(row - batchStarts.at(batch), column);
+}
+
+void QSqlQueryModelPrivate::_q_batchesReady(int begin, int end)
+{
+    Q_Q(QSqlQueryModel);
+    const int firstNewRow = fetchedRows;
+    for (int i = begin; i < end; ++i) {
+        const QSqlAsyncResult result = batchWatcher->resultAt(i);
+        if (result.lastError().isValid())
+            error = result.lastError();
+
+        // the first result tells the columns
+        if (rec.isEmpty() && !result.record().isEmpty()) {
+            const QSqlRecord newRec = result.record();
+            q->beginInsertColumns(QModelIndex(), 0, newRec.count() - 1);
+            rec = newRec;
+            initColOffsets(rec.count());
+            bottom = q->createIndex(bottom.row(), rec.count() - 1);
+            q->endInsertColumns();
+        }
+
+        const QSqlColumnBatch rows = result.rows();
+        if (rows.rowCount() == 0)
+            continue;
+        batchStarts.append(fetchedRows);
+        batches.append(rows);
+        fetchedRows += rows.rowCount();
+    }
+    if (fetchedRows == firstNewRow)
+        return;
+
+    // rows that were inserted for the exact row count only get their data now
+    if (firstNewRow <= bottom.row()) {
+        emit q->dataChanged(q->createIndex(firstNewRow, 0),
+                            q->createIndex(qMin(fetchedRows - 1, bottom.row()), rec.count() - 1));
+    }
+    if (fetchedRows - 1 > bottom.row())
+        setBackgroundRowCount(fetchedRows);
+}
+
+void QSqlQueryModelPrivate::_q_batchesFinished()
+{
+    // the exact row count may be out of date if rows were deleted meanwhile
+    if (!batchWatcher->isCanceled())
+        setBackgroundRowCount(fetchedRows);
+}
+
+void QSqlQueryModelPrivate::_q_rowCountReady()
+{
+    const QFuture<QSqlAsyncResult> future = rowCountWatcher->future();
+    if (future.isCanceled() || future.resultCount() == 0)
+        return;
+
+    const QSqlAsyncResult result = future.result();
+    if (!result.isActive() || result.rows().rowCount() != 1) {
+        error = result.lastError();
+        return;
+    }
+    // once all rows are read, their number is exact already
+    if (!batchWatcher->isFinished())
+        setBackgroundRowCount(qMax(result.rows().value(0, 0).toInt(), fetchedRows));
+}
+#endif // QT_NO_QFUTURE
+
 void QSqlQueryModelPrivate::initColOffsets(int size)
 {
     colOffsets.resize(size);
@@ -138,6 +248,11 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
     a query, the model will fetch rows incrementally.
     See fetchMore() for more information.
 
+    To keep large result sets from blocking the thread of the model,
+    setQuery() can also run the query on a QSqlQueryPool. The rows are then
+    read in a worker thread and added to the model in batches as they
+    arrive.
+
     \sa QSqlTableModel, QSqlRelationalTableModel, QSqlQuery,
         {Model/View Programming}, {Query Model Example}
 */
@@ -164,6 +279,10 @@ QSqlQueryModel::QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent)
 */
 QSqlQueryModel::~QSqlQueryModel()
 {
+#ifndef QT_NO_QFUTURE
+    Q_D(QSqlQueryModel);
+    d->cancelBackgroundFetch();
+#endif
 }
 
 /*!
@@ -345,6 +464,10 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+#ifndef QT_NO_QFUTURE
+    if (d->background)
+        return d->backgroundValue(dItem.row(), dItem.column());
+#endif
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -404,6 +527,9 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
 {
     Q_D(QSqlQueryModel);
     beginResetModel();
+#ifndef QT_NO_QFUTURE
+    d->cancelBackgroundFetch();
+#endif
 
     QSqlRecord newRec = query.record();
     bool columnsChanged = (newRec != d->rec);
@@ -465,12 +591,90 @@ void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
     setQuery(QSqlQuery(query, db));
 }
 
+#ifndef QT_NO_QFUTURE
+/*!
+    \enum QSqlQueryModel::RowCountMode
+    \since 5.6
+
+    This enum describes how a model that reads its rows in the background
+    knows how many rows there are.
+
+    \value IncrementalRowCount rowCount() grows as the rows arrive.
+    \value ExactRowCount The number of rows is counted with a second query,
+           and rowCount() returns it as soon as it is known. The rows that
+           have not arrived yet return invalid values until they do, and
+           dataChanged() is emitted for them.
+*/
+
+/*!
+    \overload
+    \since 5.6
+
+    Resets the model and runs \a query on a worker connection of \a pool
+    instead of the model's thread. The rows are read in batches, each of
+    which emits rowsInserted() once. The columns are inserted when the
+    first batch arrives. \a mode tells whether the model learns the
+    number of rows from a \c{SELECT COUNT(*)} query first.
+
+    The rows are cached in typed column buffers, see QSqlColumnBatch. Date
+    and time values are returned as strings. query() returns an empty
+    query, since the query runs on a connection of the pool.
+
+    \sa QSqlQueryPool::fetchInBatches()
+*/
+void QSqlQueryModel::setQuery(const QString &query, QSqlQueryPool *pool, RowCountMode mode)
+{
+    typedef QSqlQueryModelSql Sql;
+    Q_D(QSqlQueryModel);
+    beginResetModel();
+
+    d->cancelBackgroundFetch();
+    d->error = QSqlError();
+    d->query.clear();
+    d->rec.clear();
+    d->colOffsets.clear();
+    d->bottom = QModelIndex();
+    d->atEnd = true;
+
+    if (!pool) {
+        d->error = QSqlError(QLatin1String("No query pool to run the query"),
+                             QString(), QSqlError::ConnectionError);
+        endResetModel();
+        return;
+    }
+
+    d->background = true;
+    if (!d->batchWatcher) {
+        d->batchWatcher = new QFutureWatcher<QSqlAsyncResult>(this);
+        connect(d->batchWatcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(_q_batchesReady(int,int)));
+        connect(d->batchWatcher, SIGNAL(finished()), this, SLOT(_q_batchesFinished()));
+    }
+    d->batchWatcher->setFuture(pool->fetchInBatches(query, QVariantList(), QSQL_BACKGROUND_BATCH));
+
+    if (mode == ExactRowCount) {
+        if (!d->rowCountWatcher) {
+            d->rowCountWatcher = new QFutureWatcher<QSqlAsyncResult>(this);
+            connect(d->rowCountWatcher, SIGNAL(finished()), this, SLOT(_q_rowCountReady()));
+        }
+        const QString countQuery = Sql::select(Sql::concat(QLatin1String("COUNT(*)"),
+                                   Sql::from(Sql::concat(Sql::paren(query), QLatin1String("qt_row_count")))));
+        d->rowCountWatcher->setFuture(pool->exec(countQuery));
+    }
+
+    endResetModel();
+    queryChange();
+}
+#endif // QT_NO_QFUTURE
+
 /*!
     Clears the model and releases any acquired resource.
 */
 void QSqlQueryModel::clear()
 {
     Q_D(QSqlQueryModel);
+#ifndef QT_NO_QFUTURE
+    d->cancelBackgroundFetch();
+#endif
     d->error = QSqlError();
     d->atEnd = true;
     d->query.clear();
@@ -670,3 +874,5 @@ QModelIndex QSqlQueryModel::indexInQuery(const QModelIndex &item) const
 }
 
 QT_END_NAMESPACE
+
+#include "moc_qsqlquerymodel.cpp"
@@ -44,6 +44,7 @@ class QSqlQueryModelPrivate;
 class QSqlError;
 class QSqlRecord;
 class QSqlQuery;
+class QSqlQueryPool;
 
 class Q_SQL_EXPORT QSqlQueryModel: public QAbstractTableModel
 {
@@ -51,6 +52,11 @@ class Q_SQL_EXPORT QSqlQueryModel: public QAbstractTableModel
     Q_DECLARE_PRIVATE(QSqlQueryModel)
 
 public:
+    enum RowCountMode {
+        IncrementalRowCount,
+        ExactRowCount
+    };
+
     explicit QSqlQueryModel(QObject *parent = 0);
     virtual ~QSqlQueryModel();
 
@@ -70,6 +76,9 @@ public:
 
     void setQuery(const QSqlQuery &query);
     void setQuery(const QString &query, const QSqlDatabase &db = QSqlDatabase());
+#ifndef QT_NO_QFUTURE
+    void setQuery(const QString &query, QSqlQueryPool *pool, RowCountMode mode = IncrementalRowCount);
+#endif
     QSqlQuery query() const;
 
     virtual void clear();
@@ -99,6 +108,13 @@ protected:
     virtual QModelIndex indexInQuery(const QModelIndex &item) const;
     void setLastError(const QSqlError &error);
     QSqlQueryModel(QSqlQueryModelPrivate &dd, QObject *parent = 0);
+
+private:
+#ifndef QT_NO_QFUTURE
+    Q_PRIVATE_SLOT(d_func(), void _q_batchesReady(int, int))
+    Q_PRIVATE_SLOT(d_func(), void _q_batchesFinished())
+    Q_PRIVATE_SLOT(d_func(), void _q_rowCountReady())
+#endif
 };
 
 QT_END_NAMESPACE
@@ -49,9 +49,12 @@
 #include "QtSql/qsqlerror.h"
 #include "QtSql/qsqlquery.h"
 #include "QtSql/qsqlrecord.h"
+#include "QtCore/qfuturewatcher.h"
 #include "QtCore/qhash.h"
 #include "QtCore/qvarlengtharray.h"
 #include "QtCore/qvector.h"
+#include "QtSql/qsqlcolumnbatch.h"
+#include "QtSql/qsqlquerypool.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -59,21 +62,43 @@ class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate() : atEnd(false), background(false), nestedResetLevel(0)
+#ifndef QT_NO_QFUTURE
+        , batchWatcher(0), rowCountWatcher(0), fetchedRows(0)
+#endif
+    {}
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
+#ifndef QT_NO_QFUTURE
+    void cancelBackgroundFetch();
+    void setBackgroundRowCount(int count);
+    QVariant backgroundValue(int row, int column) const;
+    void _q_batchesReady(int begin, int end);
+    void _q_batchesFinished();
+    void _q_rowCountReady();
+#endif
+
     mutable QSqlQuery query;
     mutable QSqlError error;
     QModelIndex bottom;
     QSqlRecord rec;
     uint atEnd : 1;
+    uint background : 1; // rows come from a QSqlQueryPool instead of query
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
+
+#ifndef QT_NO_QFUTURE
+    QFutureWatcher<QSqlAsyncResult> *batchWatcher;
+    QFutureWatcher<QSqlAsyncResult> *rowCountWatcher;
+    QVector<QSqlColumnBatch> batches;
+    QVector<int> batchStarts; // the row each batch starts at
+    int fetchedRows;
+#endif
 };
 
 // helpers for building SQL expressions
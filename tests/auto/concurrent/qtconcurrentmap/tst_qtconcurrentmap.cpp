@@ -61,6 +61,8 @@ private slots:
     void stlContainers();
     void qFutureAssignmentLeak();
     void stressTest();
+    void nestedInWorkerThreads();
+    void clearDuringBlockingMap();
     void persistentResultTest();
 public slots:
     void throttling();
@@ -2382,6 +2384,72 @@ void tst_QtConcurrentMap::stressTest()
     }
 }
 
+void incrementAll(QList<int> &list)
+{
+    QtConcurrent::blockingMap(list, increment);
+}
+
+void tst_QtConcurrentMap::nestedInWorkerThreads()
+{
+    // the inner maps start from worker threads of a saturated pool, which
+    // then run most of their iterations themselves
+    const int listCount = 4 * QThreadPool::globalInstance()->maxThreadCount();
+    const int listSize = 1000;
+    QList<QList<int> > lists;
+    for (int i = 0; i < listCount; ++i) {
+        QList<int> list;
+        for (int j = 0; j < listSize; ++j)
+            list.append(j);
+        lists.append(list);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        QtConcurrent::blockingMap(lists, incrementAll);
+        for (int j = 0; j < listCount; ++j) {
+            for (int k = 0; k < listSize; ++k)
+                QCOMPARE(lists.at(j).at(k), k + i + 1);
+        }
+    }
+}
+
+class ClearingThread : public QThread
+{
+public:
+    QAtomicInt stop;
+    void run()
+    {
+        while (!stop.load())
+            QThreadPool::globalInstance()->clear();
+    }
+};
+
+void tst_QtConcurrentMap::clearDuringBlockingMap()
+{
+    // clearing the pool must not drop the copies of the inner thread
+    // engines that their blockingMap() waits for
+    const int listCount = 4 * QThreadPool::globalInstance()->maxThreadCount();
+    const int listSize = 1000;
+    QList<QList<int> > lists;
+    for (int i = 0; i < listCount; ++i) {
+        QList<int> list;
+        for (int j = 0; j < listSize; ++j)
+            list.append(j);
+        lists.append(list);
+    }
+
+    ClearingThread clearingThread;
+    clearingThread.start();
+    for (int i = 0; i < 10; ++i)
+        QtConcurrent::blockingMap(lists, incrementAll);
+    clearingThread.stop.store(1);
+    clearingThread.wait();
+
+    for (int j = 0; j < listCount; ++j) {
+        for (int k = 0; k < listSize; ++k)
+            QCOMPARE(lists.at(j).at(k), k + 10);
+    }
+}
+
 struct LockedCounter
 {
     LockedCounter(QMutex *mutex, QAtomicInt *ai)
@@ -59,6 +59,9 @@ private slots:
 
     void peekBug();
     void readAllKeepPosition();
+    void readChunks();
+    void readChunks_QTcpSocket();
+    void readChunks_QSslSocketUnencrypted();
 };
 
 void tst_QIODevice::initTestCase()
@@ -628,5 +631,110 @@ void tst_QIODevice::readAllKeepPosition()
     QCOMPARE(resultArray, buffer.buffer());
 }
 
+void tst_QIODevice::readChunks()
+{
+    QFile f(QFINDTESTDATA("tst_qiodevice.cpp"));
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QByteArray contents = f.readAll();
+    QVERIFY(f.seek(0));
+
+    // fill the buffer, then read across its end
+    QCOMPARE(f.read(10), contents.left(10));
+    QByteArrayList chunks = f.readChunks(20000);
+    QByteArray data = chunks.join();
+    QCOMPARE(data.size(), qMin(20000, contents.size() - 10));
+    QCOMPARE(data, contents.mid(10, data.size()));
+    QCOMPARE(f.pos(), qint64(10 + data.size()));
+
+    chunks = f.readChunks();
+    QCOMPARE(chunks.join(), contents.mid(10 + data.size()));
+    QVERIFY(f.atEnd());
+    QVERIFY(f.readChunks().isEmpty());
+
+    QVERIFY(f.seek(5));
+    QCOMPARE(f.readChunks(0), QByteArrayList());
+    QCOMPARE(f.readChunks(5).join(), contents.mid(5, 5));
+
+    QBuffer buffer;
+    buffer.setData(contents);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::readChunks (QBuffer): Called with maxSize < 0");
+    QCOMPARE(buffer.readChunks(-1), QByteArrayList());
+    QCOMPARE(buffer.readChunks().join(), contents);
+}
+
+void tst_QIODevice::readChunks_QTcpSocket()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket client;
+    client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(client.waitForConnected(5000));
+
+    QByteArray expected;
+    for (int i = 0; i < 64; ++i)
+        expected += QByteArray(1024, char('a' + i % 26));
+    peer->write(expected);
+    QVERIFY(peer->waitForBytesWritten(5000));
+
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        if (!client.bytesAvailable())
+            QVERIFY(client.waitForReadyRead(5000));
+        const QByteArrayList chunks = client.readChunks(10000);
+        qint64 size = 0;
+        foreach (const QByteArray &chunk, chunks)
+            size += chunk.size();
+        QVERIFY(size <= 10000);
+        received += chunks.join();
+    }
+    QCOMPARE(received, expected);
+    QCOMPARE(client.bytesAvailable(), qint64(0));
+    delete peer;
+}
+
+void tst_QIODevice::readChunks_QSslSocketUnencrypted()
+{
+#ifdef QT_NO_SSL
+    QSKIP("This test requires SSL support");
+#else
+    // in UnencryptedMode, QSslSocket leaves the data in its plain socket
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QSslSocket client;
+    client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(client.waitForConnected(5000));
+    QCOMPARE(client.mode(), QSslSocket::UnencryptedMode);
+
+    QByteArray expected;
+    for (int i = 0; i < 64; ++i)
+        expected += QByteArray(1024, char('a' + i % 26));
+    peer->write(expected);
+    QVERIFY(peer->waitForBytesWritten(5000));
+
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        if (!client.bytesAvailable())
+            QVERIFY(client.waitForReadyRead(5000));
+        const QByteArray data = client.readChunks(10000).join();
+        QVERIFY(!data.isEmpty());
+        QVERIFY(data.size() <= 10000);
+        received += data;
+    }
+    QCOMPARE(received, expected);
+
+    peer->write("tail");
+    QVERIFY(peer->waitForBytesWritten(5000));
+    QVERIFY(client.waitForReadyRead(5000));
+    QCOMPARE(client.readChunks().join(), QByteArray("tail"));
+    QCOMPARE(client.bytesAvailable(), qint64(0));
+    delete peer;
+#endif
+}
+
 QTEST_MAIN(tst_QIODevice)
 #include "tst_qiodevice.moc"
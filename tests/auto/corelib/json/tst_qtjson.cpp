@@ -37,6 +37,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstreamreader.h"
 #include <limits>
 
 #define INVALID_UNICODE "\xCE\xBA\xE1"
@@ -103,6 +104,9 @@ private Q_SLOTS:
     void fromBinary();
     void toAndFromBinary_data();
     void toAndFromBinary();
+    void fromMappedFile();
+    void fromMappedFileInvalid();
+    void fromRawDataNotModified();
     void parseNumbers();
     void parseStrings();
     void parseDuplicateKeys();
@@ -139,6 +143,7 @@ private Q_SLOTS:
     void nesting();
 
     void longStrings();
+    void stringsAcrossBlockBoundaries();
 
     void arrayInitializerList();
     void objectInitializerList();
@@ -147,6 +152,13 @@ private Q_SLOTS:
     void garbageAtEnd();
 
     void removeNonLatinKey();
+
+    void streamReader();
+    void streamReaderIncremental_data();
+    void streamReaderIncremental();
+    void streamReaderReadValue();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
 private:
     QString testDataDir;
 };
@@ -1773,6 +1785,93 @@ void tst_QtJson::toAndFromBinary()
     QVERIFY(doc == outdoc);
 }
 
+void tst_QtJson::fromMappedFile()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+    const QByteArray binary = doc.toBinaryData();
+
+    QTemporaryFile tmp;
+    QVERIFY(tmp.open());
+    QCOMPARE(tmp.write(binary), qint64(binary.size()));
+    tmp.close();
+
+    QJsonDocument mapped = QJsonDocument::fromMappedFile(tmp.fileName());
+    QVERIFY(!mapped.isNull());
+    QVERIFY(mapped == doc);
+    QCOMPARE(QJsonDocument::fromMappedFile(tmp.fileName(), QJsonDocument::BypassValidation), doc);
+
+    // the data is referenced, not copied
+    int size;
+    const char *raw = mapped.rawData(&size);
+    QCOMPARE(size, binary.size());
+    QVERIFY(raw != binary.constData());
+    QVERIFY(memcmp(raw, binary.constData(), size) == 0);
+
+    // values outlive the document they were taken from
+    QJsonArray array = mapped.array();
+    mapped = QJsonDocument();
+    QCOMPARE(array, doc.array());
+
+    // the mapping is read-only, modifications must go to a copy
+    QVERIFY(!array.isEmpty());
+    array.removeFirst();
+    array.append(QLatin1String("appended"));
+    QJsonArray expected = doc.array();
+    expected.removeFirst();
+    expected.append(QLatin1String("appended"));
+    QCOMPARE(array, expected);
+
+    QVERIFY(tmp.open());
+    QCOMPARE(tmp.readAll(), binary);
+}
+
+void tst_QtJson::fromMappedFileInvalid()
+{
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/does-not-exist.bjson").isNull());
+    // text JSON is not the binary format
+    QVERIFY(QJsonDocument::fromMappedFile(testDataDir + "/test.json").isNull());
+
+    QJsonObject object;
+    object.insert(QStringLiteral("key"), QStringLiteral("value"));
+    QByteArray binary = QJsonDocument(object).toBinaryData();
+
+    // truncated
+    QTemporaryFile tmp;
+    QVERIFY(tmp.open());
+    tmp.write(binary.constData(), binary.size() - 4);
+    tmp.close();
+    QVERIFY(QJsonDocument::fromMappedFile(tmp.fileName()).isNull());
+
+    // trailing data after the document is ignored
+    QVERIFY(tmp.open());
+    tmp.resize(0);
+    tmp.write(binary + QByteArray(16, 'x'));
+    tmp.close();
+    QJsonDocument doc = QJsonDocument::fromMappedFile(tmp.fileName());
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc.object(), object);
+}
+
+void tst_QtJson::fromRawDataNotModified()
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("a"), 1);
+    object.insert(QStringLiteral("b"), 2);
+    const QByteArray binary = QJsonDocument(object).toBinaryData();
+    QByteArray buffer = binary;
+    buffer.detach();
+
+    QJsonObject raw = QJsonDocument::fromRawData(buffer.constData(), buffer.size()).object();
+    raw.remove(QStringLiteral("a"));
+    raw[QStringLiteral("b")] = 3;
+    QCOMPARE(raw.value(QStringLiteral("b")).toInt(), 3);
+    QVERIFY(!raw.contains(QStringLiteral("a")));
+    QCOMPARE(buffer, binary);
+}
+
 void tst_QtJson::parseNumbers()
 {
     {
@@ -2626,6 +2725,34 @@ void tst_QtJson::longStrings()
     }
 }
 
+void tst_QtJson::stringsAcrossBlockBoundaries()
+{
+    // the parser scans strings and whitespace in blocks of 16 and 32 bytes,
+    // check that whatever ends a block of plain ASCII is found at any offset
+    const QString specials[] = {
+        QStringLiteral("\""),
+        QStringLiteral("\\"),
+        QString(QChar(0xe9)),
+        QString(QChar(0x0402))
+    };
+    for (int length = 0; length < 80; ++length) {
+        for (uint j = 0; j < sizeof(specials) / sizeof(specials[0]); ++j) {
+            for (int i = 0; i <= length; ++i) {
+                QString string(length, QLatin1Char('a'));
+                string.insert(i, specials[j]);
+                QJsonArray array;
+                array.append(string);
+                const QByteArray json = QByteArray(length, ' ') + QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+                QJsonParseError error;
+                const QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+                QCOMPARE(error.error, QJsonParseError::NoError);
+                QCOMPARE(doc.array().first().toString(), string);
+            }
+        }
+    }
+}
+
 void tst_QtJson::testJsonValueRefDefault()
 {
     QJsonObject empty;
@@ -2797,5 +2924,206 @@ void tst_QtJson::removeNonLatinKey()
     QVERIFY(restoredObject.contains(nonLatinKeyName));
 }
 
+void tst_QtJson::streamReader()
+{
+    QJsonStreamReader reader(QByteArray("{ \"a\": [1, -2.5e3, true, false, null, \"x\\u00e9\\n\"],"
+                                        " \"\xc3\xa9t\xc3\xa9\": {}, \"b\": [] }"));
+
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QString("a"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.value(), QJsonValue(1));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.text(), QString("-2.5e3"));
+    QCOMPARE(reader.value(), QJsonValue(-2500));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.value(), QJsonValue(true));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.value(), QJsonValue(false));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Null));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), QString::fromUtf8("x\xc3\xa9\n"));
+    QCOMPARE(reader.value(), QJsonValue(QString::fromUtf8("x\xc3\xa9\n")));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), QString::fromUtf8("\xc3\xa9t\xc3\xa9"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.value(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+}
+
+namespace {
+// feeds the reader chunkSize bytes at a time, whenever it runs dry
+struct StreamFeeder
+{
+    QJsonStreamReader reader;
+    QByteArray json;
+    int fed;
+    int chunkSize;
+
+    StreamFeeder(const QByteArray &json, int chunkSize) : json(json), fed(0), chunkSize(chunkSize) {}
+
+    QJsonStreamReader::TokenType next()
+    {
+        QJsonStreamReader::TokenType type = reader.readNext();
+        while (type == QJsonStreamReader::Invalid && !reader.hasError() && fed < json.size()) {
+            reader.addData(json.mid(fed, chunkSize));
+            fed += chunkSize;
+            type = reader.readNext();
+        }
+        return type;
+    }
+};
+}
+
+static QJsonValue readStreamValue(StreamFeeder &feeder, QJsonStreamReader::TokenType type)
+{
+    switch (type) {
+    case QJsonStreamReader::StartObject: {
+        QJsonObject object;
+        forever {
+            type = feeder.next();
+            if (type == QJsonStreamReader::EndObject)
+                return object;
+            if (type != QJsonStreamReader::Name)
+                return QJsonValue(QJsonValue::Undefined);
+            const QString name = feeder.reader.text();
+            const QJsonValue value = readStreamValue(feeder, feeder.next());
+            if (value.isUndefined())
+                return value;
+            object.insert(name, value);
+        }
+    }
+    case QJsonStreamReader::StartArray: {
+        QJsonArray array;
+        forever {
+            type = feeder.next();
+            if (type == QJsonStreamReader::EndArray)
+                return array;
+            const QJsonValue value = readStreamValue(feeder, type);
+            if (value.isUndefined())
+                return value;
+            array.append(value);
+        }
+    }
+    default:
+        return feeder.reader.value();
+    }
+}
+
+void tst_QtJson::streamReaderIncremental_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("7") << 7;
+    QTest::newRow("4096") << 4096;
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    QFETCH(int, chunkSize);
+
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+
+    StreamFeeder feeder(json, chunkSize);
+    const QJsonValue value = readStreamValue(feeder, feeder.next());
+    QVERIFY2(!feeder.reader.hasError(), qPrintable(feeder.reader.errorString()));
+    QCOMPARE(value, QJsonValue(QJsonDocument::fromJson(json).array()));
+
+    QCOMPARE(feeder.next(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderReadValue()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray testJson = file.readAll().trimmed();
+
+    // large enough to cross a couple of the reader's buffer refills
+    QByteArray json = "[";
+    for (int i = 0; i < 32; ++i) {
+        if (i)
+            json += ",\n";
+        json += testJson;
+    }
+    json += "]";
+    const QJsonArray expected = QJsonDocument::fromJson(json).array();
+    QCOMPARE(expected.size(), 32);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QJsonArray array;
+    while (reader.readNext() != QJsonStreamReader::EndArray) {
+        QCOMPARE(reader.tokenType(), QJsonStreamReader::StartArray);
+        array.append(reader.readValue());
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    }
+    QCOMPARE(array, expected);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("no-container") << QByteArray("42");
+    QTest::newRow("unterminated-object") << QByteArray("{\n    \n\n");
+    QTest::newRow("missing-name-separator") << QByteArray("{\n    \"key\" 10\n");
+    QTest::newRow("unterminated-array") << QByteArray("[\n   1, true\n\n");
+    QTest::newRow("missing-value-separator") << QByteArray("[\n  1 true\n\n");
+    QTest::newRow("truncated-literal") << QByteArray("[\n    nul");
+    QTest::newRow("illegal-literal") << QByteArray("[\n    falsd]");
+    QTest::newRow("termination-by-number") << QByteArray("[\n    11111");
+    QTest::newRow("illegal-number") << QByteArray("[\n    -1E10000]");
+    QTest::newRow("illegal-escape") << QByteArray("[\n    \"\\u12\"]");
+    QTest::newRow("illegal-utf8") << QByteArray("[\n    \"c" UNICODE_DJE "a" INVALID_UNICODE "bar\"]");
+    QTest::newRow("unterminated-string") << QByteArray("[\n    \"c" UNICODE_DJE "a ]");
+    QTest::newRow("trailing-comma-array") << QByteArray("[1,]");
+    QTest::newRow("trailing-comma-object") << QByteArray("{\"a\": 1,}");
+    QTest::newRow("garbage-at-end") << QByteArray("{},");
+    QTest::newRow("deep-nesting") << QByteArray(1025, '[');
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    QJsonDocument::fromJson(json, &error);
+    QVERIFY(error.error != QJsonParseError::NoError);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error.error);
+    QCOMPARE(reader.errorString(), error.errorString());
+
+    // errors are sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error.error);
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
@@ -472,6 +472,138 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(int producer, int sequence)
+        : QEvent(QEvent::Type(QEvent::User + producer)), sequence(sequence)
+    { }
+    int sequence;
+};
+
+class PostingThread : public QThread
+{
+public:
+    PostingThread(QObject *receiver, int producer, int count)
+        : receiver(receiver), producer(producer), count(count)
+    { }
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < count; ++i)
+            QCoreApplication::postEvent(receiver, new SequenceEvent(producer, i));
+    }
+
+private:
+    QObject *receiver;
+    int producer;
+    int count;
+};
+
+class SequenceRecorder : public QObject
+{
+public:
+    QVector<int> last;
+    int received;
+    bool inOrder;
+
+    SequenceRecorder(int producers)
+        : last(producers, -1), received(0), inOrder(true)
+    { }
+
+    bool event(QEvent *event)
+    {
+        const int producer = event->type() - QEvent::User;
+        if (producer < 0 || producer >= last.size())
+            return QObject::event(event);
+        const int sequence = static_cast<SequenceEvent *>(event)->sequence;
+        if (sequence != last.at(producer) + 1)
+            inOrder = false;
+        last[producer] = sequence;
+        ++received;
+        return true;
+    }
+};
+
+void tst_QCoreApplication::postEventFromOtherThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const int producers = 4;
+    const int count = 10000;
+    SequenceRecorder recorder(producers);
+
+    QList<PostingThread *> threads;
+    for (int i = 0; i < producers; ++i)
+        threads << new PostingThread(&recorder, i, count);
+    for (int i = 0; i < producers; ++i)
+        threads.at(i)->start();
+
+    // deliver while the threads are still posting
+    QElapsedTimer timer;
+    timer.start();
+    while (recorder.received < producers * count && timer.elapsed() < 30000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+
+    for (int i = 0; i < producers; ++i)
+        QVERIFY(threads.at(i)->wait());
+    qDeleteAll(threads);
+
+    QCOMPARE(recorder.received, producers * count);
+    // the events of each producer are delivered in the order they were posted
+    QVERIFY(recorder.inOrder);
+}
+
+void tst_QCoreApplication::postEventPriorityFromOtherThread()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    EventSpy spy;
+    QObject receiver;
+    receiver.installEventFilter(&spy);
+
+    // one event posted from this thread, the others from another thread
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::Type(QEvent::User + 1)));
+
+    class Poster : public QThread
+    {
+    public:
+        QObject *receiver;
+        void run()
+        {
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(QEvent::User + 2)));
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(QEvent::User + 3)), 1);
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(QEvent::User + 4)), -1);
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(QEvent::User + 5)), 1);
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(QEvent::User + 6)));
+        }
+    } poster;
+    poster.receiver = &receiver;
+    poster.start();
+    QVERIFY(poster.wait());
+
+    // a compressible event after them still goes through compression
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::Quit));
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::Quit));
+
+    QList<int> expected;
+    expected << QEvent::User + 3
+             << QEvent::User + 5
+             << QEvent::User + 1
+             << QEvent::User + 2
+             << QEvent::User + 6
+             << QEvent::Quit
+             << QEvent::User + 4;
+
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(spy.recordedEvents, expected);
+}
 #endif // QT_NO_QTHREAD
 
 void tst_QCoreApplication::applicationPid()
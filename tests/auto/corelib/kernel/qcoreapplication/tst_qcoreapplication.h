@@ -48,6 +48,8 @@ private slots:
     void removePostedEvents();
 #ifndef QT_NO_THREAD
     void deliverInDefinedOrder();
+    void postEventFromOtherThreads();
+    void postEventPriorityFromOtherThread();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
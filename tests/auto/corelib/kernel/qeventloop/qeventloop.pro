@@ -8,3 +8,4 @@ win32:!wince*:!winrt:LIBS += -luser32
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
 
 contains(QT_CONFIG, glib): DEFINES += HAVE_GLIB
+linux:!android:contains(QT_CONFIG, eventfd): DEFINES += HAVE_EPOLL
@@ -44,6 +44,9 @@
   #if defined(HAVE_GLIB)
     #include <private/qeventdispatcher_glib_p.h>
   #endif
+  #if defined(HAVE_EPOLL)
+    #include <private/qeventdispatcher_epoll_p.h>
+  #endif
 #endif
 #include <qmutex.h>
 #include <qthread.h>
@@ -535,10 +538,13 @@ void tst_QEventLoop::processEventsExcludeTimers()
     if (!qobject_cast<QEventDispatcherUNIX *>(eventDispatcher)
   #if defined(HAVE_GLIB)
         && !qobject_cast<QEventDispatcherGlib *>(eventDispatcher)
+  #endif
+  #if defined(HAVE_EPOLL)
+        && !qobject_cast<QEventDispatcherEpoll *>(eventDispatcher)
   #endif
         )
 #endif
-        QEXPECT_FAIL("", "X11ExcludeTimers only supported in the UNIX/Glib dispatchers", Continue);
+        QEXPECT_FAIL("", "X11ExcludeTimers only supported in the UNIX/Glib/epoll dispatchers", Continue);
 
     QCOMPARE(timerReceiver.gotTimerEvent, -1);
     timerReceiver.gotTimerEvent = -1;
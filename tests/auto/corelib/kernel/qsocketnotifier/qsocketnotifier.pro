@@ -7,4 +7,6 @@ SOURCES = tst_qsocketnotifier.cpp
 requires(contains(QT_CONFIG,private_tests))
 
 include(../../../network/socket/platformsocketengine/platformsocketengine.pri)
+
+linux:!android:contains(QT_CONFIG, eventfd): DEFINES += HAVE_EPOLL_DISPATCHER
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
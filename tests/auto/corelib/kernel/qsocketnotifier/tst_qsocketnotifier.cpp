@@ -50,6 +50,13 @@
 #include <private/qnet_unix_p.h>
 #include <sys/select.h>
 #endif
+#ifdef HAVE_EPOLL_DISPATCHER
+#include <QtCore/QDir>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+#include <private/qcore_unix_p.h>
+#include <private/qeventdispatcher_epoll_p.h>
+#endif
 #include <limits>
 
 #if defined (Q_CC_MSVC) && defined(max)
@@ -66,6 +73,11 @@ private slots:
 #ifdef Q_OS_UNIX
     void posixSockets();
 #endif
+#ifdef HAVE_EPOLL_DISPATCHER
+    void epollDispatcher();
+    void epollDispatcherUnwatchableFd_data();
+    void epollDispatcherUnwatchableFd();
+#endif
 };
 
 class UnexpectedDisconnectTester : public QObject
@@ -299,5 +311,203 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#ifdef HAVE_EPOLL_DISPATCHER
+class EpollPipeReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EpollPipeReader(int fd)
+        : fd(fd), notifier(0), timerId(0)
+    { }
+
+    int fd;
+    QSocketNotifier *notifier;
+    int timerId;
+
+public slots:
+    void start()
+    {
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), SLOT(readData()));
+        timerId = startTimer(10);
+    }
+
+    void stop()
+    {
+        killTimer(timerId);
+        delete notifier;
+        notifier = 0;
+    }
+
+    void readData()
+    {
+        char c;
+        if (qt_safe_read(fd, &c, 1) == 1)
+            emit dataRead(int(c));
+    }
+
+signals:
+    void dataRead(int c);
+    void timerFired();
+
+protected:
+    void timerEvent(QTimerEvent *)
+    {
+        emit timerFired();
+    }
+};
+
+void tst_QSocketNotifier::epollDispatcher()
+{
+    if (!QEventDispatcherEpoll::isSupported())
+        QSKIP("epoll(7) is not available");
+
+    int fds[2];
+    QCOMPARE(qt_safe_pipe(fds, O_NONBLOCK), 0);
+
+    QThread thread;
+    thread.setEventDispatcher(new QEventDispatcherEpoll);
+
+    EpollPipeReader reader(fds[0]);
+    reader.moveToThread(&thread);
+    QSignalSpy readSpy(&reader, SIGNAL(dataRead(int)));
+    QVERIFY(readSpy.isValid());
+    QSignalSpy timerSpy(&reader, SIGNAL(timerFired()));
+    QVERIFY(timerSpy.isValid());
+    connect(&thread, SIGNAL(started()), &reader, SLOT(start()));
+    thread.start();
+
+    QTRY_VERIFY(timerSpy.count() > 0);
+
+    qt_safe_write(fds[1], "a", 1);
+    QTRY_COMPARE(readSpy.count(), 1);
+    QCOMPARE(readSpy.at(0).at(0).toInt(), int('a'));
+
+    qt_safe_write(fds[1], "bc", 2);
+    QTRY_COMPARE(readSpy.count(), 3);
+    QCOMPARE(readSpy.at(2).at(0).toInt(), int('c'));
+
+    QMetaObject::invokeMethod(&reader, "stop", Qt::BlockingQueuedConnection);
+    qt_safe_write(fds[1], "d", 1);
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+    QCOMPARE(readSpy.count(), 3);
+
+    qt_safe_close(fds[0]);
+    qt_safe_close(fds[1]);
+}
+
+class EpollFileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EpollFileWatcher(int fd)
+        : fd(fd), readNotifier(0), writeNotifier(0)
+    { }
+
+    int fd;
+    QSocketNotifier *readNotifier;
+    QSocketNotifier *writeNotifier;
+
+public slots:
+    void start()
+    {
+        readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(readNotifier, SIGNAL(activated(int)), SLOT(readyRead()));
+        writeNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+        connect(writeNotifier, SIGNAL(activated(int)), SLOT(readyWrite()));
+    }
+
+    void readyRead()
+    {
+        // the fd stays ready, so disable the notifier to avoid spinning
+        readNotifier->setEnabled(false);
+        emit activated(int(QSocketNotifier::Read));
+    }
+
+    void readyWrite()
+    {
+        writeNotifier->setEnabled(false);
+        emit activated(int(QSocketNotifier::Write));
+    }
+
+signals:
+    void activated(int type);
+};
+
+void tst_QSocketNotifier::epollDispatcherUnwatchableFd_data()
+{
+    QTest::addColumn<bool>("directory");
+
+    QTest::newRow("regular-file") << false;
+    QTest::newRow("directory") << true;
+}
+
+void tst_QSocketNotifier::epollDispatcherUnwatchableFd()
+{
+    // epoll_ctl() fails with EPERM for fds that do not support polling; the
+    // dispatcher must then report them as always ready, like select() does
+    if (!QEventDispatcherEpoll::isSupported())
+        QSKIP("epoll(7) is not available");
+
+    QFETCH(bool, directory);
+
+    QTemporaryFile file;
+    int fd;
+    if (directory) {
+        fd = qt_safe_open(QFile::encodeName(QDir::tempPath()).constData(), O_RDONLY);
+    } else {
+        QVERIFY(file.open());
+        fd = file.handle();
+    }
+    QVERIFY(fd != -1);
+
+    int pipeFds[2];
+    QCOMPARE(qt_safe_pipe(pipeFds, O_NONBLOCK), 0);
+
+    QThread thread;
+    thread.setEventDispatcher(new QEventDispatcherEpoll);
+
+    EpollFileWatcher watcher(fd);
+    watcher.moveToThread(&thread);
+    QSignalSpy spy(&watcher, SIGNAL(activated(int)));
+    QVERIFY(spy.isValid());
+    EpollPipeReader reader(pipeFds[0]);
+    reader.moveToThread(&thread);
+    QSignalSpy readSpy(&reader, SIGNAL(dataRead(int)));
+    QVERIFY(readSpy.isValid());
+    connect(&thread, SIGNAL(started()), &watcher, SLOT(start()));
+    connect(&thread, SIGNAL(started()), &reader, SLOT(start()));
+    thread.start();
+
+    QTRY_COMPARE(spy.count(), 2);
+    QList<int> types;
+    types << spy.at(0).at(0).toInt() << spy.at(1).at(0).toInt();
+    QVERIFY(types.contains(int(QSocketNotifier::Read)));
+    QVERIFY(types.contains(int(QSocketNotifier::Write)));
+
+    // the fds that epoll watches must still be reported next to it
+    qt_safe_write(pipeFds[1], "a", 1);
+    QTRY_COMPARE(readSpy.count(), 1);
+
+    // re-enabling a notifier on the unwatchable fd activates it again
+    QMetaObject::invokeMethod(watcher.readNotifier, "setEnabled", Qt::BlockingQueuedConnection,
+                              Q_ARG(bool, true));
+    QTRY_COMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(2).at(0).toInt(), int(QSocketNotifier::Read));
+
+    QMetaObject::invokeMethod(&reader, "stop", Qt::BlockingQueuedConnection);
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+
+    if (directory)
+        qt_safe_close(fd);
+    qt_safe_close(pipeFds[0]);
+    qt_safe_close(pipeFds[1]);
+}
+#endif
+
 QTEST_MAIN(tst_QSocketNotifier)
 #include <tst_qsocketnotifier.moc>
@@ -67,6 +67,8 @@ private slots:
     void timerFiresOnlyOncePerProcessEvents();
     void timerIdPersistsAfterThreadExit();
     void cancelLongTimer();
+    void manyTimers();
+    void longTimersRemainingTime();
     void singleShotStaticFunctionZeroTimeout();
     void recurseOnTimeoutAndStopTimer();
     void singleShotToFunctors();
@@ -570,6 +572,92 @@ void tst_QTimer::cancelLongTimer()
     QVERIFY(!timer.isActive());
 }
 
+class TimerRecorder : public QObject
+{
+public:
+    struct Activation {
+        int timerId;
+        qint64 elapsed;
+    };
+    QElapsedTimer clock;
+    QVector<Activation> activations;
+
+protected:
+    void timerEvent(QTimerEvent *te) Q_DECL_OVERRIDE
+    {
+        Activation a = { te->timerId(), clock.elapsed() };
+        activations.append(a);
+        killTimer(te->timerId());
+    }
+};
+
+void tst_QTimer::manyTimers()
+{
+    // enough timers, with enough different intervals, to spread over
+    // several levels of the timer wheel
+    const int count = 3000;
+    TimerRecorder recorder;
+    QHash<int, int> intervals;
+    QSet<int> killed;
+
+    recorder.clock.start();
+    for (int i = 0; i < count; ++i) {
+        const int interval = 10 + (i * 7919) % 500;
+        const int id = recorder.startTimer(interval, Qt::PreciseTimer);
+        QVERIFY(id > 0);
+        intervals.insert(id, interval);
+    }
+    const qint64 registrationTime = recorder.clock.elapsed();
+    for (QHash<int, int>::const_iterator it = intervals.constBegin(); it != intervals.constEnd(); ++it) {
+        if (it.key() % 3 == 0) {
+            recorder.killTimer(it.key());
+            killed.insert(it.key());
+        }
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(recorder.activations.size(), count - killed.size(), 10000);
+    QTest::qWait(50);
+    QCOMPARE(recorder.activations.size(), count - killed.size());
+
+    QSet<int> fired;
+    int previousInterval = 0;
+    foreach (const TimerRecorder::Activation &a, recorder.activations) {
+        QVERIFY(!killed.contains(a.timerId));
+        QVERIFY(!fired.contains(a.timerId));
+        fired.insert(a.timerId);
+
+        // precise timers never fire early, and fire in the order of their
+        // deadlines, which differ from the intervals by at most the time
+        // it took to start them all
+        const int interval = intervals.value(a.timerId);
+        QVERIFY2(a.elapsed >= interval,
+                 qPrintable(QString::fromLatin1("interval %1 fired after %2 ms").arg(interval).arg(a.elapsed)));
+        QVERIFY(interval >= previousInterval - registrationTime - 1);
+        previousInterval = qMax(previousInterval, interval);
+    }
+}
+
+void tst_QTimer::longTimersRemainingTime()
+{
+    // one hour and one day timers are filed high up in the timer wheel
+    const int intervals[] = { 5 * 1000, 100 * 1000, 60 * 60 * 1000, 24 * 60 * 60 * 1000 };
+    QTimer timers[4];
+    for (int i = 0; i < 4; ++i) {
+        timers[i].setTimerType(Qt::PreciseTimer);
+        timers[i].start(intervals[i]);
+    }
+
+    QCoreApplication::processEvents();
+    QTest::qWait(10);
+
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY(timers[i].isActive());
+        const int remaining = timers[i].remainingTime();
+        QVERIFY2(remaining <= intervals[i] && remaining >= intervals[i] - 1000,
+                 qPrintable(QString::number(remaining)));
+    }
+}
+
 void tst_QTimer::singleShotStaticFunctionZeroTimeout()
 {
     TimerHelper helper;
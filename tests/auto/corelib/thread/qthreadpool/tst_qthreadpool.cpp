@@ -93,6 +93,10 @@ private slots:
     void waitForDone();
     void clear();
     void cancel();
+    void startFromWorkerThread();
+    void cancelFromWorkerThread();
+    void waitForChildFromWorkerThread();
+    void startFromWorkerThreadKeepsOrder();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
     void stressTest();
@@ -1009,6 +1013,180 @@ void tst_QThreadPool::cancel()
     delete[] runnables;
 }
 
+void tst_QThreadPool::startFromWorkerThread()
+{
+    // runnables started by a busy worker are queued locally and must
+    // all run, whether the worker itself or an idle one picks them up
+    class SpawningRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        int runs;
+        SpawningRunnable(QThreadPool *p, int r) : pool(p), runs(r) {}
+        void run()
+        {
+            for (int i = 0; i < runs; ++i)
+                pool->start(new CountingRunnable());
+        }
+    };
+
+    const int spawners = 8;
+    const int runs = 1000;
+    count.store(0);
+    {
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(4);
+        for (int i = 0; i < spawners; ++i)
+            threadPool.start(new SpawningRunnable(&threadPool, runs));
+        QVERIFY(threadPool.waitForDone(60000));
+        QCOMPARE(count.load(), spawners * runs);
+        QCOMPARE(threadPool.activeThreadCount(), 0);
+    }
+    QCOMPARE(count.load(), spawners * runs);
+}
+
+void tst_QThreadPool::cancelFromWorkerThread()
+{
+    class TargetRunnable : public QRunnable
+    {
+    public:
+        QAtomicInt runCount;
+        TargetRunnable() { setAutoDelete(false); }
+        void run() { runCount.ref(); }
+    };
+
+    class CancellingRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        TargetRunnable *target;
+        CancellingRunnable(QThreadPool *p, TargetRunnable *t) : pool(p), target(t) {}
+        void run()
+        {
+            // the pool is saturated, so target ends up in our local queue
+            pool->start(target);
+            pool->cancel(target);
+        }
+    };
+
+    TargetRunnable target;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.start(new CancellingRunnable(&threadPool, &target));
+    QVERIFY(threadPool.waitForDone(10000));
+    QCOMPARE(target.runCount.load(), 0);
+}
+
+void tst_QThreadPool::waitForChildFromWorkerThread()
+{
+    class ChildRunnable : public QRunnable
+    {
+    public:
+        QSemaphore *done;
+        ChildRunnable(QSemaphore *d) : done(d) {}
+        void run() { done->release(); }
+    };
+
+    class ParentRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        bool releaseThread;
+        QAtomicInt childFinished;
+        ParentRunnable(QThreadPool *p, bool r) : pool(p), releaseThread(r) { setAutoDelete(false); }
+        void run()
+        {
+            // the pool is saturated, so the child ends up in our local queue
+            QSemaphore done;
+            pool->start(new ChildRunnable(&done));
+            if (releaseThread)
+                pool->releaseThread();
+            childFinished.store(done.tryAcquire(1, 10000));
+            if (releaseThread)
+                pool->reserveThread();
+        }
+    };
+
+    class SleepingRunnable : public QRunnable
+    {
+    public:
+        void run() { QTest::qSleep(100); }
+    };
+
+    {
+        // releasing the thread makes room for a new one to run the child
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(1);
+        ParentRunnable parent(&threadPool, true);
+        threadPool.start(&parent);
+        QVERIFY(threadPool.waitForDone(20000));
+        QCOMPARE(parent.childFinished.load(), 1);
+    }
+    {
+        // another worker steals the child once it is done with its own work
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(2);
+        ParentRunnable parent(&threadPool, false);
+        threadPool.start(new SleepingRunnable);
+        threadPool.start(&parent);
+        QVERIFY(threadPool.waitForDone(20000));
+        QCOMPARE(parent.childFinished.load(), 1);
+    }
+}
+
+void tst_QThreadPool::startFromWorkerThreadKeepsOrder()
+{
+    class OrderedRunnable : public QRunnable
+    {
+    public:
+        QMutex *mutex;
+        QStringList *order;
+        QString name;
+        OrderedRunnable(QMutex *m, QStringList *o, const QString &n) : mutex(m), order(o), name(n) {}
+        void run()
+        {
+            QMutexLocker locker(mutex);
+            order->append(name);
+        }
+    };
+
+    class StartingRunnable : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        QSemaphore *go;
+        QMutex *mutex;
+        QStringList *order;
+        StartingRunnable(QThreadPool *p, QSemaphore *g, QMutex *m, QStringList *o)
+            : pool(p), go(g), mutex(m), order(o) {}
+        void run()
+        {
+            go->acquire();
+            pool->start(new OrderedRunnable(mutex, order, QStringLiteral("b")));
+            pool->start(new OrderedRunnable(mutex, order, QStringLiteral("c")));
+        }
+    };
+
+    // "a" is queued before the worker starts "b" and "c", so it runs first
+    QMutex mutex;
+    QStringList order;
+    QSemaphore go;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.start(new StartingRunnable(&threadPool, &go, &mutex, &order));
+    threadPool.start(new OrderedRunnable(&mutex, &order, QStringLiteral("a")));
+    go.release();
+    QVERIFY(threadPool.waitForDone(10000));
+    QCOMPARE(order, QStringList() << "a" << "b" << "c");
+
+    // with nothing else queued, the worker runs them in the order it started them
+    order.clear();
+    threadPool.start(new StartingRunnable(&threadPool, &go, &mutex, &order));
+    go.release();
+    QVERIFY(threadPool.waitForDone(10000));
+    QCOMPARE(order, QStringList() << "b" << "c");
+}
+
 void tst_QThreadPool::destroyingWaitsForTasksToFinish()
 {
     QTime total, pass;
@@ -0,0 +1,484 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void operatorBracket();
+    void remove();
+    void take();
+    void erase();
+    void iterate();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void compare();
+    void keysValues();
+    void complexTypes();
+    void collisions();
+    void tombstones();
+    void detachWithTombstones();
+    void randomOperations();
+    void javaStyleIterators();
+    void initializerList();
+};
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QCOMPARE(hash.value(1), 0);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+
+    for (int i = 0; i < 1000; ++i) {
+        QFlatHash<int, int>::iterator it = hash.insert(i, i * 2);
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), i * 2);
+    }
+    QCOMPARE(hash.size(), 1000);
+    QVERIFY(hash.capacity() >= 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.count(i), 1);
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.find(i).value(), i * 2);
+    }
+    QVERIFY(!hash.contains(1000));
+    QCOMPARE(hash.value(1000, -1), -1);
+
+    // inserting an existing key replaces the value
+    hash.insert(10, 42);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(10), 42);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(10));
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<QString, int> hash;
+    hash["one"] = 1;
+    hash["two"] += 2;
+    ++hash["two"];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value("one"), 1);
+    QCOMPARE(hash.value("two"), 3);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash["three"], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    QCOMPARE(hash.remove(1), 0);
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, "one");
+    hash.insert(2, "two");
+    QCOMPARE(hash.take(1), QString("one"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 1);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.contains(2));
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    int erased = 0;
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0) {
+            it = hash.erase(it);
+            ++erased;
+        } else {
+            ++it;
+        }
+    }
+    QCOMPARE(erased, 34);
+    QCOMPARE(hash.size(), 66);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+
+    // erasing through an iterator of a shared hash only affects the detached copy
+    QFlatHash<int, int> copy = hash;
+    QFlatHash<int, int>::const_iterator cit = hash.constFind(1);
+    hash.erase(cit);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(copy.contains(1));
+    QCOMPARE(copy.size(), 66);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.constBegin() == hash.constEnd());
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, -i);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), -it.key());
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 500);
+
+    int count = 0;
+    QFlatHash<int, int>::const_iterator it = hash.constEnd();
+    while (it != hash.constBegin()) {
+        --it;
+        QVERIFY(seen.contains(it.key()));
+        ++count;
+    }
+    QCOMPARE(count, 500);
+
+    for (QFlatHash<int, int>::iterator mit = hash.begin(); mit != hash.end(); ++mit)
+        *mit = mit.key();
+    QCOMPARE(hash.value(123), 123);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, "one");
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(2, "two");
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(copy.size(), 2);
+    QCOMPARE(copy.value(1), QString("one"));
+
+    QFlatHash<int, QString> copy2 = copy;
+    copy2[1] = "uno";
+    QCOMPARE(copy.value(1), QString("one"));
+    QCOMPARE(copy2.value(1), QString("uno"));
+
+    copy2.swap(hash);
+    QCOMPARE(copy2.size(), 1);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(1), QString("uno"));
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, int> a, b;
+    QVERIFY(a == b);
+    for (int i = 0; i < 50; ++i)
+        a.insert(i, i);
+    for (int i = 49; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+    b[10] = 11;
+    QVERIFY(a != b);
+    b.remove(10);
+    QVERIFY(a != b);
+    b.insert(10, 10);
+    QVERIFY(a == b);
+}
+
+void tst_QFlatHash::keysValues()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 20; ++i)
+        hash.insert(i, QString::number(i));
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 20);
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(keys.at(i), i);
+
+    QList<QString> values = hash.values();
+    QCOMPARE(values.size(), 20);
+    QVERIFY(values.contains("7"));
+
+    QCOMPARE(hash.key("13"), 13);
+    QCOMPARE(hash.key("nope", -1), -1);
+
+    QFlatHash<int, QString> other;
+    other.insert(19, "nineteen");
+    other.insert(20, "twenty");
+    hash.unite(other);
+    QCOMPARE(hash.size(), 21);
+    QCOMPARE(hash.value(19), QString("nineteen"));
+}
+
+struct Counted
+{
+    static int alive;
+    int value;
+    Counted(int v = 0) : value(v) { ++alive; }
+    Counted(const Counted &o) : value(o.value) { ++alive; }
+    ~Counted() { --alive; }
+    Counted &operator=(const Counted &o) { value = o.value; return *this; }
+    bool operator==(const Counted &o) const { return value == o.value; }
+};
+int Counted::alive = 0;
+Q_DECLARE_TYPEINFO(Counted, Q_COMPLEX_TYPE);
+
+void tst_QFlatHash::complexTypes()
+{
+    {
+        QFlatHash<QString, Counted> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(QString::number(i), Counted(i));
+        QCOMPARE(Counted::alive, 1000);
+        for (int i = 0; i < 1000; i += 2)
+            hash.remove(QString::number(i));
+        QCOMPARE(Counted::alive, 500);
+
+        QFlatHash<QString, Counted> copy = hash;
+        copy.insert("x", Counted(-1));
+        QCOMPARE(Counted::alive, 1001);
+        hash.squeeze();
+        QCOMPARE(Counted::alive, 1001);
+        QCOMPARE(hash.value("999").value, 999);
+    }
+    QCOMPARE(Counted::alive, 0);
+}
+
+struct BadKey
+{
+    int v;
+    bool operator==(const BadKey &o) const { return v == o.v; }
+};
+uint qHash(const BadKey &, uint = 0) { return 0; }
+
+void tst_QFlatHash::collisions()
+{
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 200; ++i) {
+        BadKey k = { i };
+        hash.insert(k, i);
+    }
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 200; ++i) {
+        BadKey k = { i };
+        QCOMPARE(hash.value(k, -1), i);
+    }
+    for (int i = 0; i < 200; i += 2) {
+        BadKey k = { i };
+        QCOMPARE(hash.remove(k), 1);
+    }
+    for (int i = 0; i < 200; ++i) {
+        BadKey k = { i };
+        QCOMPARE(hash.contains(k), bool(i & 1));
+    }
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // churning through keys must not grow the table without bound
+    QFlatHash<int, int> hash;
+    hash.reserve(100);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 50; ++i)
+        hash.insert(i, i);
+    for (int i = 50; i < 100000; ++i) {
+        hash.remove(i - 50);
+        hash.insert(i, i);
+    }
+    QCOMPARE(hash.size(), 50);
+    QCOMPARE(hash.capacity(), capacity);
+    for (int i = 99950; i < 100000; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::detachWithTombstones()
+{
+    // the colliding keys overflow their first groups, so erasing the
+    // first ones leaves tombstones that the probes for the rest must
+    // cross, in the original and in a detached copy alike
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 40; ++i) {
+        BadKey k = { i };
+        hash.insert(k, i);
+    }
+    for (int i = 0; i < 16; ++i) {
+        BadKey k = { i };
+        QCOMPARE(hash.remove(k), 1);
+    }
+
+    QFlatHash<BadKey, int> copy = hash;
+    BadKey last = { 39 };
+    copy[last] = -1;
+    QVERIFY(!copy.isSharedWith(hash));
+
+    QCOMPARE(copy.size(), 24);
+    for (int i = 0; i < 40; ++i) {
+        BadKey k = { i };
+        QCOMPARE(copy.contains(k), i >= 16);
+        QCOMPARE(hash.contains(k), i >= 16);
+        if (i >= 16) {
+            QCOMPARE(copy.value(k), i == 39 ? -1 : i);
+            QCOMPARE(hash.value(k), i);
+        }
+    }
+
+    // the copy can still take new keys and erase old ones
+    for (int i = 40; i < 60; ++i) {
+        BadKey k = { i };
+        copy.insert(k, i);
+    }
+    for (int i = 16; i < 30; ++i) {
+        BadKey k = { i };
+        QCOMPARE(copy.remove(k), 1);
+    }
+    QCOMPARE(copy.size(), 30);
+    for (int i = 30; i < 60; ++i) {
+        BadKey k = { i };
+        QCOMPARE(copy.value(k, -2), i == 39 ? -1 : i);
+    }
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QFlatHash<int, int> hash;
+    QHash<int, int> reference;
+    uint state = 12345;
+    for (int i = 0; i < 200000; ++i) {
+        state = state * 1103515245 + 12345;
+        const int key = int((state >> 8) % 4096);
+        switch ((state >> 24) % 4) {
+        case 0:
+        case 1:
+            hash.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(hash.value(key, -1), reference.value(key, -1));
+            break;
+        }
+    }
+    QCOMPARE(hash.size(), reference.size());
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it)
+        QCOMPARE(it.value(), reference.value(it.key()));
+}
+
+void tst_QFlatHash::javaStyleIterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, i);
+
+    int sum = 0;
+    QFlatHashIterator<int, int> it(hash);
+    while (it.hasNext()) {
+        it.next();
+        sum += it.value();
+    }
+    QCOMPARE(sum, 45);
+
+    QMutableFlatHashIterator<int, int> mit(hash);
+    while (mit.hasNext()) {
+        mit.next();
+        if (mit.key() & 1)
+            mit.remove();
+        else
+            mit.setValue(-mit.key());
+    }
+    QCOMPARE(hash.size(), 5);
+    QCOMPARE(hash.value(4), -4);
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = {{1, "bar"}, {1, "hello"}, {2, "initializer_list"}};
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash.value(1), QString("hello"));
+    QCOMPARE(hash.value(2), QString("initializer_list"));
+
+    QFlatHash<int, int> empty {};
+    QVERIFY(empty.isEmpty());
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -51,6 +51,8 @@ private slots:
     void reserveFrontAndRead();
     void chop();
     void ungetChar();
+    void ungetBlock();
+    void readChunk();
     void indexOf();
     void appendAndRead();
     void peek();
@@ -275,6 +277,56 @@ void tst_QRingBuffer::ungetChar()
     QCOMPARE(ringBuffer.size(), Q_INT64_C(1));
 }
 
+void tst_QRingBuffer::ungetBlock()
+{
+    QRingBuffer ringBuffer(16);
+    ringBuffer.append(QByteArray("0123456789"));
+    ringBuffer.append(QByteArray("abcdef"));
+
+    char data[12];
+    QCOMPARE(ringBuffer.read(data, 12), Q_INT64_C(12));
+    ringBuffer.ungetBlock(data, 12);
+    QCOMPARE(ringBuffer.size(), Q_INT64_C(16));
+    QCOMPARE(ringBuffer.read(data, 12), Q_INT64_C(12));
+    QCOMPARE(QByteArray(data, 12), QByteArray("0123456789ab"));
+
+    ringBuffer.ungetBlock(data + 8, 4);
+    QCOMPARE(ringBuffer.size(), Q_INT64_C(8));
+    QCOMPARE(ringBuffer.read(data, 8), Q_INT64_C(8));
+    QCOMPARE(QByteArray(data, 8), QByteArray("89abcdef"));
+}
+
+void tst_QRingBuffer::readChunk()
+{
+    QRingBuffer ringBuffer;
+    QByteArray ba1(4096, 'a');
+    QByteArray ba2("Hello world!");
+    ringBuffer.append(ba1);
+    ringBuffer.append(ba2);
+
+    // a full block is handed out without copying
+    QByteArray chunk = ringBuffer.readChunk(8192);
+    QCOMPARE(chunk, ba1);
+    QCOMPARE(chunk.constData(), ba1.constData());
+
+    // a part of a block is copied
+    chunk = ringBuffer.readChunk(5);
+    QCOMPARE(chunk, QByteArray("Hello"));
+    QCOMPARE(ringBuffer.size(), Q_INT64_C(7));
+    chunk = ringBuffer.readChunk(100);
+    QCOMPARE(chunk, QByteArray(" world!"));
+    QVERIFY(ringBuffer.isEmpty());
+    QVERIFY(ringBuffer.readChunk(100).isEmpty());
+
+    // so is data that fills only a small part of its block
+    char *ptr = ringBuffer.reserve(10);
+    memcpy(ptr, "0123456789", 10);
+    chunk = ringBuffer.readChunk(100);
+    QCOMPARE(chunk, QByteArray("0123456789"));
+    QVERIFY(chunk.capacity() < 4096);
+    QVERIFY(ringBuffer.isEmpty());
+}
+
 void tst_QRingBuffer::indexOf()
 {
     QRingBuffer ringBuffer(16);
@@ -20,6 +20,7 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -73,6 +73,11 @@ private slots:
 
     void convertToFormatRgb888ToRGB32();
 
+    void convertLargeImage_data();
+    void convertLargeImage();
+    void unpremultiplyInvalidPixels_data();
+    void unpremultiplyInvalidPixels();
+
     void createAlphaMask_data();
     void createAlphaMask();
 #ifndef QT_NO_IMAGE_HEURISTIC_MASK
@@ -957,6 +962,143 @@ void tst_QImage::convertToFormatRgb888ToRGB32()
     }
 }
 
+void tst_QImage::convertLargeImage_data()
+{
+    QTest::addColumn<QImage::Format>("inFormat");
+    QTest::addColumn<QImage::Format>("outFormat");
+
+    static const QImage::Format pairs[][2] = {
+        { QImage::Format_RGB888, QImage::Format_RGB32 },
+        { QImage::Format_RGB888, QImage::Format_ARGB32_Premultiplied },
+        { QImage::Format_RGB32, QImage::Format_RGB888 },
+        { QImage::Format_RGB32, QImage::Format_Grayscale8 },
+        { QImage::Format_Grayscale8, QImage::Format_RGB32 },
+        { QImage::Format_Grayscale8, QImage::Format_ARGB32 },
+        { QImage::Format_Grayscale8, QImage::Format_ARGB32_Premultiplied },
+        { QImage::Format_ARGB32, QImage::Format_ARGB32_Premultiplied },
+        { QImage::Format_ARGB32_Premultiplied, QImage::Format_ARGB32 },
+        { QImage::Format_ARGB32_Premultiplied, QImage::Format_RGB32 },
+        { QImage::Format_ARGB32, QImage::Format_RGBA8888 },
+        { QImage::Format_ARGB32, QImage::Format_RGBX8888 },
+        { QImage::Format_ARGB32_Premultiplied, QImage::Format_RGBA8888_Premultiplied },
+        { QImage::Format_RGBA8888, QImage::Format_ARGB32 },
+        { QImage::Format_RGBA8888, QImage::Format_RGB32 },
+        { QImage::Format_RGBX8888, QImage::Format_RGB32 },
+        { QImage::Format_RGBX8888, QImage::Format_ARGB32 },
+        { QImage::Format_RGBA8888_Premultiplied, QImage::Format_ARGB32_Premultiplied },
+        { QImage::Format_RGBA8888_Premultiplied, QImage::Format_RGBA8888 },
+        { QImage::Format_RGBA8888_Premultiplied, QImage::Format_RGBX8888 },
+        { QImage::Format_RGB16, QImage::Format_ARGB32 },
+    };
+
+    for (size_t i = 0; i < sizeof(pairs) / sizeof(pairs[0]); ++i) {
+        const QString name = formatToString(pairs[i][0]) + QLatin1String(" -> ") + formatToString(pairs[i][1]);
+        QTest::newRow(qPrintable(name)) << pairs[i][0] << pairs[i][1];
+    }
+}
+
+void tst_QImage::convertLargeImage()
+{
+    QFETCH(QImage::Format, inFormat);
+    QFETCH(QImage::Format, outFormat);
+
+    // Large enough to be converted in bands, with an odd width so the
+    // vectorized converters also have to handle a scalar tail.
+    const int width = 1031;
+    const int height = 263;
+
+    QImage source(width, height, QImage::Format_ARGB32);
+    qsrand(1);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(source.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            // Make sure the fully opaque and fully transparent fast paths are hit too.
+            const int alpha = (x / 64) % 3 == 0 ? 255 : (x / 64) % 3 == 1 ? 0 : qrand() & 0xff;
+            line[x] = qRgba(qrand() & 0xff, qrand() & 0xff, qrand() & 0xff, alpha);
+        }
+    }
+    source = source.convertToFormat(inFormat);
+    QCOMPARE(source.format(), inFormat);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(4);
+    const QImage result = source.convertToFormat(outFormat);
+    pool->setMaxThreadCount(maxThreadCount);
+    QCOMPARE(result.format(), outFormat);
+
+    const bool inPremultiplied = inFormat == QImage::Format_ARGB32_Premultiplied
+                                 || inFormat == QImage::Format_RGBA8888_Premultiplied;
+    const bool outPremultiplied = outFormat == QImage::Format_ARGB32_Premultiplied
+                                  || outFormat == QImage::Format_RGBA8888_Premultiplied;
+    const bool outOpaque = !result.hasAlphaChannel();
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            QRgb expected = source.pixel(x, y);
+            if (inPremultiplied && !outPremultiplied)
+                expected = qUnpremultiply(expected);
+            else if (!inPremultiplied && outPremultiplied)
+                expected = qPremultiply(expected);
+            if (outOpaque)
+                expected |= 0xff000000;
+            if (outFormat == QImage::Format_Grayscale8)
+                expected = qRgb(qGray(expected), qGray(expected), qGray(expected));
+            if (result.pixel(x, y) != expected)
+                QCOMPARE(result.pixel(x, y), expected);
+        }
+    }
+}
+
+void tst_QImage::unpremultiplyInvalidPixels_data()
+{
+    QTest::addColumn<QImage::Format>("inFormat");
+    QTest::addColumn<QImage::Format>("outFormat");
+
+    QTest::newRow("argb32pm -> argb32") << QImage::Format_ARGB32_Premultiplied << QImage::Format_ARGB32;
+    QTest::newRow("argb32pm -> rgb32") << QImage::Format_ARGB32_Premultiplied << QImage::Format_RGB32;
+    QTest::newRow("rgba8888pm -> rgba8888") << QImage::Format_RGBA8888_Premultiplied << QImage::Format_RGBA8888;
+    QTest::newRow("rgba8888pm -> rgbx8888") << QImage::Format_RGBA8888_Premultiplied << QImage::Format_RGBX8888;
+}
+
+void tst_QImage::unpremultiplyInvalidPixels()
+{
+    QFETCH(QImage::Format, inFormat);
+    QFETCH(QImage::Format, outFormat);
+
+    // Premultiplied pixels whose color exceeds their alpha are invalid, but
+    // the vectorized converters must still give the same results as
+    // qUnpremultiply() for them, in runs of fully transparent, translucent
+    // and opaque pixels alike.
+    const int width = 1031;
+    const int height = 16;
+    QImage source(width, height, QImage::Format_ARGB32_Premultiplied);
+    qsrand(2);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(source.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int run = ((x + y) / 4) % 3;
+            const int alpha = run == 0 ? 0 : run == 1 ? 1 + qrand() % 254 : 255;
+            line[x] = qRgba(qrand() & 0xff, qrand() & 0xff, qrand() & 0xff, alpha);
+        }
+    }
+    source = source.convertToFormat(inFormat);
+    QCOMPARE(source.format(), inFormat);
+
+    const QImage result = source.convertToFormat(outFormat);
+    QCOMPARE(result.format(), outFormat);
+    const bool outOpaque = !result.hasAlphaChannel();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            QRgb expected = qUnpremultiply(source.pixel(x, y));
+            if (outOpaque)
+                expected |= 0xff000000;
+            if (result.pixel(x, y) != expected)
+                QCOMPARE(result.pixel(x, y), expected);
+        }
+    }
+}
+
 void tst_QImage::createAlphaMask_data()
 {
     QTest::addColumn<int>("x");
@@ -54,6 +54,7 @@
 #include <qpixmap.h>
 
 #include <private/qdrawhelper_p.h>
+#include <private/qpaintengine_raster_p.h>
 #include <qpainter.h>
 
 #ifndef QT_NO_WIDGETS
@@ -69,6 +70,8 @@
 #include <qlayout.h>
 #endif
 #include <qfontdatabase.h>
+#include <qstatictext.h>
+#include <qthreadpool.h>
 
 Q_DECLARE_METATYPE(QGradientStops)
 Q_DECLARE_METATYPE(QPainterPath)
@@ -305,6 +308,9 @@ private slots:
     void drawPolyline_data();
     void drawPolyline();
 
+    void tiledRendering_data();
+    void tiledRendering();
+
 private:
     void fillData();
     void setPenColor(QPainter& p);
@@ -5047,6 +5053,182 @@ void tst_QPainter::drawPolyline()
     QCOMPARE(images[0], images[1]);
 }
 
+static void paintTiledRenderingScene(QPainter *p, const QSize &size)
+{
+    QImage source(64, 48, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < source.height(); ++y)
+        for (int x = 0; x < source.width(); ++x)
+            source.setPixel(x, y, qPremultiply(qRgba(x * 4, y * 5, (x ^ y) * 8, 128 + x + y)));
+    const QPixmap pixmap = QPixmap::fromImage(source);
+    QBitmap bitmap(16, 16);
+    bitmap.fill(Qt::color0);
+    {
+        QPainter bp(&bitmap);
+        bp.drawEllipse(2, 2, 12, 12);
+    }
+
+    QLinearGradient background(0, 0, size.width(), size.height());
+    background.setColorAt(0, QColor(30, 60, 90));
+    background.setColorAt(1, QColor(200, 180, 120));
+    p->fillRect(QRect(QPoint(0, 0), size), background);
+
+    // Antialiased curves under a rotation, filled with a radial gradient
+    p->setRenderHint(QPainter::Antialiasing);
+    QPainterPath path;
+    path.moveTo(20, 20);
+    path.cubicTo(200, 0, 0, 200, 180, 170);
+    path.quadTo(60, 230, 20, 20);
+    QRadialGradient radial(100, 100, 90);
+    radial.setColorAt(0, QColor(255, 0, 0, 200));
+    radial.setColorAt(1, QColor(0, 0, 255, 100));
+    p->save();
+    p->translate(size.width() / 2, size.height() / 3);
+    p->rotate(23);
+    p->setPen(QPen(Qt::black, 3.5, Qt::SolidLine, Qt::RoundCap, Qt::MiterJoin));
+    p->setBrush(radial);
+    p->drawPath(path);
+    p->restore();
+
+    // Cosmetic and dashed pens
+    p->setRenderHint(QPainter::Antialiasing, false);
+    p->setPen(QPen(Qt::darkGreen, 0, Qt::DashDotLine));
+    for (int i = 0; i < size.height(); i += 7)
+        p->drawLine(QLineF(0, i, size.width(), size.height() - i * 0.7));
+    p->setPen(QPen(QColor(255, 255, 0, 160), 5, Qt::DashLine, Qt::SquareCap, Qt::MiterJoin));
+    const QPointF zigzag[] = { QPointF(10, 300), QPointF(90, 20), QPointF(170, 290), QPointF(250, 30) };
+    p->drawPolyline(zigzag, 4);
+    p->setRenderHint(QPainter::Antialiasing);
+    p->setPen(QPen(Qt::white, 1.5));
+    p->drawLine(QLine(5, size.height() - 5, size.width() - 5, 5));
+    p->drawEllipse(QRectF(40.5, 60.25, 210, 130));
+    p->setRenderHint(QPainter::Antialiasing, false);
+    p->drawEllipse(QRect(100, 150, 80, 190));
+
+    // Images and pixmaps, scaled, rotated and tiled
+    p->drawImage(QPointF(7, 11), source);
+    p->drawImage(QRectF(30, 120, 150, 230), source, QRectF(3, 2, 50, 40));
+    p->setRenderHint(QPainter::SmoothPixmapTransform);
+    p->drawImage(QRectF(200, 40, 100, 300), source);
+    p->save();
+    p->translate(220, 200);
+    p->rotate(-35);
+    p->scale(1.7, 2.3);
+    p->drawImage(QPointF(0, 0), source);
+    p->drawPixmap(QPointF(-40, 30), pixmap);
+    p->restore();
+    p->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    p->drawPixmap(QRectF(10, 200, 90, 70), pixmap, QRectF(5, 5, 40, 30));
+    p->drawTiledPixmap(QRectF(150, 250, 170, 120), pixmap, QPointF(13, 7));
+    p->setPen(Qt::magenta);
+    p->drawPixmap(260, 10, bitmap);
+
+    // Texture brushes
+    p->setPen(Qt::NoPen);
+    p->setBrush(QBrush(source));
+    p->setBrushOrigin(3, 5);
+    p->drawRect(QRectF(20.5, 330.5, 140, 60));
+    p->setBrush(QBrush(pixmap));
+    p->drawRoundedRect(QRectF(180, 320, 130, 70), 12, 12);
+
+    // Clipping, including a clip that is switched off and back on
+    p->save();
+    p->setClipRect(QRect(30, 30, 200, 250));
+    QPainterPath clipPath;
+    clipPath.addEllipse(QRectF(20, 40, 220, 200));
+    p->setRenderHint(QPainter::Antialiasing);
+    p->setClipPath(clipPath, Qt::IntersectClip);
+    p->setOpacity(0.6);
+    p->fillRect(QRect(0, 0, size.width(), size.height()), QColor(0, 255, 128));
+    p->setClipping(false);
+    p->setPen(QPen(Qt::red, 2));
+    p->drawRect(QRect(1, 1, size.width() - 3, size.height() - 3));
+    p->setClipping(true);
+    p->setOpacity(1);
+    p->rotate(10);
+    p->setPen(Qt::blue);
+    p->setBrush(Qt::Dense4Pattern);
+    p->drawRect(QRectF(40, 20, 200, 200));
+    p->restore();
+
+    QRegion region(QRect(200, 200, 100, 60));
+    region |= QRect(150, 280, 60, 80);
+    region -= QRect(210, 220, 20, 20);
+    p->setClipRegion(region);
+    p->setCompositionMode(QPainter::CompositionMode_Multiply);
+    p->fillRect(QRect(140, 190, 200, 200), QColor(120, 200, 255));
+    p->setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p->setClipping(false);
+
+    // Primitives and text
+    p->setPen(QPen(Qt::black, 2));
+    const QPoint points[] = { QPoint(5, 5), QPoint(300, 7), QPoint(12, 390), QPoint(150, 200) };
+    p->drawPoints(points, 4);
+    const QPointF star[] = { QPointF(250, 250), QPointF(310, 390), QPointF(180, 300),
+                             QPointF(320, 300), QPointF(190, 390) };
+    p->setBrush(QColor(255, 255, 255, 120));
+    p->drawPolygon(star, 5, Qt::OddEvenFill);
+    const QRect rects[] = { QRect(3, 250, 20, 40), QRect(8, 270, 30, 100) };
+    p->drawRects(rects, 2);
+
+    QFont font;
+    font.setPixelSize(18);
+    p->setFont(font);
+    p->setPen(Qt::darkBlue);
+    p->drawText(QPointF(15, 40), QStringLiteral("Tiled rendering"));
+    p->save();
+    p->translate(60, 380);
+    p->rotate(-60);
+    p->drawText(QPointF(0, 0), QStringLiteral("Rotated text across tiles"));
+    p->restore();
+    QStaticText staticText(QStringLiteral("Static text"));
+    p->drawStaticText(QPointF(120, 100), staticText);
+}
+
+void tst_QPainter::tiledRendering_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<int>("tileHeight");
+
+    QTest::newRow("ARGB32_Premultiplied, automatic") << QImage::Format_ARGB32_Premultiplied << 0;
+    QTest::newRow("ARGB32_Premultiplied, 1") << QImage::Format_ARGB32_Premultiplied << 1;
+    QTest::newRow("ARGB32_Premultiplied, 7") << QImage::Format_ARGB32_Premultiplied << 7;
+    QTest::newRow("ARGB32_Premultiplied, 64") << QImage::Format_ARGB32_Premultiplied << 64;
+    QTest::newRow("RGB32, 13") << QImage::Format_RGB32 << 13;
+    QTest::newRow("ARGB32, 50") << QImage::Format_ARGB32 << 50;
+    QTest::newRow("RGB16, 9") << QImage::Format_RGB16 << 9;
+}
+
+void tst_QPainter::tiledRendering()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(int, tileHeight);
+
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(4);
+
+    const QSize size(330, 400);
+    QImage expected(size, format);
+    expected.fill(Qt::transparent);
+    QImage tiled = expected.copy();
+
+    QPainter p(&expected);
+    paintTiledRenderingScene(&p, size);
+    p.end();
+
+    QRasterPaintEngine *engine = static_cast<QRasterPaintEngine *>(tiled.paintEngine());
+    QCOMPARE(engine->type(), QPaintEngine::Raster);
+    engine->setTiledRendering(true, tileHeight);
+    QVERIFY(engine->isTiledRenderingEnabled());
+    p.begin(&tiled);
+    paintTiledRenderingScene(&p, size);
+    p.end();
+    engine->setTiledRendering(false);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+
+    QCOMPARE(tiled, expected);
+}
+
 QTEST_MAIN(tst_QPainter)
 
 #include "tst_qpainter.moc"
@@ -34,6 +34,7 @@
 
 #include <QtTest/QtTest>
 #include "private/qhttpnetworkconnection_p.h"
+#include "private/qhttpcontentdecoder_p.h"
 
 class tst_QHttpNetworkReply: public QObject
 {
@@ -46,6 +47,10 @@ private Q_SLOTS:
 
     void parseHeader_data();
     void parseHeader();
+    void contentDecoder_data();
+    void contentDecoder();
+    void contentDecoderSafetyCheck();
+    void registerContentDecoder();
 };
 
 
@@ -122,5 +127,117 @@ void tst_QHttpNetworkReply::parseHeader()
     }
 }
 
+static QByteArray contentDecoderInput()
+{
+    QByteArray data;
+    for (int i = 0; data.size() < 200 * 1024; ++i)
+        data += "line " + QByteArray::number(i) + " of the reply body\n";
+    return data;
+}
+
+void tst_QHttpNetworkReply::contentDecoder_data()
+{
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<QByteArray>("compressed");
+    QTest::addColumn<int>("pieceSize");
+
+    // qCompress() prepends the uncompressed size to a zlib stream
+    const QByteArray zlibData = qCompress(contentDecoderInput()).mid(4);
+    // without the 2 byte zlib header and the 4 byte adler32 trailer
+    const QByteArray rawDeflateData = zlibData.mid(2, zlibData.size() - 6);
+
+    QTest::newRow("deflate") << QByteArray("deflate") << zlibData << zlibData.size();
+    QTest::newRow("deflate-pieces") << QByteArray("deflate") << zlibData << 7;
+    QTest::newRow("raw-deflate") << QByteArray("deflate") << rawDeflateData << rawDeflateData.size();
+    QTest::newRow("raw-deflate-pieces") << QByteArray("Deflate") << rawDeflateData << 1000;
+}
+
+void tst_QHttpNetworkReply::contentDecoder()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(QByteArray, compressed);
+    QFETCH(int, pieceSize);
+
+    QVERIFY(QHttpContentDecoder::isSupported(encoding));
+    QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoder::create(encoding));
+    QVERIFY(decoder);
+
+    QByteDataBuffer out;
+    for (int i = 0; i < compressed.size(); i += pieceSize)
+        QVERIFY(decoder->decode(compressed.mid(i, pieceSize), &out));
+    QVERIFY(decoder->atEnd());
+    QVERIFY(!decoder->hasError());
+
+    // the output is handed out in bounded chunks
+    for (int i = 0; i < out.bufferCount(); ++i)
+        QVERIFY(out[i].size() <= QHttpContentDecoder::ChunkSize);
+    QCOMPARE(out.readAll(), contentDecoderInput());
+    QCOMPARE(decoder->bytesIn(), qint64(compressed.size()));
+
+    // data after the end of the stream is ignored
+    QVERIFY(decoder->decode("garbage", &out));
+    QVERIFY(out.isEmpty());
+}
+
+void tst_QHttpNetworkReply::contentDecoderSafetyCheck()
+{
+    // 16 MiB of zeros compress at more than 1000:1
+    const QByteArray bomb = qCompress(QByteArray(16 * 1024 * 1024, '\0')).mid(4);
+
+    QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoder::create("gzip"));
+    QVERIFY(decoder);
+    QCOMPARE(decoder->safetyCheckThreshold(), qint64(QHttpContentDecoder::DefaultSafetyCheckThreshold));
+    QByteDataBuffer out;
+    QVERIFY(!decoder->decode(bomb, &out));
+    QVERIFY(decoder->hasError());
+    QVERIFY(!decoder->errorMessage().isEmpty());
+    QVERIFY(out.byteAmount() <= QHttpContentDecoder::DefaultSafetyCheckThreshold);
+    // once failed, it stays failed
+    QVERIFY(!decoder->decode(bomb, &out));
+
+    decoder.reset(QHttpContentDecoder::create("gzip"));
+    decoder->setSafetyCheckThreshold(-1);
+    out.clear();
+    QVERIFY(decoder->decode(bomb, &out));
+    QVERIFY(decoder->atEnd());
+    QCOMPARE(out.byteAmount(), qint64(16 * 1024 * 1024));
+}
+
+class ReversingDecoder : public QHttpContentDecoder
+{
+public:
+    ReversingDecoder() : QHttpContentDecoder(1) {}
+    static QHttpContentDecoder *create() { return new ReversingDecoder; }
+
+protected:
+    bool decodeData(const char *data, qint64 size) Q_DECL_OVERRIDE
+    {
+        QByteArray chunk;
+        for (qint64 i = size - 1; i >= 0; --i)
+            chunk += data[i];
+        return appendDecoded(chunk);
+    }
+};
+
+void tst_QHttpNetworkReply::registerContentDecoder()
+{
+    QVERIFY(!QHttpContentDecoder::isSupported("x-reversed"));
+    QVERIFY(!QHttpContentDecoder::create("x-reversed"));
+    QVERIFY(!QHttpContentDecoder::isSupported(QByteArray()));
+#ifndef QT_NO_COMPRESS
+    QCOMPARE(QHttpContentDecoder::acceptEncoding(), QByteArray("gzip, deflate"));
+#endif
+
+    QHttpContentDecoder::registerDecoder("X-Reversed", &ReversingDecoder::create);
+    QVERIFY(QHttpContentDecoder::isSupported("x-reversed"));
+    QVERIFY(QHttpContentDecoder::acceptEncoding().endsWith("x-reversed"));
+
+    QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoder::create(" x-reversed "));
+    QVERIFY(decoder);
+    QByteDataBuffer out;
+    QVERIFY(decoder->decode("olleh", &out));
+    QCOMPARE(out.readAll(), QByteArray("hello"));
+}
+
 QTEST_MAIN(tst_QHttpNetworkReply)
 #include "tst_qhttpnetworkreply.moc"
@@ -35,6 +35,10 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QAuthenticator>
+#include <QtNetwork/QHttpConnectionPolicy>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/QNetworkConfigurationManager>
 #endif
@@ -55,6 +59,11 @@ public:
 private slots:
     void networkAccessible();
     void alwaysCacheRequest();
+    void httpConnectionPolicy();
+    void pipelineStallFallback();
+    void sharedConnectionPool();
+    void sharedPoolPipelinePolicy();
+    void sharedPoolAuthentication();
 };
 
 tst_QNetworkAccessManager::tst_QNetworkAccessManager()
@@ -131,5 +140,384 @@ void tst_QNetworkAccessManager::alwaysCacheRequest()
     delete reply;
 }
 
+void tst_QNetworkAccessManager::httpConnectionPolicy()
+{
+    QHttpConnectionPolicy policy;
+    QCOMPARE(policy.channelCount(), 6);
+    QCOMPARE(policy.channelCount(QStringLiteral("example.com")), 6);
+    QVERIFY(!policy.isPipeliningEnabled());
+    QCOMPARE(policy.maximumPipelineLength(), 3);
+    QCOMPARE(policy.pipelineStallTimeout(), 0);
+
+    QVERIFY(!policy.isSharedConnectionPoolEnabled());
+
+    QHttpConnectionPolicy copy = policy;
+    policy.setChannelCount(8);
+    policy.setChannelCount(QStringLiteral("Example.com"), 2);
+    policy.setPipeliningEnabled(true);
+    policy.setMaximumPipelineLength(6);
+    policy.setPipelineStallTimeout(500);
+    QCOMPARE(policy.channelCount(), 8);
+    QCOMPARE(policy.channelCount(QStringLiteral("example.com")), 2);
+    QCOMPARE(policy.channelCount(QStringLiteral("example.org")), 8);
+    QVERIFY(policy.isPipeliningEnabled());
+    QCOMPARE(policy.maximumPipelineLength(), 6);
+    QCOMPARE(policy.pipelineStallTimeout(), 500);
+    QVERIFY(copy != policy);
+    QCOMPARE(copy.channelCount(), 6);
+
+    copy = policy;
+    policy.setSharedConnectionPoolEnabled(true);
+    QVERIFY(policy.isSharedConnectionPoolEnabled());
+    QVERIFY(copy != policy);
+
+    QTest::ignoreMessage(QtWarningMsg, "QHttpConnectionPolicy::setChannelCount: invalid channel count 0");
+    policy.setChannelCount(0);
+    QCOMPARE(policy.channelCount(), 8);
+
+    policy.resetChannelCount(QStringLiteral("EXAMPLE.COM"));
+    QCOMPARE(policy.channelCount(QStringLiteral("example.com")), 8);
+
+    QNetworkAccessManager manager;
+    QCOMPARE(manager.httpConnectionPolicy(), QHttpConnectionPolicy());
+    manager.setHttpConnectionPolicy(policy);
+    QCOMPARE(manager.httpConnectionPolicy(), policy);
+}
+
+// Answers every request right away, except for /stall: that one and
+// everything pipelined behind it on the same connection is never answered.
+class StallingHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    StallingHttpServer() : connectionCount(0)
+    {
+        connect(this, SIGNAL(newConnection()), this, SLOT(newConnectionSlot()));
+        listen(QHostAddress::LocalHost);
+    }
+
+    int connectionCount;
+
+private slots:
+    void newConnectionSlot()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            ++connectionCount;
+            connect(socket, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void readyReadSlot()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int end;
+        while (!stalled.contains(socket) && (end = buffer.indexOf("\r\n\r\n")) != -1) {
+            if (buffer.startsWith("GET /stall ")) {
+                stalled.insert(socket);
+                break;
+            }
+            buffer.remove(0, end + 4);
+            socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+        }
+    }
+
+private:
+    QHash<QTcpSocket *, QByteArray> buffers;
+    QSet<QTcpSocket *> stalled;
+};
+
+void tst_QNetworkAccessManager::pipelineStallFallback()
+{
+    qRegisterMetaType<QNetworkReply *>();
+
+    StallingHttpServer server;
+    QVERIFY(server.isListening());
+    const QString base = QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort());
+
+    QHttpConnectionPolicy policy;
+    policy.setChannelCount(2);
+    policy.setPipeliningEnabled(true);
+    policy.setPipelineStallTimeout(200);
+    QNetworkAccessManager manager;
+    manager.setHttpConnectionPolicy(policy);
+
+    // open both channels and let them learn that the server keeps connections alive
+    QList<QNetworkReply *> replies;
+    QSignalSpy finishedSpy(&manager, SIGNAL(finished(QNetworkReply*)));
+    for (int i = 0; i < 2; ++i)
+        replies << manager.get(QNetworkRequest(QUrl(base + QLatin1String("warmup"))));
+    QTRY_COMPARE(finishedSpy.count(), 2);
+    qDeleteAll(replies);
+    replies.clear();
+    finishedSpy.clear();
+
+    QNetworkReply *stalledReply = manager.get(QNetworkRequest(QUrl(base + QLatin1String("stall"))));
+    for (int i = 0; i < 8; ++i)
+        replies << manager.get(QNetworkRequest(QUrl(base + QString::number(i))));
+
+    // the requests pipelined behind the stalled one must move to the other channel
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), replies.count(), 10000);
+    foreach (QNetworkReply *reply, replies) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), QByteArray("ok"));
+    }
+    // the stalled request has been sent again on a new connection
+    QVERIFY(server.connectionCount > 2);
+    QVERIFY(!stalledReply->isFinished());
+
+    stalledReply->abort();
+    delete stalledReply;
+    qDeleteAll(replies);
+}
+
+void tst_QNetworkAccessManager::sharedConnectionPool()
+{
+    qRegisterMetaType<QNetworkReply *>();
+
+    StallingHttpServer server;
+    QVERIFY(server.isListening());
+    const QString base = QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort());
+
+    QCOMPARE(QHttpConnectionPolicy::sharedPoolChannelCount(), 6);
+    QCOMPARE(QHttpConnectionPolicy::sharedPoolIdleTimeout(), 120);
+    QTest::ignoreMessage(QtWarningMsg, "QHttpConnectionPolicy::setSharedPoolChannelCount: invalid channel count 0");
+    QHttpConnectionPolicy::setSharedPoolChannelCount(0);
+    QHttpConnectionPolicy::setSharedPoolChannelCount(2);
+
+    QHttpConnectionPolicy policy;
+    policy.setSharedConnectionPoolEnabled(true);
+    QNetworkAccessManager first;
+    first.setHttpConnectionPolicy(policy);
+    QNetworkAccessManager second;
+    second.setHttpConnectionPolicy(policy);
+
+    // the limit of two connections applies to both managers together
+    QList<QNetworkReply *> replies;
+    QSignalSpy firstSpy(&first, SIGNAL(finished(QNetworkReply*)));
+    QSignalSpy secondSpy(&second, SIGNAL(finished(QNetworkReply*)));
+    for (int i = 0; i < 4; ++i) {
+        replies << first.get(QNetworkRequest(QUrl(base + QLatin1String("first") + QString::number(i))));
+        replies << second.get(QNetworkRequest(QUrl(base + QLatin1String("second") + QString::number(i))));
+    }
+    QTRY_COMPARE(firstSpy.count() + secondSpy.count(), replies.count());
+    foreach (QNetworkReply *reply, replies) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), QByteArray("ok"));
+    }
+    QVERIFY(server.connectionCount <= 2);
+    const int connectionCount = server.connectionCount;
+    qDeleteAll(replies);
+    replies.clear();
+
+    // idle connections opened for one manager are reused by the other
+    QNetworkReply *reply = second.get(QNetworkRequest(QUrl(base + QLatin1String("again"))));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.connectionCount, connectionCount);
+    delete reply;
+
+    // clearing the access cache closes the idle pooled connections
+    first.clearAccessCache();
+    reply = second.get(QNetworkRequest(QUrl(base + QLatin1String("fresh"))));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.connectionCount, connectionCount + 1);
+    delete reply;
+
+    QHttpConnectionPolicy::setSharedPoolChannelCount(6);
+}
+
+void tst_QNetworkAccessManager::sharedPoolPipelinePolicy()
+{
+    StallingHttpServer server;
+    QVERIFY(server.isListening());
+    const QString base = QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort());
+
+    QHttpConnectionPolicy policy;
+    policy.setSharedConnectionPoolEnabled(true);
+    QNetworkAccessManager first;
+    first.setHttpConnectionPolicy(policy);
+    policy.setMaximumPipelineLength(1);
+    policy.setPipelineStallTimeout(200);
+    QNetworkAccessManager second;
+    second.setHttpConnectionPolicy(policy);
+    QNetworkAccessManager third;
+    third.setHttpConnectionPolicy(policy);
+
+    QNetworkReply *reply = first.get(QNetworkRequest(QUrl(base + QLatin1String("first"))));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.connectionCount, 1);
+    delete reply;
+
+    // a different pipelining policy must not reuse the idle connection of the first manager
+    reply = second.get(QNetworkRequest(QUrl(base + QLatin1String("second"))));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.connectionCount, 2);
+    delete reply;
+
+    // the same policy does
+    reply = third.get(QNetworkRequest(QUrl(base + QLatin1String("third"))));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.connectionCount, 2);
+    delete reply;
+
+    first.clearAccessCache();
+}
+
+// Answers GET requests, asking for Basic authentication for paths below
+// /private/, and records the Authorization header of every request.
+class AuthenticatingHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    AuthenticatingHttpServer()
+    {
+        connect(this, SIGNAL(newConnection()), this, SLOT(newConnectionSlot()));
+        listen(QHostAddress::LocalHost);
+    }
+
+    QMutex mutex;
+    QList<QPair<QByteArray, QByteArray> > requests; // path and Authorization header
+
+private slots:
+    void newConnectionSlot()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            connect(socket, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void readyReadSlot()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+            const QList<QByteArray> lines = buffer.left(end).split('\n');
+            buffer.remove(0, end + 4);
+            const QByteArray path = lines.first().split(' ').value(1);
+            QByteArray authorization;
+            foreach (const QByteArray &line, lines) {
+                if (line.toLower().startsWith("authorization:"))
+                    authorization = line.mid(14).trimmed();
+            }
+            {
+                QMutexLocker locker(&mutex);
+                requests << qMakePair(path, authorization);
+            }
+
+            if (path.startsWith("/private/") && authorization.isEmpty())
+                socket->write("HTTP/1.1 401 Unauthorized\r\nWWW-Authenticate: Basic realm=\"test\"\r\n"
+                              "Content-Length: 0\r\n\r\n");
+            else
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+        }
+    }
+
+private:
+    QHash<QTcpSocket *, QByteArray> buffers;
+};
+
+class CredentialsProvider : public QObject
+{
+    Q_OBJECT
+public:
+    CredentialsProvider(const QString &user) : user(user) {}
+
+public slots:
+    void authenticationRequired(QNetworkReply *, QAuthenticator *authenticator)
+    {
+        if (!user.isEmpty()) {
+            authenticator->setUser(user);
+            authenticator->setPassword(QStringLiteral("secret"));
+        }
+    }
+
+private:
+    QString user;
+};
+
+// Runs a pooled manager that fetches urls in a thread of its own
+class PooledManagerThread : public QThread
+{
+public:
+    PooledManagerThread(const QString &user, const QList<QUrl> &urls) : user(user), urls(urls) {}
+
+    QList<QNetworkReply::NetworkError> errors;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        QHttpConnectionPolicy policy;
+        policy.setSharedConnectionPoolEnabled(true);
+        QNetworkAccessManager manager;
+        manager.setHttpConnectionPolicy(policy);
+        CredentialsProvider provider(user);
+        QObject::connect(&manager, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)),
+                         &provider, SLOT(authenticationRequired(QNetworkReply*,QAuthenticator*)));
+
+        foreach (const QUrl &url, urls) {
+            QNetworkReply *reply = manager.get(QNetworkRequest(url));
+            QEventLoop loop;
+            QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+            QTimer::singleShot(10000, &loop, SLOT(quit()));
+            loop.exec();
+            errors << (reply->isFinished() ? reply->error() : QNetworkReply::TimeoutError);
+            delete reply;
+        }
+    }
+
+private:
+    QString user;
+    QList<QUrl> urls;
+};
+
+void tst_QNetworkAccessManager::sharedPoolAuthentication()
+{
+    AuthenticatingHttpServer server;
+    QVERIFY(server.isListening());
+    const QString base = QStringLiteral("http://127.0.0.1:%1/").arg(server.serverPort());
+
+    // the first manager authenticates
+    PooledManagerThread first(QStringLiteral("first"), QList<QUrl>()
+                              << QUrl(base + QLatin1String("private/first"))
+                              << QUrl(base + QLatin1String("public/first")));
+    first.start();
+    QTRY_VERIFY_WITH_TIMEOUT(first.isFinished(), 20000);
+    QCOMPARE(first.errors, QList<QNetworkReply::NetworkError>()
+             << QNetworkReply::NoError << QNetworkReply::NoError);
+
+    // the second one has no credentials and must not get those of the first
+    PooledManagerThread second(QString(), QList<QUrl>()
+                               << QUrl(base + QLatin1String("public/second"))
+                               << QUrl(base + QLatin1String("private/second")));
+    second.start();
+    QTRY_VERIFY_WITH_TIMEOUT(second.isFinished(), 20000);
+    QCOMPARE(second.errors, QList<QNetworkReply::NetworkError>()
+             << QNetworkReply::NoError << QNetworkReply::AuthenticationRequiredError);
+
+    QMutexLocker locker(&server.mutex);
+    bool firstAuthenticated = false;
+    for (int i = 0; i < server.requests.count(); ++i) {
+        const QByteArray &path = server.requests.at(i).first;
+        const QByteArray &authorization = server.requests.at(i).second;
+        if (path == "/private/first" && !authorization.isEmpty())
+            firstAuthenticated = true;
+        if (path.endsWith("/second"))
+            QVERIFY2(authorization.isEmpty(), path.constData());
+    }
+    QVERIFY(firstAuthenticated);
+}
+
 QTEST_MAIN(tst_QNetworkAccessManager)
 #include "tst_qnetworkaccessmanager.moc"
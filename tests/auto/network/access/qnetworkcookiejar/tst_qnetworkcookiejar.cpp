@@ -58,6 +58,8 @@ private slots:
 #endif
     void rfc6265_data();
     void rfc6265();
+    void manyDomains();
+    void expiredCookiesAreDropped();
 };
 
 QT_BEGIN_NAMESPACE
@@ -556,6 +558,78 @@ void tst_QNetworkCookieJar::rfc6265()
     }
 }
 
+void tst_QNetworkCookieJar::manyDomains()
+{
+    MyCookieJar jar;
+    QList<QNetworkCookie> expectedAll;
+    for (int i = 0; i < 1000; ++i) {
+        QNetworkCookie cookie("n", QByteArray::number(i));
+        cookie.setDomain(QString::fromLatin1(".host%1.example.com").arg(i));
+        cookie.setPath("/");
+        QVERIFY(jar.insertCookie(cookie));
+        expectedAll += cookie;
+    }
+
+    QNetworkCookie parent("parent", "1");
+    parent.setDomain(".example.com");
+    parent.setPath("/");
+    QNetworkCookie exact("exact", "1");
+    exact.setDomain("www.host7.example.com");
+    exact.setPath("/dir");
+    QNetworkCookie secure("secure", "1");
+    secure.setDomain(".host7.example.com");
+    secure.setPath("/");
+    secure.setSecure(true);
+    jar.insertCookie(parent);
+    jar.insertCookie(exact);
+    jar.insertCookie(secure);
+    expectedAll << parent << exact << secure;
+    QCOMPARE(jar.allCookies(), expectedAll);
+
+    QList<QNetworkCookie> expected;
+    expected << exact << expectedAll.at(7) << parent;
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://www.host7.example.com/dir/file")), expected);
+    expected << secure;
+    QCOMPARE(jar.cookiesForUrl(QUrl("https://www.host7.example.com/dir/file")), expected);
+
+    expected.clear();
+    expected << expectedAll.at(7) << parent;
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://host7.example.com/")), expected);
+    expected.clear();
+    expected << parent;
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://otherhost7.example.com/")), expected);
+
+    // deleting and inserting again moves a cookie to the end
+    QVERIFY(jar.deleteCookie(expectedAll.at(3)));
+    QVERIFY(!jar.deleteCookie(expectedAll.at(3)));
+    QVERIFY(jar.insertCookie(expectedAll.at(3)));
+    expectedAll.append(expectedAll.takeAt(3));
+    QCOMPARE(jar.allCookies(), expectedAll);
+}
+
+void tst_QNetworkCookieJar::expiredCookiesAreDropped()
+{
+    MyCookieJar jar;
+
+    QNetworkCookie session("session", "1");
+    session.setDomain(".example.com");
+    session.setPath("/");
+    QNetworkCookie expired("expired", "1");
+    expired.setDomain(".example.com");
+    expired.setPath("/");
+    expired.setExpirationDate(QDateTime::currentDateTime().addDays(-1));
+    QNetworkCookie elsewhere = expired;
+    elsewhere.setDomain(".example.org");
+
+    QList<QNetworkCookie> all;
+    all << session << expired << elsewhere;
+    jar.setAllCookies(all);
+    QCOMPARE(jar.allCookies(), all);
+
+    // only the expired cookies that the lookup came across are gone
+    QCOMPARE(jar.cookiesForUrl(QUrl("http://www.example.com/")), QList<QNetworkCookie>() << session);
+    QCOMPARE(jar.allCookies(), QList<QNetworkCookie>() << session << elsewhere);
+}
+
 QTEST_MAIN(tst_QNetworkCookieJar)
 #include "tst_qnetworkcookiejar.moc"
-
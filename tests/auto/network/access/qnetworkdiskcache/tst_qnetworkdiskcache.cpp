@@ -75,6 +75,11 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void persistentIndex();
+    void indexRebuild();
+    void reimplementedExpire();
+    void sharedDirectory();
+    void staleIndex();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -544,6 +549,239 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+static void insertItem(QNetworkDiskCache *cache, const QUrl &url)
+{
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(url);
+    QIODevice *device = cache->prepare(metaData);
+    QVERIFY(device);
+    device->write(QByteArray(1000, 'x'));
+    cache->insert(device);
+}
+
+static QString indexFileName(const QString &cacheDirectory)
+{
+    const QStringList dataDirectories = QDir(cacheDirectory).entryList(QStringList("data*"), QDir::Dirs);
+    if (dataDirectories.count() != 1)
+        return QString();
+    return cacheDirectory + '/' + dataDirectories.first() + "/index";
+}
+
+void tst_QNetworkDiskCache::persistentIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl url0("http://localhost:4/0");
+    const QUrl url1("http://localhost:4/1");
+    const QUrl url2("http://localhost:4/2");
+
+    qint64 size;
+    QString indexFile;
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        insertItem(&cache, url0);
+        insertItem(&cache, url1);
+        insertItem(&cache, url2);
+        size = cache.cacheSize();
+        QVERIFY(size > 3000);
+        // makes url1 the least recently used item
+        QVERIFY(cache.metaData(url0).isValid());
+
+        indexFile = indexFileName(cache.cacheDirectory());
+        QVERIFY(!indexFile.isEmpty());
+        QVERIFY(!QFile::exists(indexFile));
+    }
+    QVERIFY(QFile::exists(indexFile));
+
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    // the index is only kept on disk while the cache is closed
+    QVERIFY(!QFile::exists(indexFile));
+    QCOMPARE(cache.cacheSize(), size);
+    QVERIFY(!cache.metaData(QUrl("http://localhost:4/3")).isValid());
+
+    cache.setMaximumCacheSize(size);
+    QVERIFY(cache.cacheSize() < size);
+    QVERIFY(cache.metaData(url0).isValid());
+    QVERIFY(!cache.metaData(url1).isValid());
+    QVERIFY(cache.metaData(url2).isValid());
+}
+
+void tst_QNetworkDiskCache::indexRebuild()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl url0("http://localhost:4/0");
+    const QUrl url1("http://localhost:4/1");
+
+    qint64 size;
+    QString cacheDirectory;
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        insertItem(&cache, url0);
+        insertItem(&cache, url1);
+        size = cache.cacheSize();
+        cacheDirectory = cache.cacheDirectory();
+    }
+
+    // simulate a crash: no index, and a leftover from an unfinished insertion
+    QVERIFY(QFile::remove(indexFileName(cacheDirectory)));
+    QFile stale(cacheDirectory + "prepared/stale.d");
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    stale.write("stale");
+    stale.close();
+
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QVERIFY(!stale.exists());
+    QCOMPARE(cache.cacheSize(), size);
+    QVERIFY(cache.metaData(url0).isValid());
+    QVERIFY(cache.remove(url0));
+    QVERIFY(cache.cacheSize() < size);
+    QVERIFY(cache.metaData(url1).isValid());
+}
+
+// Removes every cache file itself instead of calling the base implementation.
+class RemoveAllDiskCache : public QNetworkDiskCache
+{
+public:
+    RemoveAllDiskCache() : expireCount(0) {}
+
+    qint64 expire() Q_DECL_OVERRIDE
+    {
+        ++expireCount;
+        foreach (const QString &path, countFiles(cacheDirectory())) {
+            if (QFileInfo(path).isFile() && path.endsWith(".d") && !path.contains("/prepared/"))
+                QFile::remove(path);
+        }
+        return 0;
+    }
+
+    int expireCount;
+};
+
+void tst_QNetworkDiskCache::reimplementedExpire()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl url0("http://localhost:4/0");
+    const QUrl url1("http://localhost:4/1");
+
+    RemoveAllDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    insertItem(&cache, url0);
+    QCOMPARE(cache.expireCount, 1);
+    QVERIFY(cache.metaData(url0).isValid());
+
+    // the second insertion's expire() removes the first item's file
+    insertItem(&cache, url1);
+    QCOMPARE(cache.expireCount, 2);
+    QVERIFY(!cache.metaData(url0).isValid());
+    QVERIFY(cache.metaData(url1).isValid());
+
+    qint64 size = 0;
+    foreach (const QString &path, countFiles(cache.cacheDirectory())) {
+        const QFileInfo info(path);
+        if (info.isFile() && path.endsWith(".d"))
+            size += info.size();
+    }
+    QVERIFY(size > 0);
+    QCOMPARE(cache.cacheSize(), size);
+}
+
+void tst_QNetworkDiskCache::sharedDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl url0("http://localhost:4/0");
+    const QUrl url1("http://localhost:4/1");
+    const QUrl url2("http://localhost:4/2");
+
+    QScopedPointer<QNetworkDiskCache> first(new QNetworkDiskCache);
+    first->setCacheDirectory(dir.path());
+    QScopedPointer<QNetworkDiskCache> second(new QNetworkDiskCache);
+    second->setCacheDirectory(dir.path());
+    // waits for the scans of the empty directory
+    QCOMPARE(first->cacheSize(), qint64(0));
+    QCOMPARE(second->cacheSize(), qint64(0));
+    insertItem(first.data(), url0);
+    const qint64 itemSize = first->cacheSize();
+    QVERIFY(itemSize > 0);
+    insertItem(second.data(), url1);
+    QCOMPARE(second->cacheSize(), itemSize);
+
+    // a file the other cache wrote is found, and counted from then on
+    insertItem(first.data(), url2);
+    QVERIFY(second->metaData(url2).isValid());
+    QCOMPARE(second->cacheSize(), 2 * itemSize);
+
+    // each cache saves its index when it is closed, the second one must
+    // not drop the file only the first one knows about
+    const QString indexFile = indexFileName(first->cacheDirectory());
+    first.reset();
+    QVERIFY(QFile::exists(indexFile));
+    second.reset();
+
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), 3 * itemSize);
+    QVERIFY(cache.metaData(url0).isValid());
+    QVERIFY(cache.metaData(url1).isValid());
+    QVERIFY(cache.metaData(url2).isValid());
+
+    // and expiring the cache removes all of them
+    cache.clear();
+    QCOMPARE(cache.cacheSize(), qint64(0));
+    foreach (const QString &path, countFiles(cache.cacheDirectory()))
+        QVERIFY2(!path.endsWith(".d"), qPrintable(path));
+}
+
+void tst_QNetworkDiskCache::staleIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl url0("http://localhost:4/0");
+    const QUrl url1("http://localhost:4/1");
+
+    qint64 itemSize;
+    QString indexFile;
+    QByteArray savedIndex;
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        insertItem(&cache, url0);
+        itemSize = cache.cacheSize();
+        indexFile = indexFileName(cache.cacheDirectory());
+    }
+    {
+        QFile file(indexFile);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        savedIndex = file.readAll();
+    }
+
+    // file systems may only store whole seconds
+    QTest::qWait(1100);
+
+    // another cache adds a file, and crashes, leaving the old index behind
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        insertItem(&cache, url1);
+    }
+    QFile file(indexFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(savedIndex);
+    file.close();
+
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), 2 * itemSize);
+    QVERIFY(cache.metaData(url0).isValid());
+    QVERIFY(cache.metaData(url1).isValid());
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
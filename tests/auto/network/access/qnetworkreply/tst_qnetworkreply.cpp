@@ -65,6 +65,7 @@
 #include <QtNetwork/qsslconfiguration.h>
 #ifdef QT_BUILD_INTERNAL
 #include <QtNetwork/private/qsslconfiguration_p.h>
+#include <QtNetwork/private/qsslsessioncache_p.h>
 #endif
 #endif
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -318,6 +319,7 @@ private Q_SLOTS:
 #endif // !QT_NO_NETWORKPROXY
     void ioPostToHttpFromMiddleOfFileToEnd();
     void ioPostToHttpFromMiddleOfFileFiveBytes();
+    void ioPostToHttpFromMiddleOfLargeFile();
     void ioPostToHttpFromMiddleOfQBufferFiveBytes();
     void ioPostToHttpNoBufferFlag();
     void ioPostToHttpUploadProgress();
@@ -388,6 +390,9 @@ private Q_SLOTS:
     void sslSessionSharing();
     void sslSessionSharingFromPersistentSession_data();
     void sslSessionSharingFromPersistentSession();
+    void sslSessionCachePersistence_data();
+    void sslSessionCachePersistence();
+    void sslSessionCacheIgnoredErrors();
 #endif
 #endif
 
@@ -401,6 +406,7 @@ private Q_SLOTS:
     void getFromHttpIntoBuffer2_data();
     void getFromHttpIntoBuffer2();
     void getFromHttpIntoBufferCanReadLine();
+    void readChunksFromHttp();
 
     void ioGetFromHttpWithoutContentLength();
 
@@ -4685,6 +4691,62 @@ void tst_QNetworkReply::ioPostToHttpFromMiddleOfFileFiveBytes()
     QCOMPARE(reply->readAll().trimmed(), md5sum(data).toHex());
 }
 
+void tst_QNetworkReply::ioPostToHttpFromMiddleOfLargeFile()
+{
+    // larger than the socket buffers, so that the upload has to be resumed
+    QFile sourceFile(testDataDir + "/image1.jpg");
+    QVERIFY(sourceFile.open(QIODevice::ReadOnly));
+    const qint64 offset = 1000;
+    QVERIFY(sourceFile.seek(offset));
+    const QByteArray expected = sourceFile.readAll();
+    QVERIFY(sourceFile.seek(offset));
+
+    // emulate a minimal http server
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress(QHostAddress::LocalHost), 0));
+    connect(&server, SIGNAL(newConnection()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+
+    QUrl url = QUrl(QString("http://127.0.0.1:%1/").arg(server.serverPort()));
+    QNetworkRequest request(url);
+    request.setRawHeader("Content-Type", "application/octet-stream");
+    QNetworkReplyPtr reply(manager.post(request, &sourceFile));
+    QSignalSpy spy(reply.data(), SIGNAL(uploadProgress(qint64,qint64)));
+
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QTcpSocket *incomingSocket = server.nextPendingConnection();
+    QVERIFY(incomingSocket);
+    disconnect(&server, SIGNAL(newConnection()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+
+    QByteArray received;
+    int headerEnd = -1;
+    QElapsedTimer timer;
+    timer.start();
+    while ((headerEnd == -1 || received.size() - headerEnd - 4 < expected.size())
+           && timer.elapsed() < 20000) {
+        QTest::qWait(10);
+        received += incomingSocket->readAll();
+        if (headerEnd == -1)
+            headerEnd = received.indexOf("\r\n\r\n");
+    }
+    QVERIFY(headerEnd != -1);
+    QVERIFY(received.left(headerEnd).contains("Content-Length: " + QByteArray::number(expected.size())));
+    QCOMPARE(received.mid(headerEnd + 4), expected);
+    QTRY_VERIFY(!spy.isEmpty() && spy.last().at(0).toLongLong() == expected.size());
+    QCOMPARE(spy.last().at(1).toLongLong(), qint64(expected.size()));
+
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+    incomingSocket->write("HTTP/1.0 200 OK\r\n");
+    incomingSocket->write("Content-Length: 0\r\n");
+    incomingSocket->write("\r\n");
+    QTestEventLoop::instance().enterLoop(10);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    incomingSocket->close();
+    server.close();
+}
+
 void tst_QNetworkReply::ioPostToHttpFromMiddleOfQBufferFiveBytes()
 {
     // test needed since a QBuffer goes with a different codepath than the QFile
@@ -6279,6 +6341,63 @@ void tst_QNetworkReply::sslSessionSharingFromPersistentSession()
     QCOMPARE(sessionPersistenceEnabled, sslSessionSharingWasUsedInReply);
 }
 
+void tst_QNetworkReply::sslSessionCachePersistence_data()
+{
+    QTest::addColumn<bool>("sessionPersistenceEnabled");
+    QTest::newRow("enabled") << true;
+    QTest::newRow("disabled") << false;
+}
+
+void tst_QNetworkReply::sslSessionCachePersistence()
+{
+    QSslSessionCache *sessionCache = QSslSessionCache::instance();
+    sessionCache->clear();
+    const qint64 insertions = sessionCache->statistics().insertions;
+
+    QNetworkRequest request(QUrl("https://" + QtNetworkSettings::serverName()));
+    QSslConfiguration configuration;
+    configuration.setCaCertificates(QSslCertificate::fromPath(testDataDir + "/certs/qt-test-server-cacert.pem"));
+    QFETCH(bool, sessionPersistenceEnabled);
+    configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, !sessionPersistenceEnabled);
+    request.setSslConfiguration(configuration);
+
+    // a new manager, so that no connection to the server is reused
+    QNetworkAccessManager newManager;
+    QNetworkReplyPtr reply(newManager.get(request));
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    // the session is only cached, and handed out, if the application
+    // allows it to be persisted
+    QCOMPARE(!reply->sslConfiguration().sessionTicket().isEmpty(), sessionPersistenceEnabled);
+    QCOMPARE(sessionCache->statistics().insertions > insertions, sessionPersistenceEnabled);
+    QCOMPARE(sessionCache->size(), sessionPersistenceEnabled ? 1 : 0);
+}
+
+void tst_QNetworkReply::sslSessionCacheIgnoredErrors()
+{
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\nok", true);
+    server.doClose = true;
+
+    QSslSessionCache *sessionCache = QSslSessionCache::instance();
+    sessionCache->clear();
+    const qint64 insertions = sessionCache->statistics().insertions;
+
+    // the server's certificate is not trusted, so the handshake only
+    // succeeds because the errors are ignored
+    QNetworkRequest request(QUrl("https://127.0.0.1:" + QString::number(server.serverPort())));
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    request.setSslConfiguration(configuration);
+    QNetworkReplyPtr reply(manager.get(request));
+    reply->ignoreSslErrors();
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->readAll(), QByteArray("ok"));
+
+    // so its session must not be offered to other clients
+    QCOMPARE(sessionCache->statistics().insertions, insertions);
+    QCOMPARE(sessionCache->size(), 0);
+}
+
 #endif // QT_BUILD_INTERNAL
 #endif // QT_NO_SSL
 
@@ -6580,6 +6699,35 @@ void tst_QNetworkReply::getFromHttpIntoBufferCanReadLine()
     QVERIFY(!reply->canReadLine());
 }
 
+void tst_QNetworkReply::readChunksFromHttp()
+{
+    QByteArray content;
+    for (int i = 0; i < 100; ++i)
+        content += QByteArray(1000, char('a' + i % 26));
+    MiniHttpServer server("HTTP/1.0 200 OK\r\nContent-Length: "
+                          + QByteArray::number(content.size()) + "\r\n\r\n" + content);
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->bytesAvailable(), qint64(content.size()));
+
+    // a partial read through the QIODevice buffer, then chunks from the download buffer
+    QCOMPARE(reply->read(10), content.left(10));
+    QByteArrayList chunks = reply->readChunks(5000);
+    QByteArray data = chunks.join();
+    QCOMPARE(data, content.mid(10, 5000));
+    QCOMPARE(reply->bytesAvailable(), qint64(content.size() - 5010));
+
+    chunks = reply->readChunks();
+    QCOMPARE(chunks.join(), content.mid(5010));
+    QCOMPARE(reply->bytesAvailable(), qint64(0));
+    QVERIFY(reply->readChunks().isEmpty());
+}
+
 
 
 // Is handled somewhere else too, introduced this special test to have it more accessible
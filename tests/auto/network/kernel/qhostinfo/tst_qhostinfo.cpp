@@ -124,6 +124,9 @@ private slots:
     void multipleDifferentLookups();
 
     void cache();
+    void cacheConfiguration();
+    void negativeCache();
+    void prefetchHost();
 
     void abortHostLookup();
 protected slots:
@@ -585,6 +588,117 @@ void tst_QHostInfo::cache()
     QCOMPARE(lookupsDoneCounter, 2);
 }
 
+void tst_QHostInfo::cacheConfiguration()
+{
+    QCOMPARE(QHostInfo::maximumCacheSize(), 128);
+    QCOMPARE(QHostInfo::cacheTimeToLive(), 60);
+    QCOMPARE(QHostInfo::negativeCacheTimeToLive(), 0);
+
+    QHostInfo::setMaximumCacheSize(1000);
+    QHostInfo::setCacheTimeToLive(300);
+    QHostInfo::setNegativeCacheTimeToLive(5);
+    QCOMPARE(QHostInfo::maximumCacheSize(), 1000);
+    QCOMPARE(QHostInfo::cacheTimeToLive(), 300);
+    QCOMPARE(QHostInfo::negativeCacheTimeToLive(), 5);
+
+    QHostInfo::setCacheTimeToLive(-1);
+    QCOMPARE(QHostInfo::cacheTimeToLive(), 0);
+
+    QHostInfo::setMaximumCacheSize(128);
+    QHostInfo::setCacheTimeToLive(60);
+    QHostInfo::setNegativeCacheTimeToLive(0);
+}
+
+void tst_QHostInfo::negativeCache()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    const QString name = QStringLiteral("invalid" TEST_DOMAIN);
+    QHostInfo notFound;
+    notFound.setHostName(name);
+    notFound.setError(QHostInfo::HostNotFound);
+
+    // failures are not cached by default
+    qt_qhostinfo_cache_inject(name, notFound);
+    qt_qhostinfo_reset_cache_statistics();
+    bool valid = true;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup(name, 0, 0, &valid, &id);
+    QVERIFY(!valid);
+    QHostInfo::abortHostLookup(id);
+
+    QHostInfo::setNegativeCacheTimeToLive(60);
+    qt_qhostinfo_cache_inject(name, notFound);
+    result = qt_qhostinfo_lookup(name, 0, 0, &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.error(), QHostInfo::HostNotFound);
+
+    // other errors may go away by themselves
+    QHostInfo unknownError;
+    unknownError.setHostName(QStringLiteral("other") + name);
+    unknownError.setError(QHostInfo::UnknownError);
+    qt_qhostinfo_cache_inject(unknownError.hostName(), unknownError);
+    result = qt_qhostinfo_lookup(unknownError.hostName(), 0, 0, &valid, &id);
+    QVERIFY(!valid);
+    QHostInfo::abortHostLookup(id);
+
+    QHostInfoCache::Statistics stats = qt_qhostinfo_cache_statistics();
+    QCOMPARE(stats.lookups, qint64(3));
+    QCOMPARE(stats.hits, qint64(1));
+    QCOMPARE(stats.negativeHits, qint64(1));
+
+    // entries expire with the current setting
+    QHostInfo::setNegativeCacheTimeToLive(0);
+    result = qt_qhostinfo_lookup(name, 0, 0, &valid, &id);
+    QVERIFY(!valid);
+    QHostInfo::abortHostLookup(id);
+}
+
+void tst_QHostInfo::prefetchHost()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    qt_qhostinfo_reset_cache_statistics();
+    lookupsDoneCounter = 0;
+
+    QHostInfo::prefetchHost("localhost");
+    QCOMPARE(qt_qhostinfo_cache_statistics().prefetches, qint64(1));
+
+    // either waits for the prefetch or finds its result
+    QHostInfo::lookupHost("localhost", this, SLOT(resultsReady(QHostInfo)));
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(lookupsDoneCounter, 1);
+    QVERIFY(!lookupResults.addresses().isEmpty());
+    QHostInfoCache::Statistics stats = qt_qhostinfo_cache_statistics();
+    QCOMPARE(stats.coalescedLookups + stats.hits, qint64(1));
+
+    // nothing to do for a cached name
+    QHostInfo::prefetchHost("localhost");
+    QCOMPARE(qt_qhostinfo_cache_statistics().prefetches, qint64(1));
+
+    // entries in use are refreshed shortly before they expire
+    QHostInfo::setCacheTimeToLive(1);
+    qt_qhostinfo_clear_cache();
+    qt_qhostinfo_reset_cache_statistics();
+    bool valid = true;
+    int id = -1;
+    qt_qhostinfo_lookup("localhost", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QTest::qWait(850);
+    qt_qhostinfo_lookup("localhost", this, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QHostInfo::setCacheTimeToLive(60);
+    if (!valid)
+        QSKIP("The system is too slow to test refreshing entries");
+    QCOMPARE(qt_qhostinfo_cache_statistics().prefetches, qint64(1));
+}
+
 void tst_QHostInfo::resultsReady(const QHostInfo &hi)
 {
     lookupDone = true;
@@ -60,6 +60,7 @@
 #include <QPointer>
 #include <QProcess>
 #include <QStringList>
+#include <QTemporaryFile>
 #include <QTcpServer>
 #include <QTcpSocket>
 #ifndef QT_NO_SSL
@@ -201,6 +202,8 @@ private slots:
     void setSocketOption();
     void clientSendDataOnDelayedDisconnect();
     void serverDisconnectWithBuffered();
+    void sendFile();
+    void sendFilePartialWrite();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3030,5 +3033,125 @@ void tst_QTcpSocket::serverDisconnectWithBuffered()
     delete socket;
 }
 
+static qint64 bytesWrittenTotal(const QSignalSpy &spy)
+{
+    qint64 total = 0;
+    for (int i = 0; i < spy.count(); ++i)
+        total += spy.at(i).at(0).toLongLong();
+    return total;
+}
+
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return; //proxy not useful for localhost test case
+
+    // more than the socket buffers take, so that sendFile() has to be called again
+    QByteArray expected;
+    for (int i = 0; expected.size() < 4 * 1024 * 1024; ++i)
+        expected += QByteArray::number(i) + ' ';
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write("header"), qint64(6));
+    QCOMPARE(file.write(expected), qint64(expected.size()));
+    QVERIFY(file.seek(6));
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(peer);
+
+    QSignalSpy bytesWrittenSpy(socket, SIGNAL(bytesWritten(qint64)));
+    QByteArray received;
+    qint64 sent = 0;
+    while (received.size() < expected.size()) {
+        if (sent < expected.size()) {
+            const qint64 n = socket->sendFile(&file, 256 * 1024);
+            QVERIFY(n >= 0);
+            sent += n;
+            QCOMPARE(file.pos(), 6 + sent);
+        }
+        socket->flush();
+        QVERIFY(peer->waitForReadyRead(5000));
+        received += peer->readAll();
+    }
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->sendFile(&file, 1024), qint64(0));
+
+    // bytesWritten() is emitted for the data sent from the file, too
+    QTRY_COMPARE(bytesWrittenTotal(bytesWrittenSpy), qint64(expected.size()));
+
+    delete socket;
+}
+
+// Takes at most writeLimit bytes in total
+class LimitedWriteSocket : public QTcpSocket
+{
+public:
+    LimitedWriteSocket() : writeLimit(0) {}
+    qint64 writeLimit;
+
+protected:
+    qint64 writeData(const char *data, qint64 size) Q_DECL_OVERRIDE
+    {
+        const qint64 n = qMin(size, writeLimit);
+        if (n <= 0)
+            return 0;
+        writeLimit -= n;
+        return QTcpSocket::writeData(data, n);
+    }
+};
+
+void tst_QTcpSocket::sendFilePartialWrite()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return; //proxy not useful for localhost test case
+
+    QByteArray expected;
+    for (int i = 0; expected.size() < 64 * 1024; ++i)
+        expected += QByteArray::number(i) + ' ';
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(expected), qint64(expected.size()));
+    file.close();
+    // in text mode the data is copied through write()
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    LimitedWriteSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(socket.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *peer = server.nextPendingConnection();
+    QVERIFY(peer);
+
+    // the part of a block the socket did not take stays in the file
+    socket.writeLimit = 20000;
+    QCOMPARE(socket.sendFile(&file, expected.size()), qint64(20000));
+    QCOMPARE(file.pos(), qint64(20000));
+    QCOMPARE(socket.sendFile(&file, expected.size()), qint64(0));
+    QCOMPARE(file.pos(), qint64(20000));
+
+    socket.writeLimit = expected.size();
+    QCOMPARE(socket.sendFile(&file, expected.size()), qint64(expected.size() - 20000));
+    QVERIFY(file.atEnd());
+
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        socket.flush();
+        QVERIFY(peer->waitForReadyRead(5000));
+        received += peer->readAll();
+    }
+    QCOMPARE(received, expected);
+    delete peer;
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
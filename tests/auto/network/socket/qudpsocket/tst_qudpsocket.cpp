@@ -89,6 +89,7 @@ private slots:
     void bindAndConnectToHost();
     void pendingDatagramSize();
     void writeDatagram();
+    void readWriteDatagrams();
     void performance();
     void bindMode();
     void writeDatagramToNonExistingPeer_data();
@@ -760,6 +761,65 @@ void tst_QUdpSocket::writeDatagram()
     }
 }
 
+void tst_QUdpSocket::readWriteDatagrams()
+{
+    QUdpSocket server;
+#ifdef FORCE_SESSION
+    server.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY2(server.bind(), server.errorString().toLatin1().constData());
+
+    QHostAddress serverAddress = makeNonAny(server.localAddress());
+    QUdpSocket client;
+#ifdef FORCE_SESSION
+    client.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+
+    QByteArrayList datagrams;
+    qint64 totalSize = 0;
+    for (int i = 0; i < 100; ++i) {
+        datagrams << QByteArray(i + 1, char('a' + i % 26));
+        totalSize += i + 1;
+    }
+
+    QSignalSpy bytesspy(&client, SIGNAL(bytesWritten(qint64)));
+    QCOMPARE(client.writeDatagrams(datagrams, serverAddress, server.localPort()), datagrams.size());
+    QCOMPARE(bytesspy.count(), 1);
+    QCOMPARE(bytesspy.at(0).at(0).toLongLong(), totalSize);
+
+    QByteArrayList received;
+    QList<QHostAddress> hosts;
+    QList<quint16> ports;
+    while (received.size() < datagrams.size()) {
+        if (!server.hasPendingDatagrams() && !server.waitForReadyRead(5000))
+            break;
+        QVERIFY(server.readDatagrams(&received, datagrams.size() - received.size(), 1024,
+                                     &hosts, &ports) >= 0);
+    }
+    if (received.size() < datagrams.size())
+        QSKIP("UDP packets lost, unable to complete the test.");
+    QCOMPARE(received, datagrams);
+    QCOMPARE(hosts.size(), datagrams.size());
+    QCOMPARE(ports.size(), datagrams.size());
+    for (int i = 0; i < ports.size(); ++i)
+        QCOMPARE(ports.at(i), client.localPort());
+
+    // Nothing left
+    QCOMPARE(server.readDatagrams(&received, 10, 1024), 0);
+
+    // Datagrams longer than maxSize are truncated
+    QCOMPARE(client.writeDatagrams(QByteArrayList() << QByteArray(100, 'x') << QByteArray("y"),
+                                   serverAddress, server.localPort()), 2);
+    received.clear();
+    while (received.size() < 2) {
+        if (!server.hasPendingDatagrams() && !server.waitForReadyRead(5000))
+            QSKIP("UDP packets lost, unable to complete the test.");
+        QVERIFY(server.readDatagrams(&received, 2 - received.size(), 10) >= 0);
+    }
+    QCOMPARE(received.at(0), QByteArray(10, 'x'));
+    QCOMPARE(received.at(1), QByteArray("y"));
+}
+
 void tst_QUdpSocket::performance()
 {
     QByteArray arr(8192, '@');
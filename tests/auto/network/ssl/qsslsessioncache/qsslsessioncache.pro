@@ -0,0 +1,7 @@
+CONFIG += testcase
+CONFIG += parallel_test
+
+SOURCES += tst_qsslsessioncache.cpp
+QT = core network network-private testlib
+
+TARGET = tst_qsslsessioncache
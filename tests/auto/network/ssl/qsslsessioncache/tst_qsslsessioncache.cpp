@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QSslCertificate>
+#include <QtNetwork/QSslConfiguration>
+#include "private/qsslsessioncache_p.h"
+
+static QByteArray key(const QString &host, quint16 port, const QString &peerName = QString(),
+                      const QSslConfiguration &configuration = QSslConfiguration())
+{
+    return QSslSessionCache::key(host, port, peerName, configuration);
+}
+
+class tst_QSslSessionCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findAndInsert();
+    void keys();
+    void configurationKeys();
+    void eviction();
+    void expiry();
+    void disabled();
+    void statistics();
+    void globalInstance();
+};
+
+void tst_QSslSessionCache::findAndInsert()
+{
+    QSslSessionCache cache;
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.find(key("example.com", 443)).isEmpty());
+
+    cache.insert(key("example.com", 443), "session1");
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.find(key("example.com", 443)), QByteArray("session1"));
+
+    // Newer sessions replace older ones
+    cache.insert(key("example.com", 443), "session2");
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.find(key("example.com", 443)), QByteArray("session2"));
+
+    // Empty sessions are not stored
+    cache.insert(key("example.org", 443), QByteArray());
+    QCOMPARE(cache.size(), 1);
+
+    cache.remove(key("example.com", 443));
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.find(key("example.com", 443)).isEmpty());
+
+    cache.insert(key("example.com", 443), "session3");
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+}
+
+void tst_QSslSessionCache::keys()
+{
+    QSslSessionCache cache;
+    cache.insert(key("example.com", 443), "a");
+    cache.insert(key("example.com", 8443), "b");
+    cache.insert(key("example.com", 443, "www.example.com"), "c");
+
+    QCOMPARE(cache.size(), 3);
+    QCOMPARE(cache.find(key("EXAMPLE.com", 443)), QByteArray("a"));
+    QCOMPARE(cache.find(key("example.com", 8443)), QByteArray("b"));
+    QCOMPARE(cache.find(key("example.com", 443, "WWW.example.com")), QByteArray("c"));
+    QVERIFY(cache.find(key("example.org", 443)).isEmpty());
+}
+
+void tst_QSslSessionCache::configurationKeys()
+{
+    const QSslConfiguration defaults;
+    QCOMPARE(key("example.com", 443, QString(), defaults), key("example.com", 443));
+
+    // the session itself and whether it may be persisted do not matter
+    QSslConfiguration config = defaults;
+    config.setSessionTicket("ticket");
+    config.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    QCOMPARE(key("example.com", 443, QString(), config), key("example.com", 443));
+
+    // everything that changes the verification or the identity of the client does
+    config = defaults;
+    config.setPeerVerifyMode(QSslSocket::VerifyNone);
+    QVERIFY(key("example.com", 443, QString(), config) != key("example.com", 443));
+
+    config = defaults;
+    config.setProtocol(QSsl::TlsV1_2);
+    QVERIFY(key("example.com", 443, QString(), config) != key("example.com", 443));
+
+    config = defaults;
+    config.setSslOption(QSsl::SslOptionDisableSessionTickets, true);
+    QVERIFY(key("example.com", 443, QString(), config) != key("example.com", 443));
+
+    const QList<QSslCertificate> certificates =
+            QSslCertificate::fromPath(QFINDTESTDATA("../qsslsocket/certs/fluke.cert"));
+    if (certificates.isEmpty())
+        QSKIP("Test certificate not found");
+
+    config = defaults;
+    config.setCaCertificates(certificates);
+    QVERIFY(key("example.com", 443, QString(), config) != key("example.com", 443));
+
+    config = defaults;
+    config.setLocalCertificate(certificates.first());
+    const QByteArray clientKey = key("example.com", 443, QString(), config);
+    QVERIFY(clientKey != key("example.com", 443));
+
+    QSslSessionCache cache;
+    cache.insert(clientKey, "client");
+    QVERIFY(cache.find(key("example.com", 443)).isEmpty());
+    QCOMPARE(cache.find(clientKey), QByteArray("client"));
+}
+
+void tst_QSslSessionCache::eviction()
+{
+    QSslSessionCache cache(3);
+    QCOMPARE(cache.maximumSize(), 3);
+
+    cache.insert(key("a", 443), "a");
+    cache.insert(key("b", 443), "b");
+    cache.insert(key("c", 443), "c");
+    // Make "a" the most recently used entry
+    QVERIFY(!cache.find(key("a", 443)).isEmpty());
+
+    cache.insert(key("d", 443), "d");
+    QCOMPARE(cache.size(), 3);
+    QVERIFY(cache.find(key("b", 443)).isEmpty());
+    QCOMPARE(cache.find(key("a", 443)), QByteArray("a"));
+    QCOMPARE(cache.statistics().evictions, qint64(1));
+
+    cache.setMaximumSize(1);
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.statistics().evictions, qint64(3));
+}
+
+void tst_QSslSessionCache::expiry()
+{
+    QSslSessionCache cache;
+    cache.insert(key("example.com", 443), "session", 1);
+    QCOMPARE(cache.find(key("example.com", 443)), QByteArray("session"));
+    QTest::qWait(1100);
+    QVERIFY(cache.find(key("example.com", 443)).isEmpty());
+    QCOMPARE(cache.size(), 0);
+
+    // Sessions without a lifetime hint do not expire
+    cache.insert(key("example.com", 443), "session", 0);
+    QCOMPARE(cache.find(key("example.com", 443)), QByteArray("session"));
+}
+
+void tst_QSslSessionCache::disabled()
+{
+    QSslSessionCache cache(0);
+    cache.insert(key("example.com", 443), "session");
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.find(key("example.com", 443)).isEmpty());
+    QCOMPARE(cache.statistics().insertions, qint64(0));
+}
+
+void tst_QSslSessionCache::statistics()
+{
+    QSslSessionCache cache;
+    QSslSessionCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.lookups, qint64(0));
+    QCOMPARE(stats.hitRate(), 0.0);
+
+    cache.find(key("example.com", 443));
+    cache.insert(key("example.com", 443), "session");
+    cache.find(key("example.com", 443));
+    cache.find(key("example.com", 443));
+    cache.find(key("example.org", 443));
+
+    stats = cache.statistics();
+    QCOMPARE(stats.lookups, qint64(4));
+    QCOMPARE(stats.hits, qint64(2));
+    QCOMPARE(stats.misses(), qint64(2));
+    QCOMPARE(stats.insertions, qint64(1));
+    QCOMPARE(stats.evictions, qint64(0));
+    QCOMPARE(stats.hitRate(), 0.5);
+
+    cache.resetStatistics();
+    QCOMPARE(cache.statistics().lookups, qint64(0));
+    QCOMPARE(cache.size(), 1);
+}
+
+void tst_QSslSessionCache::globalInstance()
+{
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    QVERIFY(cache);
+    QCOMPARE(QSslSessionCache::instance(), cache);
+    QCOMPARE(cache->maximumSize(), int(QSslSessionCache::DefaultMaximumSize));
+}
+
+QTEST_MAIN(tst_QSslSessionCache)
+#include "tst_qsslsessioncache.moc"
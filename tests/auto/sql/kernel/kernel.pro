@@ -5,6 +5,7 @@ SUBDIRS=\
    qsqlerror \
    qsqldriver \
    qsqlquery \
+   qsqlquerypool \
    qsqlrecord \
    qsqlthread \
    qsql \
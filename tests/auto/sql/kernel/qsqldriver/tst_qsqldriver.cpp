@@ -57,6 +57,7 @@ private slots:
     void record();
     void primaryIndex();
     void formatValue();
+    void statementCache();
 };
 
 
@@ -228,5 +229,66 @@ void tst_QSqlDriver::formatValue()
     QCOMPARE(db.driver()->formatValue(rec.field("more_data")), QString("1.234567"));
 }
 
+void tst_QSqlDriver::statementCache()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    QSqlDriver *driver = db.driver();
+
+    QCOMPARE(driver->statementCacheSize(), 0);
+    driver->setStatementCacheSize(2);
+    if (driver->statementCacheSize() == 0)
+        QSKIP("The driver does not cache statements");
+    const qint64 hits = driver->statementCacheHits();
+    const qint64 misses = driver->statementCacheMisses();
+
+    const QString tablename(qTableName("relTEST1", __FILE__, db));
+    const QString select = "SELECT name FROM " + tablename + " WHERE id = ?";
+    const char *names[] = { "harry", "trond", "vohi", "boris" };
+    for (int i = 0; i < 4; ++i) {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(select));
+        q.addBindValue(i + 1);
+        QVERIFY_SQL(q, exec());
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString(), QString::fromLatin1(names[i]));
+    }
+    QCOMPARE(driver->statementCacheMisses() - misses, qint64(1));
+    QCOMPARE(driver->statementCacheHits() - hits, qint64(3));
+
+    // a statement used by another query is not shared
+    {
+        QSqlQuery q1(db);
+        QSqlQuery q2(db);
+        QVERIFY_SQL(q1, prepare(select));
+        QVERIFY_SQL(q2, prepare(select));
+        q1.addBindValue(1);
+        q2.addBindValue(2);
+        QVERIFY_SQL(q1, exec());
+        QVERIFY_SQL(q2, exec());
+        QVERIFY(q1.next());
+        QVERIFY(q2.next());
+        QCOMPARE(q1.value(0).toString(), QString::fromLatin1("harry"));
+        QCOMPARE(q2.value(0).toString(), QString::fromLatin1("trond"));
+    }
+    QCOMPARE(driver->statementCacheMisses() - misses, qint64(2));
+    QCOMPARE(driver->statementCacheHits() - hits, qint64(4));
+
+    // the least recently used statements are dropped
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, prepare("SELECT id FROM " + tablename + " WHERE id = 1"));
+    QVERIFY_SQL(q, prepare("SELECT id FROM " + tablename + " WHERE id = 2"));
+    QVERIFY_SQL(q, prepare("SELECT id FROM " + tablename + " WHERE id = 1"));
+    QVERIFY_SQL(q, prepare(select));
+    QCOMPARE(driver->statementCacheMisses() - misses, qint64(5));
+    QCOMPARE(driver->statementCacheHits() - hits, qint64(5));
+
+    driver->setStatementCacheSize(0);
+    QCOMPARE(driver->statementCacheSize(), 0);
+    QVERIFY_SQL(q, prepare(select));
+    QCOMPARE(driver->statementCacheMisses() - misses, qint64(5));
+}
+
 QTEST_MAIN(tst_QSqlDriver)
 #include "tst_qsqldriver.moc"
@@ -151,7 +151,9 @@ private slots:
     void batchExec();
     void QTBUG_43874_data() { generic_data(); }
     void QTBUG_43874();
-    void oraArrayBind_data() { generic_data(); }
+    void batchExecRollback_data() { generic_data(); }
+    void batchExecRollback();
+    void oraArrayBind_data() { generic_data("QOCI"); }
     void oraArrayBind();
     void lastInsertId_data() { generic_data(); }
     void lastInsertId();
@@ -241,6 +243,9 @@ private slots:
 
     void aggregateFunctionTypes_data() { generic_data(); }
     void aggregateFunctionTypes();
+
+    void fetchBatch_data() { generic_data(); }
+    void fetchBatch();
 private:
     // returns all database connections
     void generic_data(const QString &engine=QString());
@@ -2219,6 +2224,64 @@ void tst_QSqlQuery::QTBUG_43874()
     QCOMPARE(q.value(0).toInt(), 1);
 }
 
+void tst_QSqlQuery::batchExecRollback()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QSqlDriver::DbmsType dbType = tst_Databases::getDatabaseType(db);
+    if (dbType != QSqlDriver::SQLite && dbType != QSqlDriver::PostgreSQL)
+        QSKIP("Only SQLite and PostgreSQL run a batch in a transaction");
+
+    QSqlQuery q( db );
+    const QString tableName = qTableName("qtest_batch_rollback", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int primary key, name varchar(20))"));
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " (id, name) values (?, ?)"));
+
+    QVariantList ids;
+    QVariantList names;
+    for (int i = 0; i < 5000; ++i) {
+        ids << i;
+        names << QString("name%1").arg(i);
+    }
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    QVERIFY_SQL(q, execBatch());
+
+    // the duplicate key fails the last row, none of the rows may be inserted
+    ids.clear();
+    ids << 10000 << 10001 << 0;
+    names.clear();
+    names << "a" << "b" << "c";
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    QVERIFY(!q.execBatch());
+
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 5000);
+
+    // inside a transaction, the rows are left to the caller's transaction
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " (id, name) values (?, ?)"));
+    QVERIFY(db.transaction());
+    ids.clear();
+    ids << 20000 << 20001;
+    names.clear();
+    names << "d" << "e";
+    q.addBindValue(ids);
+    q.addBindValue(names);
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY(db.rollback());
+
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 5000);
+    q.clear();
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 void tst_QSqlQuery::oraArrayBind()
 {
     QFETCH( QString, dbName );
@@ -3974,5 +4037,64 @@ void tst_QSqlQuery::aggregateFunctionTypes()
     }
 }
 
+void tst_QSqlQuery::fetchBatch()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    for (int forwardOnly = 0; forwardOnly < 2; ++forwardOnly) {
+        QSqlQuery q(db);
+        q.setForwardOnly(forwardOnly);
+        QSqlColumnBatch batch;
+        QCOMPARE(q.fetchBatch(&batch, 10), 0);
+
+        QVERIFY_SQL(q, exec("select id, t_varchar from " + qtest + " order by id"));
+        QCOMPARE(q.fetchBatch(&batch, 2), 2);
+        QCOMPARE(batch.columnCount(), 2);
+        QCOMPARE(batch.rowCount(), 2);
+        QCOMPARE(batch.columnType(1), QSqlColumnBatch::String);
+        QCOMPARE(batch.value(0, 0).toInt(), 1);
+        QCOMPARE(batch.value(1, 0).toInt(), 2);
+        QCOMPARE(batch.stringValue(0, 1).toString(), QString("VarChar1"));
+        QCOMPARE(batch.stringValue(1, 1).toString(), QString("VarChar2"));
+
+        // the query is positioned on the last row of the batch
+        QCOMPARE(q.at(), 1);
+        QCOMPARE(q.value(0).toInt(), 2);
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 3);
+
+        QCOMPARE(q.fetchBatch(&batch, 10), 2);
+        QCOMPARE(batch.rowCount(), 2);
+        QCOMPARE(batch.value(0, 0).toInt(), 4);
+        QCOMPARE(batch.value(1, 0).toInt(), 5);
+        QCOMPARE(q.at(), int(QSql::AfterLastRow));
+
+        QCOMPARE(q.fetchBatch(&batch, 10), 0);
+        QCOMPARE(batch.rowCount(), 0);
+        QVERIFY(!q.next());
+        QVERIFY(!q.fetchBatch(&batch, 0));
+    }
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, exec("select id, t_varchar from " + qTableName("qtest_null", __FILE__, db) + " order by id"));
+    QSqlColumnBatch batch;
+    QCOMPARE(q.fetchBatch(&batch, 3), 3);
+    QVERIFY(batch.isNull(0, 1));
+    QVERIFY(!batch.isNull(1, 1));
+    QVERIFY(!batch.isNull(2, 1));
+    QVERIFY(batch.value(0, 1).isNull());
+    QCOMPARE(batch.stringValue(1, 1).toString(), QString("n"));
+    QCOMPARE(batch.stringValue(2, 1).toString(), QString("i"));
+    QCOMPARE(batch.nullFlags(1).count(true), 1);
+
+    QCOMPARE(q.fetchBatch(&batch, 3), 1);
+    QCOMPARE(batch.value(0, 0).toInt(), 3);
+    QVERIFY(batch.isNull(0, 1));
+    QCOMPARE(q.at(), int(QSql::AfterLastRow));
+}
+
 QTEST_MAIN( tst_QSqlQuery )
 #include "tst_qsqlquery.moc"
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlquerypool
+SOURCES  += tst_qsqlquerypool.cpp
+
+QT = core sql testlib core-private sql-private
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+#include "../qsqldatabase/tst_databases.h"
+
+class tst_QSqlQueryPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    void recreateTestTable(QSqlDatabase db);
+
+    tst_Databases dbs;
+
+public slots:
+    void initTestCase_data();
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void exec();
+    void error();
+    void manyQueries();
+    void futureWatcher();
+};
+
+void tst_QSqlQueryPool::initTestCase_data()
+{
+    QVERIFY(dbs.open());
+    if (dbs.fillTestTable() == 0)
+        QSKIP("No database drivers are available in this Qt configuration");
+}
+
+void tst_QSqlQueryPool::recreateTestTable(QSqlDatabase db)
+{
+    const QString tableName = qTableName("querypool", __FILE__, db);
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int, name varchar(20))"));
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " values (?, ?)"));
+    for (int i = 0; i < 100; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(QString("name%1").arg(i));
+        QVERIFY_SQL(q, exec());
+    }
+}
+
+void tst_QSqlQueryPool::initTestCase()
+{
+    foreach (const QString &dbname, dbs.dbNames)
+        recreateTestTable(QSqlDatabase::database(dbname));
+}
+
+void tst_QSqlQueryPool::cleanupTestCase()
+{
+    foreach (const QString &dbname, dbs.dbNames) {
+        QSqlDatabase db = QSqlDatabase::database(dbname);
+        tst_Databases::safeDropTable(db, qTableName("querypool", __FILE__, db));
+    }
+    dbs.close();
+}
+
+void tst_QSqlQueryPool::exec()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("querypool", __FILE__, db);
+
+    QSqlQueryPool pool(db);
+    QFuture<QSqlAsyncResult> future = pool.exec("select id, name from " + tableName
+                                                + " where id >= ? and id < ? order by id",
+                                                QVariantList() << 10 << 13);
+    future.waitForFinished();
+    const QSqlAsyncResult result = future.result();
+    QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+    QVERIFY(result.isSelect());
+    QCOMPARE(result.record().count(), 2);
+
+    const QSqlColumnBatch rows = result.rows();
+    QCOMPARE(rows.rowCount(), 3);
+    QCOMPARE(rows.value(0, 0).toInt(), 10);
+    QCOMPARE(rows.value(2, 0).toInt(), 12);
+    QCOMPARE(rows.stringValue(1, 1).toString(), QString("name11"));
+
+    QCOMPARE(pool.finishedQueryCount(), qint64(1));
+    QCOMPARE(pool.threadCount(), 1);
+}
+
+void tst_QSqlQueryPool::error()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryPool pool(db);
+    QFuture<QSqlAsyncResult> future = pool.exec("select * from "
+                                                + qTableName("querypool_none", __FILE__, db));
+    const QSqlAsyncResult result = future.result();
+    QVERIFY(!result.isActive());
+    QVERIFY(result.lastError().isValid());
+    QCOMPARE(result.rows().rowCount(), 0);
+}
+
+void tst_QSqlQueryPool::manyQueries()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName = qTableName("querypool", __FILE__, db);
+
+    QSqlQueryPool pool(db);
+    pool.setMaxThreadCount(3);
+    QCOMPARE(pool.maxThreadCount(), 3);
+
+    QList<QFuture<QSqlAsyncResult> > futures;
+    for (int i = 0; i < 30; ++i)
+        futures << pool.exec("select name from " + tableName + " where id = ?", QVariantList() << i);
+    QVERIFY(pool.threadCount() <= 3);
+    QVERIFY(pool.peakPendingQueryCount() >= 1);
+
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(pool.pendingQueryCount(), 0);
+    QCOMPARE(pool.activeQueryCount(), 0);
+    QCOMPARE(pool.finishedQueryCount(), qint64(30));
+    QVERIFY(pool.averageWaitTime() >= 0);
+
+    for (int i = 0; i < futures.count(); ++i) {
+        const QSqlAsyncResult result = futures.at(i).result();
+        QVERIFY2(result.isActive(), qPrintable(result.lastError().text()));
+        QCOMPARE(result.rows().rowCount(), 1);
+        QCOMPARE(result.rows().stringValue(0, 0).toString(), QString("name%1").arg(i));
+    }
+
+    pool.setMaxThreadCount(1);
+    QVERIFY(pool.exec("select count(*) from " + tableName).result().isActive());
+    // the other threads exit when they are woken up
+    QTRY_COMPARE(pool.threadCount(), 1);
+}
+
+void tst_QSqlQueryPool::futureWatcher()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryPool pool(db);
+    QFutureWatcher<QSqlAsyncResult> watcher;
+    QSignalSpy spy(&watcher, SIGNAL(finished()));
+    watcher.setFuture(pool.exec("select count(*) from " + qTableName("querypool", __FILE__, db)));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(watcher.result().rows().value(0, 0).toInt(), 100);
+}
+
+QTEST_MAIN(tst_QSqlQueryPool)
+#include "tst_qsqlquerypool.moc"
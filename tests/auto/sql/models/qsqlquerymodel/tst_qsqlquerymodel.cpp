@@ -75,6 +75,10 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void backgroundFetch_data() { generic_data(); }
+    void backgroundFetch();
+    void backgroundFetchExactRowCount_data() { generic_data(); }
+    void backgroundFetchExactRowCount();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -495,6 +499,69 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::backgroundFetch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryPool pool(db);
+    QSqlQueryModel model;
+    QSignalSpy modelResetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy columnsInsertedSpy(&model, SIGNAL(columnsInserted(QModelIndex,int,int)));
+    QSignalSpy rowsInsertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+
+    model.setQuery("select id, name from " + qTableName("many", __FILE__, db) + " order by id", &pool);
+    QCOMPARE(modelResetSpy.count(), 1);
+    QVERIFY(!model.canFetchMore());
+
+    QTRY_COMPARE(model.rowCount(), 2048);
+    QCOMPARE(columnsInsertedSpy.count(), 1);
+    QCOMPARE(model.columnCount(), 2);
+    QCOMPARE(model.record().fieldName(1).toLower(), QString("name"));
+    // the rows arrive in batches, not one by one
+    QVERIFY(rowsInsertedSpy.count() >= 1);
+    QVERIFY(rowsInsertedSpy.count() < 2048);
+    QCOMPARE(rowsInsertedSpy.first().at(1).toInt(), 0);
+    QCOMPARE(rowsInsertedSpy.last().at(2).toInt(), 2047);
+
+    QCOMPARE(model.data(model.index(0, 0)).toInt(), 0);
+    QCOMPARE(model.data(model.index(2047, 0)).toInt(), 2047);
+    QCOMPARE(model.data(model.index(1500, 1)).toString(), QString("harry"));
+    QVERIFY(!model.data(model.index(2048, 0)).isValid());
+    QCOMPARE(model.record(1025).value(0).toInt(), 1025);
+    QVERIFY(!model.lastError().isValid());
+
+    // a new query cancels the background fetch
+    model.setQuery("select id from " + qTableName("test", __FILE__, db) + " order by id", &pool);
+    QTRY_COMPARE(model.rowCount(), 2);
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.data(model.index(1, 0)).toInt(), 2);
+
+    model.setQuery("select * from " + qTableName("nosuchtable", __FILE__, db), &pool);
+    QTRY_VERIFY(model.lastError().isValid());
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void tst_QSqlQueryModel::backgroundFetchExactRowCount()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQueryPool pool(db);
+    QSqlQueryModel model;
+
+    model.setQuery("select id, name from " + qTableName("many", __FILE__, db) + " order by id", &pool,
+                   QSqlQueryModel::ExactRowCount);
+    QTRY_COMPARE(model.rowCount(), 2048);
+    QTRY_VERIFY(pool.pendingQueryCount() == 0 && pool.activeQueryCount() == 0);
+    QTRY_COMPARE(model.data(model.index(2047, 0)).toInt(), 2047);
+    QCOMPARE(model.rowCount(), 2048);
+    QVERIFY(!model.lastError().isValid());
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
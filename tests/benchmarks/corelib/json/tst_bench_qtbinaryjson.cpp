@@ -34,6 +34,8 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstreamreader.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -50,9 +52,14 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseJsonStream();
+    void parseJsonThroughput_data();
+    void parseJsonThroughput();
 
     void toByteArray();
     void fromByteArray();
+    void loadBinaryFile_data();
+    void loadBinaryFile();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -125,6 +132,77 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtBinaryJson::parseJsonStream()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    // same input as parseJson(), for comparing the throughput
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QJsonStreamReader::Name:
+            case QJsonStreamReader::String:
+                reader.text();
+                break;
+            case QJsonStreamReader::Number:
+            case QJsonStreamReader::Bool:
+                reader.value();
+                break;
+            default:
+                break;
+            }
+        }
+        QVERIFY(!reader.hasError());
+    }
+}
+
+void BenchmarkQtBinaryJson::parseJsonThroughput_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+    QJsonDocument testDocument = QJsonDocument::fromJson(testJson);
+
+    QJsonArray asciiStrings;
+    QJsonArray unicodeStrings;
+    for (int i = 0; i < 1000; ++i) {
+        QString string = QString("%1 the quick brown fox jumps over the lazy dog").arg(i).repeated(4);
+        asciiStrings.append(string);
+        unicodeStrings.append(string + QChar(0x0402));
+    }
+
+    QTest::newRow("test.json") << testJson;
+    QTest::newRow("compact") << testDocument.toJson(QJsonDocument::Compact);
+    QTest::newRow("indented") << testDocument.toJson(QJsonDocument::Indented);
+    QTest::newRow("ascii-strings") << QJsonDocument(asciiStrings).toJson(QJsonDocument::Compact);
+    QTest::newRow("unicode-strings") << QJsonDocument(unicodeStrings).toJson(QJsonDocument::Compact);
+}
+
+void BenchmarkQtBinaryJson::parseJsonThroughput()
+{
+    QFETCH(QByteArray, json);
+
+    // reported in bytes of JSON text per second instead of time per iteration
+    const int iterations = qMax(1, (64 << 20) / json.size());
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(!doc.isNull());
+    }
+    const qint64 elapsed = qMax<qint64>(timer.nsecsElapsed(), 1);
+    QTest::setBenchmarkResult(qreal(json.size()) * iterations * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -155,6 +233,44 @@ void BenchmarkQtBinaryJson::fromByteArray()
     }
 }
 
+void BenchmarkQtBinaryJson::loadBinaryFile_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::newRow("read") << false;
+    QTest::newRow("mapped") << true;
+}
+
+void BenchmarkQtBinaryJson::loadBinaryFile()
+{
+    // Example: a large prebuilt index shipped in binary form, loaded once
+    // and then only queried
+    QFETCH(bool, mapped);
+
+    QJsonArray array;
+    for (int i = 0; i < 100000; ++i) {
+        QJsonObject entry;
+        entry.insert(QStringLiteral("id"), i);
+        entry.insert(QStringLiteral("name"), QString::fromLatin1("entry %1").arg(i));
+        array.append(entry);
+    }
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(QJsonDocument(array).toBinaryData());
+    file.close();
+
+    QBENCHMARK {
+        QJsonDocument doc;
+        if (mapped) {
+            doc = QJsonDocument::fromMappedFile(file.fileName(), QJsonDocument::BypassValidation);
+        } else {
+            QFile f(file.fileName());
+            QVERIFY(f.open(QIODevice::ReadOnly));
+            doc = QJsonDocument::fromBinaryData(f.readAll(), QJsonDocument::BypassValidation);
+        }
+        QCOMPARE(doc.array().at(4242).toObject().value(QStringLiteral("id")).toInt(), 4242);
+    }
+}
+
 void BenchmarkQtBinaryJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -40,6 +40,52 @@ Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void queued_signal_throughput_data();
+    void queued_signal_throughput();
+};
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void valueChanged(int value);
+};
+
+class SignalProducer : public QThread
+{
+public:
+    SignalProducer(QObject *receiver, int count)
+        : receiver(receiver), count(count)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        Emitter emitter;
+        QObject::connect(&emitter, SIGNAL(valueChanged(int)), receiver, SLOT(receive(int)),
+                         Qt::QueuedConnection);
+        for (int i = 0; i < count; ++i)
+            emit emitter.valueChanged(i);
+    }
+
+private:
+    QObject *receiver;
+    int count;
+};
+
+class SignalReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    SignalReceiver() : received(0), expected(0) { }
+    int received;
+    int expected;
+
+public slots:
+    void receive(int)
+    {
+        if (++received == expected)
+            QCoreApplication::exit();
+    }
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -69,6 +115,43 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::queued_signal_throughput_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<int>("count");
+    QTest::newRow("1 thread, 100000 signals") << 1 << 100000;
+    QTest::newRow("2 threads, 100000 signals") << 2 << 100000;
+    QTest::newRow("4 threads, 100000 signals") << 4 << 100000;
+    QTest::newRow("8 threads, 100000 signals") << 8 << 100000;
+}
+
+// Several threads emit a signal that is connected to a slot in the main
+// thread with Qt::QueuedConnection, i.e. QMetaObject::activate() posts a
+// QMetaCallEvent to the main thread for every emission.
+void QCoreApplicationBenchmark::queued_signal_throughput()
+{
+    QFETCH(int, producers);
+    QFETCH(int, count);
+
+    QBENCHMARK {
+        SignalReceiver receiver;
+        receiver.expected = producers * count;
+
+        QList<SignalProducer *> threads;
+        for (int i = 0; i < producers; ++i)
+            threads << new SignalProducer(&receiver, count);
+        for (int i = 0; i < producers; ++i)
+            threads.at(i)->start();
+
+        QCoreApplication::exec();
+
+        for (int i = 0; i < producers; ++i)
+            threads.at(i)->wait();
+        qDeleteAll(threads);
+        QCOMPARE(receiver.received, receiver.expected);
+    }
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <qtest.h>
+
+class TimerOwner : public QObject
+{
+protected:
+    void timerEvent(QTimerEvent *) Q_DECL_OVERRIDE {}
+};
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void restartTimer_data();
+    void restartTimer();
+    void processEvents_data();
+    void processEvents();
+
+private:
+    void startBackgroundTimers(TimerOwner *owner, int count);
+};
+
+void tst_QTimer::startBackgroundTimers(TimerOwner *owner, int count)
+{
+    // per-connection style timeouts between 10 and 70 seconds, none of
+    // which expire while the benchmark runs
+    for (int i = 0; i < count; ++i)
+        owner->startTimer(10000 + (i * 7919) % 60000, Qt::PreciseTimer);
+}
+
+void tst_QTimer::restartTimer_data()
+{
+    QTest::addColumn<int>("activeTimers");
+    QTest::addColumn<int>("timerType");
+
+    const int counts[] = { 0, 1000, 10000, 100000 };
+    for (int i = 0; i < 4; ++i) {
+        QTest::newRow(QByteArray::number(counts[i]) + " precise") << counts[i] << int(Qt::PreciseTimer);
+        QTest::newRow(QByteArray::number(counts[i]) + " coarse") << counts[i] << int(Qt::CoarseTimer);
+    }
+}
+
+void tst_QTimer::restartTimer()
+{
+    QFETCH(int, activeTimers);
+    QFETCH(int, timerType);
+
+    TimerOwner background;
+    startBackgroundTimers(&background, activeTimers);
+
+    TimerOwner owner;
+    int interval = 30000;
+    QBENCHMARK {
+        // what restarting a timeout on every incoming packet amounts to
+        const int id = owner.startTimer(interval, Qt::TimerType(timerType));
+        owner.killTimer(id);
+        interval = interval % 50000 + 1;
+    }
+}
+
+void tst_QTimer::processEvents_data()
+{
+    QTest::addColumn<int>("activeTimers");
+
+    QTest::newRow("0") << 0;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_QTimer::processEvents()
+{
+    QFETCH(int, activeTimers);
+
+    TimerOwner background;
+    startBackgroundTimers(&background, activeTimers);
+
+    QBENCHMARK {
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "main.moc"
@@ -44,6 +44,8 @@ public:
 
 private slots:
     void startRunnables();
+    void startRunnablesFromWorkers_data();
+    void startRunnablesFromWorkers();
     void activeThreadCount();
 };
 
@@ -71,6 +73,74 @@ void tst_QThreadPool::startRunnables()
     }
 }
 
+class CountDownRunnable : public QRunnable
+{
+public:
+    CountDownRunnable(QAtomicInt *remaining, QSemaphore *done)
+        : remaining(remaining), done(done)
+    { }
+
+    void run() Q_DECL_OVERRIDE {
+        if (!remaining->deref())
+            done->release();
+    }
+
+private:
+    QAtomicInt *remaining;
+    QSemaphore *done;
+};
+
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(QThreadPool *pool, int count, QAtomicInt *remaining, QSemaphore *done)
+        : pool(pool), count(count), remaining(remaining), done(done)
+    { }
+
+    void run() Q_DECL_OVERRIDE {
+        for (int i = 0; i < count; ++i)
+            pool->start(new CountDownRunnable(remaining, done));
+    }
+
+private:
+    QThreadPool *pool;
+    int count;
+    QAtomicInt *remaining;
+    QSemaphore *done;
+};
+
+void tst_QThreadPool::startRunnablesFromWorkers_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("runnablesPerThread");
+
+    const int idealThreadCount = qMax(QThread::idealThreadCount(), 1);
+    QTest::newRow("1 thread, 10000 runnables") << 1 << 10000;
+    QTest::newRow("ideal threads, 1000 runnables") << idealThreadCount << 1000;
+    QTest::newRow("ideal threads, 10000 runnables") << idealThreadCount << 10000;
+    QTest::newRow("2x ideal threads, 10000 runnables") << 2 * idealThreadCount << 10000;
+}
+
+// every worker starts a flood of tiny runnables, as QtConcurrent-style
+// recursive algorithms do; this is where the pool's queue is contended
+void tst_QThreadPool::startRunnablesFromWorkers()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, runnablesPerThread);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        QAtomicInt remaining(threadCount * runnablesPerThread);
+        QSemaphore done;
+        for (int i = 0; i < threadCount; ++i)
+            threadPool.start(new SpawningRunnable(&threadPool, runnablesPerThread, &remaining, &done));
+        done.acquire();
+    }
+    threadPool.waitForDone();
+}
+
 void tst_QThreadPool::activeThreadCount()
 {
     QThreadPool threadPool;
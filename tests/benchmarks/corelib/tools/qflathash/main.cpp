@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QMap>
+#include <QTest>
+#include <QVector>
+
+#include <algorithm>
+
+enum ContainerType { UseQHash, UseQMap, UseQFlatHash };
+Q_DECLARE_METATYPE(ContainerType)
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert_data() { data(); }
+    void insert();
+    void lookup_data() { data(); }
+    void lookup();
+    void lookupMissing_data() { data(); }
+    void lookupMissing();
+    void iterate_data() { data(); }
+    void iterate();
+
+private:
+    void data();
+    QVector<int> shuffledKeys(int count) const;
+
+    template <typename Container> static Container filled(const QVector<int> &keys);
+    template <typename Container> void insert(const QVector<int> &keys);
+    template <typename Container> void lookup(const QVector<int> &keys);
+    template <typename Container> void lookupMissing(const QVector<int> &keys);
+    template <typename Container> void iterate(const QVector<int> &keys);
+};
+
+#define DISPATCH(function) \
+    QFETCH(ContainerType, container); \
+    QFETCH(int, count); \
+    const QVector<int> keys = shuffledKeys(count); \
+    switch (container) { \
+    case UseQHash: function<QHash<int, int> >(keys); break; \
+    case UseQMap: function<QMap<int, int> >(keys); break; \
+    case UseQFlatHash: function<QFlatHash<int, int> >(keys); break; \
+    }
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<ContainerType>("container");
+    QTest::addColumn<int>("count");
+
+    static const int counts[] = { 1000, 10000, 100000, 1000000, 10000000 };
+    static const struct { ContainerType type; const char *name; } containers[] = {
+        { UseQHash, "QHash" },
+        { UseQMap, "QMap" },
+        { UseQFlatHash, "QFlatHash" }
+    };
+    for (uint i = 0; i < sizeof counts / sizeof *counts; ++i) {
+        for (uint j = 0; j < sizeof containers / sizeof *containers; ++j) {
+            const QByteArray tag = QByteArray(containers[j].name) + ':' + QByteArray::number(counts[i]);
+            QTest::newRow(tag.constData()) << containers[j].type << counts[i];
+        }
+    }
+}
+
+void tst_QFlatHash::insert()
+{
+    DISPATCH(insert)
+}
+
+void tst_QFlatHash::lookup()
+{
+    DISPATCH(lookup)
+}
+
+void tst_QFlatHash::lookupMissing()
+{
+    DISPATCH(lookupMissing)
+}
+
+void tst_QFlatHash::iterate()
+{
+    DISPATCH(iterate)
+}
+
+QVector<int> tst_QFlatHash::shuffledKeys(int count) const
+{
+    // even numbers, so that odd ones can be used for unsuccessful lookups
+    QVector<int> keys(count);
+    for (int i = 0; i < count; ++i)
+        keys[i] = i * 2;
+    uint state = 1;
+    for (int i = count - 1; i > 0; --i) {
+        state = state * 1103515245 + 12345;
+        std::swap(keys[i], keys[int((state >> 8) % uint(i + 1))]);
+    }
+    return keys;
+}
+
+template <typename Container>
+Container tst_QFlatHash::filled(const QVector<int> &keys)
+{
+    Container c;
+    for (int i = 0; i < keys.size(); ++i)
+        c.insert(keys.at(i), i);
+    return c;
+}
+
+template <typename Container>
+void tst_QFlatHash::insert(const QVector<int> &keys)
+{
+    const int count = keys.size();
+    QBENCHMARK {
+        Container c;
+        for (int i = 0; i < count; ++i)
+            c.insert(keys.at(i), i);
+        QCOMPARE(c.size(), count);
+    }
+}
+
+template <typename Container>
+void tst_QFlatHash::lookup(const QVector<int> &keys)
+{
+    const int count = keys.size();
+    const Container c = filled<Container>(keys);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            sum += c.value(keys.at(i));
+    }
+    QVERIFY(sum > 0);
+}
+
+template <typename Container>
+void tst_QFlatHash::lookupMissing(const QVector<int> &keys)
+{
+    const int count = keys.size();
+    const Container c = filled<Container>(keys);
+
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i)
+            found += c.contains(keys.at(i) + 1);
+    }
+    QCOMPARE(found, 0);
+}
+
+template <typename Container>
+void tst_QFlatHash::iterate(const QVector<int> &keys)
+{
+    const Container c = filled<Container>(keys);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (typename Container::const_iterator it = c.constBegin(), end = c.constEnd(); it != end; ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
@@ -33,6 +33,7 @@
 
 #include <qtest.h>
 #include <QImage>
+#include <QThreadPool>
 
 Q_DECLARE_METATYPE(QImage::Format)
 
@@ -61,11 +62,15 @@ private slots:
     void convertGenericInplace_data();
     void convertGenericInplace();
 
+    void convertLargeFrame_data();
+    void convertLargeFrame();
+
 private:
     QImage generateImageRgb888(int width, int height);
     QImage generateImageRgb16(int width, int height);
     QImage generateImageRgb32(int width, int height);
     QImage generateImageArgb32(int width, int height);
+    QImage generateImageGrayscale8(int width, int height);
 };
 
 void tst_QImageConversion::convertRgb888ToRgb32_data()
@@ -321,6 +326,56 @@ void tst_QImageConversion::convertGenericInplace()
     }
 }
 
+void tst_QImageConversion::convertLargeFrame_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QImage::Format>("outputFormat");
+    QTest::addColumn<int>("threadCount");
+
+    // A 4K camera frame, converted on a single thread and in bands across
+    // the global thread pool.
+    const QImage rgb888 = generateImageRgb888(3840, 2160);
+    const QImage rgb32 = generateImageRgb32(3840, 2160);
+    const QImage argb32 = generateImageArgb32(3840, 2160);
+    const QImage argb32pm = argb32.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const QImage rgba8888 = argb32.convertToFormat(QImage::Format_RGBA8888);
+    const QImage grayscale8 = generateImageGrayscale8(3840, 2160);
+
+    const int threadCounts[] = { 1, qMax(QThread::idealThreadCount(), 1) };
+    for (int i = 0; i < 2; ++i) {
+        const int threads = threadCounts[i];
+        if (i && threads == 1)
+            break;
+        const QByteArray suffix = "; threads: " + QByteArray::number(threads);
+        QTest::newRow(QByteArray("rgb888 -> rgb32" + suffix)) << rgb888 << QImage::Format_RGB32 << threads;
+        QTest::newRow(QByteArray("rgb32 -> rgb888" + suffix)) << rgb32 << QImage::Format_RGB888 << threads;
+        QTest::newRow(QByteArray("argb32 -> argb32pm" + suffix)) << argb32 << QImage::Format_ARGB32_Premultiplied << threads;
+        QTest::newRow(QByteArray("argb32pm -> argb32" + suffix)) << argb32pm << QImage::Format_ARGB32 << threads;
+        QTest::newRow(QByteArray("argb32 -> rgba8888" + suffix)) << argb32 << QImage::Format_RGBA8888 << threads;
+        QTest::newRow(QByteArray("rgba8888 -> argb32" + suffix)) << rgba8888 << QImage::Format_ARGB32 << threads;
+        QTest::newRow(QByteArray("rgb32 -> grayscale8" + suffix)) << rgb32 << QImage::Format_Grayscale8 << threads;
+        QTest::newRow(QByteArray("grayscale8 -> rgb32" + suffix)) << grayscale8 << QImage::Format_RGB32 << threads;
+    }
+}
+
+void tst_QImageConversion::convertLargeFrame()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QImage::Format, outputFormat);
+    QFETCH(int, threadCount);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        QImage output = inputImage.convertToFormat(outputFormat);
+        output.constBits();
+    }
+
+    pool->setMaxThreadCount(maxThreadCount);
+}
+
 /*
  Fill a RGB888 image with "random" pixel values.
  */
@@ -386,5 +441,20 @@ QImage tst_QImageConversion::generateImageArgb32(int width, int height)
     return image;
 }
 
+/*
+ Fill a Grayscale8 image with "random" pixel values.
+ */
+QImage tst_QImageConversion::generateImageGrayscale8(int width, int height)
+{
+    QImage image(width, height, QImage::Format_Grayscale8);
+
+    for (int y = 0; y < image.height(); ++y) {
+        uchar *scanline = image.scanLine(y);
+        for (int x = 0; x < width; ++x)
+            scanline[x] = x ^ y;
+    }
+    return image;
+}
+
 QTEST_MAIN(tst_QImageConversion)
 #include "tst_qimageconversion.moc"
@@ -44,6 +44,7 @@
 #endif
 
 #include <private/qpixmap_raster_p.h>
+#include <private/qpaintengine_raster_p.h>
 
 Q_DECLARE_METATYPE(QPainterPath)
 Q_DECLARE_METATYPE(QPainter::RenderHint)
@@ -228,6 +229,9 @@ private slots:
     void drawTransformedSemiTransparentImage();
     void drawTransformedFilledImage();
 
+    void tiledRendering_data();
+    void tiledRendering();
+
 private:
     void setupBrushes();
     void createPrimitives();
@@ -1650,6 +1654,50 @@ void tst_QPainter::drawTransformedFilledImage()
     }
 }
 
+void tst_QPainter::tiledRendering_data()
+{
+    QTest::addColumn<bool>("tiled");
+
+    QTest::newRow("direct") << false;
+    QTest::newRow("tiled") << true;
+}
+
+void tst_QPainter::tiledRendering()
+{
+    QFETCH(bool, tiled);
+
+    QImage surface(1024, 1024, QImage::Format_ARGB32_Premultiplied);
+    surface.fill(Qt::white);
+
+    QLinearGradient gradient(0, 0, 1024, 1024);
+    gradient.setColorAt(0, Qt::red);
+    gradient.setColorAt(1, Qt::blue);
+
+    QPainterPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(200, 0, 0, 200, 200, 200);
+    path.lineTo(0, 200);
+    path.closeSubpath();
+
+    static_cast<QRasterPaintEngine *>(surface.paintEngine())->setTiledRendering(tiled);
+
+    QBENCHMARK {
+        QPainter p(&surface);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setPen(QPen(Qt::black, 3));
+        for (int i = 0; i < 200; ++i) {
+            p.setBrush(i % 2 ? QBrush(gradient) : QBrush(QColor(0, 128, 0, 128)));
+            p.drawEllipse(QRectF((i * 37) % 824, (i * 53) % 824, 200, 200));
+        }
+        p.setBrush(gradient);
+        for (int i = 0; i < 50; ++i) {
+            p.resetTransform();
+            p.translate(512, 512);
+            p.rotate(i * 7.2);
+            p.drawPath(path);
+        }
+    }
+}
 
 QTEST_MAIN(tst_QPainter)
 
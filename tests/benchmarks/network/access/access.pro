@@ -1,6 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
+        qhttpconnectionpolicy \
+        qnetworkcookiejar \
         qnetworkreply \
         qnetworkreply_from_cache \
         qnetworkdiskcache
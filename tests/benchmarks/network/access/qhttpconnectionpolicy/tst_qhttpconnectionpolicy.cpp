@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for QNetworkReply functions.
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qhttpconnectionpolicy.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+
+// Writes the responses for a batch of requests once the simulated round
+// trip time has passed.
+class DelayedResponse : public QObject
+{
+    Q_OBJECT
+public:
+    DelayedResponse(QTcpSocket *socket, int count, int delay)
+        : QObject(socket), socket(socket), count(count)
+    {
+        QTimer::singleShot(delay, this, SLOT(send()));
+    }
+
+public slots:
+    void send()
+    {
+        static const QByteArray body(512, 'x');
+        QByteArray response;
+        for (int i = 0; i < count; ++i) {
+            response += "HTTP/1.1 200 OK\r\n"
+                        "Content-Type: text/plain\r\n"
+                        "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                        "\r\n" + body;
+        }
+        socket->write(response);
+        deleteLater();
+    }
+
+private:
+    QTcpSocket *socket;
+    int count;
+};
+
+// A keep-alive HTTP/1.1 server that answers every GET after a fixed
+// latency. Pipelined requests are answered in order, all of them one
+// latency after they arrived.
+class LatencyHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit LatencyHttpServer(int latency)
+        : latency(latency), connectionCount(0)
+    {
+        connect(this, SIGNAL(newConnection()), this, SLOT(newConnectionSlot()));
+        listen(QHostAddress::LocalHost);
+    }
+
+    int connectionCount;
+
+private slots:
+    void newConnectionSlot()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            ++connectionCount;
+            connect(socket, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void readyReadSlot()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = buffers[socket];
+        buffer += socket->readAll();
+
+        int count = 0;
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+            buffer.remove(0, end + 4);
+            ++count;
+        }
+        if (count)
+            new DelayedResponse(socket, count, latency);
+    }
+
+private:
+    int latency;
+    QHash<QTcpSocket *, QByteArray> buffers;
+};
+
+class tst_QHttpConnectionPolicy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void requestsPerSecond_data();
+    void requestsPerSecond();
+
+public slots:
+    void replyFinished();
+
+private:
+    int pendingReplies;
+};
+
+void tst_QHttpConnectionPolicy::replyFinished()
+{
+    if (--pendingReplies == 0)
+        QTestEventLoop::instance().exitLoop();
+}
+
+void tst_QHttpConnectionPolicy::requestsPerSecond_data()
+{
+    QTest::addColumn<int>("channelCount");
+    QTest::addColumn<bool>("pipelining");
+    QTest::addColumn<int>("pipelineLength");
+
+    QTest::newRow("default") << 6 << false << 3;
+    QTest::newRow("1-channel") << 1 << false << 3;
+    QTest::newRow("1-channel-pipelined") << 1 << true << 3;
+    QTest::newRow("1-channel-pipelined-8") << 1 << true << 8;
+    QTest::newRow("6-channels-pipelined") << 6 << true << 3;
+    QTest::newRow("12-channels") << 12 << false << 3;
+    QTest::newRow("12-channels-pipelined-8") << 12 << true << 8;
+}
+
+void tst_QHttpConnectionPolicy::requestsPerSecond()
+{
+    QFETCH(int, channelCount);
+    QFETCH(bool, pipelining);
+    QFETCH(int, pipelineLength);
+
+    const int requestCount = 240;
+    LatencyHttpServer server(5);
+    QVERIFY(server.isListening());
+    const QUrl url(QStringLiteral("http://127.0.0.1:%1/resource").arg(server.serverPort()));
+
+    QHttpConnectionPolicy policy;
+    policy.setChannelCount(channelCount);
+    policy.setPipeliningEnabled(pipelining);
+    policy.setMaximumPipelineLength(pipelineLength);
+
+    QNetworkAccessManager manager;
+    manager.setHttpConnectionPolicy(policy);
+    connect(&manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(replyFinished()));
+
+    qint64 elapsed = 0;
+    QBENCHMARK {
+        manager.clearAccessCache();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QList<QNetworkReply *> replies;
+        pendingReplies = requestCount;
+        for (int i = 0; i < requestCount; ++i)
+            replies.append(manager.get(QNetworkRequest(url)));
+
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        elapsed = timer.elapsed();
+
+        foreach (QNetworkReply *reply, replies) {
+            QCOMPARE(reply->error(), QNetworkReply::NoError);
+            QCOMPARE(reply->readAll().size(), 512);
+        }
+        qDeleteAll(replies);
+    }
+
+    qDebug() << QTest::currentDataTag() << requestCount * 1000 / qMax(elapsed, qint64(1))
+             << "requests/s on" << server.connectionCount << "connections";
+}
+
+QTEST_MAIN(tst_QHttpConnectionPolicy)
+
+#include "tst_qhttpconnectionpolicy.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_qnetworkcookiejar
+
+QT -= gui
+QT += network testlib
+
+CONFIG += release
+
+SOURCES += tst_qnetworkcookiejar.cpp
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for QNetworkCookieJar functions.
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qnetworkcookie.h>
+#include <QtNetwork/qnetworkcookiejar.h>
+
+class tst_qnetworkcookiejar : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cookiesForUrl_data();
+    void cookiesForUrl();
+    void insertCookie();
+};
+
+static QList<QNetworkCookie> makeCookies(int count)
+{
+    QList<QNetworkCookie> cookies;
+    for (int i = 0; i < count; ++i) {
+        QNetworkCookie cookie("name", QByteArray::number(i));
+        cookie.setDomain(QString::fromLatin1(".host%1.example.com").arg(i));
+        cookie.setPath(QStringLiteral("/"));
+        cookies += cookie;
+    }
+    return cookies;
+}
+
+void tst_qnetworkcookiejar::cookiesForUrl_data()
+{
+    QTest::addColumn<int>("cookieCount");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void tst_qnetworkcookiejar::cookiesForUrl()
+{
+    QFETCH(int, cookieCount);
+
+    QNetworkCookieJar jar;
+    foreach (const QNetworkCookie &cookie, makeCookies(cookieCount))
+        jar.insertCookie(cookie);
+    const QUrl url(QStringLiteral("http://www.host42.example.com/index.html"));
+
+    QBENCHMARK {
+        QList<QNetworkCookie> cookies = jar.cookiesForUrl(url);
+        Q_UNUSED(cookies);
+    }
+}
+
+void tst_qnetworkcookiejar::insertCookie()
+{
+    const QList<QNetworkCookie> cookies = makeCookies(10000);
+
+    QBENCHMARK {
+        QNetworkCookieJar jar;
+        foreach (const QNetworkCookie &cookie, cookies)
+            jar.insertCookie(cookie);
+    }
+}
+
+QTEST_MAIN(tst_qnetworkcookiejar)
+
+#include "tst_qnetworkcookiejar.moc"
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtNetwork/qudpsocket.h>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loopbackThroughput_data();
+    void loopbackThroughput();
+};
+
+enum { DatagramsPerRound = 64, Rounds = 200 };
+
+void tst_QUdpSocket::loopbackThroughput_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("datagramSize");
+
+    QTest::newRow("single-64") << false << 64;
+    QTest::newRow("batched-64") << true << 64;
+    QTest::newRow("single-512") << false << 512;
+    QTest::newRow("batched-512") << true << 512;
+    QTest::newRow("single-1400") << false << 1400;
+    QTest::newRow("batched-1400") << true << 1400;
+}
+
+void tst_QUdpSocket::loopbackThroughput()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, datagramSize);
+
+    QUdpSocket server;
+    QVERIFY2(server.bind(QHostAddress(QHostAddress::LocalHost), 0), qPrintable(server.errorString()));
+    QUdpSocket client;
+    QVERIFY2(client.bind(QHostAddress(QHostAddress::LocalHost), 0), qPrintable(client.errorString()));
+
+    QByteArrayList datagrams;
+    for (int i = 0; i < DatagramsPerRound; ++i)
+        datagrams << QByteArray(datagramSize, char('a' + i % 26));
+    QByteArray buffer(datagramSize, Qt::Uninitialized);
+    QByteArrayList received;
+
+    qint64 lost = 0;
+    QBENCHMARK {
+        for (int round = 0; round < Rounds; ++round) {
+            if (batched) {
+                QCOMPARE(client.writeDatagrams(datagrams, server.localAddress(), server.localPort()),
+                         int(DatagramsPerRound));
+            } else {
+                for (int i = 0; i < DatagramsPerRound; ++i)
+                    client.writeDatagram(datagrams.at(i), server.localAddress(), server.localPort());
+            }
+
+            int count = 0;
+            while (count < DatagramsPerRound) {
+                if (batched) {
+                    const int read = server.readDatagrams(&received, DatagramsPerRound - count,
+                                                          datagramSize);
+                    if (read > 0) {
+                        count += read;
+                        continue;
+                    }
+                    if (read < 0 || !server.waitForReadyRead(1000))
+                        break;
+                } else {
+                    if (!server.hasPendingDatagrams() && !server.waitForReadyRead(1000))
+                        break;
+                    server.readDatagram(buffer.data(), datagramSize);
+                    ++count;
+                }
+            }
+            received.clear();
+            lost += DatagramsPerRound - count;
+        }
+    }
+
+    if (lost)
+        qDebug("%lld datagrams lost", lost);
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+
+#include "tst_qudpsocket.moc"
@@ -55,6 +55,12 @@ public slots:
 private slots:
     void benchmark_data() { generic_data(); }
     void benchmark();
+    void readValues_data() { generic_data(); }
+    void readValues();
+    void readBatches_data() { generic_data(); }
+    void readBatches();
+    void insertBatch_data() { generic_data(); }
+    void insertBatch();
 
 private:
     // returns all database connections
@@ -62,6 +68,7 @@ private:
     void dropTestTables( QSqlDatabase db );
     void createTestTables( QSqlDatabase db );
     void populateTestTables( QSqlDatabase db );
+    void createReadTable(QSqlDatabase db, const QString &tableName);
 
     tst_Databases dbs;
 };
@@ -264,4 +271,103 @@ void tst_QSqlQuery::benchmark()
     tst_Databases::safeDropTable( db, tableName );
 }
 
+void tst_QSqlQuery::createReadTable(QSqlDatabase db, const QString &tableName)
+{
+    QSqlQuery q(db);
+    tst_Databases::safeDropTable(db, tableName);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int, value double precision, name varchar(20))"));
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " values (?, ?, ?)"));
+    QVariantList ids;
+    QVariantList values;
+    QVariantList names;
+    for (int i = 0; i < 10000; ++i) {
+        ids << i;
+        values << i / 4.0;
+        names << QString("Value%1").arg(i);
+    }
+    q.addBindValue(ids);
+    q.addBindValue(values);
+    q.addBindValue(names);
+    QVERIFY_SQL(q, execBatch());
+}
+
+void tst_QSqlQuery::readValues()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName(qTableName("readValues", __FILE__, db));
+    createReadTable(db, tableName);
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec("select id, value, name from " + tableName));
+        qint64 ids = 0;
+        double values = 0;
+        int length = 0;
+        while (q.next()) {
+            ids += q.value(0).toLongLong();
+            values += q.value(1).toDouble();
+            length += q.value(2).toString().length();
+        }
+        QVERIFY(length > 0);
+    }
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::readBatches()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName(qTableName("readBatches", __FILE__, db));
+    createReadTable(db, tableName);
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    QSqlColumnBatch batch;
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec("select id, value, name from " + tableName));
+        qint64 ids = 0;
+        double values = 0;
+        int length = 0;
+        while (int rows = q.fetchBatch(&batch, 1000)) {
+            // some databases report numeric columns as doubles or strings
+            const bool typed = batch.columnType(0) == QSqlColumnBatch::Int64
+                    && batch.columnType(1) == QSqlColumnBatch::Double;
+            for (int row = 0; row < rows; ++row) {
+                if (typed) {
+                    ids += batch.int64Value(row, 0);
+                    values += batch.doubleValue(row, 1);
+                } else {
+                    ids += batch.value(row, 0).toLongLong();
+                    values += batch.value(row, 1).toDouble();
+                }
+                length += batch.stringValue(row, 2).length();
+            }
+        }
+        QVERIFY(length > 0);
+    }
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
+void tst_QSqlQuery::insertBatch()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName(qTableName("insertBatch", __FILE__, db));
+    QBENCHMARK {
+        createReadTable(db, tableName);
+    }
+
+    tst_Databases::safeDropTable( db, tableName );
+}
+
 #include "main.moc"